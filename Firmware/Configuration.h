@@ -84,6 +84,9 @@ extern const char _sPrinterMmuName[] PROGMEM;
 // Enable g-code compression (see https://github.com/scottmudge/OctoPrint-MeatPack)
 #define ENABLE_MEATPACK
 
+// Enable the binary G-code transport of the serial line (M930, see binary_transport.h)
+#define ENABLE_BINARY_TRANSPORT
+
 // This enables the serial port associated to the Bluetooth interface
 //#define BTENABLED              // Enable BT interface on AT90USB devices
 
@@ -297,6 +300,20 @@ your extruder heater takes 2 minutes to hit the target on heating.
 #define DEFAULT_ZJERK                 0.4     // (mm/sec)
 #define DEFAULT_EJERK                 4.5     // (mm/sec)
 
+// Junction deviation cornering (M205 J). Limits the speed through a corner by the distance of an
+// arc of the acceleration from the corner instead of the X, Y, Z jerk. 0 keeps the jerk limits.
+#define DEFAULT_JUNCTION_DEVIATION    0       // (mm)
+
+// Chord tolerance of the G2/G3 arcs (M214 T). The segments are as long as the chord deviates from
+// the arc by up to the tolerance, instead of the fixed segment length. 0 keeps the segment length.
+#define DEFAULT_ARC_TOLERANCE         0       // (mm)
+
+// Input shaping (M593), see input_shaper.h. A zero frequency switches the shaper of the axis off.
+#define DEFAULT_SHAPING_FREQ_X        0       // (Hz)
+#define DEFAULT_SHAPING_FREQ_Y        0       // (Hz)
+#define DEFAULT_SHAPING_ZETA          0.1     // damping ratio
+#define DEFAULT_SHAPING_TYPE          2       // 0 ZV, 1 ZVD, 2 MZV
+
 //===========================================================================
 //=============================Additional Features===========================
 //===========================================================================
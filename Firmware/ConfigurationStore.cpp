@@ -5,6 +5,7 @@
 #include "temperature.h"
 #include "ConfigurationStore.h"
 #include "Configuration_var.h"
+#include "input_shaper.h"
 
 #ifdef TMC2130
 #include "tmc2130.h"
@@ -27,7 +28,7 @@ void Config_PrintSettings(uint8_t level)
 		"%SMaximum acceleration - normal (mm/s2):\n%S  M201 X%lu Y%lu Z%lu E%lu\n"
 		"%SMaximum acceleration - stealth (mm/s2):\n%S  M201 X%lu Y%lu Z%lu E%lu\n"
 		"%SAcceleration: P=print, R=retract, T=travel\n%S  M204 P%.2f R%.2f T%.2f\n"
-		"%SAdvanced variables: S=Min feedrate (mm/s), T=Min travel feedrate (mm/s), B=minimum segment time (us), X=maximum XY jerk (mm/s),  Z=maximum Z jerk (mm/s),  E=maximum E jerk (mm/s)\n%S  M205 S%.2f T%.2f B%lu X%.2f Y%.2f Z%.2f E%.2f\n"
+		"%SAdvanced variables: S=Min feedrate (mm/s), T=Min travel feedrate (mm/s), B=minimum segment time (us), X=maximum XY jerk (mm/s),  Z=maximum Z jerk (mm/s),  E=maximum E jerk (mm/s), J=junction deviation (mm)\n%S  M205 S%.2f T%.2f B%lu X%.2f Y%.2f Z%.2f E%.2f J%.3f\n"
 		"%SHome offset (mm):\n%S  M206 X%.2f Y%.2f Z%.2f\n"
 		),
 		echomagic, echomagic, cs.axis_steps_per_mm[X_AXIS], cs.axis_steps_per_mm[Y_AXIS], cs.axis_steps_per_mm[Z_AXIS], cs.axis_steps_per_mm[E_AXIS],
@@ -37,7 +38,7 @@ void Config_PrintSettings(uint8_t level)
 		echomagic, echomagic, cs.max_acceleration_mm_per_s2_normal[X_AXIS], cs.max_acceleration_mm_per_s2_normal[Y_AXIS], cs.max_acceleration_mm_per_s2_normal[Z_AXIS], cs.max_acceleration_mm_per_s2_normal[E_AXIS],
 		echomagic, echomagic, cs.max_acceleration_mm_per_s2_silent[X_AXIS], cs.max_acceleration_mm_per_s2_silent[Y_AXIS], cs.max_acceleration_mm_per_s2_silent[Z_AXIS], cs.max_acceleration_mm_per_s2_silent[E_AXIS],
 		echomagic, echomagic, cs.acceleration, cs.retract_acceleration, cs.travel_acceleration,
-		echomagic, echomagic, cs.minimumfeedrate, cs.mintravelfeedrate, cs.min_segment_time_us, cs.max_jerk[X_AXIS], cs.max_jerk[Y_AXIS], cs.max_jerk[Z_AXIS], cs.max_jerk[E_AXIS],
+		echomagic, echomagic, cs.minimumfeedrate, cs.mintravelfeedrate, cs.min_segment_time_us, cs.max_jerk[X_AXIS], cs.max_jerk[Y_AXIS], cs.max_jerk[Z_AXIS], cs.max_jerk[E_AXIS], cs.junction_deviation,
 		echomagic, echomagic, cs.add_homing[X_AXIS], cs.add_homing[Y_AXIS], cs.add_homing[Z_AXIS]
 #else //TMC2130
 	printf_P(PSTR(
@@ -45,14 +46,14 @@ void Config_PrintSettings(uint8_t level)
 		"%SMaximum feedrates (mm/s):\n%S  M203 X%.2f Y%.2f Z%.2f E%.2f\n"
 		"%SMaximum acceleration (mm/s2):\n%S  M201 X%lu Y%lu Z%lu E%lu\n"
 		"%SAcceleration: P=print, R=retract, T=travel\n%S  M204 P%.2f R%.2f T%.2f\n"
-		"%SAdvanced variables: S=Min feedrate (mm/s), T=Min travel feedrate (mm/s), B=minimum segment time (us), X=maximum XY jerk (mm/s),  Z=maximum Z jerk (mm/s),  E=maximum E jerk (mm/s)\n%S  M205 S%.2f T%.2f B%lu X%.2f Y%.2f Z%.2f E%.2f\n"
+		"%SAdvanced variables: S=Min feedrate (mm/s), T=Min travel feedrate (mm/s), B=minimum segment time (us), X=maximum XY jerk (mm/s),  Z=maximum Z jerk (mm/s),  E=maximum E jerk (mm/s), J=junction deviation (mm)\n%S  M205 S%.2f T%.2f B%lu X%.2f Y%.2f Z%.2f E%.2f J%.3f\n"
 		"%SHome offset (mm):\n%S  M206 X%.2f Y%.2f Z%.2f\n"
 		),
 		echomagic, echomagic, cs.axis_steps_per_mm[X_AXIS], cs.axis_steps_per_mm[Y_AXIS], cs.axis_steps_per_mm[Z_AXIS], cs.axis_steps_per_mm[E_AXIS],
 		echomagic, echomagic, max_feedrate[X_AXIS], max_feedrate[Y_AXIS], max_feedrate[Z_AXIS], max_feedrate[E_AXIS],
 		echomagic, echomagic, max_acceleration_mm_per_s2[X_AXIS], max_acceleration_mm_per_s2[Y_AXIS], max_acceleration_mm_per_s2[Z_AXIS], max_acceleration_mm_per_s2[E_AXIS],
 		echomagic, echomagic, cs.acceleration, cs.retract_acceleration, cs.travel_acceleration,
-		echomagic, echomagic, cs.minimumfeedrate, cs.mintravelfeedrate, cs.min_segment_time_us, cs.max_jerk[X_AXIS], cs.max_jerk[Y_AXIS], cs.max_jerk[Z_AXIS], cs.max_jerk[E_AXIS],
+		echomagic, echomagic, cs.minimumfeedrate, cs.mintravelfeedrate, cs.min_segment_time_us, cs.max_jerk[X_AXIS], cs.max_jerk[Y_AXIS], cs.max_jerk[Z_AXIS], cs.max_jerk[E_AXIS], cs.junction_deviation,
 		echomagic, echomagic, cs.add_homing[X_AXIS], cs.add_homing[Y_AXIS], cs.add_homing[Z_AXIS]
 #endif //TMC2130
   );
@@ -101,8 +102,14 @@ void Config_PrintSettings(uint8_t level)
   }
     // Arc Interpolation Settings
     printf_P(PSTR(
-        "%SArc Settings: P:Max length(mm) S:Min length (mm) N:Corrections R:Min segments F:Segments/sec.\n%S  M214 P%.2f S%.2f N%d R%d F%d\n"),
-        echomagic, echomagic, cs.mm_per_arc_segment, cs.min_mm_per_arc_segment, cs.n_arc_correction, cs.min_arc_segments, cs.arc_segments_per_sec);
+        "%SArc Settings: P:Max length(mm) S:Min length (mm) N:Corrections R:Min segments F:Segments/sec. T:Tolerance (mm)\n%S  M214 P%.2f S%.2f N%d R%d F%d T%.3f\n"),
+        echomagic, echomagic, cs.mm_per_arc_segment, cs.min_mm_per_arc_segment, cs.n_arc_correction, cs.min_arc_segments, cs.arc_segments_per_sec, cs.arc_tolerance);
+#ifdef INPUT_SHAPING
+    printf_P(PSTR(
+        "%SInput shaping: F:Frequency (Hz, 0 off) D:Damping ratio T:Type (0 ZV, 1 ZVD, 2 MZV)\n%S  M593 X F%.2f D%.3f T%d\n%S  M593 Y F%.2f D%.3f T%d\n"),
+        echomagic, echomagic, cs.shaping_freq[X_AXIS], cs.shaping_zeta[X_AXIS], cs.shaping_type[X_AXIS],
+        echomagic, cs.shaping_freq[Y_AXIS], cs.shaping_zeta[Y_AXIS], cs.shaping_type[Y_AXIS]);
+#endif //INPUT_SHAPING
 #ifdef THERMAL_MODEL
     thermal_model_report_settings();
 #endif
@@ -117,10 +124,12 @@ static_assert (NUM_AXIS == 4, "ConfigurationStore M500_conf not implemented for
         "Fix axis_steps_per_mm max_feedrate_normal max_acceleration_mm_per_s2_normal max_jerk max_feedrate_silent"
         " max_acceleration_mm_per_s2_silent array size.");
 
-static_assert (sizeof(M500_conf) == 209, "sizeof(M500_conf) has changed, ensure that EEPROM_VERSION has been incremented, "
+#ifdef __AVR__
+static_assert (sizeof(M500_conf) == 235, "sizeof(M500_conf) has changed, ensure that EEPROM_VERSION has been incremented, "
         "or if you added members in the end of struct, ensure that historically uninitialized values will be initialized."
         "If this is caused by change to more then 8bit processor, decide whether make this struct packed to save EEPROM,"
         "leave as it is to keep fast code, or reorder struct members to pack more tightly.");
+#endif //__AVR__
 
 static const M500_conf default_conf PROGMEM =
 {
@@ -170,7 +179,12 @@ static const M500_conf default_conf PROGMEM =
     DEFAULT_MIN_MM_PER_ARC_SEGMENT,
     DEFAULT_N_ARC_CORRECTION,
     DEFAULT_MIN_ARC_SEGMENTS,
-    DEFAULT_ARC_SEGMENTS_PER_SEC
+    DEFAULT_ARC_SEGMENTS_PER_SEC,
+    DEFAULT_JUNCTION_DEVIATION,
+    {DEFAULT_SHAPING_FREQ_X, DEFAULT_SHAPING_FREQ_Y},
+    {DEFAULT_SHAPING_ZETA, DEFAULT_SHAPING_ZETA},
+    {DEFAULT_SHAPING_TYPE, DEFAULT_SHAPING_TYPE},
+    DEFAULT_ARC_TOLERANCE,
 };
 
 
@@ -202,6 +216,15 @@ bool Config_RetrieveSettings()
         eeprom_init_default_byte(&EEPROM_M500_base->n_arc_correction, pgm_read_byte(&default_conf.n_arc_correction));
         eeprom_init_default_word(&EEPROM_M500_base->min_arc_segments, pgm_read_word(&default_conf.min_arc_segments));
         eeprom_init_default_word(&EEPROM_M500_base->arc_segments_per_sec, pgm_read_word(&default_conf.arc_segments_per_sec));
+        eeprom_init_default_float(&EEPROM_M500_base->arc_tolerance, pgm_read_float(&default_conf.arc_tolerance));
+
+        // Initialize the junction deviation in eeprom if not already
+        eeprom_init_default_float(&EEPROM_M500_base->junction_deviation, pgm_read_float(&default_conf.junction_deviation));
+
+        // Initialize the input shaping settings in eeprom if not already
+        eeprom_init_default_block_P(&EEPROM_M500_base->shaping_freq, sizeof(EEPROM_M500_base->shaping_freq), default_conf.shaping_freq);
+        eeprom_init_default_block_P(&EEPROM_M500_base->shaping_zeta, sizeof(EEPROM_M500_base->shaping_zeta), default_conf.shaping_zeta);
+        eeprom_init_default_block_P(&EEPROM_M500_base->shaping_type, sizeof(EEPROM_M500_base->shaping_type), default_conf.shaping_type);
 
         // Initialize the travel_acceleration in eeprom if not already
         eeprom_init_default_float(&EEPROM_M500_base->travel_acceleration, pgm_read_float(&default_conf.travel_acceleration));
@@ -241,6 +264,9 @@ bool Config_RetrieveSettings()
 
     // Call updatePID (similar to when we have processed M301)
     updatePID();
+#ifdef INPUT_SHAPING
+    shaper_update();
+#endif //INPUT_SHAPING
 #ifdef THERMAL_MODEL
     thermal_model_load_settings();
 #endif
@@ -271,6 +297,9 @@ void Config_ResetDefault()
 #ifdef PIDTEMP
     updatePID();
 #endif//PIDTEMP
+#ifdef INPUT_SHAPING
+    shaper_update();
+#endif //INPUT_SHAPING
 #ifdef THERMAL_MODEL
     thermal_model_reset_settings();
 #endif
@@ -45,6 +45,11 @@ typedef struct
     uint8_t n_arc_correction; // If equal to zero, this is disabled
     uint16_t min_arc_segments; // If equal to zero, this is disabled
     uint16_t arc_segments_per_sec; // If equal to zero, this is disabled
+    float junction_deviation; //!< (mm) M205 J, zero selects the jerk limits for the X, Y and Z junctions
+    float shaping_freq[2]; //!< (Hz) M593 F, input shaper frequency of the X and Y axes, zero switches the shaper off
+    float shaping_zeta[2]; //!< M593 D, damping ratio of the shaped resonances
+    uint8_t shaping_type[2]; //!< M593 T, shaper type of the X and Y axes, see SHAPER_TYPE
+    float arc_tolerance; //!< (mm) M214 T, largest deviation of an arc segment from the arc, zero selects the segment length
 } M500_conf;
 
 extern M500_conf cs;
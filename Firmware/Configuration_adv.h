@@ -166,6 +166,25 @@
 #define INVERT_Z_STEP_PIN 0
 #define INVERT_E_STEP_PIN 0
 
+// The X, Y, Z and E0 step pins of the Rambo and Einsy boards share PORTC (PC0..PC3).
+// With TMC2130_DEDGE_STEPPING, let the stepper interrupt collect the steps of a Bresenham iteration
+// into a bit mask and toggle the step pins of all axes by a single write to PINC. The serial line is
+// polled once per interrupt instead of once per iteration. Ignored on other configurations.
+#define STEPPER_BATCH_STEPS
+
+// Multi-stepping: above STEP_ISR_RATE_DEFAULT steps/s the stepper interrupt executes 2 (and above twice
+// that rate 4) steps per invocation. With STEP_LOOPS_ADAPTIVE the limit follows the measured busy time of the
+// interrupt: it is lowered when the interrupt takes more than 1/STEP_ISR_LOAD_DIV of the CPU or misses
+// its next compare, and raised while multi-stepping leaves enough headroom, so the moves stay single
+// stepped as long as the CPU allows. The current state is printed by D30.
+#define STEP_LOOPS_ADAPTIVE
+#define STEP_ISR_RATE_DEFAULT 10000 // ISR invocations per second before multi-stepping
+#ifdef STEP_LOOPS_ADAPTIVE
+  #define STEP_ISR_RATE_MIN   5000
+  #define STEP_ISR_RATE_MAX   20000 // calc_timer() limits the ISR period to 100 timer ticks
+  #define STEP_ISR_LOAD_DIV   3     // target at most 1/3 of the CPU time in the stepper interrupt
+#endif
+
 //default stepper release if idle
 #define DEFAULT_STEPPER_DEACTIVE_TIME 60
 
@@ -296,6 +315,34 @@
   //#define LA_DEBUG_LOGIC     // @wavexx: setup logic channels for isr debugging
 #endif
 
+/**
+ * Jerk limited (S-curve) acceleration, see scurve.h
+ *
+ * The acceleration and deceleration ramps follow a smoothstep curve instead of a straight line.
+ * They take the same time and distance as the trapezoid ramps, the acceleration peaks
+ * at 15/8 of the configured one in the middle of the ramp and changes smoothly at its ends.
+ * The blocks grow by 6 bytes, therefore the planner queue is shortened to stay within BLOCK_BUFFER_RAM.
+ */
+//#define S_CURVE_ACCELERATION
+
+/**
+ * Input shaping of the X and Y axes, see input_shaper.h
+ *
+ * The step streams of X and Y are split into delayed copies (ZV, ZVD or MZV shaper), which cancel
+ * the ringing of the axis at the configured frequency. M593 sets the frequency, the damping ratio
+ * and the shaper type per axis, M500 stores them. A zero frequency switches the shaper of the axis off.
+ * The moves of the homing pass through without delay. Needs STEPPER_BATCH_STEPS and LIN_ADVANCE.
+ */
+#if defined(TMC2130_DEDGE_STEPPING) && defined(LIN_ADVANCE)
+#define INPUT_SHAPING
+#endif
+
+#ifdef INPUT_SHAPING
+  #define SHAPING_SLOT_SHIFT 10  // the step history is kept in slots of 2^10 timer ticks (512us)
+  #define SHAPING_SLOTS      64  // slots of the history (power of two), 64 bytes per axis, limits the longest delay
+  #define SHAPING_ISR_PERIOD 512 // longest stepper interrupt period (timer ticks) while delayed steps are pending
+#endif
+
 // Arc interpretation settings : Moved to the variant files.
 
 const unsigned int dropsegments=5; //everything with less than this number of steps will be ignored as move and joined with the next movement
@@ -336,21 +383,33 @@ const unsigned int dropsegments=5; //everything with less than this number of st
 //===========================================================================
 
 // The number of linear motions that can be in the plan at any give time.
-// THE BLOCK_BUFFER_SIZE NEEDS TO BE A POWER OF 2, i.g. 8,16,32 because shifts and ors are used to do the ring-buffering.
-#if defined SDSUPPORT
-  #define BLOCK_BUFFER_SIZE 16   // SD,LCD,Buttons take more memory, block buffer needs to be smaller
+// The planner queue (block_t) and its save/recovery side ring (block_recovery_t) have to fit into
+// BLOCK_BUFFER_RAM bytes, which is the SRAM the former 16 blocks of 110 bytes occupied.
+#define BLOCK_BUFFER_RAM 1760
+#if defined S_CURVE_ACCELERATION
+  #define BLOCK_BUFFER_SIZE 18
+#elif defined SDSUPPORT
+  #define BLOCK_BUFFER_SIZE 20   // SD,LCD,Buttons take more memory, block buffer needs to be smaller
 #else
-  #define BLOCK_BUFFER_SIZE 16 // maximize block buffer
+  #define BLOCK_BUFFER_SIZE 20 // maximize block buffer
 #endif
 
 
 //The ASCII buffer for receiving from the serial:
 #define MAX_CMD_SIZE 96
 #define BUFSIZE 4
-// The command header contains the following values:
-// 1st byte: the command source (CMDBUFFER_CURRENT_TYPE_USB, CMDBUFFER_CURRENT_TYPE_SDCARD, CMDBUFFER_CURRENT_TYPE_UI or CMDBUFFER_CURRENT_TYPE_CHAINED)
-// 2nd and 3rd byte (LSB first) contains a 16bit length of a command including its preceding comments.
-#define CMDHDRSIZE 3
+// Descriptors of the queued commands, a power of two. The commands of a print are short, several of
+// them share the space of one of the BUFSIZE lines, the moves stored as records (CMDQUEUE_PREFETCH_MOVES)
+// about 16 of them. Five descriptors are kept for the commands pushed to the front.
+#define CMDQUEUE_SIZE 32
+// The plain G0/G1 moves read from the serial line or the SD card are parsed when queued and stored as
+// records shorter than their text, so that more lines fit the queue. loop() plans up to this many of
+// them right after the command it processed while the planner has free blocks, before it spends its
+// time on the heaters and the LCD.
+#define CMDQUEUE_PREFETCH_MOVES 4
+// Count the moves, which found the planner queue drained by the stepper while no command waited for
+// it: the commands did not come fast enough (D31). Costs 3 bytes of SRAM.
+#define PLANNER_STARVATION_COUNT
 
 #define FILAMENT_CHANGE_UNLOAD_FEEDRATE         10.f  // (mm/s) Unload filament feedrate. This can be pretty fast.
 #define FILAMENT_UNLOAD_FAST_RETRACT_FEEDRATE   86.67f  // (mm/s) Unload fast retract feedrate.
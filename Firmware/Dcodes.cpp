@@ -605,6 +605,72 @@ void dcode_12()
 
 }
 
+#ifdef STEP_LOOPS_ADAPTIVE
+#include "stepper.h"
+
+    /*!
+    ### D30 - Stepper interrupt multi-stepping statistics
+    Prints the steps per interrupt chosen last, the step rate above which the interrupt multi-steps,
+    the longest interrupt and the number of missed compare matches since the last reset.
+    #### Usage
+
+        D30 [ R ]
+
+    #### Parameters
+    - `R` - Reset the statistics after printing them
+    */
+void dcode_30()
+{
+	st_isr_stats_t stats;
+	st_get_isr_stats(stats);
+	printf_P(PSTR("step_loops=%u limit=%u busy_max=%uus overruns=%u\n"),
+		stats.step_loops, stats.isr_rate_max, stats.busy_max / 2, stats.overruns);
+	if (code_seen('R'))
+		st_reset_isr_stats();
+}
+#endif //STEP_LOOPS_ADAPTIVE
+
+#ifdef PLANNER_STARVATION_COUNT
+#include "planner.h"
+#include "telemetry.h"
+
+    /*!
+    ### D31 - Planner starvation count, feed telemetry
+    Prints the number of moves, which found the planner queue already drained by the stepper although
+    no command waited for the moves to finish: the commands did not come fast enough.
+
+    The builds with FEED_TELEMETRY print in one line instead:
+    - `starved` - moves, which found the planner queue already drained by the stepper although no
+      command waited for the moves to finish: the commands did not come fast enough
+    - `starved_ms` - time with the planner queue drained that way during a print
+    - `rx_max` - most characters stored in the serial receive buffer at once
+    - `rx_full` - serial receive buffer overflows ("Full RX Buffer")
+    - `overruns` - stepper interrupt overruns
+    - `planner_ms`, `cmdqueue_ms` - time by the occupancy of the planner and of the command queue,
+      in 8 bins from empty to full
+
+    Periodically reported by `M155 C8`.
+    #### Usage
+
+        D31 [ R ]
+
+    #### Parameters
+    - `R` - Reset the count or the telemetry after printing it
+    */
+void dcode_31()
+{
+#ifdef FEED_TELEMETRY
+	telemetry_report();
+	if (code_seen('R'))
+		telemetry_reset();
+#else
+	printf_P(PSTR("planner_starved=%u\n"), planner_starvation_count());
+	if (code_seen('R'))
+		planner_starvation_reset();
+#endif //FEED_TELEMETRY
+}
+#endif //PLANNER_STARVATION_COUNT
+
 #ifdef HEATBED_ANALYSIS
     /*!
     ### D80 - Bed check <a href="https://reprap.org/wiki/G-code#D80:_Bed_check">D80: Bed check</a>
@@ -42,6 +42,14 @@ extern bool emergency_serial_dump; //emergency dump enabled flag
 extern void serial_dump_and_reset(dump_crash_reason);
 #endif
 
+#ifdef STEP_LOOPS_ADAPTIVE
+extern void dcode_30(); //D30 - Stepper interrupt multi-stepping statistics
+#endif //STEP_LOOPS_ADAPTIVE
+
+#ifdef PLANNER_STARVATION_COUNT
+extern void dcode_31(); //D31 - Planner starvation count, feed telemetry
+#endif //PLANNER_STARVATION_COUNT
+
 #ifdef HEATBED_ANALYSIS
 extern void dcode_80(); //D80 - Bed check. This command will log data to SD card file "mesh.txt".
 extern void dcode_81(); //D81 - Bed analysis. This command will log data to SD card file "wldsd.txt".
@@ -31,23 +31,13 @@ uint8_t selectedSerialPort = 0;
 #if defined(UBRRH) || defined(UBRR0H) || defined(UBRR1H) || defined(UBRR2H) || defined(UBRR3H)
 
 #ifdef HAS_UART
-  ring_buffer rx_buffer  =  { { 0 }, 0, 0 };
+#ifdef FEED_TELEMETRY
+  ring_buffer rx_buffer  =  { { 0 }, 0, 0, false, 0 };
+#else
+  ring_buffer rx_buffer  =  { { 0 }, 0, 0, false };
+#endif //FEED_TELEMETRY
 #endif
 
-FORCE_INLINE void store_char(unsigned char c)
-{
-  int i = (unsigned int)(rx_buffer.head + 1) % RX_BUFFER_SIZE;
-
-  // if we should be storing the received character into the location
-  // just before the tail (meaning that the head would advance to the
-  // current location of the tail), we're about to overflow the buffer
-  // and so we don't write the character or advance the head.
-  if (i != rx_buffer.tail) {
-    rx_buffer.buffer[rx_buffer.head] = c;
-    rx_buffer.head = i;
-  }
-}
-
 
 #if defined(M_USARTx_RX_vect)
 // The serial line receive interrupt routine for a baud rate 115200
@@ -164,7 +154,7 @@ void MarlinSerial::end()
 
 int MarlinSerial::peek(void)
 {
-  if (rx_buffer.head == rx_buffer.tail) {
+  if (rx_head() == rx_buffer.tail) {
     return -1;
   } else {
     return rx_buffer.buffer[rx_buffer.tail];
@@ -174,23 +164,56 @@ int MarlinSerial::peek(void)
 int MarlinSerial::read(void)
 {
   // if the head isn't ahead of the tail, we don't have any characters
-  if (rx_buffer.head == rx_buffer.tail) {
+  if (rx_head() == rx_buffer.tail) {
     return -1;
   } else {
     unsigned char c = rx_buffer.buffer[rx_buffer.tail];
-    rx_buffer.tail = (unsigned int)(rx_buffer.tail + 1) % RX_BUFFER_SIZE;
+    skip(1);
     return c;
   }
 }
 
+rx_index_t MarlinSerial::peekBlock(const unsigned char *&data)
+{
+  const rx_index_t head = rx_head();
+  const rx_index_t tail = rx_buffer.tail;
+  data = rx_buffer.buffer + tail;
+  // Up to the head, or up to the end of the ring if the head wrapped around.
+  return (head >= tail) ? rx_index_t(head - tail) : rx_index_t(RX_BUFFER_SIZE - tail);
+}
+
+void MarlinSerial::skip(rx_index_t n)
+{
+  const rx_index_t tail = (rx_buffer.tail + n) & RX_BUFFER_MASK;
+#ifdef RX_INDEX_ATOMIC
+  CRITICAL_SECTION_START;
+  rx_buffer.tail = tail;
+  CRITICAL_SECTION_END;
+#else
+  rx_buffer.tail = tail;
+#endif
+}
+
+rx_index_t MarlinSerial::readBlock(unsigned char *dst, rx_index_t size)
+{
+  rx_index_t count = 0;
+  // At most two blocks, before and after the end of the ring.
+  for (uint8_t i = 0; i < 2 && count < size; ++i) {
+    const unsigned char *data;
+    rx_index_t n = peekBlock(data);
+    if (n > size - count)
+      n = size - count;
+    memcpy(dst + count, data, n);
+    skip(n);
+    count += n;
+  }
+  return count;
+}
+
 void MarlinSerial::flush()
 {
-  // don't reverse this or there may be problems if the RX interrupt
-  // occurs after reading the value of rx_buffer_head but before writing
-  // the value to rx_buffer_tail; the previous value of rx_buffer_head
-  // may be written to rx_buffer_tail, making it appear as if the buffer
-  // were full, not empty.
-  rx_buffer.head = rx_buffer.tail;
+  // The main loop owns the tail: drop the received characters by moving the tail to the head.
+  skip(available());
 }
 
 
@@ -69,25 +69,65 @@
 
 
 #ifndef AT90USB
-// Define constants and variables for buffering incoming serial data.  We're
-// using a ring buffer (I think), in which rx_buffer_head is the index of the
-// location to which to write the next incoming character and rx_buffer_tail
-// is the index of the location from which to read.
+// Define constants and variables for buffering incoming serial data. The receive interrupt (and
+// checkRx() from the stepper interrupt) is the only writer of rx_buffer.head, the main loop the only
+// writer of rx_buffer.tail, so neither side has to disable the interrupts. The location before the
+// tail is kept free, head == tail means an empty ring.
+// The size is a power of two up to 512, the variant may select a larger ring than the default.
+#ifndef RX_BUFFER_SIZE
 #define RX_BUFFER_SIZE 128
+#endif
+#if (RX_BUFFER_SIZE & (RX_BUFFER_SIZE - 1)) || RX_BUFFER_SIZE > 512
+#error "RX_BUFFER_SIZE has to be a power of two up to 512"
+#endif
+#define RX_BUFFER_MASK (RX_BUFFER_SIZE - 1)
+
+#if RX_BUFFER_SIZE <= 256
+typedef uint8_t rx_index_t;
+#else
+// The 16bit indices are not read and written atomically by the AVR.
+typedef uint16_t rx_index_t;
+#define RX_INDEX_ATOMIC
+#endif
 
 extern uint8_t selectedSerialPort;
 
 struct ring_buffer
 {
   unsigned char buffer[RX_BUFFER_SIZE];
-  int head;
-  int tail;
+  volatile rx_index_t head;
+  volatile rx_index_t tail;
+  volatile bool overflow; // characters were dropped, as the ring was full
+#ifdef FEED_TELEMETRY
+  volatile rx_index_t max_used; // most characters stored in the ring at once
+#endif //FEED_TELEMETRY
 };
 
 #ifdef HAS_UART
   extern ring_buffer rx_buffer;
 #endif
 
+FORCE_INLINE void store_char(unsigned char c)
+{
+  // Called by the interrupts only, the main loop updates the tail atomically.
+  const rx_index_t i = (rx_buffer.head + 1) & RX_BUFFER_MASK;
+
+  // if we should be storing the received character into the location
+  // just before the tail (meaning that the head would advance to the
+  // current location of the tail), we're about to overflow the buffer
+  // and so we don't write the character or advance the head.
+  if (i != rx_buffer.tail) {
+    rx_buffer.buffer[rx_buffer.head] = c;
+    rx_buffer.head = i;
+#ifdef FEED_TELEMETRY
+    const rx_index_t used = (i - rx_buffer.tail) & RX_BUFFER_MASK;
+    if (used > rx_buffer.max_used)
+      rx_buffer.max_used = used;
+#endif //FEED_TELEMETRY
+  } else
+    rx_buffer.overflow = true;
+}
+
 class MarlinSerial //: public Stream
 {
 
@@ -98,10 +138,49 @@ class MarlinSerial //: public Stream
     static int read(void);
     static void flush(void);
 
-    static /*FORCE_INLINE*/ int available(void)
+    static FORCE_INLINE rx_index_t available(void)
+    {
+      return (rx_head() - rx_buffer.tail) & RX_BUFFER_MASK;
+    }
+
+    // Points data to the oldest received characters and returns how many of them are stored
+    // contiguously, 0 for an empty ring. They stay in the ring until released by skip().
+    static rx_index_t peekBlock(const unsigned char *&data);
+    // Releases the first n characters returned by peekBlock().
+    static void skip(rx_index_t n);
+    // Copies up to size received characters to dst and returns their count.
+    static rx_index_t readBlock(unsigned char *dst, rx_index_t size);
+
+    // Returns whether received characters were dropped since the last call, as the ring was full.
+    static bool overflowed(void)
+    {
+      const bool overflow = rx_buffer.overflow;
+      rx_buffer.overflow = false;
+      return overflow;
+    }
+
+#ifdef FEED_TELEMETRY
+    // The most characters stored in the ring at once since rxMaxReset().
+    static rx_index_t rxMax(void)
+    {
+#ifdef RX_INDEX_ATOMIC
+      rx_index_t max_used;
+      CRITICAL_SECTION_START;
+      max_used = rx_buffer.max_used;
+      CRITICAL_SECTION_END;
+      return max_used;
+#else
+      return rx_buffer.max_used;
+#endif
+    }
+    static void rxMaxReset(void)
     {
-      return (unsigned int)(RX_BUFFER_SIZE + rx_buffer.head - rx_buffer.tail) % RX_BUFFER_SIZE;
+      CRITICAL_SECTION_START;
+      rx_buffer.max_used = 0;
+      CRITICAL_SECTION_END;
     }
+#endif //FEED_TELEMETRY
+
     /*
     FORCE_INLINE void write(uint8_t c)
     {
@@ -136,15 +215,7 @@ class MarlinSerial //: public Stream
                     (void)(*(char *)M_UDRx);
                 } else {
                     unsigned char c  =  M_UDRx;
-                    int i = (unsigned int)(rx_buffer.head + 1) % RX_BUFFER_SIZE;
-                    // if we should be storing the received character into the location
-                    // just before the tail (meaning that the head would advance to the
-                    // current location of the tail), we're about to overflow the buffer
-                    // and so we don't write the character or advance the head.
-                    if (i != rx_buffer.tail) {
-                        rx_buffer.buffer[rx_buffer.head] = c;
-                        rx_buffer.head = i;
-                    }
+                    store_char(c);
                     //selectedSerialPort = 0;
 #ifdef DEBUG_DUMP_TO_2ND_SERIAL
 					UDR1 = c;
@@ -160,15 +231,7 @@ class MarlinSerial //: public Stream
                     (void)(*(char *)UDR1);
                 } else {
                     unsigned char c  =  UDR1;
-                    int i = (unsigned int)(rx_buffer.head + 1) % RX_BUFFER_SIZE;
-                    // if we should be storing the received character into the location
-                    // just before the tail (meaning that the head would advance to the
-                    // current location of the tail), we're about to overflow the buffer
-                    // and so we don't write the character or advance the head.
-                    if (i != rx_buffer.tail) {
-                        rx_buffer.buffer[rx_buffer.head] = c;
-                        rx_buffer.head = i;
-                    }
+                    store_char(c);
                     //selectedSerialPort = 1;
 #ifdef DEBUG_DUMP_TO_2ND_SERIAL
 					M_UDRx = c;
@@ -180,6 +243,20 @@ class MarlinSerial //: public Stream
 
 
     private:
+    // The head written by the receive interrupt.
+    static FORCE_INLINE rx_index_t rx_head(void)
+    {
+#ifdef RX_INDEX_ATOMIC
+      rx_index_t head;
+      CRITICAL_SECTION_START;
+      head = rx_buffer.head;
+      CRITICAL_SECTION_END;
+      return head;
+#else
+      return rx_buffer.head;
+#endif
+    }
+
     static void printNumber(unsigned long, uint8_t);
     static void printFloat(double, uint8_t);
 
@@ -120,6 +120,8 @@
 #include "sound.h"
 
 #include "cmdqueue.h"
+#include "binary_transport.h"
+#include "telemetry.h"
 
 //filament types
 #define FILAMENT_DEFAULT 0
@@ -315,7 +317,7 @@ class AutoReportFeatures {
             uint8_t temp : 1; //Temperature flag
             uint8_t fans : 1; //Fans flag
             uint8_t pos: 1;   //Position flag
-            uint8_t ar4 : 1;  //Unused
+            uint8_t telemetry : 1; //Feed telemetry flag
             uint8_t ar5 : 1;  //Unused
             uint8_t ar6 : 1;  //Unused
             uint8_t ar7 : 1;  //Unused
@@ -342,6 +344,9 @@ public:
     inline bool Pos()const { return arFunctionsActive.bits.pos != 0; }
     inline void SetPos(uint8_t v){ arFunctionsActive.bits.pos = v; }
 
+    inline bool Telemetry()const { return arFunctionsActive.bits.telemetry != 0; }
+    inline void SetTelemetry(uint8_t v){ arFunctionsActive.bits.telemetry = v; }
+
     inline void SetMask(uint8_t mask){ arFunctionsActive.byte = mask; }
 
     /// sets the autoreporting timer's period
@@ -370,6 +375,8 @@ static void print_time_remaining_init();
 static void wait_for_heater(long codenum, uint8_t extruder);
 static void gcode_G28(bool home_x_axis, bool home_y_axis, bool home_z_axis);
 static void gcode_M105();
+static uint8_t get_move_words(float values[NUM_AXIS + 1]);
+static void set_coordinates(uint8_t seen, const float values[NUM_AXIS + 1]);
 
 #ifndef PINDA_THERMISTOR
 static void temp_compensation_start();
@@ -1660,6 +1667,11 @@ void host_autoreport()
             gcode_M123();
         }
 #endif //AUTO_REPORT and (FANCHECK and TACH_0 or TACH_1)
+#ifdef FEED_TELEMETRY
+        if(autoReportFeatures.Telemetry()){
+            telemetry_report();
+        }
+#endif //FEED_TELEMETRY
         autoReportFeatures.TimerStart();
     }
 }
@@ -1741,73 +1753,7 @@ void loop()
   #endif
   if(buflen)
   {
-    cmdbuffer_front_already_processed = false;
-    #ifdef SDSUPPORT
-      if(card.saving)
-      {
-        // Saving a G-code file onto an SD-card is in progress.
-        // Saving starts with M28, saving until M29 is seen.
-        if(strstr_P(CMDBUFFER_CURRENT_STRING, PSTR("M29")) == NULL) {
-          card.write_command(CMDBUFFER_CURRENT_STRING);
-          if(card.logging)
-            process_commands();
-          else
-           SERIAL_PROTOCOLLNRPGM(MSG_OK);
-        } else {
-          card.closefile();
-          SERIAL_PROTOCOLLNRPGM(MSG_FILE_SAVED);
-        }
-      } else {
-        process_commands();
-      }
-    #else
-      process_commands();
-    #endif //SDSUPPORT
-
-    if (! cmdbuffer_front_already_processed && buflen)
-    {
-      // ptr points to the start of the block currently being processed.
-      // The first character in the block is the block type.
-      char *ptr = cmdbuffer + bufindr;
-      if (*ptr == CMDBUFFER_CURRENT_TYPE_SDCARD) {
-        // To support power panic, move the length of the command on the SD card to a planner buffer.
-        union {
-          struct {
-              char lo;
-              char hi;
-          } lohi;
-          uint16_t value;
-        } sdlen;
-        sdlen.value = 0;
-        {
-          // This block locks the interrupts globally for 3.25 us,
-          // which corresponds to a maximum repeat frequency of 307.69 kHz.
-          // This blocking is safe in the context of a 10kHz stepper driver interrupt
-          // or a 115200 Bd serial line receive interrupt, which will not trigger faster than 12kHz.
-          cli();
-          // Reset the command to something, which will be ignored by the power panic routine,
-          // so this buffer length will not be counted twice.
-          *ptr ++ = CMDBUFFER_CURRENT_TYPE_TO_BE_REMOVED;
-          // Extract the current buffer length.
-          sdlen.lohi.lo = *ptr ++;
-          sdlen.lohi.hi = *ptr;
-          // and pass it to the planner queue.
-          planner_add_sd_length(sdlen.value);
-          sei();
-        }
-	  }
-	  else if((*ptr == CMDBUFFER_CURRENT_TYPE_USB_WITH_LINENR) && !IS_SD_PRINTING){
-		  cli();
-          *ptr ++ = CMDBUFFER_CURRENT_TYPE_TO_BE_REMOVED;
-          // and one for each command to previous block in the planner queue.
-          planner_add_sd_length(1);
-          sei();
-	  }
-      // Now it is safe to release the already processed command block. If interrupted by the power panic now,
-      // this block's SD card length will not be counted twice as its command type has been replaced
-      // by CMDBUFFER_CURRENT_TYPE_TO_BE_REMOVED.
-      cmdqueue_pop_front();
-    }
+    cmdqueue_process_front();
 	host_keepalive();
   }
 }
@@ -1917,6 +1863,54 @@ inline void gcode_M900() {
 }
 #endif // LIN_ADVANCE
 
+#ifdef INPUT_SHAPING
+   /**
+    * M593: Set and/or Get the input shaper of the X and Y axes
+    *
+    *  X Y          Axes to set, both if none is given
+    *  F<Hz>        Frequency of the resonance, 0 switches the shaper off
+    *  D<ratio>     Damping ratio of the resonance
+    *  T<type>      0 ZV, 1 ZVD, 2 MZV
+    */
+inline void gcode_M593() {
+    bool set_axis[2] = { code_seen('X'), code_seen('Y') };
+    if (!set_axis[X_AXIS] && !set_axis[Y_AXIS])
+        set_axis[X_AXIS] = set_axis[Y_AXIS] = true;
+
+    if (code_seen('F') || code_seen('D') || code_seen('T'))
+    {
+        float freq[2], zeta[2];
+        uint8_t type[2];
+        // Check the settings of both axes before any of them is changed.
+        for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis)
+        {
+            freq[axis] = code_seen('F') ? code_value() : cs.shaping_freq[axis];
+            zeta[axis] = code_seen('D') ? code_value() : cs.shaping_zeta[axis];
+            type[axis] = code_seen('T') ? code_value_uint8() : cs.shaping_type[axis];
+            shaper_params_t params;
+            // The type and the damping ratio of a switched off shaper are checked at a nominal frequency.
+            if (set_axis[axis] && !shaper_params(type[axis], freq[axis] ? freq[axis] : 100, zeta[axis], params))
+            {
+                SERIAL_ECHOLNPGM("Input shaper settings out of range!");
+                return;
+            }
+        }
+        for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis)
+        {
+            if (!set_axis[axis])
+                continue;
+            cs.shaping_freq[axis] = freq[axis];
+            cs.shaping_zeta[axis] = zeta[axis];
+            cs.shaping_type[axis] = type[axis];
+        }
+        shaper_update();
+    }
+
+    for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis)
+        printf_P(PSTR("M593 %c F%.2f D%.3f T%d\n"), axis_codes[axis], cs.shaping_freq[axis], cs.shaping_zeta[axis], cs.shaping_type[axis]);
+}
+#endif //INPUT_SHAPING
+
 bool check_commands() {
 	bool end_command_found = false;
 
@@ -3546,6 +3540,36 @@ static void gcode_G92()
     }
 }
 
+// G0/G1 - Coordinated movement to the words X Y Z E F of the command, seen is their mask.
+// Returns false if the move was taken as a firmware retraction, which is not confirmed.
+static bool gcode_G0_G1(uint8_t seen, const float values[NUM_AXIS + 1])
+{
+    uint16_t start_segment_idx = restore_interrupted_gcode();
+    set_coordinates(seen, values);
+
+    if (total_filament_used > ((current_position[E_AXIS] - destination[E_AXIS]) * 100)) { //protection against total_filament_used overflow
+        total_filament_used = total_filament_used + ((destination[E_AXIS] - current_position[E_AXIS]) * 100);
+    }
+
+#ifdef FWRETRACT
+    if(cs.autoretract_enabled) {
+        if( !(seen & (X_AXIS_MASK | Y_AXIS_MASK | Z_AXIS_MASK)) && (seen & E_AXIS_MASK)) {
+            float echange=destination[E_AXIS]-current_position[E_AXIS];
+            if((echange<-MIN_RETRACT && !retracted[active_extruder]) || (echange>MIN_RETRACT && retracted[active_extruder])) { //move appears to be an attempt to retract or recover
+                st_synchronize();
+                current_position[E_AXIS] = destination[E_AXIS]; //hide the slicer-generated retract/recover from calculations
+                plan_set_e_position(current_position[E_AXIS]); //AND from the planner
+                retract(!retracted[active_extruder]);
+                return false;
+            }
+        }
+    }
+#endif //FWRETRACT
+
+    prepare_move(start_segment_idx);
+    return true;
+}
+
 /// @brief Helper function to reduce code size in M861
 /// by extracting common code into one function
 static void gcode_M861_print_pinda_cal_eeprom() {
@@ -3588,6 +3612,8 @@ static void extended_capabilities_report()
     // EXTENDED_M20 (support for L and T parameters)
     cap_line(PSTR("EXTENDED_M20"), 1);
     cap_line(PSTR("PRUSA_MMU2"), 1); //this will soon change to ENABLED(PRUSA_MMU2_SUPPORT)
+    // BINARY_TRANSPORT (M930)
+    cap_line(PSTR("BINARY_TRANSPORT"), ENABLED(ENABLE_BINARY_TRANSPORT));
 }
 #endif //EXTENDED_CAPABILITIES_REPORT
 
@@ -3731,6 +3757,7 @@ extern uint8_t st_backlash_y;
 //!@n M509 - Force language selection
 //!@n M540 - Abort print on endstop hit (enable/disable)
 //!@n M552 - Set IP address
+//!@n M593 - Set input shaping options
 //!@n M600 - Initiate Filament change procedure
 //!@n M601 - Pause print
 //!@n M602 - Resume print
@@ -3760,6 +3787,7 @@ extern uint8_t st_backlash_y;
 //!@n M917 - Set TMC2130 PWM amplitude offset (pwm_ampl)
 //!@n M918 - Set TMC2130 PWM amplitude gradient (pwm_grad)
 //!@n M928 - Start SD logging (M928 filename.g) - ended by M29
+//!@n M930 - Binary transport of the serial line
 //! <br><br>
 
 /** @defgroup marlin_main Marlin main */
@@ -3779,7 +3807,7 @@ void process_commands()
 
 #ifdef CMDBUFFER_DEBUG
   SERIAL_ECHOPGM("Processing a GCODE command: ");
-  SERIAL_ECHO(cmdbuffer+bufindr+CMDHDRSIZE);
+  SERIAL_ECHO(CMDBUFFER_CURRENT_STRING);
   SERIAL_ECHOLNPGM("");
   SERIAL_ECHOPGM("In cmdqueue: ");
   SERIAL_ECHO(buflen);
@@ -3788,8 +3816,25 @@ void process_commands()
 
   unsigned long codenum; //throw away variable
 
-  // PRUSA GCODES
   KEEPALIVE_STATE(IN_HANDLER);
+
+  // Plain G0/G1 moves are most of a print. They are parsed in a single scan and skip the
+  // dispatch below.
+  {
+    float values[NUM_AXIS + 1];
+    const uint8_t seen = code_move_words(values);
+    if (seen != MOVE_WORDS_INVALID) {
+      if (gcode_G0_G1(seen, values)) {
+        KEEPALIVE_STATE(NOT_BUSY);
+        ClearToSend();
+      }
+      return;
+    }
+  }
+
+  code_words_parse();
+
+  // PRUSA GCODES
     /*!
     ### Special internal commands
     These are used by internal functions to process certain actions in the right order. Some of these are also usable by the user.
@@ -4048,30 +4093,9 @@ void process_commands()
     case 0: // G0 -> G1
     case 1: // G1
         {
-        uint16_t start_segment_idx = restore_interrupted_gcode();
-        get_coordinates(); // For X Y Z E F
-
-		if (total_filament_used > ((current_position[E_AXIS] - destination[E_AXIS]) * 100)) { //protection against total_filament_used overflow
-			total_filament_used = total_filament_used + ((destination[E_AXIS] - current_position[E_AXIS]) * 100);
-		}
-
-#ifdef FWRETRACT
-        if(cs.autoretract_enabled) {
-            if( !(code_seen('X') || code_seen('Y') || code_seen('Z')) && code_seen('E')) {
-                float echange=destination[E_AXIS]-current_position[E_AXIS];
-                if((echange<-MIN_RETRACT && !retracted[active_extruder]) || (echange>MIN_RETRACT && retracted[active_extruder])) { //move appears to be an attempt to retract or recover
-                    st_synchronize();
-                    current_position[E_AXIS] = destination[E_AXIS]; //hide the slicer-generated retract/recover from calculations
-                    plan_set_e_position(current_position[E_AXIS]); //AND from the planner
-                    retract(!retracted[active_extruder]);
-                    return;
-                }
-            }
-        }
-#endif //FWRETRACT
-
-        prepare_move(start_segment_idx);
-        //ClearToSend();
+        float values[NUM_AXIS + 1];
+        if (!gcode_G0_G1(get_move_words(values), values))
+            return;
       }
       break;
 
@@ -4680,7 +4704,7 @@ void process_commands()
         break;
 #endif //PRUSA_FARM
 	default:
-		printf_P(MSG_UNKNOWN_CODE, 'G', cmdbuffer + bufindr + CMDHDRSIZE);
+		printf_P(MSG_UNKNOWN_CODE, 'G', CMDBUFFER_CURRENT_STRING);
     }
 //	printf_P(_N("END G-CODE=%u\n"), gcode_in_progress);
 	gcode_in_progress = 0;
@@ -4703,7 +4727,7 @@ void process_commands()
 
 	 /*for (++strchr_pointer; *strchr_pointer == ' ' || *strchr_pointer == '\t'; ++strchr_pointer);*/
 	  if (*(strchr_pointer+index) < '0' || *(strchr_pointer+index) > '9') {
-		  printf_P(PSTR("Invalid M code: %s\n"), cmdbuffer + bufindr + CMDHDRSIZE);
+		  printf_P(PSTR("Invalid M code: %s\n"), CMDBUFFER_CURRENT_STRING);
 
 	  } else
 	  {
@@ -5375,7 +5399,7 @@ void process_commands()
           bit 0 = Auto-report temperatures
           bit 1 = Auto-report fans
           bit 2 = Auto-report position
-          bit 3 = free
+          bit 3 = Auto-report the feed telemetry (D31), only in the builds with FEED_TELEMETRY
           bit 4 = free
           bit 5 = free
           bit 6 = free
@@ -6171,7 +6195,7 @@ void process_commands()
     Set some advanced settings related to movement.
     #### Usage
 
-        M205 [ S | T | B | X | Y | Z | E ]
+        M205 [ S | T | B | X | Y | Z | E | J ]
 
     #### Parameters
     - `S` - Minimum feedrate for print moves (unit/s)
@@ -6181,6 +6205,7 @@ void process_commands()
     - `Y` - Maximum Y jerk (units/s)
     - `Z` - Maximum Z jerk (units/s)
     - `E` - Maximum E jerk (units/s)
+    - `J` - Junction deviation (units), selects the junction deviation cornering instead of the X, Y and Z jerk. `J0` selects the jerk again.
     */
     case 205:
     {
@@ -6198,6 +6223,7 @@ void process_commands()
 #endif
           cs.max_jerk[E_AXIS] = e;
       }
+      if(code_seen('J')) cs.junction_deviation = code_value();
     }
     break;
 
@@ -6323,7 +6349,7 @@ void process_commands()
 
     #### Usage
 
-        M214 [P] [S] [N] [R] [F]
+        M214 [P] [S] [N] [R] [F] [T]
 
     #### Parameters
     - `P` - A float representing the max and default millimeters per arc segment.  Must be greater than 0.
@@ -6334,6 +6360,8 @@ void process_commands()
             and maximum segment length.  Set to 0 to disable.
     - `F` - An int representing the number of segments per second, unless this results in segment lengths
             greater than or less than the minimum and maximum segment length.  Set to 0 to disable.
+    - `T` - A float representing the chord tolerance in millimeters. The segments are as long as they deviate from the arc
+            by up to the tolerance, their length follows the radius. Replaces `P` and `R`, `S` and `F` still apply.  Set to 0 to disable.
     */
     case 214:
     {
@@ -6343,9 +6371,10 @@ void process_commands()
         unsigned char n = code_seen('N') ? code_value() : cs.n_arc_correction;
         unsigned short r = code_seen('R') ? code_value() : cs.min_arc_segments;
         unsigned short f = code_seen('F') ? code_value() : cs.arc_segments_per_sec;
+        float t = code_seen('T') ? code_value() : cs.arc_tolerance;
 
         // Ensure mm_per_arc_segment is greater than 0, and that min_mm_per_arc_segment is sero or greater than or equal to mm_per_arc_segment
-        if (p <=0 || s < 0 || p < s)
+        if (p <=0 || s < 0 || p < s || t < 0)
         {
             // Should we display some error here?
             break;
@@ -6356,6 +6385,7 @@ void process_commands()
         cs.n_arc_correction = n;
         cs.min_arc_segments = r;
         cs.arc_segments_per_sec = f;
+        cs.arc_tolerance = t;
     }break;
 
     /*!
@@ -6946,6 +6976,27 @@ void process_commands()
         }
     } break;
 
+#ifdef INPUT_SHAPING
+    /*!
+    ### M593 - Set input shaping options <a href="https://reprap.org/wiki/G-code#M593:_Input_Shaping">M593: Input Shaping</a>
+    Sets the input shaper of the X and Y axes, which cancels the ringing of the axis at the given resonance frequency.
+    Without F, D and T the current settings are reported. Use M500 to store them in the EEPROM.
+    #### Usage
+
+        M593 [ X | Y ] [ F | D | T ]
+
+    #### Parameters
+    - `X` - Set the X axis
+    - `Y` - Set the Y axis, both axes are set if none is given
+    - `F` - Resonance frequency (Hz), 0 switches the shaper off. The delays of the shaper have to fit into the step history, which limits the lowest frequency to about 16 Hz (ZV) or 31 Hz (ZVD).
+    - `D` - Damping ratio of the resonance (0 to less than 1)
+    - `T` - Shaper type: 0 ZV, 1 ZVD, 2 MZV
+    */
+    case 593:
+        gcode_M593();
+    break;
+#endif //INPUT_SHAPING
+
     #ifdef FILAMENTCHANGEENABLE
 
     /*!
@@ -7757,6 +7808,26 @@ void process_commands()
 #endif //TMC2130_SERVICE_CODES_M910_M918
 #endif // TMC2130
 
+#ifdef ENABLE_BINARY_TRANSPORT
+    /*!
+    ### M930 - Binary transport
+    Switches the serial line between the G-code text and the binary frames described in binary_transport.h.
+    The command is handled as soon as it is received, the bytes which follow are read in the new mode: the host sends
+    the first frame after the `ok` of `M930 S1`, then `M930 S0` in a frame to return to the text. Moves are sent in
+    move frames, the other commands as text in G-code frames. Not to be used while uploading a file (M28).
+    #### Usage
+
+        M930 [ S ]
+
+    #### Parameters
+    - `S` - `1` binary frames, `0` G-code text. Without `S` the current mode is reported.
+    */
+    case 930:
+        if (!code_seen('S'))
+            printf_P(PSTR("Binary transport:%d\n"), bt_enabled);
+        break;
+#endif //ENABLE_BINARY_TRANSPORT
+
     /*!
     ### M350 - Set microstepping mode <a href="https://reprap.org/wiki/G-code#M350:_Set_microstepping_mode">M350: Set microstepping mode</a>
     Printers with TMC2130 drivers have `X`, `Y`, `Z` and `E` as options. The steps-per-unit value is updated accordingly. Not all resolutions are valid!
@@ -8106,7 +8177,7 @@ void process_commands()
     #### End of M-Commands
     */
 	default:
-		printf_P(MSG_UNKNOWN_CODE, 'M', cmdbuffer + bufindr + CMDHDRSIZE);
+		printf_P(MSG_UNKNOWN_CODE, 'M', CMDBUFFER_CURRENT_STRING);
     }
 //  printf_P(_N("END M-CODE=%u\n"), mcode_in_progress);
 	mcode_in_progress = 0;
@@ -8388,6 +8459,43 @@ void process_commands()
     };
 #endif
 
+#ifdef STEP_LOOPS_ADAPTIVE
+    /*!
+    ### D30 - Stepper interrupt multi-stepping statistics
+    Prints the steps per interrupt chosen last, the step rate above which the interrupt multi-steps,
+    the longest interrupt and the number of missed compare matches since the last reset.
+    #### Usage
+
+        D30 [ R ]
+
+    #### Parameters
+    - `R` - Reset the statistics after printing them
+    */
+    case 30:
+        dcode_30();
+        break;
+#endif //STEP_LOOPS_ADAPTIVE
+
+#ifdef PLANNER_STARVATION_COUNT
+    /*!
+    ### D31 - Planner starvation count, feed telemetry
+    Prints the number of moves, which found the planner queue already drained by the stepper although
+    no command waited for the moves to finish. The builds with FEED_TELEMETRY print how well the host or
+    the SD card keep the planner fed: the moves and the time with the planner queue drained during a print,
+    the serial receive high water mark and overflows, the stepper interrupt overruns and the time
+    histograms of the planner and command queue occupancy.
+    #### Usage
+
+        D31 [ R ]
+
+    #### Parameters
+    - `R` - Reset the count or the telemetry after printing it
+    */
+    case 31:
+        dcode_31();
+        break;
+#endif //PLANNER_STARVATION_COUNT
+
 #ifdef THERMAL_MODEL_DEBUG
     /*!
     ## D70 - Enable low-level thermal model logging for offline simulation
@@ -8535,7 +8643,7 @@ void process_commands()
 #endif //DEBUG_DCODES
 
     default:
-        printf_P(MSG_UNKNOWN_CODE, 'D', cmdbuffer + bufindr + CMDHDRSIZE);
+        printf_P(MSG_UNKNOWN_CODE, 'D', CMDBUFFER_CURRENT_STRING);
 	}
   }
 
@@ -8614,12 +8722,33 @@ void update_currents() {
 }
 #endif //MOTHERBOARD == BOARD_RAMBO_MINI_1_0 || MOTHERBOARD == BOARD_RAMBO_MINI_1_3
 
+// Words X Y Z E F of the current command, see code_move_words().
+static uint8_t get_move_words(float values[NUM_AXIS + 1]) {
+  uint8_t seen = 0;
+  for (uint8_t i = X_AXIS; i < NUM_AXIS; i++) {
+    if(code_seen(axis_codes[i])) {
+      seen |= _BV(i);
+      values[i] = code_value();
+    }
+  }
+  if(code_seen('F')) {
+    seen |= _BV(MOVE_WORD_F);
+    values[MOVE_WORD_F] = code_value();
+  }
+  return seen;
+}
+
 void get_coordinates() {
+  float values[NUM_AXIS + 1];
+  set_coordinates(get_move_words(values), values);
+}
+
+static void set_coordinates(uint8_t seen, const float values[NUM_AXIS + 1]) {
   for (uint8_t i = X_AXIS, mask = X_AXIS_MASK; i < NUM_AXIS; i++, mask <<= 1) {
-    if(code_seen(axis_codes[i]))
+    if(seen & mask)
     {
       bool relative = axis_relative_modes & mask;
-      destination[i] = code_value();
+      destination[i] = values[i];
       if (i == E_AXIS) {
         float emult = extruder_multiplier[active_extruder];
         if (emult != 1.) {
@@ -8638,8 +8767,8 @@ void get_coordinates() {
     }
     else destination[i] = current_position[i]; //Are these else lines really needed?
   }
-  if(code_seen('F')) {
-    const float next_feedrate = code_value();
+  if(seen & _BV(MOVE_WORD_F)) {
+    const float next_feedrate = values[MOVE_WORD_F];
     if(next_feedrate > 0.f) feedrate = next_feedrate;
   }
 }
@@ -8918,6 +9047,9 @@ void manage_inactivity(bool ignore_stepper_queue/*=false*/) //default argument s
       }
   }
 
+#ifdef FEED_TELEMETRY
+  telemetry_update(printJobOngoing());
+#endif //FEED_TELEMETRY
 #if defined(AUTO_REPORT)
   host_autoreport();
 #endif //AUTO_REPORT
@@ -9927,9 +10059,10 @@ void restore_print_file_state() {
 void save_planner_global_state() {
     if (current_block && !(mesh_bed_leveling_flag || homing_flag))
     {
-        memcpy(saved_start_position, current_block->gcode_start_position, sizeof(saved_start_position));
-        saved_feedrate2 = current_block->gcode_feedrate;
-        saved_segment_idx = current_block->segment_idx;
+        const block_recovery_t *recovery = plan_get_recovery(current_block);
+        memcpy(saved_start_position, recovery->gcode_start_position, sizeof(saved_start_position));
+        saved_feedrate2 = recovery->gcode_feedrate;
+        saved_segment_idx = recovery->segment_idx;
     }
     else
     {
@@ -191,21 +191,15 @@ void serial_read_stream() {
     // lock in the routine
     uint32_t receivedBytes = 0;
     while (prusa_sd_card_upload) {
-        int i;
-        for (i=0; i<CHUNK_SIZE; i++) {
-            int data;
-
-            // check if we're not done
-            if (receivedBytes == bytesToReceive) {
-                break;
-            }
-
-            // read the next byte
-            while ((data = MYSERIAL.read()) == -1) {};
-            receivedBytes++;
-
-            // save it to the chunk
-            chunk[i] = data;
+        // fill the chunk with the received bytes, until we're done
+        uint8_t i = 0;
+        while (i < CHUNK_SIZE && receivedBytes < bytesToReceive) {
+            rx_index_t n = CHUNK_SIZE - i;
+            if (n > bytesToReceive - receivedBytes)
+                n = bytesToReceive - receivedBytes;
+            n = MYSERIAL.readBlock((unsigned char*)chunk + i, n);
+            i += n;
+            receivedBytes += n;
         }
 
         // write the chunk to SD
@@ -152,6 +152,9 @@ static void spiSend(uint8_t data) {
 //------------------------------------------------------------------------------
 // send command and return error code.  Return zero for OK
 uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
+  // end the multiple block read left open by readBlockStream()
+  if (streamBlock_ && cmd != CMD12) readStop();
+
   // select card
   chipSelectLow();
 
@@ -285,6 +288,8 @@ bool Sd2Card::eraseSingleBlockEnable() {
  */
 bool Sd2Card::init(uint8_t sckRateID) {
   errorCode_ = type_ = 0;
+  // CMD0 resets a multiple block read of a card which stayed in the slot
+  streamBlock_ = 0;
   // 16-bit init start time allows over a minute
   uint16_t t0 = (uint16_t)_millis();
   uint32_t arg;
@@ -428,6 +433,32 @@ bool Sd2Card::readBlock(uint32_t blockNumber, uint8_t* dst) {
   return false;
 }
 //------------------------------------------------------------------------------
+/**
+ * Read a 512 byte block, leaving the card in a multiple block read sequence.
+ *
+ * A following call for the next block continues the sequence without a
+ * command, which saves the command and the access time of readBlock() when a
+ * file is read sequentially. Any other command ends the sequence first.
+ *
+ * \param[in] blockNumber Logical block to be read.
+ * \param[out] dst Pointer to the location that will receive the data.
+ * \return The value one, true, is returned for success and
+ * the value zero, false, is returned for failure.
+ */
+bool Sd2Card::readBlockStream(uint32_t blockNumber, uint8_t* dst) {
+  if (!streamBlock_ || blockNumber != streamBlock_) {
+    if (!readStart(blockNumber)) goto fail;
+    streamBlock_ = blockNumber;
+  }
+  if (!readData(dst)) goto fail;
+  streamBlock_ = blockNumber + 1;
+  return true;
+
+ fail:
+  // retry with a single block read, it ends the sequence
+  return readBlock(blockNumber, dst);
+}
+//------------------------------------------------------------------------------
 /** Read one data block in a multiple block read sequence
  *
  * \param[in] dst Pointer to the location for the data to be read.
@@ -575,6 +606,7 @@ bool Sd2Card::readStart(uint32_t blockNumber) {
  * the value zero, false, is returned for failure.
  */
 bool Sd2Card::readStop() {
+  streamBlock_ = 0;
   chipSelectLow();
   if (cardCommand(CMD12, 0)) {
     error(SD_CARD_ERROR_CMD12);
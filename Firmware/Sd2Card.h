@@ -148,7 +148,7 @@ uint8_t const SPI_SCK_PIN = SOFT_SPI_SCK_PIN;
 class Sd2Card {
  public:
   /** Construct an instance of Sd2Card. */
-  Sd2Card() : errorCode_(SD_CARD_ERROR_INIT_NOT_CALLED), type_(0), flash_air_compatible_(false) {}
+  Sd2Card() : errorCode_(SD_CARD_ERROR_INIT_NOT_CALLED), type_(0), flash_air_compatible_(false), streamBlock_(0) {}
   uint32_t cardSize();
   bool erase(uint32_t firstBlock, uint32_t lastBlock);
   bool eraseSingleBlockEnable();
@@ -171,6 +171,7 @@ class Sd2Card {
    */
   bool init(uint8_t sckRateID = SPI_FULL_SPEED);
   bool readBlock(uint32_t block, uint8_t* dst);
+  bool readBlockStream(uint32_t block, uint8_t* dst);
   /**
    * Read a card's CID register. The CID contains card identification
    * information such as Manufacturer ID, Product name, Product serial
@@ -197,6 +198,11 @@ class Sd2Card {
   bool readData(uint8_t *dst);
   bool readStart(uint32_t blockNumber);
   bool readStop();
+  /** End the multiple block read left open by readBlockStream(), if any. */
+  bool readStreamEnd() { return !streamBlock_ || readStop(); }
+  /** Forget the multiple block read without CMD12 and deselect the card. For the power panic
+   * interrupt, which may have interrupted a transfer and does not return to it. */
+  void readStreamAbandon() { streamBlock_ = 0; chipSelectHigh(); }
   bool setSckRate(uint8_t sckRateID);
   /** Return the card type: SD V1, SD V2 or SDHC
    * \return 0 - SD V1, 1 - SD V2, or 3 - SDHC.
@@ -220,6 +226,12 @@ class Sd2Card {
   uint8_t status_;
   uint8_t type_;
   bool    flash_air_compatible_;
+  // next block of the multiple block read left open by readBlockStream(),
+  // zero without one (block 0 holds the MBR or the boot sector, never file data).
+  // The SPI bus is shared with the TMC2130 drivers and the xflash, spi_setup()
+  // ends the sequence with readStreamEnd() before it selects one of them. The
+  // power panic drops it with readStreamAbandon() first.
+  uint32_t streamBlock_;
   // private functions
   uint8_t cardAcmd(uint8_t cmd, uint32_t arg) {
     cardCommand(CMD55, 0);
@@ -1070,6 +1070,9 @@ int16_t SdBaseFile::read(void* buf, uint16_t nbyte) {
         if (curPosition_ == 0) {
           // use first cluster in file
           curCluster_ = firstCluster_;
+        } else if (flags_ & F_FILE_CONTIGUOUS) {
+          // the next cluster follows, no need to read the FAT
+          curCluster_++;
         } else {
           // get next cluster from FAT
           if (!vol_->fatGet(curCluster_, &curCluster_)) goto fail;
@@ -1476,6 +1479,11 @@ bool SdBaseFile::seekSet(uint32_t pos) {
   nCur = (curPosition_ - 1) >> (vol_->clusterSizeShift_ + 9);
   nNew = (pos - 1) >> (vol_->clusterSizeShift_ + 9);
 
+  if (flags_ & F_FILE_CONTIGUOUS) {
+    curCluster_ = firstCluster_ + nNew;
+    curPosition_ = pos;
+    goto done;
+  }
   if (nNew < nCur || curPosition_ == 0) {
     // must follow chain from first cluster
     curCluster_ = firstCluster_;
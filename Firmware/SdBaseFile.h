@@ -333,6 +333,8 @@ public:
   // bits defined in flags_
   // should be 0X0F
   static uint8_t const F_OFLAG = (O_ACCMODE | O_APPEND | O_SYNC);
+  // clusters of the file follow each other, set by SdFile::openFilteredGcode()
+  static uint8_t const F_FILE_CONTIGUOUS = 0X40;
   // sync of directory entry required
   static uint8_t const F_FILE_DIR_DIRTY = 0X80;
 
@@ -103,6 +103,27 @@ uint8_t const SOFT_SPI_MISO_PIN = 12;
 /** Software SPI Clock pin */
 uint8_t const SOFT_SPI_SCK_PIN = 13;
 //------------------------------------------------------------------------------
+/**
+ * Number of the runs of clusters of a fragmented G-code file remembered while
+ * it is read, to seek in it without following the FAT from the start of the
+ * file. If a file has more runs, every other one is forgotten whenever the
+ * table fills. Each run costs 10 bytes of SRAM. Zero disables the table,
+ * otherwise at least 3 runs.
+ */
+#define SD_GCODE_EXTENTS 16
+//------------------------------------------------------------------------------
+/**
+ * Set SD_FAT_CACHE nonzero to keep the last FAT block read in a cache of its
+ * own, so that the FAT lookups at the cluster boundaries of a file don't evict
+ * the data block from the block cache and the data block isn't read again.
+ *
+ * The FAT cache costs 524 bytes of SRAM. Contiguous G-code files are printed
+ * without reading the FAT, only fragmented ones and directories gain from it.
+ */
+#ifndef SD_FAT_CACHE
+#define SD_FAT_CACHE 0
+#endif
+//------------------------------------------------------------------------------
 /**
  * The __cxa_pure_virtual function is an error handler that is invoked when
  * a pure virtual function is called.
@@ -31,8 +31,23 @@
 SdFile::SdFile(const char* path, uint8_t oflag) : SdBaseFile(path, oflag) {
 }
 
+#if SD_GCODE_EXTENTS
+SdFile::gfExtent_t SdFile::gfExtents[SD_GCODE_EXTENTS];
+uint8_t SdFile::gfExtentCount;
+#endif
+
 bool SdFile::openFilteredGcode(SdBaseFile* dirFile, const char* path){
     if( open(dirFile, path, O_READ) ){
+        // Most files are written in one piece. Check the FAT once, then the blocks
+        // of the whole file and any seek are computed without reading the FAT.
+        uint32_t bgnBlock, endBlock;
+        if( contiguousRange(&bgnBlock, &endBlock) ){
+            flags_ |= F_FILE_CONTIGUOUS;
+        }
+#if SD_GCODE_EXTENTS
+        // the runs of a fragmented one are remembered as its clusters are read
+        gfExtentCount = 0;
+#endif
         // compute the block to start with
         if( ! gfComputeNextFileBlock() )
             return false;
@@ -44,6 +59,11 @@ bool SdFile::openFilteredGcode(SdBaseFile* dirFile, const char* path){
 }
 
 bool SdFile::seekSetFilteredGcode(uint32_t pos){
+#if SD_GCODE_EXTENTS
+    if( gfExtentCount && isOpen() && pos && pos <= fileSize_ ){
+        if(! gfSeekCluster(pos) )return false;
+    } else
+#endif
     if(! seekSet(pos) )return false;
     if(! gfComputeNextFileBlock() )return false;
     gfReset();
@@ -65,6 +85,14 @@ void __attribute__((noinline)) SdFile::gfUpdateCurrentPosition(uint16_t inc){
     curPosition_ += inc;
 }
 
+#ifdef _NO_ASM
+#define find_endl(resultP, startP) \
+do { \
+    const uint8_t *p = (startP); \
+    while (*p++ != '\n'); \
+    (resultP) = p; \
+} while (0)
+#else //_NO_ASM
 #define find_endl(resultP, startP) \
 __asm__ __volatile__ (  \
 "cycle:          \n" \
@@ -75,6 +103,7 @@ __asm__ __volatile__ (  \
 : "z" (startP)   /* input of the ASM code - in our case the Z register as well (R30:R31) */ \
 : "r22"          /* modifying register R22 - so that the compiler knows */ \
 )
+#endif //_NO_ASM
 
 // avoid calling the default heavy-weight read() for just one byte
 int16_t SdFile::readFilteredGcode(){
@@ -178,10 +207,11 @@ eof_or_fail:
 }
 
 bool SdFile::gfEnsureBlock(){
-    // this comparison is heavy-weight, especially when there is another one inside cacheRawBlock
+    // this comparison is heavy-weight, especially when there is another one inside cacheStreamBlock
     // but it is necessary to avoid computing of terminateOfs if not needed
     if( gfBlock != vol_->cacheBlockNumber_ ){
-        if ( ! vol_->cacheRawBlock(gfBlock, SdVolume::CACHE_FOR_READ)){
+        // the G-code is read sequentially, keep the card in a multiple block read
+        if ( ! vol_->cacheStreamBlock(gfBlock)){
             return false;
         }
         // terminate with a '\n'
@@ -205,12 +235,20 @@ bool SdFile::gfComputeNextFileBlock() {
         uint8_t blockOfCluster = vol_->blockOfCluster(curPosition_);
         if (gfOffset == 0 && blockOfCluster == 0) {
             // start of new cluster
-            if (curPosition_ == 0) {
-                // use first cluster in file
-                curCluster_ = firstCluster_;
+            if (flags_ & F_FILE_CONTIGUOUS) {
+                // the next cluster follows, the card keeps streaming the blocks
+                curCluster_ = curPosition_ ? curCluster_ + 1 : firstCluster_;
             } else {
-                // get next cluster from FAT
-                if (!vol_->fatGet(curCluster_, &curCluster_)) return false;
+                if (curPosition_ == 0) {
+                    // use first cluster in file
+                    curCluster_ = firstCluster_;
+                } else {
+                    // get next cluster from FAT
+                    if (!vol_->fatGet(curCluster_, &curCluster_)) return false;
+                }
+#if SD_GCODE_EXTENTS
+                gfRecordCluster(curPosition_ >> (vol_->clusterSizeShift_ + 9));
+#endif
             }
         }
         gfBlock = vol_->clusterStartBlock(curCluster_) + blockOfCluster;
@@ -218,6 +256,69 @@ bool SdFile::gfComputeNextFileBlock() {
     return true;
 }
 
+#if SD_GCODE_EXTENTS
+// A full table keeps every other run and the last one, then takes the new run: at least three.
+static_assert(SD_GCODE_EXTENTS == 0 || SD_GCODE_EXTENTS >= 3, "the first and the last run of clusters are kept");
+
+// Adds curCluster_, the cluster fileCluster of the file, to the runs of clusters. Only the
+// cluster right after the last run is added, the others are known already or past the end.
+void SdFile::gfRecordCluster(uint32_t fileCluster){
+    gfExtent_t *e = gfExtents + gfExtentCount;
+    if( gfExtentCount ){
+        --e;
+        if( fileCluster != e->fileCluster + e->clusters )
+            return;
+        if( curCluster_ == e->cluster + e->clusters && e->clusters != 0xFFFF ){
+            ++e->clusters;
+            return;
+        }
+        if( gfExtentCount == SD_GCODE_EXTENTS ){
+            // The table is full, keep every other run, the first and the last one. A seek
+            // between the runs kept follows the FAT from the end of the run before it.
+            uint8_t n = 0;
+            for( uint8_t i = 0; i < SD_GCODE_EXTENTS - 1; i += 2 )
+                gfExtents[n++] = gfExtents[i];
+            gfExtents[n++] = *e;
+            gfExtentCount = n;
+            e = gfExtents + n - 1;
+        }
+        ++e;
+    } else if( fileCluster ){
+        return;
+    }
+    e->fileCluster = fileCluster;
+    e->cluster = curCluster_;
+    e->clusters = 1;
+    ++gfExtentCount;
+}
+
+// Sets the position like seekSet(), finding the cluster of pos in the runs of clusters by
+// a binary search. Past the run found the FAT is followed, new runs at the end are remembered.
+bool SdFile::gfSeekCluster(uint32_t pos){
+    // the cluster of the last byte before pos, like seekSet() does
+    const uint32_t target = (pos - 1) >> (vol_->clusterSizeShift_ + 9);
+    uint8_t lo = 0, hi = gfExtentCount;
+    while( hi - lo > 1 ){
+        const uint8_t mid = (lo + hi) / 2;
+        if( gfExtents[mid].fileCluster <= target )
+            lo = mid;
+        else
+            hi = mid;
+    }
+    const gfExtent_t &e = gfExtents[lo];
+    uint32_t index = target - e.fileCluster;
+    if( index >= e.clusters )
+        index = e.clusters - 1;
+    curCluster_ = e.cluster + index;
+    for( index += e.fileCluster; index < target; ){
+        if (!vol_->fatGet(curCluster_, &curCluster_)) return false;
+        gfRecordCluster(++index);
+    }
+    curPosition_ = pos;
+    return true;
+}
+#endif
+
 //------------------------------------------------------------------------------
 /** Write data to an open file.
  *
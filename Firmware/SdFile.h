@@ -51,6 +51,21 @@ class SdFile : public SdBaseFile/*, public Print*/ {
   bool gfEnsureBlock();
   bool gfComputeNextFileBlock();
   void gfUpdateCurrentPosition(uint16_t inc);
+
+#if SD_GCODE_EXTENTS
+  // run of consecutive clusters of a fragmented file
+  struct gfExtent_t {
+    uint32_t fileCluster; // index of the first cluster of the run in the file
+    uint32_t cluster;     // the cluster on the volume
+    uint16_t clusters;    // length of the run
+  };
+  // runs of the file opened last by openFilteredGcode(), sorted, the first one at its start
+  static gfExtent_t gfExtents[SD_GCODE_EXTENTS];
+  static uint8_t gfExtentCount;
+
+  void gfRecordCluster(uint32_t fileCluster);
+  bool gfSeekCluster(uint32_t pos);
+#endif
 public:
   SdFile() {}
   SdFile(const char* name, uint8_t oflag);
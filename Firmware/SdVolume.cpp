@@ -29,6 +29,13 @@ cache_t  SdVolume::cacheBuffer_;       // 512 byte cache for Sd2Card
 Sd2Card* SdVolume::sdCard_;            // pointer to SD card object
 bool     SdVolume::cacheDirty_;        // cacheFlush() will write block if true
 uint32_t SdVolume::cacheMirrorBlock_;  // mirror  block for second FAT
+#if SD_FAT_CACHE
+// FAT block cache
+cache_t  SdVolume::fatCacheBuffer_;       // 512 byte cache for FAT blocks
+uint32_t SdVolume::fatCacheBlockNumber_;  // current FAT block number
+uint32_t SdVolume::fatCacheHits_;         // fatGet() served by the FAT cache
+uint32_t SdVolume::fatCacheMisses_;       // FAT blocks read into the FAT cache
+#endif  // SD_FAT_CACHE
 #endif  // USE_MULTIPLE_CARDS
 //------------------------------------------------------------------------------
 // find a contiguous group of clusters
@@ -137,6 +144,20 @@ bool SdVolume::cacheRawBlock(uint32_t blockNumber, bool dirty) {
   return false;
 }
 //------------------------------------------------------------------------------
+// read a block of a file being read sequentially, the card keeps sending
+// the following blocks (see Sd2Card::readBlockStream())
+bool SdVolume::cacheStreamBlock(uint32_t blockNumber) {
+  if (cacheBlockNumber_ != blockNumber) {
+    if (!cacheFlush()) goto fail;
+    if (!sdCard_->readBlockStream(blockNumber, cacheBuffer_.data)) goto fail;
+    cacheBlockNumber_ = blockNumber;
+  }
+  return true;
+
+ fail:
+  return false;
+}
+//------------------------------------------------------------------------------
 // return the size in bytes of a cluster chain
 bool SdVolume::chainSize(uint32_t cluster, uint32_t* size) {
   uint32_t s = 0;
@@ -178,6 +199,25 @@ bool SdVolume::fatGet(uint32_t cluster, uint32_t* value) {
   } else {
     goto fail;
   }
+#if SD_FAT_CACHE
+  if (lba != fatCacheBlockNumber_) {
+    if (lba == cacheBlockNumber_) {
+      // the block cache may hold changes not written yet
+      memcpy(fatCacheBuffer_.data, cacheBuffer_.data, 512);
+    } else if (!sdCard_->readBlock(lba, fatCacheBuffer_.data)) {
+      goto fail;
+    }
+    fatCacheBlockNumber_ = lba;
+    fatCacheMisses_++;
+  } else {
+    fatCacheHits_++;
+  }
+  if (fatType_ == 16) {
+    *value = fatCacheBuffer_.fat16[cluster & 0XFF];
+  } else {
+    *value = fatCacheBuffer_.fat32[cluster & 0X7F] & FAT32MASK;
+  }
+#else  // SD_FAT_CACHE
   if (lba != cacheBlockNumber_) {
     if (!cacheRawBlock(lba, CACHE_FOR_READ)) goto fail;
   }
@@ -186,6 +226,7 @@ bool SdVolume::fatGet(uint32_t cluster, uint32_t* value) {
   } else {
     *value = cacheBuffer_.fat32[cluster & 0X7F] & FAT32MASK;
   }
+#endif  // SD_FAT_CACHE
   return true;
 
  fail:
@@ -237,6 +278,10 @@ bool SdVolume::fatPut(uint32_t cluster, uint32_t value) {
     goto fail;
   }
   if (!cacheRawBlock(lba, CACHE_FOR_WRITE)) goto fail;
+#if SD_FAT_CACHE
+  // fatGet() copies the changed block from the block cache
+  if (lba == fatCacheBlockNumber_) fatCacheBlockNumber_ = 0XFFFFFFFF;
+#endif  // SD_FAT_CACHE
   // store entry
   if (fatType_ == 16) {
     cacheBuffer_.fat16[cluster & 0XFF] = value;
@@ -332,6 +377,9 @@ bool SdVolume::init(Sd2Card* dev, uint8_t part) {
   cacheDirty_ = 0;  // cacheFlush() will write block if true
   cacheMirrorBlock_ = 0;
   cacheBlockNumber_ = 0XFFFFFFFF;
+#if SD_FAT_CACHE
+  fatCacheBlockNumber_ = 0XFFFFFFFF;
+#endif  // SD_FAT_CACHE
 
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
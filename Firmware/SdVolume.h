@@ -117,6 +117,19 @@ class SdVolume {
    * \return true for success or false for failure
    */
   bool dbgFat(uint32_t n, uint32_t* v) {return fatGet(n, v);}
+#if SD_FAT_CACHE
+#if USE_MULTIPLE_CARDS
+  /** \return The number of FAT lookups served by the FAT cache. */
+  uint32_t fatCacheHits() const {return fatCacheHits_;}
+  /** \return The number of FAT blocks read into the FAT cache. */
+  uint32_t fatCacheMisses() const {return fatCacheMisses_;}
+#else  // USE_MULTIPLE_CARDS
+  /** \return The number of FAT lookups served by the FAT cache. */
+  static uint32_t fatCacheHits() {return fatCacheHits_;}
+  /** \return The number of FAT blocks read into the FAT cache. */
+  static uint32_t fatCacheMisses() {return fatCacheMisses_;}
+#endif  // USE_MULTIPLE_CARDS
+#endif  // SD_FAT_CACHE
 //------------------------------------------------------------------------------
  private:
   friend class SdFile;
@@ -141,6 +154,19 @@ class SdVolume {
   static bool cacheDirty_;            // cacheFlush() will write block if true
   static uint32_t cacheMirrorBlock_;  // block number for mirror FAT
 #endif  // USE_MULTIPLE_CARDS
+#if SD_FAT_CACHE
+#if USE_MULTIPLE_CARDS
+  cache_t fatCacheBuffer_;        // 512 byte cache for FAT blocks
+  uint32_t fatCacheBlockNumber_;  // Logical number of FAT block in the cache
+  uint32_t fatCacheHits_;         // fatGet() served by the FAT cache
+  uint32_t fatCacheMisses_;       // FAT blocks read into the FAT cache
+#else  // USE_MULTIPLE_CARDS
+  static cache_t fatCacheBuffer_;        // 512 byte cache for FAT blocks
+  static uint32_t fatCacheBlockNumber_;  // Logical number of FAT block in the cache
+  static uint32_t fatCacheHits_;         // fatGet() served by the FAT cache
+  static uint32_t fatCacheMisses_;       // FAT blocks read into the FAT cache
+#endif  // USE_MULTIPLE_CARDS
+#endif  // SD_FAT_CACHE
   uint32_t allocSearchStart_;   // start cluster for alloc search
   uint8_t blocksPerCluster_;    // cluster size in blocks
   uint32_t blocksPerFat_;       // FAT size in blocks
@@ -165,9 +191,11 @@ class SdVolume {
 #if USE_MULTIPLE_CARDS
   bool cacheFlush();
   bool cacheRawBlock(uint32_t blockNumber, bool dirty);
+  bool cacheStreamBlock(uint32_t blockNumber);
 #else  // USE_MULTIPLE_CARDS
   static bool cacheFlush();
   static bool cacheRawBlock(uint32_t blockNumber, bool dirty);
+  static bool cacheStreamBlock(uint32_t blockNumber);
 #endif  // USE_MULTIPLE_CARDS
   // used by SdBaseFile write to assign cache to SD location
   void cacheSetBlockNumber(uint32_t blockNumber, bool dirty) {
@@ -0,0 +1,162 @@
+#include "binary_transport.h"
+
+#ifdef ENABLE_BINARY_TRANSPORT
+
+#ifdef __AVR__
+#include <util/crc16.h>
+#endif
+#include "cmdqueue.h"
+
+#define BT_MOVE_WORDS (_BV(MOVE_WORD_F + 1) - 1)
+
+enum BtState : uint8_t {
+    BT_STATE_SYNC,
+    BT_STATE_TYPE,
+    BT_STATE_LENGTH,
+    BT_STATE_N_LOW,
+    BT_STATE_N_HIGH,
+    BT_STATE_MASK,
+    BT_STATE_PAYLOAD,
+    BT_STATE_CRC_LOW,
+    BT_STATE_CRC_HIGH,
+};
+
+bool bt_enabled = false;
+
+static struct {
+    uint8_t state;
+    uint8_t type;
+    uint8_t remaining; // payload bytes not received yet
+    uint8_t value_bytes; // bytes of the move value being received
+    uint8_t words; // mask of the move values not received yet
+    uint32_t value;
+    uint16_t n;
+    uint16_t crc;
+    uint8_t crc_low;
+    bool resync; // looking for the next frame after an error
+} bt;
+
+uint16_t bt_crc16_update(uint16_t crc, uint8_t b)
+{
+#ifdef __AVR__
+    return _crc_xmodem_update(crc, b);
+#else
+    crc ^= uint16_t(b) << 8;
+    for (uint8_t i = 0; i < 8; ++i)
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    return crc;
+#endif
+}
+
+void bt_enable(bool enable)
+{
+    bt_enabled = enable;
+    bt.state = BT_STATE_SYNC;
+    bt.resync = false;
+}
+
+uint16_t bt_frame_n()
+{
+    return bt.n;
+}
+
+// Drops the frame being received. Returns whether the error is to be reported.
+static bool bt_error()
+{
+    bt.state = BT_STATE_SYNC;
+    if (bt.resync)
+        return false;
+    bt.resync = true;
+    return true;
+}
+
+uint8_t bt_receive(const uint8_t *in, uint16_t in_count, uint16_t &consumed, char *line, int &line_len)
+{
+    consumed = 0;
+    while (consumed < in_count) {
+        const uint8_t c = in[consumed++];
+        if (bt.state != BT_STATE_SYNC && bt.state < BT_STATE_CRC_LOW)
+            bt.crc = bt_crc16_update(bt.crc, c);
+        switch (bt.state) {
+        case BT_STATE_SYNC:
+            if (c == BT_SYNC) {
+                bt.crc = 0xffff;
+                line_len = 0;
+                bt.state = BT_STATE_TYPE;
+            }
+            continue;
+        case BT_STATE_TYPE:
+            bt.type = c;
+            if (c != BT_FRAME_MOVE && c != BT_FRAME_GCODE)
+                break;
+            bt.state = BT_STATE_LENGTH;
+            continue;
+        case BT_STATE_LENGTH:
+            // The G-code and the move record fit into a command of the queue.
+            if (c == 0 || c >= MAX_CMD_SIZE)
+                break;
+            bt.remaining = c;
+            bt.state = BT_STATE_N_LOW;
+            continue;
+        case BT_STATE_N_LOW:
+            bt.n = c;
+            bt.state = BT_STATE_N_HIGH;
+            continue;
+        case BT_STATE_N_HIGH:
+            bt.n |= uint16_t(c) << 8;
+            bt.state = (bt.type == BT_FRAME_MOVE) ? BT_STATE_MASK : BT_STATE_PAYLOAD;
+            continue;
+        case BT_STATE_MASK: {
+            // The mask announces the length of the payload.
+            uint8_t words = 0;
+            for (uint8_t mask = c; mask; mask &= mask - 1)
+                ++words;
+            if ((c & ~BT_MOVE_WORDS) || bt.remaining != 1 + words * 4)
+                break;
+            line[0] = MOVE_RECORD_MARKER;
+            line[1] = char(0x80 | c);
+            line_len = 2;
+            bt.words = c;
+            bt.value_bytes = 0;
+            bt.state = (--bt.remaining) ? BT_STATE_PAYLOAD : BT_STATE_CRC_LOW;
+            continue;
+        }
+        case BT_STATE_PAYLOAD:
+            if (bt.type == BT_FRAME_GCODE) {
+                if (c == 0)
+                    break;
+                line[line_len++] = char(c);
+            } else {
+                bt.value = (bt.value >> 8) | (uint32_t(c) << 24);
+                if (++bt.value_bytes == 4) {
+                    // The feedrate is the last word. Exact up to 2^24 units, the division rounds
+                    // once like the one of code_move_words().
+                    const float scale = (bt.words == _BV(MOVE_WORD_F)) ? BT_FEEDRATE_SCALE : BT_AXIS_SCALE;
+                    move_record_value(line + line_len, float(int32_t(bt.value)) / scale);
+                    line_len += MOVE_RECORD_WORD_SIZE;
+                    bt.words &= bt.words - 1;
+                    bt.value_bytes = 0;
+                }
+            }
+            if (--bt.remaining == 0)
+                bt.state = BT_STATE_CRC_LOW;
+            continue;
+        case BT_STATE_CRC_LOW:
+            bt.crc_low = c;
+            bt.state = BT_STATE_CRC_HIGH;
+            continue;
+        case BT_STATE_CRC_HIGH:
+            if (bt.crc != (bt.crc_low | (uint16_t(c) << 8)))
+                break;
+            bt.state = BT_STATE_SYNC;
+            bt.resync = false;
+            return BT_RX_FRAME;
+        }
+        // A corrupted frame.
+        if (bt_error())
+            return BT_RX_ERROR;
+    }
+    return BT_RX_PENDING;
+}
+
+#endif // ENABLE_BINARY_TRANSPORT
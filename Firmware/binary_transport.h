@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @brief Binary G-code transport of the serial line.
+ *
+ * Switched on by `M930 S1` and off by `M930 S0`, both handled by get_command() when the line is
+ * received. Each command is sent in a frame:
+ *
+ *     0xA5 | type | length | N (2) | payload (length) | CRC (2)
+ *
+ * Multi-byte fields are little endian. N is the low 16 bits of the line number, following the
+ * rules of the `N` of the text lines. The CRC is CRC-16/CCITT-FALSE (polynomial 0x1021, initial
+ * value 0xFFFF) of the bytes from the type to the end of the payload. A frame with a wrong CRC is
+ * answered by a resend request, like a text line with a wrong checksum.
+ *
+ * A move frame (BT_FRAME_MOVE, the G0/G1 moves) carries the mask of the words (1 << axis for
+ * X Y Z E, 1 << MOVE_WORD_F) followed by the int32 values of the words in this order: the axes in
+ * BT_AXIS_SCALE units, the feedrate in BT_FEEDRATE_SCALE units. A G-code frame (BT_FRAME_GCODE)
+ * carries the text of any other command, without the terminator.
+ */
+
+#ifndef BINARY_TRANSPORT_H
+#define BINARY_TRANSPORT_H
+
+#include <stdint.h>
+#include "Configuration.h"
+
+#ifdef ENABLE_BINARY_TRANSPORT
+
+#define BT_SYNC 0xA5
+#define BT_FRAME_MOVE 1
+#define BT_FRAME_GCODE 2
+
+// Bytes of a frame around the payload: sync, type, length, N, CRC.
+#define BT_FRAME_OVERHEAD 7
+
+// Units of the move values per mm and per mm/min.
+#define BT_AXIS_SCALE 100000.f
+#define BT_FEEDRATE_SCALE 1000.f
+
+// Return values of bt_receive().
+#define BT_RX_PENDING 0
+#define BT_RX_FRAME 1
+#define BT_RX_ERROR 2
+
+// True while the serial line carries binary frames.
+extern bool bt_enabled;
+
+// Switches the serial line between the binary frames and the G-code text.
+extern void bt_enable(bool enable);
+
+// Receives the bytes in[0..in_count) into the frame being received. The command of the frame is
+// stored to line, line_len characters so far, NUL free: the text of a G-code frame or the move
+// record (MOVE_RECORD_MARKER) of a move frame.
+// @param consumed [out] Number of bytes read from in, up to the end of a frame or an error.
+// @return BT_RX_FRAME when a frame is complete and line_len characters of the command stored,
+//  BT_RX_ERROR for a corrupted frame, BT_RX_PENDING when all the bytes are read. Errors following
+//  the first one are not reported until a valid frame is received again.
+extern uint8_t bt_receive(const uint8_t *in, uint16_t in_count, uint16_t &consumed, char *line, int &line_len);
+
+// Low 16 bits of the line number of the last frame received.
+extern uint16_t bt_frame_n();
+
+// CRC-16/CCITT-FALSE update by one byte.
+extern uint16_t bt_crc16_update(uint16_t crc, uint8_t b);
+
+#endif // ENABLE_BINARY_TRANSPORT
+
+#endif // BINARY_TRANSPORT_H
@@ -9,11 +9,17 @@
 #include "Prusa_farm.h"
 #include "power_panic.h"
 #include "stopwatch.h"
+#include "spi.h"
 
 #ifdef SDSUPPORT
 
 #define LONGEST_FILENAME (longFilename[0] ? longFilename : filename)
 
+void spi_sd_stream_end(void)
+{
+  card.readStreamEnd();
+}
+
 CardReader::CardReader()
 {
 
@@ -79,6 +79,11 @@ public:
   FORCE_INLINE char* getWorkDirName(){workDir.getFilename(filename);return filename;};
   FORCE_INLINE uint32_t get_sdpos() { if (!isFileOpen()) return 0; else return(sdpos); };
 
+  // The card leaves the SPI bus to the other devices, see spi_setup().
+  FORCE_INLINE void readStreamEnd() { card.readStreamEnd(); }
+  // The power panic takes the bus from the interrupt, without finishing the read in progress.
+  FORCE_INLINE void readStreamAbandon() { card.readStreamAbandon(); }
+
   bool ToshibaFlashAir_isEnabled() const { return card.getFlashAirCompatible(); }
   void ToshibaFlashAir_enable(bool enable) { card.setFlashAirCompatible(enable); }
   bool ToshibaFlashAir_GetIP(uint8_t *ip);
@@ -2,9 +2,12 @@
 #include <util/atomic.h>
 #include "cmdqueue.h"
 #include "cardreader.h"
+#include "planner.h"
 #include "ultralcd.h"
 #include "Prusa_farm.h"
 #include "meatpack.h"
+#include "binary_transport.h"
+#include "telemetry.h"
 #include "messages.h"
 #include "language.h"
 #include "stopwatch.h"
@@ -12,12 +15,15 @@
 
 // Reserve BUFSIZE lines of length MAX_CMD_SIZE plus CMDBUFFER_RESERVE_FRONT.
 char cmdbuffer[BUFSIZE * (MAX_CMD_SIZE + 1) + CMDBUFFER_RESERVE_FRONT];
-// Head of the circular buffer, where to read.
-size_t bufindr = 0;
-// Tail of the buffer, where to write.
+// Descriptors of the queued commands.
+CmdQueueEntry cmdqueue[CMDQUEUE_SIZE];
+// Head of the descriptor ring, where to read.
+uint8_t bufindr = 0;
+// Tail of the character buffer, where to write the next string.
 static size_t bufindw = 0;
-// Number of lines in cmdbuffer.
+// Number of commands in the queue.
 int buflen = 0;
+uint16_t cmdqueue_sdlen = 0;
 // Flag for processing the current command inside the main Arduino loop().
 // If a new command was pushed to the front of a command buffer while
 // processing another command, this replaces the command on the top.
@@ -36,6 +42,28 @@ ShortTimer serialTimeoutTimer;
 long gcode_LastN = 0;
 uint32_t sdpos_atomic = 0;
 
+// Offsets + 1 of the first occurrence of the letters A-Z in the command code_words_cmd, 0 if absent.
+static uint8_t code_words['Z' - 'A' + 1];
+static const char *code_words_cmd = NULL;
+static_assert(MAX_CMD_SIZE < 255, "The command offsets have to fit code_words");
+
+
+static inline uint8_t cmdqueue_index(uint8_t i)
+{
+    return i & (CMDQUEUE_SIZE - 1);
+}
+
+// Descriptor of the command to be pushed to the tail.
+static inline CmdQueueEntry &cmdqueue_back()
+{
+    return cmdqueue[cmdqueue_index(bufindr + buflen)];
+}
+
+// Start of the strings in cmdbuffer: the string of the command at the front, the tail if empty.
+static inline size_t cmdqueue_strings_start()
+{
+    return buflen ? CMDBUFFER_CURRENT_ENTRY.cmd : bufindw;
+}
 
 // Pop the currently processed command from the queue.
 // It is expected, that there is at least one command in the queue.
@@ -44,7 +72,7 @@ bool cmdqueue_pop_front()
     if (buflen > 0) {
 #ifdef CMDBUFFER_DEBUG
         SERIAL_ECHOPGM("Dequeing ");
-        SERIAL_ECHO(cmdbuffer+bufindr+CMDHDRSIZE);
+        SERIAL_ECHO(CMDBUFFER_CURRENT_STRING);
         SERIAL_ECHOLNPGM("");
         SERIAL_ECHOPGM("Old indices: buflen ");
         SERIAL_ECHO(buflen);
@@ -58,24 +86,15 @@ bool cmdqueue_pop_front()
         SERIAL_ECHO(sizeof(cmdbuffer));
         SERIAL_ECHOLNPGM("");
 #endif /* CMDBUFFER_DEBUG */
-        if (-- buflen == 0) {
-            // Empty buffer.
-            if (serial_count == 0)
-                // No serial communication is pending. Reset both pointers to zero.
-                bufindw = 0;
-            bufindr = bufindw;
-        } else {
-            // There is at least one ready line in the buffer.
-            // First skip the current command ID and iterate up to the end of the string.
-            for (bufindr += CMDHDRSIZE; cmdbuffer[bufindr] != 0; ++ bufindr) ;
-            // Second, skip the end of string null character and iterate until a nonzero command ID is found.
-            for (++ bufindr; bufindr < sizeof(cmdbuffer) && cmdbuffer[bufindr] == 0; ++ bufindr) ;
-            // If the end of the buffer was empty,
-            if (bufindr == sizeof(cmdbuffer)) {
-                // skip to the start and find the nonzero command.
-                for (bufindr = 0; cmdbuffer[bufindr] == 0; ++ bufindr) ;
-            }
+        if (CMDBUFFER_CURRENT_TYPE == CMDBUFFER_CURRENT_TYPE_SDCARD) {
+            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { cmdqueue_sdlen -= CMDBUFFER_CURRENT_ENTRY.sdlen; }
+        }
+        bufindr = cmdqueue_index(bufindr + 1);
+        if (-- buflen == 0 && serial_count == 0)
+            // Empty queue and no serial communication is pending. Restart at the start of the buffer.
+            bufindw = 0;
 #ifdef CMDBUFFER_DEBUG
+        if (buflen) {
             SERIAL_ECHOPGM("New indices: buflen ");
             SERIAL_ECHO(buflen);
             SERIAL_ECHOPGM(", bufindr ");
@@ -85,10 +104,10 @@ bool cmdqueue_pop_front()
             SERIAL_ECHOPGM(", serial_count ");
             SERIAL_ECHO(serial_count);
             SERIAL_ECHOPGM(" new command on the top: ");
-            SERIAL_ECHO(cmdbuffer+bufindr+CMDHDRSIZE);
+            SERIAL_ECHO(CMDBUFFER_CURRENT_STRING);
             SERIAL_ECHOLNPGM("");
-#endif /* CMDBUFFER_DEBUG */
         }
+#endif /* CMDBUFFER_DEBUG */
         return true;
     }
     return false;
@@ -98,7 +117,7 @@ void cmdqueue_reset()
 {
 	while (buflen)
 	{
-		// printf_P(PSTR("dumping: \"%s\" of type %u\n"), cmdbuffer+bufindr+CMDHDRSIZE, CMDBUFFER_CURRENT_TYPE);
+		// printf_P(PSTR("dumping: \"%s\" of type %u\n"), CMDBUFFER_CURRENT_STRING, CMDBUFFER_CURRENT_TYPE);
 		ClearToSend();
 		cmdqueue_pop_front();
 	}
@@ -111,10 +130,10 @@ void cmdqueue_reset()
 	cmdbuffer_front_already_processed = true;
 }
 
-// How long a string could be pushed to the front of the command queue?
-// If yes, adjust bufindr to the new position, where the new command could be enqued.
+// Could a string of length len_asked be pushed to the front of the command queue?
+// If yes, return its position in cmdbuffer in pos.
 // len_asked does not contain the zero terminator size.
-static bool cmdqueue_could_enqueue_front(size_t len_asked)
+static bool cmdqueue_could_enqueue_front(size_t len_asked, size_t &pos)
 {
     // MAX_CMD_SIZE has to accommodate the zero terminator.
     if (len_asked >= MAX_CMD_SIZE)
@@ -124,29 +143,31 @@ static bool cmdqueue_could_enqueue_front(size_t len_asked)
         cmdqueue_pop_front();
         cmdbuffer_front_already_processed = true;
     }
-    if (bufindr == bufindw && buflen > 0)
+    if (buflen >= CMDQUEUE_SIZE)
+        // No free descriptor.
+        return false;
+    const size_t start = cmdqueue_strings_start();
+    if (start == bufindw && buflen > 0)
         // Full buffer.
         return false;
     // Adjust the end of the write buffer based on whether a partial line is in the receive buffer.
-    int endw = (serial_count > 0) ? (bufindw + MAX_CMD_SIZE + 1) : bufindw;
-    if (bufindw < bufindr) {
-        int bufindr_new = bufindr - len_asked - (1 + CMDHDRSIZE);
+    const size_t endw = (serial_count > 0) ? (bufindw + MAX_CMD_SIZE + 1) : bufindw;
+    const size_t size = len_asked + 1;
+    if (bufindw < start) {
         // Simple case. There is a contiguous space between the write buffer and the read buffer.
-        if (endw <= bufindr_new) {
-            bufindr = bufindr_new;
+        if (endw + size <= start) {
+            pos = start - size;
             return true;
         }
     } else {
         // Otherwise the free space is split between the start and end.
-        if (len_asked + (1 + CMDHDRSIZE) <= bufindr) {
+        if (size <= start) {
             // Could fit at the start.
-            bufindr -= len_asked + (1 + CMDHDRSIZE);
+            pos = start - size;
             return true;
         }
-        int bufindr_new = sizeof(cmdbuffer) - len_asked - (1 + CMDHDRSIZE);
-        if (endw <= bufindr_new) {
-            memset(cmdbuffer, 0, bufindr);
-            bufindr = bufindr_new;
+        if (endw + size <= sizeof(cmdbuffer)) {
+            pos = sizeof(cmdbuffer) - size;
             return true;
         }
     }
@@ -157,58 +178,53 @@ static bool cmdqueue_could_enqueue_front(size_t len_asked)
 // while leaving CMDBUFFER_RESERVE_FRONT at the start?
 // If yes, adjust bufindw to the new position, where the new command could be enqued.
 // len_asked does not contain the zero terminator size.
-// This function may update bufindw, therefore for the power panic to work, this function must be called
-// with the interrupts disabled!
 static bool __attribute__((noinline)) cmdqueue_could_enqueue_back(size_t len_asked)
 {
     // MAX_CMD_SIZE has to accommodate the zero terminator.
     if (len_asked >= MAX_CMD_SIZE)
         return false;
 
-    if (bufindr == bufindw && buflen > 0)
+    if (buflen >= CMDQUEUE_SIZE - CMDQUEUE_RESERVE_FRONT)
+        // No free descriptor, apart from the ones reserved for the commands pushed to the front.
+        return false;
+
+    const size_t start = cmdqueue_strings_start();
+    if (start == bufindw && buflen > 0)
         // Full buffer.
         return false;
 
     // If there is some data stored starting at bufindw, len_asked is certainly smaller than
-    // the allocated data buffer. Try to reserve a new buffer and to move the already received
-    // serial data.
-    // How much memory to reserve for the commands pushed to the front?
+    // the allocated data buffer.
     // End of the queue, when pushing to the end.
-    size_t endw = bufindw + len_asked + (1 + CMDHDRSIZE);
-    if (bufindw < bufindr)
+    size_t endw = bufindw + len_asked + 1;
+    if (bufindw < start)
         // Simple case. There is a contiguous space between the write buffer and the read buffer.
-        return endw + CMDBUFFER_RESERVE_FRONT <= bufindr;
+        return endw + CMDBUFFER_RESERVE_FRONT <= start;
     // Otherwise the free space is split between the start and end.
     if (// Could one fit to the end, including the reserve?
         endw + CMDBUFFER_RESERVE_FRONT <= sizeof(cmdbuffer) ||
         // Could one fit to the end, and the reserve to the start?
-        (endw <= sizeof(cmdbuffer) && CMDBUFFER_RESERVE_FRONT <= bufindr))
+        (endw <= sizeof(cmdbuffer) && CMDBUFFER_RESERVE_FRONT <= start))
         return true;
-    // Could one fit both to the start?
-    if (len_asked + (1 + CMDHDRSIZE) + CMDBUFFER_RESERVE_FRONT <= bufindr) {
-        // Mark the rest of the buffer as used.
-        memset(cmdbuffer+bufindw, 0, sizeof(cmdbuffer)-bufindw);
-        // and point to the start.
-        // Be careful! The bufindw needs to be changed atomically for the power panic & filament panic to work.
-        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { bufindw = 0; }
+    // Could one fit both to the start? The rest of the buffer stays unused until the queue passes it.
+    if (len_asked + 1 + CMDBUFFER_RESERVE_FRONT <= start) {
+        bufindw = 0;
         return true;
     }
     return false;
 }
 
 #ifdef CMDBUFFER_DEBUG
-void cmdqueue_dump_to_serial_single_line(int nr, const char *p)
+void cmdqueue_dump_to_serial_single_line(int nr, const CmdQueueEntry &entry)
 {
     SERIAL_ECHOPGM("Entry nr: ");
     SERIAL_ECHO(nr);
     SERIAL_ECHOPGM(", type: ");
-    int type = *p;
-    SERIAL_ECHO(type);
+    SERIAL_ECHO(int(entry.type));
     SERIAL_ECHOPGM(", size: ");
-    unsigned int size = *(unsigned int*)(p + 1);
-    SERIAL_ECHO(size);
+    SERIAL_ECHO(entry.sdlen);
     SERIAL_ECHOPGM(", cmd: ");
-    SERIAL_ECHO(p + CMDHDRSIZE);
+    SERIAL_ECHO(cmdbuffer + entry.cmd);
     SERIAL_ECHOLNPGM("");
 }
 
@@ -224,31 +240,8 @@ void cmdqueue_dump_to_serial()
         SERIAL_ECHOPGM(", indw ");
         SERIAL_ECHO(bufindw);
         SERIAL_ECHOLNPGM("");
-        int nr = 0;
-        if (bufindr < bufindw) {
-            for (const char *p = cmdbuffer + bufindr; p < cmdbuffer + bufindw; ++ nr) {
-                cmdqueue_dump_to_serial_single_line(nr, p);
-                // Skip the command.
-                for (p += CMDHDRSIZE; *p != 0; ++ p);
-                // Skip the gaps.
-                for (++p; p < cmdbuffer + bufindw && *p == 0; ++ p);
-            }
-        } else {
-            for (const char *p = cmdbuffer + bufindr; p < cmdbuffer + sizeof(cmdbuffer); ++ nr) {
-                cmdqueue_dump_to_serial_single_line(nr, p);
-                // Skip the command.
-                for (p += CMDHDRSIZE; *p != 0; ++ p);
-                // Skip the gaps.
-                for (++p; p < cmdbuffer + sizeof(cmdbuffer) && *p == 0; ++ p);
-            }
-            for (const char *p = cmdbuffer; p < cmdbuffer + bufindw; ++ nr) {
-                cmdqueue_dump_to_serial_single_line(nr, p);
-                // Skip the command.
-                for (p += CMDHDRSIZE; *p != 0; ++ p);
-                // Skip the gaps.
-                for (++p; p < cmdbuffer + bufindw && *p == 0; ++ p);
-            }
-        }
+        for (int nr = 0; nr < buflen; ++ nr)
+            cmdqueue_dump_to_serial_single_line(nr, cmdqueue[cmdqueue_index(bufindr + nr)]);
         SERIAL_ECHOLNPGM("End of the buffer.");
     }
 }
@@ -282,16 +275,18 @@ void enquecommand(const char *cmd, bool from_progmem)
     if (cmdqueue_could_enqueue_back(len)) {
         // This is dangerous if a mixing of serial and this happens
         // This may easily be tested: If serial_count > 0, we have a problem.
-        cmdbuffer[bufindw] = CMDBUFFER_CURRENT_TYPE_UI;
+        CmdQueueEntry &entry = cmdqueue_back();
+        entry.type = CMDBUFFER_CURRENT_TYPE_UI;
+        entry.cmd = bufindw;
         if (from_progmem)
-            strcpy_P(cmdbuffer + bufindw + CMDHDRSIZE, cmd);
+            strcpy_P(cmdbuffer + bufindw, cmd);
         else
-            strcpy(cmdbuffer + bufindw + CMDHDRSIZE, cmd);
+            strcpy(cmdbuffer + bufindw, cmd);
         SERIAL_ECHO_START;
         SERIAL_ECHORPGM(MSG_Enqueing);
-        SERIAL_ECHO(cmdbuffer + bufindw + CMDHDRSIZE);
+        SERIAL_ECHO(cmdbuffer + bufindw);
         SERIAL_ECHOLNPGM("\"");
-        bufindw += len + (CMDHDRSIZE + 1);
+        bufindw += len + 1;
         if (bufindw == sizeof(cmdbuffer))
             bufindw = 0;
         ++ buflen;
@@ -320,17 +315,21 @@ bool cmd_buffer_empty()
 void enquecommand_front(const char *cmd, bool from_progmem)
 {
     size_t len = from_progmem ? strlen_P(cmd) : strlen(cmd);
-    // Does cmd fit the queue? This call shall move bufindr, so the command may be copied.
-    if (cmdqueue_could_enqueue_front(len)) {
-        cmdbuffer[bufindr] = CMDBUFFER_CURRENT_TYPE_UI;
+    // Does cmd fit the queue? The position of the string is returned, if it does.
+    size_t pos;
+    if (cmdqueue_could_enqueue_front(len, pos)) {
+        CmdQueueEntry &entry = cmdqueue[cmdqueue_index(bufindr - 1)];
+        entry.type = CMDBUFFER_CURRENT_TYPE_UI;
+        entry.cmd = pos;
         if (from_progmem)
-            strcpy_P(cmdbuffer + bufindr + CMDHDRSIZE, cmd);
+            strcpy_P(cmdbuffer + pos, cmd);
         else
-            strcpy(cmdbuffer + bufindr + CMDHDRSIZE, cmd);
+            strcpy(cmdbuffer + pos, cmd);
+        bufindr = cmdqueue_index(bufindr - 1);
         ++ buflen;
         SERIAL_ECHO_START;
         SERIAL_ECHORPGM(enqueingFront);
-        SERIAL_ECHO(cmdbuffer + bufindr + CMDHDRSIZE);
+        SERIAL_ECHO(CMDBUFFER_CURRENT_STRING);
         SERIAL_ECHOLNPGM("\"");
 #ifdef CMDBUFFER_DEBUG
         cmdqueue_dump_to_serial();
@@ -356,105 +355,178 @@ void repeatcommand_front()
     cmdbuffer_front_already_processed = true;
 }
 
-void get_command()
+#ifdef CMDQUEUE_PREFETCH_MOVES
+// Store the plain G0/G1 move cmd of len characters, which is being queued to the back, as a move
+// record. Returns the length of the command stored. The move is parsed once here, loop() plans it
+// right after the command before it, and the characters saved are free for the following lines.
+static size_t cmdqueue_prefetch(char *cmd, size_t len)
 {
-    // Test and reserve space for the new command string.
-    if (! cmdqueue_could_enqueue_back(MAX_CMD_SIZE - 1))
-      return;
+#ifdef SDSUPPORT
+    // The lines written to a file by M28 stay text.
+    if (card.saving)
+        return len;
+#endif
+    return move_record_from_text(cmd, len);
+}
+#endif // CMDQUEUE_PREFETCH_MOVES
 
-	if (MYSERIAL.available() == RX_BUFFER_SIZE - 1) { //compare number of chars buffered in rx buffer with rx buffer size
-		MYSERIAL.flush();
-		SERIAL_ECHOLNPGM("Full RX Buffer");   //if buffer was full, there is danger that reading of last gcode will not be completed
-	}
+// Release the command processed by cmdqueue_process_front() unless a command was pushed in front of it.
+static void cmdqueue_pop_processed()
+{
+  if (! cmdbuffer_front_already_processed && buflen)
+  {
+    CmdQueueEntry &entry = CMDBUFFER_CURRENT_ENTRY;
+    if (entry.type == CMDBUFFER_CURRENT_TYPE_SDCARD) {
+      // To support power panic, move the length of the command on the SD card to a planner buffer.
+      {
+        // This block locks the interrupts globally for 3.25 us,
+        // which corresponds to a maximum repeat frequency of 307.69 kHz.
+        // This blocking is safe in the context of a 10kHz stepper driver interrupt
+        // or a 115200 Bd serial line receive interrupt, which will not trigger faster than 12kHz.
+        cli();
+        // Reset the command to something, which will be ignored by the power panic routine,
+        // so this buffer length will not be counted twice.
+        entry.type = CMDBUFFER_CURRENT_TYPE_TO_BE_REMOVED;
+        cmdqueue_sdlen -= entry.sdlen;
+        // and pass it to the planner queue.
+        planner_add_sd_length(entry.sdlen);
+        sei();
+      }
+    }
+    else if((entry.type == CMDBUFFER_CURRENT_TYPE_USB_WITH_LINENR) && !IS_SD_PRINTING){
+      cli();
+      entry.type = CMDBUFFER_CURRENT_TYPE_TO_BE_REMOVED;
+      // and one for each command to previous block in the planner queue.
+      planner_add_sd_length(1);
+      sei();
+    }
+    // Now it is safe to release the already processed command block. If interrupted by the power panic now,
+    // this block's SD card length will not be counted twice as its command type has been replaced
+    // by CMDBUFFER_CURRENT_TYPE_TO_BE_REMOVED.
+    cmdqueue_pop_front();
+  }
+}
 
-  // start of serial line processing loop
-  while (((MYSERIAL.available() > 0 && !saved_printing) || (MYSERIAL.available() > 0 && printingIsPaused())) && !cmdqueue_serial_disabled) {  //is print is saved (crash detection or filament detection), dont process data from serial line
+#ifdef CMDQUEUE_PREFETCH_MOVES
+// Is the move record at the front to be planned right after the command processed? Not while the
+// commands are written to a file by M28 or logged by M928, the M28 may have been queued before them.
+static bool cmdqueue_plan_prefetched()
+{
+    if (! cmdqueue_front_prefetched() || planner_queue_full() || planner_aborted)
+        return false;
+#ifdef SDSUPPORT
+    if (card.saving || card.logging)
+        return false;
+#endif //SDSUPPORT
+    return true;
+}
+#endif //CMDQUEUE_PREFETCH_MOVES
 
-#ifdef ENABLE_MEATPACK
-    // MeatPack Changes
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-      const int rec = MYSERIAL.read();
-      if (rec < 0) continue;
+void cmdqueue_process_front()
+{
+    cmdbuffer_front_already_processed = false;
+    #ifdef SDSUPPORT
+      if(card.saving)
+      {
+        // Saving a G-code file onto an SD-card is in progress.
+        // Saving starts with M28, saving until M29 is seen.
+        if(strstr_P(CMDBUFFER_CURRENT_STRING, PSTR("M29")) == NULL) {
+          char *cmd = CMDBUFFER_CURRENT_STRING;
+          // A move queued as a record before the M28 ran, the file gets its text.
+          char text[MOVE_RECORD_TEXT_SIZE];
+          if(cmd[0] == MOVE_RECORD_MARKER) {
+            move_record_to_text(cmd, text);
+            cmd = text;
+          }
+          card.write_command(cmd);
+          if(card.logging)
+            process_commands();
+          else
+           SERIAL_PROTOCOLLNRPGM(MSG_OK);
+        } else {
+          card.closefile();
+          SERIAL_PROTOCOLLNRPGM(MSG_FILE_SAVED);
+        }
+      } else {
+        process_commands();
+      }
+    #else
+      process_commands();
+    #endif //SDSUPPORT
 
-      mp_handle_rx_char((uint8_t)rec);
-      char c_res[2] = {0, 0};
-      const uint8_t char_count = mp_get_result_char(c_res);
-      // Note -- Paired bracket in preproc switch below
-      for (uint8_t i = 0; i < char_count; ++i) { char serial_char = c_res[i];
-#else
-    char serial_char = MYSERIAL.read();
-#endif
+    cmdqueue_pop_processed();
+#ifdef CMDQUEUE_PREFETCH_MOVES
+    // Plan the moves parsed ahead behind it while the planner has free blocks, rather than one
+    // command per pass through the heater and LCD updates of loop().
+    for (uint8_t moves = CMDQUEUE_PREFETCH_MOVES; moves && cmdqueue_plan_prefetched(); -- moves)
+    {
+      cmdbuffer_front_already_processed = false;
+      process_commands();
+      cmdqueue_pop_processed();
+    }
+#endif //CMDQUEUE_PREFETCH_MOVES
+}
 
-    serialTimeoutTimer.start();
 
-    if (serial_char < 0)
-        // Ignore extended ASCII characters. These characters have no meaning in the G-code apart from the file names
-        // and Marlin does not support such file names anyway.
-        // Serial characters with a highest bit set to 1 are generated when the USB cable is unplugged, leading
-        // to a hang-up of the print process from an SD card.
-        continue;
-    if(serial_char == '\n' ||
-       serial_char == '\r' ||
-       serial_count >= (MAX_CMD_SIZE - 1) )
-    {
-      if(!serial_count) { //if empty line
-        comment_mode = false; //for new command
-        return;
-      }
-      cmdbuffer[bufindw+serial_count+CMDHDRSIZE] = 0; // terminate string
-      char* cmd_head = cmdbuffer+bufindw+CMDHDRSIZE; // current command pointer
-      char* cmd_start = cmd_head; // pointer past the line number (if any)
-
-      if(!comment_mode){
-		  long gcode_N = -1; // seen line number
-
-		  // Line numbers must be first in buffer
-		  if (*cmd_head == 'N') {
-
-			  // Line number met: decode the number, then move cmd_start past all spaces.
-			  gcode_N = (strtol(cmd_head+1, &cmd_start, 10));
-			  while (*cmd_start == ' ') ++cmd_start;
-
-			  // Test whether the successive lines are stamped with an increasing line number ID.
-			  if(gcode_N != gcode_LastN+1 && strncmp_P(cmd_start, PSTR("M110"), 4)) {
-				  // Line numbers not sent in succession and M110 not seen.
-				  SERIAL_ERROR_START;
-				  SERIAL_ERRORRPGM(_n("Line Number is not Last Line Number+1, Last Line: "));////MSG_ERR_LINE_NO
-				  SERIAL_ERRORLN(gcode_LastN);
-				  //Serial.println(gcode_N);
-				  FlushSerialRequestResend();
-				  serial_count = 0;
-				  return;
-			  }
-
-			  if((strchr_pointer = strchr(cmd_start, '*')) != NULL)
-			  {
-				  byte checksum = 0;
-				  char *p = cmd_head;
-				  while (p != strchr_pointer)
-					  checksum = checksum^(*p++);
-				  if (code_value_short() != (int16_t)checksum) {
-					  SERIAL_ERROR_START;
-					  SERIAL_ERRORRPGM(_n("checksum mismatch, Last Line: "));////MSG_ERR_CHECKSUM_MISMATCH
-					  SERIAL_ERRORLN(gcode_LastN);
-					  FlushSerialRequestResend();
-					  serial_count = 0;
-					  return;
-				  }
-				  // If no errors, remove the checksum and continue parsing.
-				  *strchr_pointer = 0;
-			  }
-			  else
-			  {
-				  SERIAL_ERROR_START;
-				  SERIAL_ERRORRPGM(_n("No Checksum with line number, Last Line: "));////MSG_ERR_NO_CHECKSUM
-				  SERIAL_ERRORLN(gcode_LastN);
-				  FlushSerialRequestResend();
-				  serial_count = 0;
-				  return;
-			  }
-		}
-        else
+// Handles the command received into the queue, serial_count characters at bufindw. binary_N is the
+// line number of a binary frame, -1 for a text line, which carries its own line number and checksum.
+// Returns false when the reception stops: after an error, while Stopped or when the queue is full.
+static bool get_command_line(long binary_N)
+{
+    cmdbuffer[bufindw+serial_count] = 0; // terminate string
+    char* cmd_head = cmdbuffer+bufindw; // current command pointer
+    char* cmd_start = cmd_head; // pointer past the line number (if any)
+
+    if(!comment_mode){
+        long gcode_N = binary_N; // seen line number
+
+        // Line numbers must be first in buffer
+        if (binary_N < 0 && *cmd_head == 'N') {
+
+            // Line number met: decode the number, then move cmd_start past all spaces.
+            gcode_N = (strtol(cmd_head+1, &cmd_start, 10));
+            while (*cmd_start == ' ') ++cmd_start;
+
+            // Test whether the successive lines are stamped with an increasing line number ID.
+            if(gcode_N != gcode_LastN+1 && strncmp_P(cmd_start, PSTR("M110"), 4)) {
+                // Line numbers not sent in succession and M110 not seen.
+                SERIAL_ERROR_START;
+                SERIAL_ERRORRPGM(_n("Line Number is not Last Line Number+1, Last Line: "));////MSG_ERR_LINE_NO
+                SERIAL_ERRORLN(gcode_LastN);
+                //Serial.println(gcode_N);
+                FlushSerialRequestResend();
+                serial_count = 0;
+                return false;
+            }
+
+            if((strchr_pointer = strchr(cmd_start, '*')) != NULL)
+            {
+                byte checksum = 0;
+                char *p = cmd_head;
+                while (p != strchr_pointer)
+                    checksum = checksum^(*p++);
+                if (code_value_short() != (int16_t)checksum) {
+                    SERIAL_ERROR_START;
+                    SERIAL_ERRORRPGM(_n("checksum mismatch, Last Line: "));////MSG_ERR_CHECKSUM_MISMATCH
+                    SERIAL_ERRORLN(gcode_LastN);
+                    FlushSerialRequestResend();
+                    serial_count = 0;
+                    return false;
+                }
+                // If no errors, remove the checksum and continue parsing.
+                *strchr_pointer = 0;
+            }
+            else
+            {
+                SERIAL_ERROR_START;
+                SERIAL_ERRORRPGM(_n("No Checksum with line number, Last Line: "));////MSG_ERR_NO_CHECKSUM
+                SERIAL_ERRORLN(gcode_LastN);
+                FlushSerialRequestResend();
+                serial_count = 0;
+                return false;
+            }
+        }
+        else if (binary_N < 0)
         {
             // move cmd_start past all spaces
             while (*cmd_start == ' ') ++cmd_start;
@@ -467,13 +539,23 @@ void get_command()
                 SERIAL_ERRORLN(gcode_LastN);
                 FlushSerialRequestResend();
                 serial_count = 0;
-                return;
+                return false;
             }
         }
+        else if (gcode_N != gcode_LastN+1 && strncmp_P(cmd_start, PSTR("M110"), 4))
+        {
+            // A binary frame, checked by its CRC, out of sequence.
+            SERIAL_ERROR_START;
+            SERIAL_ERRORRPGM(_n("Line Number is not Last Line Number+1, Last Line: "));////MSG_ERR_LINE_NO
+            SERIAL_ERRORLN(gcode_LastN);
+            FlushSerialRequestResend();
+            serial_count = 0;
+            return false;
+        }
 
         // Handle KILL early, even when Stopped
         if(strcmp_P(cmd_start, PSTR("M112")) == 0)
-          kill(MSG_M112_KILL);
+            kill(MSG_M112_KILL);
 
         // Bypass Stopped for some commands
         bool allow_when_stopped = false;
@@ -481,7 +563,7 @@ void get_command()
             allow_when_stopped = true;
 
         // Handle the USB timer
-        if ((*cmd_start == 'G') && (GetPrinterState() != PrinterState::IsSDPrinting)) {
+        if ((*cmd_start == 'G' || *cmd_start == MOVE_RECORD_MARKER) && (GetPrinterState() != PrinterState::IsSDPrinting)) {
             usb_timer.start();
             SetPrinterState(PrinterState::IsHostPrinting); //set printer state busy printing to hide LCD menu while USB printing
             eeprom_update_byte_notify((uint8_t*)EEPROM_UVLO, PowerPanic::NO_PENDING_RECOVERY);
@@ -495,13 +577,21 @@ void get_command()
             // line number, a request for resend will happen (if necessary), ensuring we don't skip
             // commands whenever Stopped is cleared and processing resumes.
             serial_count = 0;
-            return;
+            return false;
         }
 
+#ifdef ENABLE_BINARY_TRANSPORT
+        // Switch the transport when the command is received, the bytes which follow are read in the new mode.
+        if (strncmp_P(cmd_start, PSTR("M930 S"), 6) == 0)
+            bt_enable(cmd_start[6] == '1');
+#endif
+
         // Command is complete: store the current line into buffer, move to the next line.
 
-		// Store type of entry
-        cmdbuffer[bufindw] = gcode_N >= 0 ? CMDBUFFER_CURRENT_TYPE_USB_WITH_LINENR : CMDBUFFER_CURRENT_TYPE_USB;
+        // Store the descriptor, the command stays in place (past the line number, up to the checksum).
+        CmdQueueEntry &entry = cmdqueue_back();
+        entry.type = gcode_N >= 0 ? CMDBUFFER_CURRENT_TYPE_USB_WITH_LINENR : CMDBUFFER_CURRENT_TYPE_USB;
+        entry.cmd = cmd_start - cmdbuffer;
 
 #ifdef CMDBUFFER_DEBUG
         SERIAL_ECHO_START;
@@ -510,17 +600,12 @@ void get_command()
         SERIAL_ECHOLNPGM("");
 #endif /* CMDBUFFER_DEBUG */
 
-        // Store the command itself (without line number or checksum)
-        size_t cmd_len;
-        if (cmd_head == cmd_start)
-            cmd_len = strlen(cmd_start) + 1;
-        else {
-            // strip the line number
-            cmd_len = 0;
-            do { cmd_head[cmd_len] = cmd_start[cmd_len]; }
-            while (cmd_head[cmd_len++]);
-        }
-        bufindw += cmd_len + CMDHDRSIZE;
+        // The characters following the command are free again.
+#ifdef CMDQUEUE_PREFETCH_MOVES
+        bufindw = entry.cmd + cmdqueue_prefetch(cmd_start, strlen(cmd_start)) + 1;
+#else
+        bufindw = entry.cmd + strlen(cmd_start) + 1;
+#endif
         if (bufindw == sizeof(cmdbuffer))
             bufindw = 0;
         ++ buflen;
@@ -534,26 +619,120 @@ void get_command()
         SERIAL_ECHO(buflen);
         SERIAL_ECHOLNPGM("");
 #endif /* CMDBUFFER_DEBUG */
-      } // end of 'not comment mode'
-      serial_count = 0; //clear buffer
-      // Don't call cmdqueue_could_enqueue_back if there are no characters waiting
-      // in the queue, as this function will reserve the memory.
-      if (MYSERIAL.available() == 0 || ! cmdqueue_could_enqueue_back(MAX_CMD_SIZE-1))
+    } // end of 'not comment mode'
+    serial_count = 0; //clear buffer
+    // Don't call cmdqueue_could_enqueue_back if there are no characters waiting
+    // in the queue, as this function will reserve the memory.
+    return MYSERIAL.available() != 0 && cmdqueue_could_enqueue_back(MAX_CMD_SIZE-1);
+}
+
+void get_command()
+{
+    // Test and reserve space for the new command string.
+    if (! cmdqueue_could_enqueue_back(MAX_CMD_SIZE - 1))
+      return;
+
+	if (MYSERIAL.overflowed()) //characters were dropped by the receive interrupt, the line being received is likely incomplete
+	{
+		SERIAL_ECHOLNPGM("Full RX Buffer");
+#ifdef FEED_TELEMETRY
+		++telemetry.rx_full;
+#endif //FEED_TELEMETRY
+	}
+
+  // start of serial line processing loop
+  // The received characters are processed in place, one contiguous block of the receive ring at a time.
+  // They are released at the end of each line, the ones following a line which does not fit into the
+  // command queue stay in the ring.
+  const unsigned char *rx;
+  rx_index_t rx_count;
+  while ((!saved_printing || printingIsPaused()) && !cmdqueue_serial_disabled && (rx_count = MYSERIAL.peekBlock(rx)) > 0) {  //is print is saved (crash detection or filament detection), dont process data from serial line
+
+    serialTimeoutTimer.start();
+
+    rx_index_t rx_used = 0;
+    while (rx_used < rx_count) {
+#ifdef ENABLE_BINARY_TRANSPORT
+      if (bt_enabled) {
+        // The command of a binary frame is stored in place as well, handled once the frame is complete.
+        uint16_t consumed;
+        const uint8_t status = bt_receive(rx + rx_used, rx_count - rx_used, consumed, cmdbuffer + bufindw, serial_count);
+        rx_used += consumed;
+        if (status == BT_RX_PENDING)
+          continue;
+        MYSERIAL.skip(rx_used);
+        rx += rx_used;
+        rx_count -= rx_used;
+        rx_used = 0;
+        if (status == BT_RX_ERROR) {
+          SERIAL_ERROR_START;
+          SERIAL_ERRORRPGM(_n("checksum mismatch, Last Line: "));////MSG_ERR_CHECKSUM_MISMATCH
+          SERIAL_ERRORLN(gcode_LastN);
+          FlushSerialRequestResend();
+          serial_count = 0;
+          return;
+        }
+        comment_mode = false;
+        // The line number nearest to the expected one with the low 16 bits of the frame.
+        if (!get_command_line(gcode_LastN + 1 + int16_t(bt_frame_n() - uint16_t(gcode_LastN + 1))))
           return;
+        continue;
+      }
+#endif
+#ifdef ENABLE_MEATPACK
+    // MeatPack Changes
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+      // Decode straight into the line being received, up to its end. The characters are then stored
+      // in place below. The location of the terminator takes the character ending an overlong line.
+      char *const decoded = cmdbuffer + bufindw + serial_count;
+      uint16_t consumed;
+      const uint8_t char_count = mp_decode_line(rx + rx_used, rx_count - rx_used, consumed, decoded, MAX_CMD_SIZE - serial_count);
+      rx_used += consumed;
+      // Note -- Paired bracket in preproc switch below
+      for (uint8_t i = 0; i < char_count; ++i) { char serial_char = decoded[i];
+#else
+      { char serial_char = rx[rx_used++];
+#endif
+
+    if (serial_char < 0)
+        // Ignore extended ASCII characters. These characters have no meaning in the G-code apart from the file names
+        // and Marlin does not support such file names anyway.
+        // Serial characters with a highest bit set to 1 are generated when the USB cable is unplugged, leading
+        // to a hang-up of the print process from an SD card.
+        continue;
+    if(serial_char == '\n' ||
+       serial_char == '\r' ||
+       serial_count >= (MAX_CMD_SIZE - 1) )
+    {
+      // Release the characters of the line before handling it, the errors flush the receive ring.
+      MYSERIAL.skip(rx_used);
+      rx += rx_used;
+      rx_count -= rx_used;
+      rx_used = 0;
+
+      if(!serial_count) { //if empty line
+        comment_mode = false; //for new command
+        continue;
+      }
+      if (!get_command_line(-1))
+        return;
     } // end of "end of line" processing
     else {
       // Not an "end of line" symbol. Store the new character into a buffer.
       if(serial_char == ';') comment_mode = true;
-      if(!comment_mode) cmdbuffer[bufindw+CMDHDRSIZE+serial_count++] = serial_char;
+      if(!comment_mode) cmdbuffer[bufindw+serial_count++] = serial_char;
+    }
+      } // Paired bracket of the preproc switch above
     }
-    #ifdef ENABLE_MEATPACK
-     }
-    #endif
+    MYSERIAL.skip(rx_used);
   } // end of serial line processing loop
 
     if (serial_count > 0 && serialTimeoutTimer.expired(farm_mode ? 800 : 2000)) {
         comment_mode = false;
         serial_count = 0;
+#ifdef ENABLE_BINARY_TRANSPORT
+        bt_enable(bt_enabled); // drop the frame being received
+#endif
         SERIAL_ECHOLNPGM("RX timeout");
         return;
     }
@@ -571,14 +750,6 @@ void get_command()
 
   static bool stop_buffering=false;
   if(buflen==0) stop_buffering=false;
-  union {
-    struct {
-        char lo;
-        char hi;
-    } lohi;
-    uint16_t value;
-  } sd_count;
-  sd_count.value = 0;
   // Reads whole lines from the SD card. Never leaves a half-filled line in the cmdbuffer.
   while( !card.eof() && !stop_buffering) {
     int16_t n=card.getFilteredGcodeChar();
@@ -595,31 +766,32 @@ void get_command()
       if(!serial_count)
       {
         // This is either an empty line, or a line with just a comment.
-        // Continue to the following line, and continue accumulating the number of bytes
-        // read from the sdcard into sd_count,
-        // so that the length of the already read empty lines and comments will be added
+        // Continue to the following line, the number of bytes read from the sdcard
+        // is counted from sdpos_atomic, so that the length of the already read empty lines and comments will be added
         // to the following non-empty line.
         return; // prevent cycling indefinitely - let manage_heaters do their job
       }
-      // The new command buffer could be updated non-atomically, because it is not yet considered
+      // The new descriptor could be updated non-atomically, because it is not yet considered
       // to be inside the active queue.
-      sd_count.value = card.get_sdpos() - sdpos_atomic;
-      cmdbuffer[bufindw] = CMDBUFFER_CURRENT_TYPE_SDCARD;
-      cmdbuffer[bufindw+1] = sd_count.lohi.lo;
-      cmdbuffer[bufindw+2] = sd_count.lohi.hi;
-      cmdbuffer[bufindw+serial_count+CMDHDRSIZE] = 0; //terminate string
-      // Calculate the length before disabling the interrupts.
-      uint8_t len = strlen(cmdbuffer+bufindw+CMDHDRSIZE) + (1 + CMDHDRSIZE);
+      CmdQueueEntry &entry = cmdqueue_back();
+      entry.type = CMDBUFFER_CURRENT_TYPE_SDCARD;
+      entry.cmd = bufindw;
+      entry.sdlen = card.get_sdpos() - sdpos_atomic;
+      cmdbuffer[bufindw+serial_count] = 0; //terminate string
+#ifdef CMDQUEUE_PREFETCH_MOVES
+      const size_t len = cmdqueue_prefetch(cmdbuffer + bufindw, serial_count) + 1;
+#else
+      const size_t len = serial_count + 1;
+#endif
 
 //      SERIAL_ECHOPGM("SD cmd(");
-//      MYSERIAL.print(sd_count.value, DEC);
+//      MYSERIAL.print(entry.sdlen, DEC);
 //      SERIAL_ECHOPGM(") ");
-//      SERIAL_ECHOLN(cmdbuffer+bufindw+CMDHDRSIZE);
+//      SERIAL_ECHOLN(cmdbuffer+bufindw);
 //      SERIAL_ECHOPGM("cmdbuffer:");
 //      MYSERIAL.print(cmdbuffer);
 //      SERIAL_ECHOPGM("buflen:");
 //      MYSERIAL.print(buflen+1);
-      sd_count.value = 0;
 
       cli();
       // This block locks the interrupts globally for 3.56 us,
@@ -627,6 +799,7 @@ void get_command()
       // This blocking is safe in the context of a 10kHz stepper driver interrupt
       // or a 115200 Bd serial line receive interrupt, which will not trigger faster than 12kHz.
       ++ buflen;
+      cmdqueue_sdlen += entry.sdlen;
       bufindw += len;
       sdpos_atomic = card.get_sdpos();
       if (bufindw == sizeof(cmdbuffer))
@@ -645,7 +818,7 @@ void get_command()
     else
     {
         // there are no comments coming from the filtered file
-        cmdbuffer[bufindw+CMDHDRSIZE+serial_count++] = serial_char;
+        cmdbuffer[bufindw+serial_count++] = serial_char;
     }
   }
   if(card.eof())
@@ -682,35 +855,194 @@ void get_command()
   #endif //SDSUPPORT
 }
 
-uint16_t cmdqueue_calc_sd_length()
+void code_words_parse()
+{
+    const char *cmd = CMDBUFFER_CURRENT_STRING;
+    memset(code_words, 0, sizeof(code_words));
+    for (uint8_t i = 0; cmd[i]; ++ i) {
+        const uint8_t word = cmd[i] - 'A';
+        if (word < sizeof(code_words) && ! code_words[word])
+            code_words[word] = i + 1;
+    }
+    code_words_cmd = cmd;
+}
+
+bool code_seen(char code)
 {
-    if (buflen == 0)
-        return 0;
-    union {
-        struct {
-            char lo;
-            char hi;
-        } lohi;
-        uint16_t value;
-    } sdlen_single;
-    uint16_t sdlen = 0;
-    for (size_t _buflen = buflen, _bufindr = bufindr;;) {
-        if (cmdbuffer[_bufindr] == CMDBUFFER_CURRENT_TYPE_SDCARD) {
-            sdlen_single.lohi.lo = cmdbuffer[_bufindr + 1];
-            sdlen_single.lohi.hi = cmdbuffer[_bufindr + 2];
-            sdlen += sdlen_single.value;
+    const uint8_t word = code - 'A';
+    if (word >= sizeof(code_words))
+        return (strchr_pointer = strchr(CMDBUFFER_CURRENT_STRING, code)) != NULL;
+    // The command on the top of the queue changed without being dequeued (a command was pushed
+    // to the front while processing another one).
+    if (code_words_cmd != CMDBUFFER_CURRENT_STRING)
+        code_words_parse();
+    const uint8_t offset = code_words[word];
+    strchr_pointer = offset ? (char*)code_words_cmd + offset - 1 : NULL;
+    return offset;
+}
+
+// Exact powers of ten of a float, for the fractional digits of code_move_words().
+static const float pow10_decimals[] PROGMEM = { 1.f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f };
+
+// The words of the plain G0/G1 move in the text p, see code_move_words().
+static uint8_t move_text_words(const char *p, float values[NUM_AXIS + 1])
+{
+    if (p[0] != 'G' || (p[1] != '0' && p[1] != '1') || (p[2] != ' ' && p[2] != 0))
+        return MOVE_WORDS_INVALID;
+    uint8_t seen = 0;
+    for (p += 2;;) {
+        uint8_t word;
+        switch (*p++) {
+        case ' ': continue;
+        case 0: return seen;
+        case 'X': word = X_AXIS; break;
+        case 'Y': word = Y_AXIS; break;
+        case 'Z': word = Z_AXIS; break;
+        case 'E': word = E_AXIS; break;
+        case 'F': word = MOVE_WORD_F; break;
+        default: return MOVE_WORDS_INVALID;
+        }
+
+        // Up to 9 significant digits, the float keeps 7 of them. Further fractional digits are
+        // below its resolution and dropped.
+        const bool negative = (*p == '-');
+        if (negative || *p == '+')
+            ++p;
+        uint32_t mantissa = 0;
+        uint8_t digits = 0;
+        int8_t decimals = -1;
+        for (;; ++p) {
+            const uint8_t digit = *p - '0';
+            if (digit < 10) {
+                if (digits < 9 && decimals < 9) {
+                    mantissa = mantissa * 10 + digit;
+                    if (mantissa)
+                        ++digits;
+                    if (decimals >= 0)
+                        ++decimals;
+                } else if (decimals < 0)
+                    return MOVE_WORDS_INVALID;
+            } else if (*p == '.' && decimals < 0)
+                decimals = 0;
+            else
+                break;
         }
-        if (-- _buflen == 0)
-            break;
-        // First skip the current command ID and iterate up to the end of the string.
-        for (_bufindr += CMDHDRSIZE; cmdbuffer[_bufindr] != 0; ++ _bufindr) ;
-        // Second, skip the end of string null character and iterate until a nonzero command ID is found.
-        for (++ _bufindr; _bufindr < sizeof(cmdbuffer) && cmdbuffer[_bufindr] == 0; ++ _bufindr) ;
-        // If the end of the buffer was empty,
-        if (_bufindr == sizeof(cmdbuffer)) {
-            // skip to the start and find the nonzero command.
-            for (_bufindr = 0; cmdbuffer[_bufindr] == 0; ++ _bufindr) ;
+        // strtod() would read a following E as the exponent, leave that to the generic parser.
+        if (*p == 'E')
+            return MOVE_WORDS_INVALID;
+
+        // The first occurrence of a word counts, like for code_seen().
+        if (seen & _BV(word))
+            continue;
+        seen |= _BV(word);
+        // Up to 7 digits both the mantissa and the power of ten are exact, the division rounds once.
+        float value = mantissa;
+        if (decimals > 0)
+            value /= pgm_read_float(&pow10_decimals[decimals]);
+        values[word] = negative ? -value : value;
+    }
+}
+
+uint8_t code_move_words(float values[NUM_AXIS + 1])
+{
+    const char *p = CMDBUFFER_CURRENT_STRING;
+    if (p[0] == MOVE_RECORD_MARKER)
+        return move_record_words(p, values);
+    return move_text_words(p, values);
+}
+
+void move_record_value(char *record, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // 7 bit groups from the lowest one.
+    for (uint8_t i = 0; i < MOVE_RECORD_WORD_SIZE; ++i, bits >>= 7)
+        record[i] = char(0x80 | (bits & 0x7f));
+}
+
+uint8_t move_record_words(const char *record, float values[NUM_AXIS + 1])
+{
+    const uint8_t seen = record[1] & 0x7f;
+    record += 2;
+    for (uint8_t word = 0; word <= MOVE_WORD_F; ++word) {
+        if (!(seen & _BV(word)))
+            continue;
+        uint32_t bits = 0;
+        for (uint8_t i = MOVE_RECORD_WORD_SIZE; i--;)
+            bits = (bits << 7) | (record[i] & 0x7f);
+        record += MOVE_RECORD_WORD_SIZE;
+        memcpy(&values[word], &bits, sizeof(bits));
+    }
+    return seen;
+}
+
+size_t move_record_from_text(char *cmd, size_t len)
+{
+    float values[NUM_AXIS + 1];
+    const uint8_t seen = move_text_words(cmd, values);
+    if (seen == MOVE_WORDS_INVALID)
+        return len;
+    uint8_t words = 0;
+    for (uint8_t mask = seen; mask; mask &= mask - 1)
+        ++words;
+    const size_t record_len = 2 + words * MOVE_RECORD_WORD_SIZE;
+    if (record_len > len)
+        return len;
+    cmd[0] = MOVE_RECORD_MARKER;
+    cmd[1] = char(0x80 | seen);
+    char *p = cmd + 2;
+    for (uint8_t word = 0; word <= MOVE_WORD_F; ++word)
+        if (seen & _BV(word)) {
+            move_record_value(p, values[word]);
+            p += MOVE_RECORD_WORD_SIZE;
+        }
+    *p = 0;
+    return record_len;
+}
+
+// The letters of the words of a move, in the order of code_move_words().
+static const char move_word_letters[] PROGMEM = "XYZEF";
+
+size_t move_record_to_text(const char *record, char *text)
+{
+    float values[NUM_AXIS + 1];
+    const uint8_t seen = move_record_words(record, values);
+    char *p = text;
+    *p++ = 'G';
+    *p++ = '1';
+    for (uint8_t word = 0; word <= MOVE_WORD_F; ++word) {
+        if (!(seen & _BV(word)))
+            continue;
+        *p++ = ' ';
+        *p++ = pgm_read_byte(&move_word_letters[word]);
+        float value = values[word];
+        if (value < 0) {
+            *p++ = '-';
+            value = -value;
+        }
+        uint32_t integer = uint32_t(value);
+        uint32_t fraction = uint32_t((value - integer) * 100000.f + 0.5f);
+        if (fraction >= 100000) {
+            ++integer;
+            fraction -= 100000;
+        }
+        char digits[10];
+        uint8_t n = 0;
+        do {
+            digits[n++] = char('0' + integer % 10);
+            integer /= 10;
+        } while (integer);
+        while (n)
+            *p++ = digits[--n];
+        if (fraction) {
+            // Five digits with the leading zeros, then the trailing zeros dropped.
+            *p++ = '.';
+            for (uint32_t digit = 10000; digit && fraction; digit /= 10) {
+                *p++ = char('0' + fraction / digit);
+                fraction %= digit;
+            }
         }
     }
-    return sdlen;
+    *p = 0;
+    return p - text;
 }
@@ -3,10 +3,13 @@
 
 #include "Marlin.h"
 
-// String circular buffer. Commands may be pushed to the buffer from both sides:
-// Chained commands will be pushed to the front, interactive (from LCD menu)
+// Command queue: a ring of descriptors of the commands, which point to the strings stored in the
+// circular character buffer cmdbuffer in the order of the queue. Commands may be pushed to the queue
+// from both sides: Chained commands will be pushed to the front, interactive (from LCD menu)
 // and printing commands (from serial line or from SD card) are pushed to the tail.
-// First character of each entry indicates the type of the entry:
+// The lines from the serial line and from the SD card are received in place, the descriptor points
+// past the line number.
+// Type of an entry:
 #define CMDBUFFER_CURRENT_TYPE_UNKNOWN  0
 // Command in cmdbuffer was sent over USB.
 #define CMDBUFFER_CURRENT_TYPE_USB      1
@@ -28,17 +31,33 @@
 // which are pushed to the front of the queue?
 // Maximum 5 commands of max length 20 + null terminator.
 #define CMDBUFFER_RESERVE_FRONT       (5*21)
+#define CMDQUEUE_RESERVE_FRONT        5
+
+static_assert(!(CMDQUEUE_SIZE & (CMDQUEUE_SIZE - 1)) && CMDQUEUE_SIZE <= 128, "CMDQUEUE_SIZE has to be a power of two up to 128");
+static_assert(CMDQUEUE_SIZE > CMDQUEUE_RESERVE_FRONT, "CMDQUEUE_SIZE has to leave descriptors to the tail");
+
+struct CmdQueueEntry {
+    uint16_t cmd;   // offset of the string in cmdbuffer
+    uint16_t sdlen; // SD card bytes of a CMDBUFFER_CURRENT_TYPE_SDCARD command including its preceding comments
+    uint8_t type;   // CMDBUFFER_CURRENT_TYPE_*
+};
 
 extern char cmdbuffer[BUFSIZE * (MAX_CMD_SIZE + 1) + CMDBUFFER_RESERVE_FRONT];
-extern size_t bufindr;
+extern CmdQueueEntry cmdqueue[CMDQUEUE_SIZE];
+// Index of the descriptor at the front of the queue.
+extern uint8_t bufindr;
 extern int buflen;
+// Sum of the SD card lengths of the CMDBUFFER_CURRENT_TYPE_SDCARD commands in the queue.
+extern uint16_t cmdqueue_sdlen;
 extern bool cmdbuffer_front_already_processed;
 extern bool cmdqueue_serial_disabled;
 
+// Descriptor of a command, which is to be executed right now.
+#define CMDBUFFER_CURRENT_ENTRY  (cmdqueue[bufindr])
 // Type of a command, which is to be executed right now.
-#define CMDBUFFER_CURRENT_TYPE   (cmdbuffer[bufindr])
+#define CMDBUFFER_CURRENT_TYPE   (CMDBUFFER_CURRENT_ENTRY.type)
 // String of a command, which is to be executed right now.
-#define CMDBUFFER_CURRENT_STRING (cmdbuffer+bufindr+CMDHDRSIZE)
+#define CMDBUFFER_CURRENT_STRING (cmdbuffer + CMDBUFFER_CURRENT_ENTRY.cmd)
 
 // Enable debugging of the command buffer.
 // Debugging information will be sent to serial line.
@@ -55,7 +74,7 @@ extern long gcode_LastN;
 extern bool cmdqueue_pop_front();
 extern void cmdqueue_reset();
 #ifdef CMDBUFFER_DEBUG
-extern void cmdqueue_dump_to_serial_single_line(int nr, const char *p);
+extern void cmdqueue_dump_to_serial_single_line(int nr, const CmdQueueEntry &entry);
 extern void cmdqueue_dump_to_serial();
 #endif /* CMDBUFFER_DEBUG */
 extern bool cmd_buffer_empty();
@@ -67,7 +86,8 @@ extern void enquecommand(const char *cmd, bool from_progmem = false);
 extern void enquecommand_front(const char *cmd, bool from_progmem = false);
 extern void repeatcommand_front();
 extern void get_command();
-extern uint16_t cmdqueue_calc_sd_length();
+// Sum of the SD card lengths of the commands in the queue, see cmdqueue_sdlen.
+static inline uint16_t cmdqueue_calc_sd_length() { return cmdqueue_sdlen; }
 
 
 #if defined(__cplusplus)
@@ -78,8 +98,52 @@ extern "C" {
 }
 #endif
 
-// Return True if a character was found
-static inline bool    code_seen(char code) { return (strchr_pointer = strchr(CMDBUFFER_CURRENT_STRING, code)) != NULL; }
+// Index the first occurrence of each of the letters A-Z in the current command. Called once when
+// the command is dequeued for processing, code_seen() of a letter is then a table lookup instead of
+// a scan of the whole command.
+extern void code_words_parse();
+
+// Return True if a character was found, strchr_pointer points to its first occurrence.
+extern bool code_seen(char code);
+
+// Words of a G0/G1 move returned by code_move_words(): X Y Z E at their axis index, then F.
+#define MOVE_WORD_F NUM_AXIS
+#define MOVE_WORDS_INVALID 0xff
+
+// Parse the current command as a plain G0/G1 move ("G1 X12.5 Y.8 E.0312 F1800") in a single scan,
+// with fixed point numbers. Returns the mask of the words seen (1 << axis, 1 << MOVE_WORD_F) and
+// stores their values, or MOVE_WORDS_INVALID if the command has to go through the generic parser
+// (another command, other words, exponents or integer parts longer than 9 digits).
+// A move record (MOVE_RECORD_MARKER) returns the words stored in it.
+extern uint8_t code_move_words(float values[NUM_AXIS + 1]);
+
+// A G0/G1 move stored in the queue with its words already parsed: MOVE_RECORD_MARKER, 0x80 | mask
+// of the words, then the float value of each word in MOVE_RECORD_WORD_SIZE characters of 7 bits
+// with the highest bit set, so that the record is a NUL free string. Stored by the binary transport
+// and by the prefetch of the moves read as text (CMDQUEUE_PREFETCH_MOVES).
+#define MOVE_RECORD_MARKER '\x7f'
+#define MOVE_RECORD_WORD_SIZE 5
+
+// Store the bits of value at record, MOVE_RECORD_WORD_SIZE characters.
+extern void move_record_value(char *record, float value);
+// Words of the move record, in the form of code_move_words().
+extern uint8_t move_record_words(const char *record, float values[NUM_AXIS + 1]);
+// Replace the plain G0/G1 move in the text cmd of len characters by its move record, if the record
+// is not longer. Returns the length of the command.
+extern size_t move_record_from_text(char *cmd, size_t len);
+// Write the move record as a G1 text command with up to 5 decimals, the integer parts below 2^32.
+// Returns the length of the text, the buffer holds MOVE_RECORD_TEXT_SIZE characters.
+#define MOVE_RECORD_TEXT_SIZE (2 + (NUM_AXIS + 1) * 19 + 1)
+extern size_t move_record_to_text(const char *record, char *text);
+
+// Process the command at the front of the queue, or write it to the file being saved by M28, then
+// plan the moves prefetched behind it. Called by loop() with a command in the queue.
+extern void cmdqueue_process_front();
+
+#ifdef CMDQUEUE_PREFETCH_MOVES
+// Is the command at the front a move record, to be planned right after the command processed?
+static inline bool cmdqueue_front_prefetched() { return buflen && CMDBUFFER_CURRENT_STRING[0] == MOVE_RECORD_MARKER; }
+#endif
 static inline bool    code_seen_P(const char *code_PROGMEM) { return (strchr_pointer = strstr_P(CMDBUFFER_CURRENT_STRING, code_PROGMEM)) != NULL; }
 static inline float   code_value()      { return strtod_noE(strchr_pointer+1, NULL);}
 static inline long    code_value_long()    { return strtol(strchr_pointer+1, NULL, 10); }
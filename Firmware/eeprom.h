@@ -44,7 +44,7 @@ typedef struct
 // Otherwise it would move following items.
 #define EEPROM_SHEETS_SIZEOF 89
 
-#ifdef __cplusplus
+#if defined(__cplusplus) && defined(__AVR__) // host builds don't share the packed AVR layout
 static_assert(sizeof(Sheets) == EEPROM_SHEETS_SIZEOF, "Sizeof(Sheets) is not EEPROM_SHEETS_SIZEOF.");
 #endif
 /** @defgroup eeprom_table EEPROM Table
@@ -0,0 +1,76 @@
+// fastdiv: exact divisions of the linear advance scheduling without the 16/32 bit division routines
+//
+// The stepper interrupt spreads the advance ticks due during a main timer period evenly over it
+// (advance_spread() in stepper.cpp). This needs the number of advance periods, which fit into the
+// accumulated timer error, and the main period divided by the number of ticks. Both used to be a
+// subtraction loop and a call of __udivmodhi4, whose run time grows with the quotient. Here the
+// quotients are estimated by a multiplication with a reciprocal and corrected by a single compare:
+// the reciprocals of small divisors are taken from a table in the program memory, the reciprocal
+// of the advance rate is calculated at most once per block. It is not stored in block_t, which
+// would no longer fit BLOCK_BUFFER_RAM.
+
+#pragma once
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+// Largest divisor with a tabulated reciprocal, larger ones fall back to the division.
+#define FASTDIV_TABLE_MAX 16
+
+// The advance rate reciprocal is 2^FASTDIV_RATE_SHIFT / rate, which fits 16 bits for rates of at
+// least 2^(FASTDIV_RATE_SHIFT - 16) ticks. The planner limits the advance to MAX_STEP_FREQUENCY
+// single steps or 4 steps per advance tick, which is at least 200 ticks.
+#define FASTDIV_RATE_SHIFT 23
+#define FASTDIV_RATE_MIN (1U << (FASTDIV_RATE_SHIFT - 16))
+
+template <uint8_t N>
+struct fastdiv_table_t
+{
+    uint16_t inv[N + 1];
+};
+
+// Entry d is 2^16 / d rounded up, the entries 0 and 1 are unused.
+template <uint8_t N>
+constexpr fastdiv_table_t<N> fastdiv_table_generate()
+{
+    fastdiv_table_t<N> table {};
+    for (uint8_t d = 2; d <= N; ++d)
+        table.inv[d] = uint16_t((0x10000UL + d - 1) / d);
+    return table;
+}
+
+static constexpr fastdiv_table_t<FASTDIV_TABLE_MAX> fastdiv_table PROGMEM = fastdiv_table_generate<FASTDIV_TABLE_MAX>();
+
+// q / d for a small divisor d > 0, rounded down.
+static inline uint16_t fastdiv(uint16_t q, uint16_t d)
+{
+    if (d <= 4 && d != 3)
+        return q >> (d / 2);
+    if (d > FASTDIV_TABLE_MAX)
+        return q / d;
+    // The rounded up reciprocal overestimates the quotient by at most one.
+    uint16_t r = (uint32_t(q) * pgm_read_word(&fastdiv_table.inv[d])) >> 16;
+    if (uint32_t(r) * d > q)
+        --r;
+    return r;
+}
+
+// Reciprocal of an advance rate for fastdiv_rate().
+static inline uint16_t fastdiv_rate_inv(uint16_t rate)
+{
+    return (rate < FASTDIV_RATE_MIN) ? UINT16_MAX : uint16_t((1UL << FASTDIV_RATE_SHIFT) / rate);
+}
+
+// Number of whole advance periods rate in err, which is subtracted from err.
+// err has to stay below 2^18, that is 3 16bit timer periods with some margin.
+static inline uint16_t fastdiv_rate(uint32_t &err, uint16_t rate, uint16_t rate_inv)
+{
+    // The truncated reciprocal underestimates the quotient by at most one.
+    uint16_t ticks = (uint32_t(uint16_t(err >> 2)) * rate_inv) >> (FASTDIV_RATE_SHIFT - 2);
+    err -= uint32_t(ticks) * rate;
+    while (err >= rate) {
+        ++ticks;
+        err -= rate;
+    }
+    return ticks;
+}
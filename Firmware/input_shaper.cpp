@@ -0,0 +1,111 @@
+#include "input_shaper.h"
+#include "Marlin.h"
+#include "stepper.h"
+#include "ConfigurationStore.h"
+#include "speed_lookuptable.h"
+#include <math.h>
+
+#ifdef INPUT_SHAPING
+
+// Duration of a slot of the step history (s).
+static const float shaper_slot_time = float(1UL << SHAPING_SLOT_SHIFT) / SPEED_TABLE_TIMER_FREQ;
+
+
+bool shaper_impulses(uint8_t type, float freq, float zeta, shaper_impulses_t &imp)
+{
+    if (!(freq > 0) || !(zeta >= 0 && zeta < 1))
+        return false;
+
+    const float df = sqrt(1 - zeta * zeta);
+    const float td = 1 / (freq * df);
+    float k, sum;
+    switch(type)
+    {
+    case SHAPER_ZV:
+        k = exp(-zeta * M_PI / df);
+        imp.count = 2;
+        imp.amp[0] = 1;
+        imp.amp[1] = k;
+        imp.time[1] = td / 2;
+        break;
+    case SHAPER_ZVD:
+        k = exp(-zeta * M_PI / df);
+        imp.count = 3;
+        imp.amp[0] = 1;
+        imp.amp[1] = 2 * k;
+        imp.amp[2] = k * k;
+        imp.time[1] = td / 2;
+        imp.time[2] = td;
+        break;
+    case SHAPER_MZV:
+        k = exp(-0.75f * zeta * M_PI / df);
+        imp.count = 3;
+        imp.amp[0] = 1 - M_SQRT1_2;
+        imp.amp[1] = (M_SQRT2 - 1) * k;
+        imp.amp[2] = (1 - M_SQRT1_2) * k * k;
+        imp.time[1] = 0.375f * td;
+        imp.time[2] = 0.75f * td;
+        break;
+    default:
+        return false;
+    }
+
+    imp.time[0] = 0;
+    sum = 0;
+    for (uint8_t i = 0; i < imp.count; ++i)
+        sum += imp.amp[i];
+    for (uint8_t i = 0; i < imp.count; ++i)
+        imp.amp[i] /= sum;
+    return true;
+}
+
+
+bool shaper_params(uint8_t type, float freq, float zeta, shaper_params_t &params)
+{
+    shaper_impulses_t imp;
+    if (!shaper_impulses(type, freq, zeta, imp))
+        return false;
+
+    params.amp0 = 256;
+    for (uint8_t i = 0; i < SHAPER_IMPULSES_MAX - 1; ++i)
+    {
+        params.amp[i] = 0;
+        params.slots[i] = 0;
+        params.frac[i] = 0;
+    }
+    for (uint8_t i = 1; i < imp.count; ++i)
+    {
+        // The delayed slot and the one before it are read from the history, the current slot
+        // is not complete yet.
+        const float delay = imp.time[i] / shaper_slot_time;
+        if (!(delay >= 1 && delay < SHAPING_SLOTS - 2))
+            return false;
+        uint16_t slots = delay;
+        uint16_t frac = lround((delay - slots) * 256);
+        if (frac == 256)
+        {
+            ++slots;
+            frac = 0;
+        }
+        params.slots[i - 1] = slots;
+        params.frac[i - 1] = frac;
+        params.amp[i - 1] = lround(imp.amp[i] * 256);
+        params.amp0 -= params.amp[i - 1];
+    }
+    return true;
+}
+
+
+void shaper_update()
+{
+    for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis)
+    {
+        shaper_params_t params;
+        if (cs.shaping_freq[axis] != 0 && shaper_params(cs.shaping_type[axis], cs.shaping_freq[axis], cs.shaping_zeta[axis], params))
+            st_set_shaper(axis, &params);
+        else
+            st_set_shaper(axis, NULL);
+    }
+}
+
+#endif //INPUT_SHAPING
@@ -0,0 +1,62 @@
+// input_shaper: input shaping of the X and Y step streams (M593)
+//
+// A shaper convolves the commanded motion of an axis with a short sequence of impulses, whose
+// amplitudes sum to one. The residual vibration of a resonance at the shaper frequency cancels:
+//
+//   K = exp(-zeta pi / sqrt(1 - zeta^2)), Td = 1 / (f sqrt(1 - zeta^2))
+//
+//   ZV   [1, K] / (1 + K)                       at [0, Td/2]
+//   ZVD  [1, 2K, K^2] / (1 + K)^2               at [0, Td/2, Td]
+//   MZV  [1 - 1/sqrt(2), (sqrt(2) - 1) K, (1 - 1/sqrt(2)) K^2], normalized,
+//        with K = exp(-0.75 zeta pi / sqrt(1 - zeta^2)), at [0, 3/8 Td, 3/4 Td]
+//
+// The stepper interrupt applies the first impulse to the Bresenham steps immediately. For the
+// delayed impulses, it keeps the number of steps of the last SHAPING_SLOTS slots of
+// 2^SHAPING_SLOT_SHIFT timer ticks. At the start of a slot, the steps of the delayed slots are
+// summed with the impulse amplitudes (interpolating between the two slots around a delay) and
+// released evenly over the slot. The shaped position is emitted whenever it moves by half a step.
+// The delays are therefore exact on average, the delayed copies are smoothed over one slot.
+//
+// The delays have to fit into the step history, which limits the frequency range: the longest
+// delay of ZVD is Td, about 31 Hz at the lowest, ZV reaches down to about 16 Hz.
+
+#pragma once
+
+#include <stdint.h>
+
+enum __attribute__((packed)) SHAPER_TYPE
+{
+    SHAPER_ZV  = 0,
+    SHAPER_ZVD = 1,
+    SHAPER_MZV = 2
+};
+
+#define SHAPER_IMPULSES_MAX 3
+
+// Impulses of a shaper: the amplitudes (summing to 1) and their delays (s).
+struct shaper_impulses_t
+{
+    uint8_t count;
+    float amp[SHAPER_IMPULSES_MAX];
+    float time[SHAPER_IMPULSES_MAX];
+};
+
+// Fixed point form of the impulses used by the stepper interrupt.
+struct shaper_params_t
+{
+    uint16_t amp0;                           // amplitude of the immediate impulse (1/256)
+    uint8_t amp[SHAPER_IMPULSES_MAX - 1];    // amplitudes of the delayed impulses (1/256), 0 if unused
+    uint8_t slots[SHAPER_IMPULSES_MAX - 1];  // delays in whole slots
+    uint8_t frac[SHAPER_IMPULSES_MAX - 1];   // and the remaining fraction of a slot (1/256)
+};
+
+// Calculate the impulses of a shaper. Returns false if the type or the damping ratio are invalid.
+bool shaper_impulses(uint8_t type, float freq, float zeta, shaper_impulses_t &imp);
+
+// Calculate the fixed point impulses. Returns false if the settings are invalid or the delays
+// do not fit into the step history.
+bool shaper_params(uint8_t type, float freq, float zeta, shaper_params_t &params);
+
+// Set the shapers of the stepper interrupt according to cs.shaping_*, disabling the ones which
+// are switched off (zero frequency) or invalid. Waits for the moves in progress to finish.
+void shaper_update();
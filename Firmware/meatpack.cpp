@@ -330,7 +330,7 @@ void FORCE_INLINE mp_handle_cmd(const MeatPack_Command c) {
 }
 
 //==========================================================================
-void mp_handle_rx_char(const uint8_t c) {
+void FORCE_INLINE mp_handle_rx_char_full(const uint8_t c) {
 
     // Check for commit complete
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -358,6 +358,37 @@ void mp_handle_rx_char(const uint8_t c) {
     mp_handle_rx_char_inner(c);
 }
 
+//==========================================================================
+void mp_handle_rx_char(const uint8_t c) {
+    mp_handle_rx_char_full(c);
+}
+
+//==========================================================================
+uint8_t mp_decode_line(const uint8_t* __restrict in, const uint16_t in_count, uint16_t& consumed, char* __restrict const out, const uint8_t out_size) {
+    uint16_t i = 0;
+    uint8_t count = 0;
+    for (;;) {
+        // Hand out the characters of the last byte first, the one following the end of a line or
+        // exceeding the output stays for the next call.
+        while (mp_char_out_count > 0) {
+            if (count == out_size)
+                goto done;
+            const char c = (char)mp_char_out_buf[0];
+            mp_char_out_buf[0] = mp_char_out_buf[1];
+            --mp_char_out_count;
+            out[count++] = c;
+            if (c == '\n' || c == '\r')
+                goto done;
+        }
+        if (i == in_count)
+            break;
+        mp_handle_rx_char_full(in[i++]);
+    }
+done:
+    consumed = i;
+    return count;
+}
+
 //==========================================================================
 uint8_t mp_get_result_char(char* const __restrict out) {
     if (mp_char_out_count > 0) {
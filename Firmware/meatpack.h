@@ -65,6 +65,12 @@ extern void mp_handle_rx_char(const uint8_t c);
 // @param out [in] Output pointer for unpacked/processed data.
 // @return Number of characters returned. Range from 0 to 2.
 extern uint8_t mp_get_result_char(char* const __restrict out);
+
+// Batched alternative of the two functions above: decodes the received bytes in[0..in_count) into out
+// until the end of a line ('\n' or '\r', which is stored) or until out_size characters are stored.
+// @param consumed [out] Number of bytes read from in, the rest is left for the next call.
+// @return Number of characters stored to out.
+extern uint8_t mp_decode_line(const uint8_t* __restrict in, const uint16_t in_count, uint16_t& consumed, char* __restrict const out, const uint8_t out_size);
 #endif
 
 #endif // MEATPACK_H_
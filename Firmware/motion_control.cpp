@@ -24,8 +24,13 @@
 #include "stepper.h"
 #include "planner.h"
 
+// Largest angle of a segment (rad) in the chord tolerance mode. A tolerance above the radius would
+// leave a small circle with a few segments only.
+#define ARC_SEGMENT_ANGLE_MAX 0.5f
+
 // The arc is approximated by generating a huge number of tiny, linear segments. The length of each
-// segment is configured in settings.mm_per_arc_segment.
+// segment is configured in settings.mm_per_arc_segment, or follows the radius and the chord tolerance
+// in settings.arc_tolerance.
 void mc_arc(const float* position, float* target, const float* offset, float feed_rate, float radius, bool isclockwise, uint16_t start_segment_idx)
 {
     float start_position[4];
@@ -47,7 +52,15 @@ void mc_arc(const float* position, float* target, const float* offset, float fee
     float angular_travel_total = atan2(r_axis_x * rt_y - r_axis_y * rt_x, r_axis_x * rt_x + r_axis_y * rt_y);
     if (angular_travel_total < 0) { angular_travel_total += 2 * M_PI; }
 
-    if (cs.min_arc_segments > 0)
+    if (cs.arc_tolerance > 0)
+    {
+        // The chord, which deviates from the arc by the tolerance (the sagitta), spans the angle
+        // 4 * asin(sqrt(sagitta / (2 * radius))). The arc length of that angle is the segment length.
+        // The tolerance replaces the maximum segment length and MIN_ARC_SEGMENTS.
+        const float sagitta = (cs.arc_tolerance < radius) ? cs.arc_tolerance : radius;
+        mm_per_arc_segment = 4 * radius * asin(sqrt(sagitta / (2 * radius)));
+    }
+    else if (cs.min_arc_segments > 0)
     {
         // 20200417 - FormerLurker - Implement MIN_ARC_SEGMENTS if it is defined - from Marlin 2.0 implementation
         // Do this before converting the angular travel for clockwise rotation
@@ -68,7 +81,7 @@ void mc_arc(const float* position, float* target, const float* offset, float fee
         // This prevents a very high number of segments from being generated for curves of a short radius
         mm_per_arc_segment = cs.min_mm_per_arc_segment;
     }
-    else if (mm_per_arc_segment > cs.mm_per_arc_segment) {
+    else if (mm_per_arc_segment > cs.mm_per_arc_segment && cs.arc_tolerance <= 0) {
         // 20210113 - This can be implemented in an else if since  we can't be below the min AND above the max at the same time.
         // 20200417 - FormerLurker - Implement MIN_MM_PER_ARC_SEGMENT if it is defined
         mm_per_arc_segment = cs.mm_per_arc_segment;
@@ -92,6 +105,12 @@ void mc_arc(const float* position, float* target, const float* offset, float fee
 
     // Calculate the number of arc segments
     unsigned short segments = static_cast<unsigned short>(ceil(millimeters_of_travel_arc / mm_per_arc_segment));
+    if (cs.arc_tolerance > 0)
+    {
+        const unsigned short min_segments = static_cast<unsigned short>(ceil(fabs(angular_travel_total) * (1.f / ARC_SEGMENT_ANGLE_MAX)));
+        if (segments < min_segments)
+            segments = min_segments;
+    }
 
     /* Vector rotation by transformation matrix: r is the original vector, r_T is the rotated vector,
        and phi is the angle of rotation. Based on the solution approach by Jens Geisler.
@@ -123,9 +142,8 @@ void mc_arc(const float* position, float* target, const float* offset, float fee
         const float theta_per_segment = angular_travel_total / segments,
             linear_per_segment = travel_z / (segments),
             segment_extruder_travel = (target[E_AXIS] - start_position[E_AXIS]) / (segments),
-            sq_theta_per_segment = theta_per_segment * theta_per_segment,
-            sin_T = theta_per_segment - sq_theta_per_segment * theta_per_segment / 6,
-            cos_T = 1 - 0.5f * sq_theta_per_segment;
+            sin_T = sin(theta_per_segment),
+            cos_T = cos(theta_per_segment);
         // Loop through all but one of the segments.  The last one can be done simply
         // by moving to the target.
         for (uint16_t i = 1; i < segments; i++) {
@@ -138,7 +156,7 @@ void mc_arc(const float* position, float* target, const float* offset, float fee
                 n_arc_correction = cs.n_arc_correction;
             }
             else {
-                // Calculate X and Y using the small angle approximation
+                // Rotate the radius vector by theta_per_segment
                 const float r_axisi = r_axis_x * sin_T + r_axis_y * cos_T;
                 r_axis_x = r_axis_x * cos_T - r_axis_y * sin_T;
                 r_axis_y = r_axisi;
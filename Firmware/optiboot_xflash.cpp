@@ -110,7 +110,7 @@ uint8_t optiboot_xflash_enter()
     }
     selectedSerialPort = 0; //switch to Serial0
     MYSERIAL.flush(); //clear RX buffer
-    int SerialHead = rx_buffer.head;
+    rx_index_t SerialHead = rx_buffer.head;
     // Send the initial magic string.
     while (ptr != end)
       putch(pgm_read_byte(ptr ++));
@@ -127,7 +127,7 @@ uint8_t optiboot_xflash_enter()
       // i.e. rx_buffer.head == SerialHead would not be checked at all!
       // With the volatile keyword the compiler generates exactly the same code as without it with only one difference:
       // the last brne instruction jumps onto the (*rx_head == SerialHead) check and NOT onto the wdr instruction bypassing the check.
-      volatile int *rx_head = &rx_buffer.head;
+      volatile rx_index_t *rx_head = &rx_buffer.head;
       while (*rx_head == SerialHead) {
         wdt_reset();
         if ( --boot_timer == 0) {
@@ -137,7 +137,7 @@ uint8_t optiboot_xflash_enter()
         }
       }
       ch = rx_buffer.buffer[SerialHead];
-      SerialHead = (unsigned int)(SerialHead + 1) % RX_BUFFER_SIZE;
+      SerialHead = (SerialHead + 1) & RX_BUFFER_MASK;
       if (pgm_read_byte(ptr ++) != ch)
       {
           // Magic was not received correctly, continue with the application
@@ -60,6 +60,7 @@
 #include "lcd.h"
 #include "language.h"
 #include "ConfigurationStore.h"
+#include "scurve.h"
 
 #ifdef MESH_BED_LEVELING
 #include "mesh_bed_leveling.h"
@@ -102,14 +103,31 @@ bool autotemp_enabled=false;
 //=================semi-private variables, used in inline  functions    =====
 //===========================================================================
 block_t block_buffer[BLOCK_BUFFER_SIZE];    // A ring buffer for motion instfructions
+block_recovery_t block_recovery[BLOCK_BUFFER_SIZE]; // Save/recovery data of the blocks in block_buffer
 volatile uint8_t block_buffer_head;         // Index of the next block to be pushed
 volatile uint8_t block_buffer_tail;         // Index of the block to process now
+volatile uint8_t block_buffer_planned;      // Index of the last block with an optimal entry speed
+
+#ifdef __AVR__
+// The host builds pad the structures to a 4 byte alignment.
+static_assert(sizeof(block_buffer) + sizeof(block_recovery) <= BLOCK_BUFFER_RAM,
+              "block_t or block_recovery_t grew, BLOCK_BUFFER_SIZE blocks no longer fit BLOCK_BUFFER_RAM");
+#endif //__AVR__
 
 #ifdef PLANNER_DIAGNOSTICS
 // Diagnostic function: Minimum number of planned moves since the last
 static uint8_t g_cntr_planner_queue_min = 0;
+// Diagnostic function: Number of square roots evaluated by planner_recalculate()
+static uint32_t g_cntr_planner_sqrt = 0;
 #endif /* PLANNER_DIAGNOSTICS */
 
+#ifdef PLANNER_STARVATION_COUNT
+// Number of moves, which found the queue drained by the stepper
+static uint16_t g_cntr_planner_starved = 0;
+// A block was planned since the last wait for the queue to drain.
+static bool g_planner_streaming = false;
+#endif /* PLANNER_STARVATION_COUNT */
+
 //===========================================================================
 //=============================private variables ============================
 //===========================================================================
@@ -179,8 +197,16 @@ FORCE_INLINE float intersection_distance(float initial_rate, float final_rate, f
 // Minimum stepper rate 120Hz.
 #define MINIMAL_STEP_RATE 120
 
+// Acceleration of a block in steps/s^2, recovered from the acceleration rate of the stepper interrupt.
+// acceleration_rate is the rounded down product of an integer acceleration and 2^24/(F_CPU/8) > 1,
+// therefore rounding up the inverse operation gives the original value (+-1 step/s^2 of float rounding).
+FORCE_INLINE uint32_t block_acceleration_steps_per_s2(const block_t *block)
+{
+  return ceil(block->acceleration_rate * float((F_CPU) / 8.0f / float(1UL << 24)));
+}
+
 // Calculates trapezoid parameters so that the entry- and exit-speed is compensated by the provided factors.
-void calculate_trapezoid_for_block(block_t *block, float entry_speed, float exit_speed)
+void calculate_trapezoid_for_block(block_t *block, speed_fx_t entry_speed, speed_fx_t exit_speed)
 {
   // These two lines are the only floating point calculations performed in this routine.
   // initial_rate, final_rate in Hz.
@@ -199,7 +225,7 @@ void calculate_trapezoid_for_block(block_t *block, float entry_speed, float exit
   if (final_rate > block->nominal_rate)
       final_rate = block->nominal_rate;
 
-  uint32_t acceleration      = block->acceleration_steps_per_s2;
+  uint32_t acceleration      = block_acceleration_steps_per_s2(block);
   if (acceleration == 0)
       // Don't allow zero acceleration.
       acceleration = 1;
@@ -207,7 +233,7 @@ void calculate_trapezoid_for_block(block_t *block, float entry_speed, float exit
   // (target_rate*target_rate-initial_rate*initial_rate)/(2.0*acceleration));
   uint32_t initial_rate_sqr  = initial_rate*initial_rate;
   //FIXME assert that this result fits a 64bit unsigned int.
-  uint32_t nominal_rate_sqr  = block->nominal_rate*block->nominal_rate;
+  uint32_t nominal_rate_sqr  = uint32_t(block->nominal_rate)*block->nominal_rate;
   uint32_t final_rate_sqr    = final_rate*final_rate;
   uint32_t acceleration_x2   = acceleration << 1;
   // ceil(estimate_acceleration_distance(initial_rate, block->nominal_rate, acceleration));
@@ -218,6 +244,10 @@ void calculate_trapezoid_for_block(block_t *block, float entry_speed, float exit
   // Size of Plateau of Nominal Rate.
   uint32_t plateau_steps     = 0;
 
+#ifdef S_CURVE_ACCELERATION
+  uint16_t cruise_rate = block->nominal_rate;
+#endif
+
 #ifdef LIN_ADVANCE
   uint16_t final_adv_steps = 0;
   uint16_t max_adv_steps = 0;
@@ -268,6 +298,16 @@ void calculate_trapezoid_for_block(block_t *block, float entry_speed, float exit
         accelerate_steps = block->step_event_count.wide - decelerate_steps;
     }
 
+#ifdef S_CURVE_ACCELERATION
+    // The nominal rate is not reached, the acceleration ramp ends at the intersection with the deceleration ramp.
+    if (accelerate_steps) {
+        float max_rate = sqrt(float(acceleration_x2) * accelerate_steps + initial_rate_sqr);
+        if (max_rate < cruise_rate)
+            cruise_rate = max_rate;
+    } else
+        cruise_rate = initial_rate;
+#endif
+
 #ifdef LIN_ADVANCE
     if (block->use_advance_lead) {
         if(!accelerate_steps || !decelerate_steps) {
@@ -282,6 +322,11 @@ void calculate_trapezoid_for_block(block_t *block, float entry_speed, float exit
 #endif
   }
 
+#ifdef S_CURVE_ACCELERATION
+  uint16_t accel_dv_inv = scurve_dv_inv((cruise_rate > initial_rate) ? (cruise_rate - initial_rate) : 0);
+  uint16_t decel_dv_inv = scurve_dv_inv((cruise_rate > final_rate) ? (cruise_rate - final_rate) : 0);
+#endif
+
   CRITICAL_SECTION_START;  // Fill variables used by the stepper in a critical section
   // This block locks the interrupts globally for 4.38 us,
   // which corresponds to a maximum repeat frequency of 228.57 kHz.
@@ -295,17 +340,42 @@ void calculate_trapezoid_for_block(block_t *block, float entry_speed, float exit
 #ifdef LIN_ADVANCE
     block->final_adv_steps = final_adv_steps;
     block->max_adv_steps = max_adv_steps;
+#endif
+#ifdef S_CURVE_ACCELERATION
+    block->cruise_rate = cruise_rate;
+    block->accel_dv_inv = accel_dv_inv;
+    block->decel_dv_inv = decel_dv_inv;
 #endif
   }
   CRITICAL_SECTION_END;
 }
 
+// Junction deviation cornering as used by Grbl: the speed, at which a circle of the given centripetal
+// acceleration passes a corner, while staying within the deviation distance of the corner.
+// cos_theta is the cosine of the angle between the unit vectors of the exit and the entry, reversed,
+// that is -1 for a straight line and 1 for a full reversal.
+float junction_deviation_speed(float cos_theta, float acceleration, float deviation)
+{
+    if (cos_theta > 0.999999f)
+        // Full reversal, the junction is a full stop.
+        return 0.f;
+    if (cos_theta < -0.999999f)
+        // Straight line, no limit except for the nominal speeds.
+        cos_theta = -0.999999f;
+    // Half of the junction angle from the trigonometric half angle identity. Always positive.
+    float sin_theta_d2 = sqrt(0.5f * (1.f - cos_theta));
+    return sqrt(acceleration * deviation * sin_theta_d2 / (1.f - sin_theta_d2));
+}
+
 // Calculates the maximum allowable entry speed, when you must be able to reach target_velocity using the
-// decceleration within the allotted distance.
-FORCE_INLINE float max_allowable_entry_speed(float decceleration, float target_velocity, float distance)
+// decceleration within the allotted distance. speed_sqr_delta = 2 * decceleration * distance
+FORCE_INLINE speed_fx_t max_allowable_entry_speed(float speed_sqr_delta, speed_fx_t target_velocity)
 {
-    // assert(decceleration < 0);
-    return  sqrt(target_velocity*target_velocity-2*decceleration*distance);
+#ifdef PLANNER_DIAGNOSTICS
+    ++ g_cntr_planner_sqrt;
+#endif /* PLANNER_DIAGNOSTICS */
+    float v = sqrt(float(target_velocity) * target_velocity + speed_sqr_delta);
+    return (v >= SPEED_FX_MAX) ? SPEED_FX_MAX : (speed_fx_t)v;
 }
 
 // Recalculates the motion plan according to the following algorithm:
@@ -345,7 +415,7 @@ FORCE_INLINE float max_allowable_entry_speed(float decceleration, float target_v
 // https://courses.cit.cornell.edu/ee476/Math/
 // https://courses.cit.cornell.edu/ee476/Math/GCC644/fixedPt/multASM.S
 //
-void planner_recalculate(const float &safe_final_speed)
+void planner_recalculate(speed_fx_t safe_final_speed)
 {
     // Reverse pass
     // Make a local copy of block_buffer_tail, because the interrupt can alter it
@@ -356,8 +426,17 @@ void planner_recalculate(const float &safe_final_speed)
 
 //    SERIAL_ECHOLNPGM("planner_recalculate - 1");
 
+    // Entry speeds of the blocks up to block_buffer_planned are optimal, they will not change
+    // by appending more blocks. Start the passes there, unless the stepper interrupt
+    // has already consumed that block.
+    uint8_t planned = block_buffer_planned;
+    uint8_t n_blocks = block_index_distance(tail, block_buffer_head);
+    if (block_index_distance(tail, planned) < n_blocks) {
+        tail = planned;
+        n_blocks = block_index_distance(tail, block_buffer_head);
+    }
+
     // At least three blocks are in the queue?
-    uint8_t n_blocks = (block_buffer_head + BLOCK_BUFFER_SIZE - tail) & (BLOCK_BUFFER_SIZE - 1);
     if (n_blocks >= 3) {
         // Initialize the last tripple of blocks.
         block_index = prev_block_index(block_buffer_head);
@@ -373,8 +452,9 @@ void planner_recalculate(const float &safe_final_speed)
                 // Also don't modify the trapezoids before this block, they are finalized already, prepared
                 // for the stepper interrupt routine to use them.
                 tail = block_index;
+                planned = block_index;
                 // Update the number of blocks to process.
-                n_blocks = (block_buffer_head + BLOCK_BUFFER_SIZE - tail) & (BLOCK_BUFFER_SIZE - 1);
+                n_blocks = block_index_distance(tail, block_buffer_head);
                 // SERIAL_ECHOLNPGM("START");
                 break;
             }
@@ -387,13 +467,12 @@ void planner_recalculate(const float &safe_final_speed)
                 // segment and the maximum acceleration allowed for this segment.
                 // If nominal length true, max junction speed is guaranteed to be reached even if decelerating to a jerk-from-zero velocity.
                 // Only compute for max allowable speed if block is decelerating and nominal length is false.
-                // entry_speed is uint16_t, 24 bits would be sufficient for block->acceleration and block->millimiteres, if scaled to um.
-                // therefore an optimized assembly 24bit x 24bit -> 32bit multiply would be more than sufficient
-                // together with an assembly 32bit->16bit sqrt function.
+                // entry_speed is uint16_t, therefore an optimized assembly 32bit->16bit sqrt function
+                // would be sufficient.
                 current->entry_speed = ((current->flag & BLOCK_FLAG_NOMINAL_LENGTH) || current->max_entry_speed <= next->entry_speed) ?
                     current->max_entry_speed :
                     // min(current->max_entry_speed, sqrt(next->entry_speed*next->entry_speed+2*current->acceleration*current->millimeters));
-                    min(current->max_entry_speed, max_allowable_entry_speed(-current->acceleration,next->entry_speed,current->millimeters));
+                    min(current->max_entry_speed, max_allowable_entry_speed(current->speed_sqr_delta, next->entry_speed));
                 current->flag |= BLOCK_FLAG_RECALCULATE;
             }
             next = current;
@@ -415,13 +494,19 @@ void planner_recalculate(const float &safe_final_speed)
             // speeds have already been reset, maximized, and reverse planned by reverse planner.
             // If nominal length is true, max junction speed is guaranteed to be reached. No need to recheck.
             if (! (prev->flag & BLOCK_FLAG_NOMINAL_LENGTH) && prev->entry_speed < current->entry_speed) {
-                float entry_speed = min(current->entry_speed, max_allowable_entry_speed(-prev->acceleration,prev->entry_speed,prev->millimeters));
+                speed_fx_t entry_speed = min(current->entry_speed, max_allowable_entry_speed(prev->speed_sqr_delta, prev->entry_speed));
                 // Check for junction speed change
                 if (current->entry_speed != entry_speed) {
                     current->entry_speed = entry_speed;
                     current->flag |= BLOCK_FLAG_RECALCULATE;
+                    // The previous block accelerates over its full length, therefore neither
+                    // the previous nor this entry speed may increase anymore.
+                    planned = block_index;
                 }
             }
+            // A block entered at its maximum entry speed will not be replanned either.
+            if (current->entry_speed == current->max_entry_speed)
+                planned = block_index;
             // Recalculate if current block entry or exit junction speed has changed.
             if ((prev->flag | current->flag) & BLOCK_FLAG_RECALCULATE) {
                 // NOTE: Entry and exit factors always > 0 by all previous logic operations.
@@ -441,12 +526,22 @@ void planner_recalculate(const float &safe_final_speed)
     calculate_trapezoid_for_block(current, current->entry_speed, safe_final_speed);
     current->flag &= ~BLOCK_FLAG_RECALCULATE;
 
+    // The stepper interrupt may have consumed the planned block meanwhile. It moves
+    // block_buffer_planned along with the tail, so only a block still queued is stored.
+    CRITICAL_SECTION_START;
+    if (block_index_distance(block_buffer_tail, planned) < block_index_distance(block_buffer_tail, block_buffer_head))
+        block_buffer_planned = planned;
+    else
+        block_buffer_planned = block_buffer_tail;
+    CRITICAL_SECTION_END;
+
 //    SERIAL_ECHOLNPGM("planner_recalculate - 4");
 }
 
 void plan_init() {
   block_buffer_head = 0;
   block_buffer_tail = 0;
+  block_buffer_planned = 0;
   memset(position, 0, sizeof(position)); // clear position
   #ifdef LIN_ADVANCE
   memset(position_float, 0, sizeof(position_float)); // clear position
@@ -455,6 +550,10 @@ void plan_init() {
   previous_nominal_speed = 0.0;
   plan_reset_next_e_queue = false;
   plan_reset_next_e_sched = false;
+#ifdef PLANNER_STARVATION_COUNT
+  g_cntr_planner_starved = 0;
+  g_planner_streaming = false;
+#endif /* PLANNER_STARVATION_COUNT */
 }
 
 
@@ -478,14 +577,15 @@ void getHighESpeed()
     if((block_buffer[block_index].steps[X_AXIS].wide != 0) ||
       (block_buffer[block_index].steps[Y_AXIS].wide != 0) ||
       (block_buffer[block_index].steps[Z_AXIS].wide != 0)) {
-      float se=(float(block_buffer[block_index].steps[E_AXIS].wide)/float(block_buffer[block_index].step_event_count.wide))*block_buffer[block_index].nominal_speed;
+      float nominal_speed = fx_to_speed(block_buffer[block_index].nominal_rate / block_buffer[block_index].speed_factor);
+      float se=(float(block_buffer[block_index].steps[E_AXIS].wide)/float(block_buffer[block_index].step_event_count.wide))*nominal_speed;
       //se; mm/sec;
       if(se>high)
       {
         high=se;
       }
     }
-    block_index = (block_index+1) & (BLOCK_BUFFER_SIZE - 1);
+    block_index = next_block_index(block_index);
   }
 
   float g=autotemp_min+high*autotemp_factor;
@@ -514,7 +614,7 @@ bool e_active()
     {
       block = &block_buffer[block_index];
       if(block->steps[E_AXIS].wide != 0) e_active++;
-      block_index = (block_index+1) & (BLOCK_BUFFER_SIZE - 1);
+      block_index = next_block_index(block_index);
     }
   }
   return (e_active > 0) ? true : false ;
@@ -540,7 +640,7 @@ void check_axes_activity()
       if(block->steps[Y_AXIS].wide != 0) y_active++;
       if(block->steps[Z_AXIS].wide != 0) z_active++;
       if(block->steps[E_AXIS].wide != 0) e_active++;
-      block_index = (block_index+1) & (BLOCK_BUFFER_SIZE - 1);
+      block_index = next_block_index(block_index);
     }
   }
   if((DISABLE_X) && (x_active == 0)) disable_x();
@@ -668,6 +768,9 @@ void planner_abort_hard()
     // Reset position sync requests
     plan_reset_next_e_queue = false;
     plan_reset_next_e_sched = false;
+#ifdef PLANNER_STARVATION_COUNT
+    g_planner_streaming = false;
+#endif /* PLANNER_STARVATION_COUNT */
 }
 
 void plan_buffer_line_curposXYZE(float feed_rate) {
@@ -694,6 +797,12 @@ void plan_buffer_line(float x, float y, float z, const float &e, float feed_rate
   // Calculate the buffer head after we push this byte
   uint8_t next_buffer_head = next_block_index(block_buffer_head);
 
+#ifdef PLANNER_STARVATION_COUNT
+  // The stepper ran out of blocks before this move came, although nothing waited for them to finish.
+  if (g_planner_streaming && block_buffer_tail == block_buffer_head)
+    ++ g_cntr_planner_starved;
+#endif /* PLANNER_STARVATION_COUNT */
+
   // If the buffer is full: good! That means we are well ahead of the robot.
   // Rest here until there is room in the buffer.
   if (block_buffer_tail == next_buffer_head) {
@@ -720,20 +829,22 @@ void plan_buffer_line(float x, float y, float z, const float &e, float feed_rate
   // Mark block as not busy (Not executed by the stepper interrupt, could be still tinkered with.)
   block->busy = false;
 
+  block_recovery_t *recovery = &block_recovery[block_buffer_head];
+
   // Set sdlen for calculating sd position
-  block->sdlen = 0;
+  recovery->sdlen = 0;
 
   // Save original start position of the move
   if (gcode_start_position)
-      memcpy(block->gcode_start_position, gcode_start_position, sizeof(block_t::gcode_start_position));
+      memcpy(recovery->gcode_start_position, gcode_start_position, sizeof(block_recovery_t::gcode_start_position));
   else
-      memcpy(block->gcode_start_position, current_position, sizeof(block_t::gcode_start_position));
+      memcpy(recovery->gcode_start_position, current_position, sizeof(block_recovery_t::gcode_start_position));
 
   // Save the index of this segment (when a single G0/1/2/3 command plans multiple segments)
-  block->segment_idx = segment_idx;
+  recovery->segment_idx = segment_idx;
 
   // Save the global feedrate at scheduling time
-  block->gcode_feedrate = feedrate;
+  recovery->gcode_feedrate = feedrate;
 
   // Reset the starting E position when requested
   if (plan_reset_next_e_queue)
@@ -886,19 +997,21 @@ Having the real displacement of the head, we can calculate the total movement le
   #endif
   delta_mm[Z_AXIS] = dz / cs.axis_steps_per_mm[Z_AXIS];
   delta_mm[E_AXIS] = de / cs.axis_steps_per_mm[E_AXIS];
+  // The total travel of this block in mm
+  float millimeters;
   if ( block->steps[X_AXIS].wide <=dropsegments && block->steps[Y_AXIS].wide <=dropsegments && block->steps[Z_AXIS].wide <=dropsegments )
   {
-    block->millimeters = fabs(delta_mm[E_AXIS]);
+    millimeters = fabs(delta_mm[E_AXIS]);
   }
   else
   {
     #ifndef COREXY
-      block->millimeters = sqrt(square(delta_mm[X_AXIS]) + square(delta_mm[Y_AXIS]) + square(delta_mm[Z_AXIS]));
+      millimeters = sqrt(square(delta_mm[X_AXIS]) + square(delta_mm[Y_AXIS]) + square(delta_mm[Z_AXIS]));
 	#else
-	  block->millimeters = sqrt(square(delta_mm[X_HEAD]) + square(delta_mm[Y_HEAD]) + square(delta_mm[Z_AXIS]));
+	  millimeters = sqrt(square(delta_mm[X_HEAD]) + square(delta_mm[Y_HEAD]) + square(delta_mm[Z_AXIS]));
     #endif
   }
-  float inverse_millimeters = 1.0/block->millimeters;  // Inverse millimeters to remove multiple divides
+  float inverse_millimeters = 1.0/millimeters;  // Inverse millimeters to remove multiple divides
 
     // Calculate speed in mm/second for each axis. No divide by zero due to previous checks.
   float inverse_second = feed_rate * inverse_millimeters;
@@ -918,8 +1031,10 @@ Having the real displacement of the head, we can calculate the total movement le
   }
 #endif // SLOWDOWN
 
-  block->nominal_speed = block->millimeters * inverse_second; // (mm/sec) Always > 0
-  block->nominal_rate = ceil(block->step_event_count.wide * inverse_second); // (step/sec) Always > 0
+  // The nominal speed for this block in mm/sec.
+  // This speed may or may not be reached due to the jerk and acceleration limits.
+  float nominal_speed = millimeters * inverse_second; // (mm/sec) Always > 0
+  uint32_t nominal_rate = ceil(block->step_event_count.wide * inverse_second); // (step/sec) Always > 0
 
   // Calculate and limit speed in mm/sec for each axis
   float current_speed[4];
@@ -940,17 +1055,26 @@ Having the real displacement of the head, we can calculate the total movement le
     {
       current_speed[i] *= speed_factor;
     }
-    block->nominal_speed *= speed_factor;
-    block->nominal_rate *= speed_factor;
+    nominal_speed *= speed_factor;
+    nominal_rate *= speed_factor;
+  }
+  // The stepper interrupt is not able to step faster than MAX_STEP_FREQUENCY anyway.
+  if (nominal_rate > UINT16_MAX) {
+    const float rate_factor = float(UINT16_MAX) / nominal_rate;
+    for(unsigned char i=0; i < 4; i++)
+      current_speed[i] *= rate_factor;
+    nominal_speed *= rate_factor;
+    nominal_rate = UINT16_MAX;
   }
+  block->nominal_rate = nominal_rate;
 
 #ifdef LIN_ADVANCE
   float e_D_ratio = 0;
 #endif
   // Compute and limit the acceleration rate for the trapezoid generator.
   // block->step_event_count ... event count of the fastest axis
-  // block->millimeters ... Euclidian length of the XYZ movement or the E length, if no XYZ movement.
-  float steps_per_mm = block->step_event_count.wide/block->millimeters;
+  // millimeters ... Euclidian length of the XYZ movement or the E length, if no XYZ movement.
+  float steps_per_mm = block->step_event_count.wide/millimeters;
   uint32_t accel;
   if(block->steps[X_AXIS].wide == 0 && block->steps[Y_AXIS].wide == 0 && block->steps[Z_AXIS].wide == 0)
   {
@@ -1019,13 +1143,13 @@ Having the real displacement of the head, we can calculate the total movement le
     }
   }
   // Acceleration of the segment, in mm/sec^2
-  block->acceleration_steps_per_s2 = accel;
-  block->acceleration = accel / steps_per_mm;
+  float acceleration = accel / steps_per_mm;
   block->acceleration_rate = (uint32_t)(accel * (float(1UL << 24) / ((F_CPU) / 8.0f)));
+  block->speed_sqr_delta = 2 * acceleration * millimeters * float(SPEED_FX_ONE * SPEED_FX_ONE);
 
   // Start with a safe speed.
   // Safe speed is the speed, from which the machine may halt to stop immediately.
-  float safe_speed = block->nominal_speed;
+  float safe_speed = nominal_speed;
   bool  limited = false;
   for (uint8_t axis = 0; axis < 4; ++ axis) {
       float jerk = fabs(current_speed[axis]);
@@ -1033,10 +1157,10 @@ Having the real displacement of the head, we can calculate the total movement le
           // The actual jerk is lower, if it has been limited by the XY jerk.
           if (limited) {
               // Spare one division by a following gymnastics:
-              // Instead of jerk *= safe_speed / block->nominal_speed,
+              // Instead of jerk *= safe_speed / nominal_speed,
               // multiply max_jerk[axis] by the divisor.
               jerk *= safe_speed;
-              float mjerk = cs.max_jerk[axis] * block->nominal_speed;
+              float mjerk = cs.max_jerk[axis] * nominal_speed;
               if (jerk > mjerk) {
                   safe_speed *= mjerk / jerk;
                   limited = true;
@@ -1070,15 +1194,30 @@ Having the real displacement of the head, we can calculate the total movement le
       // then the machine is not coasting anymore and the safe entry / exit velocities shall be used.
 
       // The junction velocity will be shared between successive segments. Limit the junction velocity to their minimum.
-      bool prev_speed_larger = previous_nominal_speed > block->nominal_speed;
-      float smaller_speed_factor = prev_speed_larger ? (block->nominal_speed / previous_nominal_speed) : (previous_nominal_speed / block->nominal_speed);
+      bool prev_speed_larger = previous_nominal_speed > nominal_speed;
+      float smaller_speed_factor = prev_speed_larger ? (nominal_speed / previous_nominal_speed) : (previous_nominal_speed / nominal_speed);
       // Pick the smaller of the nominal speeds. Higher speed shall not be achieved at the junction during coasting.
-      vmax_junction = prev_speed_larger ? block->nominal_speed : previous_nominal_speed;
+      vmax_junction = prev_speed_larger ? nominal_speed : previous_nominal_speed;
       // Factor to multiply the previous / current nominal velocities to get componentwise limited velocities.
       float v_factor = 1.f;
       limited = false;
+      // With the junction deviation cornering, the jerk limits apply to the extruder only.
+      uint8_t axis = X_AXIS;
+      if (cs.junction_deviation > 0.f) {
+          // Cosine of the angle between the previous and the current XYZ unit vectors, reversed.
+          float cos_theta = 0.f;
+          for (uint8_t i = X_AXIS; i <= Z_AXIS; ++ i)
+              cos_theta -= previous_speed[i] * current_speed[i];
+          cos_theta /= previous_nominal_speed * nominal_speed;
+          float v_deviation = junction_deviation_speed(cos_theta, acceleration, cs.junction_deviation);
+          if (v_deviation < vmax_junction) {
+              v_factor = v_deviation / vmax_junction;
+              limited = true;
+          }
+          axis = E_AXIS;
+      }
       // Now limit the jerk in all axes.
-      for (uint8_t axis = 0; axis < 4; ++ axis) {
+      for (; axis < 4; ++ axis) {
           // Limit an axis. We have to differentiate coasting from the reversal of an axis movement, or a full stop.
           float v_exit  = previous_speed[axis];
           float v_entry = current_speed [axis];
@@ -1111,8 +1250,9 @@ Having the real displacement of the head, we can calculate the total movement le
           vmax_junction *= v_factor;
       // Now the transition velocity is known, which maximizes the shared exit / entry velocity while
       // respecting the jerk factors, it may be possible, that applying separate safe exit / entry velocities will achieve faster prints.
+      // The junction deviation limits the speed through a corner, a full halt would not help there.
       float vmax_junction_threshold = vmax_junction * 0.99f;
-      if (previous_safe_speed > vmax_junction_threshold && safe_speed > vmax_junction_threshold) {
+      if (cs.junction_deviation <= 0.f && previous_safe_speed > vmax_junction_threshold && safe_speed > vmax_junction_threshold) {
           // Not coasting. The machine will stop and start the movements anyway,
           // better to start the segment from start.
           block->flag |= BLOCK_FLAG_START_FROM_FULL_HALT;
@@ -1124,11 +1264,12 @@ Having the real displacement of the head, we can calculate the total movement le
   }
 
   // Max entry speed of this block equals the max exit speed of the previous block.
-  block->max_entry_speed = vmax_junction;
+  block->max_entry_speed = speed_to_fx(vmax_junction);
 
   // Initialize block entry speed. Compute based on deceleration to safe_speed.
-  double v_allowable = max_allowable_entry_speed(-block->acceleration,safe_speed,block->millimeters);
-  block->entry_speed = min(vmax_junction, v_allowable);
+  float v_allowable = sqrt(square(safe_speed) + 2 * acceleration * millimeters);
+  block->entry_speed = min(block->max_entry_speed, speed_to_fx(v_allowable));
+  const speed_fx_t safe_speed_fx = speed_to_fx(safe_speed);
 
   // Initialize planner efficiency flags
   // Set flag if block will always reach maximum junction speed regardless of entry/exit speeds.
@@ -1139,26 +1280,27 @@ Having the real displacement of the head, we can calculate the total movement le
   // the reverse and forward planners, the corresponding block junction speed will always be at the
   // the maximum junction speed and may always be ignored for any speed reduction checks.
   // Always calculate trapezoid for new block
-  block->flag |= (block->nominal_speed <= v_allowable) ? (BLOCK_FLAG_NOMINAL_LENGTH | BLOCK_FLAG_RECALCULATE) : BLOCK_FLAG_RECALCULATE;
+  block->flag |= (nominal_speed <= v_allowable) ? (BLOCK_FLAG_NOMINAL_LENGTH | BLOCK_FLAG_RECALCULATE) : BLOCK_FLAG_RECALCULATE;
 
   // Update previous path unit_vector and nominal speed
   memcpy(previous_speed, current_speed, sizeof(previous_speed)); // previous_speed[] = current_speed[]
-  previous_nominal_speed = block->nominal_speed;
+  previous_nominal_speed = nominal_speed;
   previous_safe_speed = safe_speed;
 
   // Precalculate the division, so when all the trapezoids in the planner queue get recalculated, the division is not repeated.
-  block->speed_factor = block->nominal_rate / block->nominal_speed;
+  float speed_factor_mm = block->nominal_rate / nominal_speed; // (step/s) / (mm/s)
+  block->speed_factor = speed_factor_mm * (1.f / SPEED_FX_ONE);
 
 #ifdef LIN_ADVANCE
   if (block->use_advance_lead) {
       // calculate the compression ratio for the segment (the required advance steps are computed
       // during trapezoid planning)
       float adv_comp = extruder_advance_K * e_D_ratio * cs.axis_steps_per_mm[E_AXIS]; // (step/(mm/s))
-      block->adv_comp = adv_comp / block->speed_factor; // step/(step/min)
+      block->adv_comp = adv_comp / speed_factor_mm; // step/(step/min)
 
       float advance_speed;
       if (e_D_ratio > 0)
-          advance_speed = (extruder_advance_K * e_D_ratio * block->acceleration * cs.axis_steps_per_mm[E_AXIS]);
+          advance_speed = (extruder_advance_K * e_D_ratio * acceleration * cs.axis_steps_per_mm[E_AXIS]);
       else
           advance_speed = cs.max_jerk[E_AXIS] * cs.axis_steps_per_mm[E_AXIS];
 
@@ -1195,7 +1337,7 @@ Having the real displacement of the head, we can calculate the total movement le
   }
 #endif
 
-  calculate_trapezoid_for_block(block, block->entry_speed, safe_speed);
+  calculate_trapezoid_for_block(block, block->entry_speed, safe_speed_fx);
 
   if (block->step_event_count.wide <= 32767)
     block->flag |= BLOCK_FLAG_DDA_LOWRES;
@@ -1221,7 +1363,7 @@ Having the real displacement of the head, we can calculate the total movement le
   // the machine limits (maximum acceleration and maximum jerk).
   // This runs asynchronously with the stepper interrupt controller, which may
   // interfere with the process.
-  planner_recalculate(safe_speed);
+  planner_recalculate(safe_speed_fx);
 
 //  SERIAL_ECHOPGM("Q");
 //  SERIAL_ECHO(int(moves_planned()));
@@ -1230,6 +1372,9 @@ Having the real displacement of the head, we can calculate the total movement le
 #ifdef PLANNER_DIAGNOSTICS
   planner_update_queue_min_counter();
 #endif /* PLANNER_DIAGNOSTIC */
+#ifdef PLANNER_STARVATION_COUNT
+  g_planner_streaming = true;
+#endif /* PLANNER_STARVATION_COUNT */
 
   // The stepper timer interrupt will run continuously from now on.
   // If there are no planner blocks to be executed by the stepper routine,
@@ -1328,14 +1473,41 @@ void planner_queue_min_reset()
 {
   g_cntr_planner_queue_min = moves_planned();
 }
+
+uint32_t planner_sqrt_count()
+{
+  return g_cntr_planner_sqrt;
+}
 #endif /* PLANNER_DIAGNOSTICS */
 
+#ifdef PLANNER_STARVATION_COUNT
+uint16_t planner_starvation_count()
+{
+  return g_cntr_planner_starved;
+}
+
+void planner_starvation_reset()
+{
+  g_cntr_planner_starved = 0;
+}
+
+void planner_starvation_disarm()
+{
+  g_planner_streaming = false;
+}
+
+bool planner_starved()
+{
+  return g_planner_streaming && block_buffer_tail == block_buffer_head;
+}
+#endif /* PLANNER_STARVATION_COUNT */
+
 void planner_add_sd_length(uint16_t sdlen)
 {
   if (block_buffer_head != block_buffer_tail) {
     // The planner buffer is not empty. Get the index of the last buffer line entered,
     // which is (block_buffer_head - 1) modulo BLOCK_BUFFER_SIZE.
-    block_buffer[prev_block_index(block_buffer_head)].sdlen += sdlen;
+    block_recovery[prev_block_index(block_buffer_head)].sdlen += sdlen;
   } else {
     // There is no line stored in the planner buffer, which means the last command does not need to be revertible,
     // at a power panic, so the length of this command may be forgotten.
@@ -1349,8 +1521,8 @@ uint16_t planner_calc_sd_length()
 	uint16_t sdlen = 0;
 	while (_block_buffer_head != _block_buffer_tail)
 	{
-		sdlen += block_buffer[_block_buffer_tail].sdlen;
-	    _block_buffer_tail = (_block_buffer_tail + 1) & (BLOCK_BUFFER_SIZE - 1);
+		sdlen += block_recovery[_block_buffer_tail].sdlen;
+	    _block_buffer_tail = next_block_index(_block_buffer_tail);
 	}
 	return sdlen;
 }
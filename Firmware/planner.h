@@ -62,65 +62,89 @@ union dda_usteps_t
   };
 };
 
+// Junction speeds of the queued blocks are stored in a 10.6 fixed point format (1/64 mm/s, max. 1023.98 mm/s).
+typedef uint16_t speed_fx_t;
+#define SPEED_FX_SHIFT 6
+#define SPEED_FX_ONE (1 << SPEED_FX_SHIFT)
+#define SPEED_FX_MAX UINT16_MAX
+
+// Convert a speed in mm/s to the fixed point format. Rounds down, saturates at SPEED_FX_MAX.
+FORCE_INLINE speed_fx_t speed_to_fx(float speed)
+{
+  speed *= SPEED_FX_ONE;
+  return (speed >= SPEED_FX_MAX) ? SPEED_FX_MAX : (speed_fx_t)speed;
+}
+
+FORCE_INLINE float fx_to_speed(speed_fx_t speed)
+{
+  return speed * (1.f / SPEED_FX_ONE);
+}
+
 // This struct is used when buffering the setup for each linear movement "nominal" values are as specified in
 // the source g-code and may never actually be reached if acceleration management is active.
+// The layout is kept compact, so that BLOCK_BUFFER_SIZE blocks together with their block_recovery_t
+// fit into BLOCK_BUFFER_RAM. Add new members with care.
 typedef struct {
   // Fields used by the bresenham algorithm for tracing the line
   // steps_x.y,z, step_event_count, acceleration_rate, direction_bits and active_extruder are set by plan_buffer_line().
   dda_isteps_t steps[NUM_AXIS];             // Step count along each axis
   dda_usteps_t step_event_count;            // The number of step events required to complete this block
   uint32_t acceleration_rate;               // The acceleration rate used for acceleration calculation
-  unsigned char direction_bits;             // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
   // accelerate_until and decelerate_after are set by calculate_trapezoid_for_block() and they need to be synchronized with the stepper interrupt controller.
   uint32_t accelerate_until;                // The index of the step event on which to stop acceleration
   uint32_t decelerate_after;                // The index of the step event on which to start decelerating
 
-  // Fields used by the motion planner to manage acceleration
-//  float speed_x, speed_y, speed_z, speed_e;        // Nominal mm/sec for each axis
-  // The nominal speed for this block in mm/sec.
-  // This speed may or may not be reached due to the jerk and acceleration limits.
-  float nominal_speed;
-  // Entry speed at previous-current junction in mm/sec, respecting the acceleration and jerk limits.
-  // The entry speed limit of the current block equals the exit speed of the preceding block.
-  float entry_speed;
-  // Maximum allowable junction entry speed in mm/sec. This value is also a maximum exit speed of the previous block.
-  float max_entry_speed;
-  // The total travel of this block in mm
-  float millimeters;
-  // acceleration mm/sec^2
-  float acceleration;
+  // Settings for the trapezoid generator (runs inside an interrupt handler).
+  // Changing the following values in the planner needs to be synchronized with the interrupt handler by disabling the interrupts.
+  // The stepper interrupt handles 16bit step rates only, the planner saturates the nominal rate.
+  uint16_t nominal_rate;              // The nominal step rate for this block in step_events/sec
+  uint16_t initial_rate;              // The jerk-adjusted step rate at start of block
+  uint16_t final_rate;                // The minimal rate at exit
 
+  unsigned char direction_bits;       // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
   // Bit flags defined by the BlockFlag enum.
   uint8_t flag;
-
-  // Settings for the trapezoid generator (runs inside an interrupt handler).
-  // Changing the following values in the planner needs to be synchronized with the interrupt handler by disabling the interrupts.
-  uint32_t nominal_rate;              // The nominal step rate for this block in step_events/sec
-  uint32_t initial_rate;              // The jerk-adjusted step rate at start of block
-  uint32_t final_rate;                // The minimal rate at exit
-  uint32_t acceleration_steps_per_s2; // acceleration steps/sec^2
   uint8_t fan_speed; // Print fan speed, ranges from 0 to 255
   volatile char busy;
 
-
+  // Fields used by the motion planner to manage acceleration
+  // Entry speed at previous-current junction, respecting the acceleration and jerk limits.
+  // The entry speed limit of the current block equals the exit speed of the preceding block.
+  speed_fx_t entry_speed;
+  // Maximum allowable junction entry speed. This value is also a maximum exit speed of the previous block.
+  speed_fx_t max_entry_speed;
+  // 2 * acceleration * millimeters in speed_fx_t units squared: the largest change of the squared speed,
+  // which the block allows while accelerating or decelerating over its full length.
+  float speed_sqr_delta;
   // Pre-calculated division for the calculate_trapezoid_for_block() routine to run faster.
+  // Step rate (step/s) per speed_fx_t unit.
   float speed_factor;
 
 #ifdef LIN_ADVANCE
   bool use_advance_lead;            // Whether the current block uses LA
+  uint8_t advance_step_loops;       // Number of stepper ticks for each advance isr
   uint16_t advance_rate,            // Step-rate for extruder speed
            max_adv_steps,           // max. advance steps to get cruising speed pressure (not always nominal_speed!)
            final_adv_steps;         // advance steps due to exit speed
-  uint8_t advance_step_loops;       // Number of stepper ticks for each advance isr
   float adv_comp;                   // Precomputed E compression factor
 #endif
 
-  // Save/recovery state data
+#ifdef S_CURVE_ACCELERATION
+  // Set by calculate_trapezoid_for_block() together with the trapezoid, see scurve.h.
+  uint16_t cruise_rate;             // The peak step rate, the end of the acceleration and the start of the deceleration ramp
+  uint16_t accel_dv_inv;            // scurve_dv_inv(cruise_rate - initial_rate)
+  uint16_t decel_dv_inv;            // scurve_dv_inv(cruise_rate - final_rate)
+#endif
+} block_t;
+
+// Save/recovery state data of a block, kept in a side ring parallel to block_buffer.
+// Only read when the block is executed (power panic, print pause), therefore kept out of block_t.
+typedef struct {
   float gcode_start_position[NUM_AXIS]; // Start (abs mm) of the original Gcode instruction
   uint16_t segment_idx;             // The index of the for loop that generates segments
   uint16_t gcode_feedrate;          // Default and/or move feedrate
   uint16_t sdlen;                   // Length of the Gcode instruction
-} block_t;
+} block_recovery_t;
 
 #ifdef LIN_ADVANCE
 extern float extruder_advance_K;    // Linear-advance K factor
@@ -150,6 +174,10 @@ void plan_set_e_position(const float &e);
 // Reset the E position to zero at the start of the next segment
 void plan_reset_next_e();
 
+// Maximum speed through a junction with the junction deviation cornering (M205 J).
+// cos_theta is -1 for a straight line and 1 for a full reversal.
+float junction_deviation_speed(float cos_theta, float acceleration, float deviation);
+
 inline void set_current_to_destination() { memcpy(current_position, destination, sizeof(current_position)); }
 inline void set_destination_to_current() { memcpy(destination, current_position, sizeof(destination)); }
 
@@ -177,24 +205,32 @@ extern long position[NUM_AXIS];
 
 
 // Check for BLOCK_BUFFER_SIZE requirements
-static_assert(!(BLOCK_BUFFER_SIZE & (BLOCK_BUFFER_SIZE - 1)),
-              "BLOCK_BUFFER_SIZE must be a power of two");
 static_assert(BLOCK_BUFFER_SIZE <= (UINT8_MAX>>1),
               "BLOCK_BUFFER_SIZE too large for uint8_t");
 
 extern block_t block_buffer[BLOCK_BUFFER_SIZE];            // A ring buffer for motion instfructions
+extern block_recovery_t block_recovery[BLOCK_BUFFER_SIZE]; // Save/recovery data of the blocks in block_buffer
 // Index of the next block to be pushed into the planner queue.
 extern volatile uint8_t block_buffer_head;
 // Index of the first block in the planner queue.
 // This is the block, which is being currently processed by the stepper routine,
 // or which is first to be processed by the stepper routine.
 extern volatile uint8_t block_buffer_tail;
+// Index of the last block with an optimal entry speed, planner_recalculate() starts there.
+extern volatile uint8_t block_buffer_planned;
 // Called when the current block is no longer needed. Discards the block and makes the memory
 // available for new blocks.
 FORCE_INLINE void plan_discard_current_block()
 {
   if (block_buffer_head != block_buffer_tail) {
-    block_buffer_tail = (block_buffer_tail + 1) & (BLOCK_BUFFER_SIZE - 1);
+    uint8_t tail = block_buffer_tail + 1;
+    if (tail == BLOCK_BUFFER_SIZE)
+      tail = 0;
+    // Keep the planned block in the queue, the slot of the discarded one is reused
+    // by the next block pushed once the ring wraps.
+    if (block_buffer_planned == block_buffer_tail)
+      block_buffer_planned = tail;
+    block_buffer_tail = tail;
   }
 }
 
@@ -212,14 +248,25 @@ FORCE_INLINE block_t *plan_get_current_block()
   return(block);
 }
 
+// Gets the save/recovery data of a block from block_buffer.
+FORCE_INLINE block_recovery_t *plan_get_recovery(const block_t *block)
+{
+  return &block_recovery[block - block_buffer];
+}
+
 // Returns true if the buffer has a queued block, false otherwise
 FORCE_INLINE bool blocks_queued() {
 	return (block_buffer_head != block_buffer_tail);
 }
 
+// Number of blocks from the block at index "from" up to, but not including, the block at index "to".
+FORCE_INLINE uint8_t block_index_distance(uint8_t from, uint8_t to) {
+    return (to >= from) ? (to - from) : (to + BLOCK_BUFFER_SIZE - from);
+}
+
 //return the nr of buffered moves
 FORCE_INLINE uint8_t moves_planned() {
-    return (block_buffer_head + BLOCK_BUFFER_SIZE - block_buffer_tail) & (BLOCK_BUFFER_SIZE - 1);
+    return block_index_distance(block_buffer_tail, block_buffer_head);
 }
 
 FORCE_INLINE bool planner_queue_full() {
@@ -254,8 +301,23 @@ void update_mode_profile();
 extern uint8_t planner_queue_min();
 // Diagnostic function: Reset the minimum planner segments.
 extern void planner_queue_min_reset();
+// Diagnostic function: Number of square roots evaluated by the planner since the start.
+extern uint32_t planner_sqrt_count();
 #endif /* PLANNER_DIAGNOSTICS */
 
+#ifdef PLANNER_STARVATION_COUNT
+// Number of moves, which found the planner queue drained by the stepper while no command waited
+// for the queue to finish since the previous move. The moves did not come fast enough.
+extern uint16_t planner_starvation_count();
+// Reset the starvation count.
+extern void planner_starvation_reset();
+// The queue is drained on purpose (st_synchronize()), the next move is not starved.
+extern void planner_starvation_disarm();
+// The planner queue is drained by the stepper and no command waits for it, the next move will be
+// counted as starved.
+extern bool planner_starved();
+#endif /* PLANNER_STARVATION_COUNT */
+
 extern void planner_add_sd_length(uint16_t sdlen);
 
 extern uint16_t planner_calc_sd_length();
@@ -40,6 +40,10 @@ static void uvlo_drain_reset() {
 void uvlo_() {
     unsigned long time_start = _millis();
 
+    // The interrupt may have stopped an SD card read in the middle, leave the card without CMD12
+    // before tmc2130_setup_chopper() takes the SPI bus.
+    card.readStreamAbandon();
+
     // True if a print is already saved to RAM
     const bool print_saved_in_ram = saved_printing && (saved_printing_type != PowerPanic::PRINT_TYPE_NONE);
     const bool pos_invalid = mesh_bed_leveling_flag || homing_flag;
@@ -230,6 +234,9 @@ void uvlo_() {
 static void uvlo_tiny() {
     unsigned long time_start = _millis();
 
+    // Leave the SD card without CMD12, see uvlo_().
+    card.readStreamAbandon();
+
     // Conserve power as soon as possible.
     disable_x();
     disable_y();
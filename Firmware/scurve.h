@@ -0,0 +1,70 @@
+// scurve: jerk limited (S-curve) velocity profile of the acceleration and deceleration ramps
+//
+// With S_CURVE_ACCELERATION the stepper interrupt replaces the linear ramp of
+// the step rate by the 5th degree smoothstep polynomial, that is a Bezier
+// curve of 6 control points with the first three at the start rate and the
+// last three at the end rate:
+//
+//   v(u) = v0 + (v1 - v0) * (10u^3 - 15u^4 + 6u^5)
+//
+// u is the time since the start of the ramp normalized to the duration of
+// the linear ramp. Both the acceleration and the jerk start and end at zero.
+// The average rate equals the one of the linear ramp, so the ramp takes the
+// same time and the same number of steps. accelerate_until and
+// decelerate_after of the trapezoid stay valid. The peak acceleration in
+// the middle of the ramp is 15/8 of the configured one.
+//
+// The interrupt already computes the rate gain of the linear ramp, which
+// grows linearly with the time. Dividing it by the total rate change of the
+// ramp gives u. The planner precalculates the reciprocal of the rate change
+// (scurve_dv_inv()), so the interrupt evaluates the curve with 16x16 bit
+// multiplications only. u and the curve are evaluated in 0.16 fixed point.
+
+#pragma once
+
+#include <stdint.h>
+
+// Rate changes up to this value (steps/s) are ramped linearly.
+#define SCURVE_DV_MIN 256
+
+// Reciprocal of the rate change of a ramp, 2^24 / dv. Zero selects the linear ramp.
+static inline uint16_t scurve_dv_inv(uint16_t dv)
+{
+    return (dv > SCURVE_DV_MIN) ? uint16_t((1UL << 24) / dv) : 0;
+}
+
+// Normalized time of the ramp in 0.16 fixed point, saturated at the end of the ramp.
+// linear_gain is the rate gain of the linear ramp since its start.
+static inline uint16_t scurve_time(uint16_t linear_gain, uint16_t dv_inv)
+{
+    uint32_t u = (uint32_t(linear_gain) * dv_inv) >> 8;
+    return (u > UINT16_MAX) ? UINT16_MAX : uint16_t(u);
+}
+
+// 10u^3 - 15u^4 + 6u^5 in 0.16 fixed point.
+static inline uint16_t scurve_smoothstep(uint16_t u)
+{
+    // The curve is point symmetric around its middle. Evaluate the first half only,
+    // where 10 - 15u + 6u^2 stays between 4 and 10 and keeps its precision in 4.12 fixed point.
+    bool second_half = u > 0x8000;
+    if (second_half)
+        u = -u;
+    uint16_t u2 = (uint32_t(u) * u) >> 16;
+    uint16_t p = uint16_t(10U << 12) + uint16_t((6UL * u2) >> 4) - uint16_t((15UL * u) >> 4);
+    // Multiply by u three times, the intermediate results stay below 2 and 1 for u <= 1/2.
+    uint32_t up = (uint32_t(u) * p) >> 13;   // u p in 1.15 fixed point
+    up = (up * u) >> 15;                    // u^2 p in 0.16 fixed point
+    uint16_t s = (up * u) >> 16;            // u^3 p
+    if (second_half)
+        s = s ? uint16_t(-s) : UINT16_MAX;
+    return s;
+}
+
+// Rate gain of the S-curve ramp, which replaces the linear_gain of the linear ramp.
+// dv is the rate change of the whole ramp, dv_inv = scurve_dv_inv(dv).
+static inline uint16_t scurve_gain(uint16_t linear_gain, uint16_t dv, uint16_t dv_inv)
+{
+    if (! dv_inv)
+        return linear_gain;
+    return (uint32_t(dv) * scurve_smoothstep(scurve_time(linear_gain, dv_inv)) + 0x8000) >> 16;
+}
@@ -3,8 +3,65 @@
 
 #include "Marlin.h"
 
-extern const uint16_t speed_lookuptable_fast[256][2] PROGMEM;
-extern const uint16_t speed_lookuptable_slow[256][2] PROGMEM;
+// Step rate to timer period conversion tables, generated at compile time.
+//
+// Entry i of a table holds the timer1 period (ticks) at the step rate SPEED_TABLE_RATE_MIN + (i << shift)
+// and its difference to the next entry, calc_timer() interpolates linearly between them. The slow table
+// covers the rates below SPEED_TABLE_SLOW_SIZE << SPEED_TABLE_SLOW_SHIFT in steps of 8. The fast table
+// covers the rest up to the highest step rate of a single ISR invocation, with the finest power of two
+// spacing fitting into 8 bits of interpolation.
+
+#define SPEED_TABLE_PRESCALER 8 // timer1 prescaler, see st_init()
+#define SPEED_TABLE_TIMER_FREQ (F_CPU / SPEED_TABLE_PRESCALER)
+#define SPEED_TABLE_RATE_MIN (F_CPU / 500000) // lowest step rate, whose period fits 16 bits
+#define SPEED_TABLE_SLOW_SHIFT 3
+#define SPEED_TABLE_SLOW_SIZE 256
+
+template <uint16_t N>
+struct speed_table_t
+{
+    uint16_t entry[N][2];
+};
+
+// Period of each entry is timer_freq / (rate_min + (i << shift)), rounded to nearest or truncated.
+template <uint16_t N>
+constexpr speed_table_t<N> speed_table_generate(uint32_t timer_freq, uint16_t rate_min, uint8_t shift, bool round)
+{
+    speed_table_t<N> table {};
+    for (uint16_t i = 0; i < N; ++i) {
+        const uint32_t rate = rate_min + (uint32_t(i) << shift);
+        table.entry[i][0] = (timer_freq + (round ? rate / 2 : 0)) / rate;
+    }
+    for (uint16_t i = 0; i + 1 < N; ++i)
+        table.entry[i][1] = table.entry[i][0] - table.entry[i + 1][0];
+    table.entry[N - 1][1] = table.entry[N - 2][1];
+    return table;
+}
+
+// Smallest spacing of the fast table entries, which covers the step rates up to rate_range in 256 entries.
+constexpr uint8_t speed_table_fast_shift(uint16_t rate_range)
+{
+    uint8_t shift = SPEED_TABLE_SLOW_SHIFT;
+    while (shift < 8 && (rate_range >> shift) >= 255)
+        ++shift;
+    return shift;
+}
+
+// Highest step rate of a single ISR invocation: calc_timer() multi-steps above the ISR rate limit
+// and quad-steps the rates up to MAX_STEP_FREQUENCY.
+#ifdef STEP_LOOPS_ADAPTIVE
+#define SPEED_TABLE_ISR_RATE_LIMIT STEP_ISR_RATE_MAX
+#else
+#define SPEED_TABLE_ISR_RATE_LIMIT STEP_ISR_RATE_DEFAULT
+#endif
+#define SPEED_TABLE_MAX_RATE ((SPEED_TABLE_ISR_RATE_LIMIT > MAX_STEP_FREQUENCY / 4) ? SPEED_TABLE_ISR_RATE_LIMIT : (MAX_STEP_FREQUENCY / 4))
+
+static constexpr uint8_t SPEED_TABLE_FAST_SHIFT = speed_table_fast_shift(SPEED_TABLE_MAX_RATE - SPEED_TABLE_RATE_MIN);
+static constexpr uint16_t SPEED_TABLE_FAST_SIZE = ((SPEED_TABLE_MAX_RATE - SPEED_TABLE_RATE_MIN) >> SPEED_TABLE_FAST_SHIFT) + 2;
+static_assert(SPEED_TABLE_FAST_SIZE <= 256, "the fast speed table is indexed by 8 bits");
+
+extern const speed_table_t<SPEED_TABLE_FAST_SIZE> speed_lookuptable_fast PROGMEM;
+extern const speed_table_t<SPEED_TABLE_SLOW_SIZE> speed_lookuptable_slow PROGMEM;
 
 #ifndef _NO_ASM
 
@@ -97,7 +154,7 @@ FORCE_INLINE uint16_t MUL24x24R24(__uint24 x, __uint24 y) {
 
 FORCE_INLINE uint16_t MUL8x16R8(uint8_t charIn1, uint16_t intIn2)
 {
-    return ((uint32_t)charIn1 * (uint32_t)intIn2) >> 8;
+    return ((uint32_t)charIn1 * (uint32_t)intIn2 + 0x80) >> 8;
 }
 
 FORCE_INLINE uint16_t MUL24x24R24(uint32_t longIn1, uint32_t longIn2)
@@ -108,15 +165,16 @@ FORCE_INLINE uint16_t MUL24x24R24(uint32_t longIn1, uint32_t longIn2)
 #endif //_NO_ASM
 
 
-FORCE_INLINE unsigned short calc_timer(uint16_t step_rate, uint8_t& step_loops) {
+// isr_rate_max: highest ISR rate (steps/s) before stepping multiple times per interrupt.
+FORCE_INLINE unsigned short calc_timer(uint16_t step_rate, uint8_t& step_loops, uint16_t isr_rate_max = STEP_ISR_RATE_DEFAULT) {
   uint16_t timer;
   if(step_rate > MAX_STEP_FREQUENCY) step_rate = MAX_STEP_FREQUENCY;
 
-  if(step_rate > 20000) { // If steprate > 20kHz >> step 4 times
+  if(step_rate > 2 * isr_rate_max) { // If steprate > 2x the limit >> step 4 times
     step_rate = (step_rate >> 2)&0x3fff;
     step_loops = 4;
   }
-  else if(step_rate > 10000) { // If steprate > 10kHz >> step 2 times
+  else if(step_rate > isr_rate_max) { // If steprate > the limit >> step 2 times
     step_rate = (step_rate >> 1)&0x7fff;
     step_loops = 2;
   }
@@ -126,17 +184,16 @@ FORCE_INLINE unsigned short calc_timer(uint16_t step_rate, uint8_t& step_loops)
 
   if(step_rate < (F_CPU/500000)) step_rate = (F_CPU/500000);
   step_rate -= (F_CPU/500000); // Correct for minimal speed
-  if(step_rate >= (8*256)){ // higher step rate
-    unsigned short table_address = (unsigned short)&speed_lookuptable_fast[(unsigned char)(step_rate>>8)][0];
-    unsigned char tmp_step_rate = (step_rate & 0x00ff);
-    uint16_t gain = (uint16_t)pgm_read_word_near(table_address+2);
+  if(step_rate >= (SPEED_TABLE_SLOW_SIZE << SPEED_TABLE_SLOW_SHIFT)){ // higher step rate
+    const uint16_t *table_address = speed_lookuptable_fast.entry[(unsigned char)(step_rate>>SPEED_TABLE_FAST_SHIFT)];
+    unsigned char tmp_step_rate = (unsigned char)(step_rate << (8 - SPEED_TABLE_FAST_SHIFT)); // fraction of the entry spacing in 1/256
+    uint16_t gain = (uint16_t)pgm_read_word_near(table_address+1);
     timer = (unsigned short)pgm_read_word_near(table_address) - MUL8x16R8(tmp_step_rate, gain);
   }
   else { // lower step rates
-    unsigned short table_address = (unsigned short)&speed_lookuptable_slow[0][0];
-    table_address += ((step_rate)>>1) & 0xfffc;
+    const uint16_t *table_address = speed_lookuptable_slow.entry[(step_rate>>SPEED_TABLE_SLOW_SHIFT) & 0xff];
     timer = (unsigned short)pgm_read_word_near(table_address);
-    timer -= (((unsigned short)pgm_read_word_near(table_address+2) * (unsigned char)(step_rate & 0x0007))>>3);
+    timer -= (((unsigned short)pgm_read_word_near(table_address+1) * (unsigned char)(step_rate & 0x0007))>>3);
   }
   if(timer < 100) { timer = 100; }//(20kHz this should never happen)////MSG_STEPPER_TOO_HIGH c=0 r=0
   return timer;
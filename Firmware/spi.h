@@ -19,6 +19,10 @@
 extern "C" {
 #endif //defined(__cplusplus)
 
+// Ends the multiple block read the SD card may be left in (cardreader.cpp), before another
+// device is selected on the shared bus.
+extern void spi_sd_stream_end(void);
+
 static inline void spi_init()
 {
 	DDRB &= ~((1 << DD_SCK) | (1 << DD_MOSI) | (1 << DD_MISO));
@@ -29,8 +33,12 @@ static inline void spi_init()
 	SPSR = 0x00;
 }
 
+// Setup the bus for the TMC2130 drivers or the xflash. Called from the main loop and from the power panic
+// interrupt, which abandons the SD card read first (CardReader::readStreamAbandon()), so that no CMD12
+// is sent in the middle of a transfer.
 static inline void spi_setup(uint8_t spcr, uint8_t spsr)
 {
+	spi_sd_stream_end();
 	SPCR = spcr;
 	SPSR = spsr;
 }
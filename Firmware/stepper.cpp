@@ -29,6 +29,8 @@
 #include "lcd.h"
 #include "cardreader.h"
 #include "speed_lookuptable.h"
+#include "scurve.h"
+#include "fastdiv.h"
 #if defined(DIGIPOTSS_PIN) && DIGIPOTSS_PIN > -1
 #include <SPI.h>
 #endif
@@ -99,6 +101,32 @@ static_assert(TMC2130_MINIMUM_DELAY 1, // this will fail to compile when non-emp
 
 #endif //TMC2130_DEDGE_STEPPING
 
+// Step pulses of all axes by a single toggle of PORTC. Without the double edge stepping,
+// the drivers need the minimum pulse width of the per axis writes.
+#if defined(STEPPER_BATCH_STEPS) && !(defined(TMC2130_DEDGE_STEPPING) && \
+    ((MOTHERBOARD == BOARD_RAMBO_MINI_1_0) || (MOTHERBOARD == BOARD_RAMBO_MINI_1_3) || (MOTHERBOARD == BOARD_EINSY_1_0a)))
+#undef STEPPER_BATCH_STEPS
+#endif
+#if defined(STEPPER_BATCH_STEPS) && (defined(DEBUG_XSTEP_DUP_PIN) || defined(DEBUG_YSTEP_DUP_PIN))
+#error "STEPPER_BATCH_STEPS does not drive the duplicate step pins"
+#endif
+
+#ifdef STEPPER_BATCH_STEPS
+// Bit of an axis step pin in PORTC, see sm4_do_step()
+#define __STEP_BIT(IO) _BV(DIO ## IO ## _PIN)
+#define _STEP_BIT(IO) __STEP_BIT(IO)
+#define STEP_BIT(axis) _STEP_BIT(_STEP_PIN_##axis)
+
+// One Bresenham step of an axis, collecting the step pulse into step_mask. dda selects the counter width (lo or wide).
+#define STEP_BATCH_AXIS(axis, dda) \
+    counter[axis].dda += current_block->steps[axis].dda; \
+    if (counter[axis].dda > 0) { \
+        counter[axis].dda -= current_block->step_event_count.dda; \
+        count_position[axis] += count_direction[axis]; \
+        step_mask |= STEP_BIT(axis); \
+    }
+#endif //STEPPER_BATCH_STEPS
+
 
 //===========================================================================
 //=============================public variables  ============================
@@ -119,6 +147,14 @@ static uint16_t acc_step_rate; // needed for deccelaration start point
 static uint8_t  step_loops;
 static uint16_t OCR1A_nominal;
 static uint8_t  step_loops_nominal;
+#ifdef STEP_LOOPS_ADAPTIVE
+static uint16_t step_isr_rate_max = STEP_ISR_RATE_DEFAULT; // multi-stepping limit, see calc_timer()
+static uint16_t busy_avg16;  // running average of the ISR busy time, timer ticks * 16
+static st_isr_stats_t isr_stats;
+#define STEP_ISR_RATE_LIMIT step_isr_rate_max
+#else
+#define STEP_ISR_RATE_LIMIT STEP_ISR_RATE_DEFAULT
+#endif //STEP_LOOPS_ADAPTIVE
 
 #ifdef VERBOSE_CHECK_HIT_ENDSTOPS
 volatile long endstops_trigsteps[3]={0,0,0};
@@ -159,6 +195,7 @@ volatile signed char count_direction[NUM_AXIS] = { 1, 1, 1, 1};
   static uint16_t main_Rate;
   static uint16_t eISR_Rate;
   static uint32_t eISR_Err;
+  static uint16_t eISR_Rate_inv; // fastdiv_rate_inv(current_block->advance_rate), 0 if not calculated yet
 
   static uint16_t current_adv_steps;
   static uint16_t target_adv_steps;
@@ -173,6 +210,56 @@ volatile signed char count_direction[NUM_AXIS] = { 1, 1, 1, 1};
   #define _NEXT_ISR(T)    OCR1A = T
 #endif
 
+#ifdef INPUT_SHAPING
+#if !defined(STEPPER_BATCH_STEPS) || !defined(LIN_ADVANCE)
+#error "INPUT_SHAPING requires STEPPER_BATCH_STEPS and LIN_ADVANCE"
+#endif
+#if defined(BACKLASH_X) || defined(BACKLASH_Y)
+#error "INPUT_SHAPING does not support BACKLASH_X and BACKLASH_Y"
+#endif
+static_assert((SHAPING_SLOTS & (SHAPING_SLOTS - 1)) == 0 && SHAPING_SLOTS <= 256, "SHAPING_SLOTS has to be a power of two");
+
+#define SHAPING_SLOT_TICKS (1U << SHAPING_SLOT_SHIFT)
+
+// Input shaper of an axis, see input_shaper.h. The Bresenham steps of a shaped axis are not
+// output, but collected into the step history. The shaper sets the direction pin of the axis with
+// every step it emits, as xyzcal, homing and D2130 drive the pin directly between the moves.
+struct shaper_axis_t
+{
+  shaper_params_t params;
+  int8_t in;          // Bresenham steps of the current ISR invocation
+  int8_t slot_steps;  // Bresenham steps of the current slot
+  uint8_t echo_frac;  // fraction of the delayed steps carried to the next slot (1/65536 step)
+  int16_t echo;       // delayed steps released over the current slot (1/256 step)
+  int16_t echo_done;  // part of echo released so far
+  int16_t pos;        // shaped minus emitted position (1/256 step)
+  int8_t history[SHAPING_SLOTS]; // Bresenham steps of the past slots
+};
+
+static shaper_axis_t shaper[2];
+static uint8_t shaper_step_mask;  // step bits of the shaped axes, see STEP_BIT()
+static bool shaper_bypass;        // the current block passes the steps without delay (homing)
+static uint8_t shaper_slot;       // history index of the current slot
+static uint16_t shaper_slot_time; // timer ticks elapsed in the current slot
+static uint8_t shaper_idle_slots = SHAPING_SLOTS; // slots without Bresenham steps, the history is empty at SHAPING_SLOTS
+
+void shaper_isr(uint16_t elapsed);
+
+// Move the steps of the shaped axes out of step_mask into the shaper input.
+#define SHAPER_COLLECT(step_mask) \
+    if (step_mask & shaper_step_mask) { \
+      if (step_mask & shaper_step_mask & STEP_BIT(X_AXIS)) \
+        shaper[X_AXIS].in += count_direction[X_AXIS]; \
+      if (step_mask & shaper_step_mask & STEP_BIT(Y_AXIS)) \
+        shaper[Y_AXIS].in += count_direction[Y_AXIS]; \
+      step_mask &= ~shaper_step_mask; \
+    }
+#define SHAPED_AXIS(axis) (shaper_step_mask & STEP_BIT(axis))
+#else
+#define SHAPER_COLLECT(step_mask)
+#define SHAPED_AXIS(axis) 0
+#endif //INPUT_SHAPING
+
 #ifdef DEBUG_STEPPER_TIMER_MISSED
 extern bool stepper_timer_overflow_state;
 extern uint16_t stepper_timer_overflow_last;
@@ -266,6 +353,36 @@ void invert_z_endstop(bool endstop_invert)
 //  step_events_completed reaches block->decelerate_after after which it decelerates until the trapezoid generator is reset.
 //  The slope of acceleration is calculated using v = u + at where t is the accumulated timer values of the steps so far.
 
+#ifdef STEP_LOOPS_ADAPTIVE
+// Move the multi-stepping limit according to the load of the interrupt: the running average of the
+// ISR busy time relative to the period until the next ISR (OCR1A). Above the load target while single
+// stepping, the limit is lowered, so that the faster moves are stepped twice per ISR. While multi-stepping,
+// the limit is raised as long as the single stepped equivalent (step_loops times more frequent ISR)
+// stays below the target. The busy time of a multi-stepped ISR overestimates the single stepped one,
+// which gives the hysteresis between the two.
+FORCE_INLINE void step_loops_adapt(uint16_t busy)
+{
+  if (busy > isr_stats.busy_max)
+    isr_stats.busy_max = busy;
+  busy_avg16 += busy - (busy_avg16 >> 4);
+  const uint16_t busy_budget = (busy_avg16 >> 4) * STEP_ISR_LOAD_DIV;
+  if (step_loops == 1) {
+    if (busy_budget > OCR1A && step_isr_rate_max > STEP_ISR_RATE_MIN) {
+      step_isr_rate_max -= step_isr_rate_max >> 6;
+      if (step_isr_rate_max < STEP_ISR_RATE_MIN)
+        step_isr_rate_max = STEP_ISR_RATE_MIN;
+    }
+  } else {
+    // step_loops >> 1 is log2(step_loops) for 2 and 4
+    if ((busy_budget << (step_loops >> 1)) < OCR1A && step_isr_rate_max < STEP_ISR_RATE_MAX) {
+      step_isr_rate_max += (step_isr_rate_max >> 6) + 1;
+      if (step_isr_rate_max > STEP_ISR_RATE_MAX)
+        step_isr_rate_max = STEP_ISR_RATE_MAX;
+    }
+  }
+}
+#endif //STEP_LOOPS_ADAPTIVE
+
 // "The Stepper Driver Interrupt" - This timer interrupt is the workhorse.
 // It pops blocks from the block_buffer and executes them by pulsing the stepper pins appropriately.
 ISR(TIMER1_COMPA_vect) {
@@ -274,15 +391,38 @@ ISR(TIMER1_COMPA_vect) {
 	if (sp < SP_min) SP_min = sp;
 #endif //DEBUG_STACK_MONITOR
 
+#ifdef INPUT_SHAPING
+  // Timer1 runs in the CTC mode, OCR1A is the period since the previous invocation.
+  const uint16_t elapsed = shaper_step_mask ? OCR1A : 0;
+#endif //INPUT_SHAPING
+
 #ifdef LIN_ADVANCE
     advance_isr_scheduler();
 #else
     isr();
 #endif
 
+#ifdef INPUT_SHAPING
+  if (shaper_step_mask)
+    shaper_isr(elapsed);
+#endif //INPUT_SHAPING
+
+#ifdef STEP_LOOPS_ADAPTIVE
+  // Timer1 runs in the CTC mode, TCNT1 counts the ticks since the compare match which started the ISR.
+  const uint16_t busy = TCNT1;
+#endif //STEP_LOOPS_ADAPTIVE
+
   // Don't run the ISR faster than possible
   // Is there a 8us time left before the next interrupt triggers?
   if (OCR1A < TCNT1 + 16) {
+#ifdef STEP_LOOPS_ADAPTIVE
+    // Missed the next step: back off quickly.
+    step_isr_rate_max -= step_isr_rate_max >> 3;
+    if (step_isr_rate_max < STEP_ISR_RATE_MIN)
+      step_isr_rate_max = STEP_ISR_RATE_MIN;
+    if (isr_stats.overruns != UINT16_MAX)
+      ++isr_stats.overruns;
+#endif //STEP_LOOPS_ADAPTIVE
 #ifdef DEBUG_STEPPER_TIMER_MISSED
     // Verify whether the next planned timer interrupt has not been missed already.
     // This debugging test takes < 1.125us
@@ -300,7 +440,29 @@ ISR(TIMER1_COMPA_vect) {
     // Fix the next interrupt to be executed after 8us from now.
     OCR1A = TCNT1 + 16;
   }
+#ifdef STEP_LOOPS_ADAPTIVE
+  else if (current_block)
+    step_loops_adapt(busy);
+#endif //STEP_LOOPS_ADAPTIVE
+}
+
+#ifdef STEP_LOOPS_ADAPTIVE
+void st_get_isr_stats(st_isr_stats_t &stats)
+{
+  CRITICAL_SECTION_START;
+  stats = isr_stats;
+  stats.step_loops = step_loops;
+  stats.isr_rate_max = step_isr_rate_max;
+  CRITICAL_SECTION_END;
+}
+
+void st_reset_isr_stats()
+{
+  CRITICAL_SECTION_START;
+  memset(&isr_stats, 0, sizeof(isr_stats));
+  CRITICAL_SECTION_END;
 }
+#endif //STEP_LOOPS_ADAPTIVE
 
 uint8_t last_dir_bits = 0;
 
@@ -374,7 +536,7 @@ FORCE_INLINE void stepper_next_block()
     // state is reached.
     step_loops_nominal = 0;
     acc_step_rate = uint16_t(current_block->initial_rate);
-    acceleration_time = calc_timer(acc_step_rate, step_loops);
+    acceleration_time = calc_timer(acc_step_rate, step_loops, STEP_ISR_RATE_LIMIT);
 
 #ifdef LIN_ADVANCE
     if (current_block->use_advance_lead) {
@@ -383,6 +545,7 @@ FORCE_INLINE void stepper_next_block()
     e_steps = 0;
     nextAdvanceISR = ADV_NEVER;
     LA_phase = -1;
+    eISR_Rate_inv = 0;
 #endif
 
     if (current_block->flag & BLOCK_FLAG_E_RESET) {
@@ -412,18 +575,26 @@ FORCE_INLINE void stepper_next_block()
     // Set directions.
     out_bits = current_block->direction_bits;
     // Set the direction bits (X_AXIS=A_AXIS and Y_AXIS=B_AXIS for COREXY)
+#ifdef INPUT_SHAPING
+    shaper_bypass = check_endstops;
+#endif //INPUT_SHAPING
+    // The shaper sets the direction pins of the shaped axes when it emits their steps.
     if((out_bits & (1<<X_AXIS))!=0){
-      WRITE_NC(X_DIR_PIN, INVERT_X_DIR);
+      if (!SHAPED_AXIS(X_AXIS))
+        WRITE_NC(X_DIR_PIN, INVERT_X_DIR);
       count_direction[X_AXIS]=-1;
     } else {
-      WRITE_NC(X_DIR_PIN, !INVERT_X_DIR);
+      if (!SHAPED_AXIS(X_AXIS))
+        WRITE_NC(X_DIR_PIN, !INVERT_X_DIR);
       count_direction[X_AXIS]=1;
     }
     if((out_bits & (1<<Y_AXIS))!=0){
-      WRITE_NC(Y_DIR_PIN, INVERT_Y_DIR);
+      if (!SHAPED_AXIS(Y_AXIS))
+        WRITE_NC(Y_DIR_PIN, INVERT_Y_DIR);
       count_direction[Y_AXIS]=-1;
     } else {
-      WRITE_NC(Y_DIR_PIN, !INVERT_Y_DIR);
+      if (!SHAPED_AXIS(Y_AXIS))
+        WRITE_NC(Y_DIR_PIN, !INVERT_Y_DIR);
       count_direction[Y_AXIS]=1;
     }
     if ((out_bits & (1<<Z_AXIS)) != 0) {   // -direction
@@ -639,6 +810,34 @@ FORCE_INLINE void stepper_check_endstops()
 
 FORCE_INLINE void stepper_tick_lowres()
 {
+#ifdef STEPPER_BATCH_STEPS
+  MSerial.checkRx(); // Check for serial chars, once per interrupt.
+  for (uint8_t i=0; i < step_loops; ++ i) { // Take multiple steps per interrupt (For high speed moves)
+    uint8_t step_mask = 0;
+    STEP_BATCH_AXIS(X_AXIS, lo);
+    STEP_BATCH_AXIS(Y_AXIS, lo);
+    STEP_BATCH_AXIS(Z_AXIS, lo);
+#ifdef LIN_ADVANCE
+    // The extruder is stepped by advance_isr(), count the steps only.
+    counter[E_AXIS].lo += current_block->steps[E_AXIS].lo;
+    if (counter[E_AXIS].lo > 0) {
+      counter[E_AXIS].lo -= current_block->step_event_count.lo;
+      count_position[E_AXIS] += count_direction[E_AXIS];
+      e_steps += count_direction[E_AXIS];
+    }
+#else
+    STEP_BATCH_AXIS(E_AXIS, lo);
+#if defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
+    if (step_mask & STEP_BIT(E_AXIS))
+      fsensor.stStep(count_direction[E_AXIS] < 0);
+#endif //defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
+#endif
+    SHAPER_COLLECT(step_mask);
+    PINC = step_mask; // toggle step signals by mask
+    if(++ step_events_completed.lo >= current_block->step_event_count.lo)
+      break;
+  }
+#else
   for (uint8_t i=0; i < step_loops; ++ i) { // Take multiple steps per interrupt (For high speed moves)
     MSerial.checkRx(); // Check for serial chars.
     // Step in X axis
@@ -697,10 +896,39 @@ FORCE_INLINE void stepper_tick_lowres()
     if(++ step_events_completed.lo >= current_block->step_event_count.lo)
       break;
   }
+#endif //STEPPER_BATCH_STEPS
 }
 
 FORCE_INLINE void stepper_tick_highres()
 {
+#ifdef STEPPER_BATCH_STEPS
+  MSerial.checkRx(); // Check for serial chars, once per interrupt.
+  for (uint8_t i=0; i < step_loops; ++ i) { // Take multiple steps per interrupt (For high speed moves)
+    uint8_t step_mask = 0;
+    STEP_BATCH_AXIS(X_AXIS, wide);
+    STEP_BATCH_AXIS(Y_AXIS, wide);
+    STEP_BATCH_AXIS(Z_AXIS, wide);
+#ifdef LIN_ADVANCE
+    // The extruder is stepped by advance_isr(), count the steps only.
+    counter[E_AXIS].wide += current_block->steps[E_AXIS].wide;
+    if (counter[E_AXIS].wide > 0) {
+      counter[E_AXIS].wide -= current_block->step_event_count.wide;
+      count_position[E_AXIS] += count_direction[E_AXIS];
+      e_steps += count_direction[E_AXIS];
+    }
+#else
+    STEP_BATCH_AXIS(E_AXIS, wide);
+#if defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
+    if (step_mask & STEP_BIT(E_AXIS))
+      fsensor.stStep(count_direction[E_AXIS] < 0);
+#endif //defined(FILAMENT_SENSOR) && (FILAMENT_SENSOR_TYPE == FSENSOR_PAT9125)
+#endif
+    SHAPER_COLLECT(step_mask);
+    PINC = step_mask; // toggle step signals by mask
+    if(++ step_events_completed.wide >= current_block->step_event_count.wide)
+      break;
+  }
+#else
   for (uint8_t i=0; i < step_loops; ++ i) { // Take multiple steps per interrupt (For high speed moves)
     MSerial.checkRx(); // Check for serial chars.
     // Step in X axis
@@ -759,25 +987,27 @@ FORCE_INLINE void stepper_tick_highres()
     if(++ step_events_completed.wide >= current_block->step_event_count.wide)
       break;
   }
+#endif //STEPPER_BATCH_STEPS
 }
 
 
 #ifdef LIN_ADVANCE
-// @wavexx: fast uint16_t division for small dividends<5
-//          q/3 based on "Hacker's delight" formula
-FORCE_INLINE uint16_t fastdiv(uint16_t q, uint8_t d)
-{
-    if(d != 3) return q >> (d / 2);
-    else return ((uint32_t)0xAAAB * q) >> 17;
-}
-
 FORCE_INLINE void advance_spread(uint16_t timer)
 {
     eISR_Err += timer;
 
-    uint8_t ticks = 0;
+    uint16_t ticks = 0;
     while(eISR_Err >= current_block->advance_rate)
     {
+        if (ticks == 3)
+        {
+            // >4 ticks are still possible on slow moves, divide by the reciprocal of the advance rate.
+            // It is calculated once per block, when needed.
+            if (!eISR_Rate_inv)
+                eISR_Rate_inv = fastdiv_rate_inv(current_block->advance_rate);
+            ticks += fastdiv_rate(eISR_Err, current_block->advance_rate, eISR_Rate_inv);
+            break;
+        }
         ++ticks;
         eISR_Err -= current_block->advance_rate;
     }
@@ -788,14 +1018,7 @@ FORCE_INLINE void advance_spread(uint16_t timer)
         return;
     }
 
-    if (ticks <= 3)
-        eISR_Rate = fastdiv(timer, ticks + 1);
-    else
-    {
-        // >4 ticks are still possible on slow moves
-        eISR_Rate = timer / (ticks + 1);
-    }
-
+    eISR_Rate = fastdiv(timer, ticks + 1);
     nextAdvanceISR = eISR_Rate;
 }
 #endif
@@ -831,12 +1054,15 @@ FORCE_INLINE void isr() {
       if (step_events_completed.wide <= current_block->accelerate_until) {
         // v = t * a   ->   acc_step_rate = acceleration_time * current_block->acceleration_rate
         acc_step_rate = MUL24x24R24(acceleration_time, current_block->acceleration_rate);
+#ifdef S_CURVE_ACCELERATION
+        acc_step_rate = scurve_gain(acc_step_rate, current_block->cruise_rate - current_block->initial_rate, current_block->accel_dv_inv);
+#endif
         acc_step_rate += uint16_t(current_block->initial_rate);
         // upper limit
         if(acc_step_rate > uint16_t(current_block->nominal_rate))
           acc_step_rate = current_block->nominal_rate;
         // step_rate to timer interval
-        uint16_t timer = calc_timer(acc_step_rate, step_loops);
+        uint16_t timer = calc_timer(acc_step_rate, step_loops, STEP_ISR_RATE_LIMIT);
         _NEXT_ISR(timer);
         acceleration_time += timer;
 #ifdef LIN_ADVANCE
@@ -851,6 +1077,9 @@ FORCE_INLINE void isr() {
       }
       else if (step_events_completed.wide > current_block->decelerate_after) {
         uint16_t step_rate = MUL24x24R24(deceleration_time, current_block->acceleration_rate);
+#ifdef S_CURVE_ACCELERATION
+        step_rate = scurve_gain(step_rate, current_block->cruise_rate - current_block->final_rate, current_block->decel_dv_inv);
+#endif
 
         if (step_rate > acc_step_rate) { // Check step_rate stays positive
             step_rate = uint16_t(current_block->final_rate);
@@ -864,7 +1093,7 @@ FORCE_INLINE void isr() {
         }
 
         // Step_rate to timer interval.
-        uint16_t timer = calc_timer(step_rate, step_loops);
+        uint16_t timer = calc_timer(step_rate, step_loops, STEP_ISR_RATE_LIMIT);
         _NEXT_ISR(timer);
         deceleration_time += timer;
 
@@ -883,7 +1112,7 @@ FORCE_INLINE void isr() {
         if (! step_loops_nominal) {
           // Calculation of the steady state timer rate has been delayed to the 1st tick of the steady state to lower
           // the initial interrupt blocking.
-          OCR1A_nominal = calc_timer(uint16_t(current_block->nominal_rate), step_loops);
+          OCR1A_nominal = calc_timer(uint16_t(current_block->nominal_rate), step_loops, STEP_ISR_RATE_LIMIT);
           step_loops_nominal = step_loops;
 
 #ifdef LIN_ADVANCE
@@ -1061,6 +1290,155 @@ FORCE_INLINE void advance_isr_scheduler() {
 }
 #endif // LIN_ADVANCE
 
+#ifdef INPUT_SHAPING
+// Close the current slot: store its Bresenham steps into the history and sum up the delayed
+// steps released over the next slot.
+FORCE_INLINE void shaper_next_slot()
+{
+  bool idle = true;
+  for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis) {
+    shaper_axis_t &a = shaper[axis];
+    a.pos += a.echo - a.echo_done;
+    a.history[shaper_slot] = a.slot_steps;
+    if (a.slot_steps)
+      idle = false;
+    a.slot_steps = 0;
+  }
+  shaper_slot = (shaper_slot + 1) & (SHAPING_SLOTS - 1);
+
+  for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis) {
+    shaper_axis_t &a = shaper[axis];
+    int32_t echo = a.echo_frac;
+    for (uint8_t i = 0; i < SHAPER_IMPULSES_MAX - 1; ++i) {
+      if (!a.params.amp[i])
+        continue;
+      // Interpolate between the slot at the whole delay and the one before it.
+      const uint8_t slot = (shaper_slot - a.params.slots[i]) & (SHAPING_SLOTS - 1);
+      const uint8_t frac = a.params.frac[i];
+      const int16_t steps = int16_t(256 - frac) * a.history[slot]
+        + int16_t(frac) * a.history[(slot - 1) & (SHAPING_SLOTS - 1)];
+      echo += int32_t(steps) * a.params.amp[i];
+    }
+    a.echo = echo >> 8;
+    a.echo_frac = echo & 0xff;
+    a.echo_done = 0;
+  }
+
+  if (!idle)
+    shaper_idle_slots = 0;
+  else if (shaper_idle_slots < SHAPING_SLOTS)
+    ++shaper_idle_slots;
+}
+
+// Feed the Bresenham steps of the ISR invocation into the shaper of an axis, release the delayed
+// steps due until now and return the number of steps to emit.
+FORCE_INLINE int8_t shaper_axis_isr(shaper_axis_t &a)
+{
+  const int16_t done = (int32_t(a.echo) * shaper_slot_time) >> SHAPING_SLOT_SHIFT;
+  a.pos += done - a.echo_done;
+  a.echo_done = done;
+  if (a.in) {
+    if (shaper_bypass)
+      a.pos += int16_t(a.in) << 8;
+    else {
+      a.pos += int16_t(a.in) * a.params.amp0;
+      a.slot_steps += a.in;
+    }
+    a.in = 0;
+  }
+  const int8_t n = (a.pos + 128) >> 8;
+  a.pos -= int16_t(n) << 8;
+  return n;
+}
+
+// Runs after the Bresenham steps and the advance ticks of every invocation while an axis is shaped.
+FORCE_INLINE void shaper_isr(uint16_t elapsed)
+{
+  if (shaper_idle_slots < SHAPING_SLOTS) {
+    shaper_slot_time += elapsed;
+    while (shaper_slot_time >= SHAPING_SLOT_TICKS) {
+      shaper_slot_time -= SHAPING_SLOT_TICKS;
+      shaper_next_slot();
+    }
+  } else {
+    // The history is empty, start the first slot with the first delayed step.
+    if (!(shaper[X_AXIS].in | shaper[Y_AXIS].in))
+      return;
+    if (!shaper_bypass) {
+      shaper_idle_slots = 0;
+      shaper_slot_time = 0;
+    }
+  }
+
+  int8_t nx = shaper_axis_isr(shaper[X_AXIS]);
+  int8_t ny = shaper_axis_isr(shaper[Y_AXIS]);
+  if (nx) {
+    if (nx < 0) {
+      WRITE_NC(X_DIR_PIN, INVERT_X_DIR);
+      nx = -nx;
+    } else
+      WRITE_NC(X_DIR_PIN, !INVERT_X_DIR);
+  }
+  if (ny) {
+    if (ny < 0) {
+      WRITE_NC(Y_DIR_PIN, INVERT_Y_DIR);
+      ny = -ny;
+    } else
+      WRITE_NC(Y_DIR_PIN, !INVERT_Y_DIR);
+  }
+  while (nx | ny) {
+    uint8_t step_mask = 0;
+    if (nx) {
+      step_mask |= STEP_BIT(X_AXIS);
+      --nx;
+    }
+    if (ny) {
+      step_mask |= STEP_BIT(Y_AXIS);
+      --ny;
+    }
+    PINC = step_mask; // toggle step signals by mask
+  }
+
+  // Keep releasing the delayed steps while the Bresenham steps are slow or stopped. The LIN_ADVANCE
+  // scheduler counts the remaining period of the main ISR down, split it into halves at the end,
+  // so that no invocation comes too close to the next one.
+  if (shaper_idle_slots < SHAPING_SLOTS) {
+    if (OCR1A > 2 * SHAPING_ISR_PERIOD)
+      OCR1A = SHAPING_ISR_PERIOD;
+    else if (OCR1A > SHAPING_ISR_PERIOD)
+      OCR1A = OCR1A / 2;
+  }
+}
+
+// Reset the dynamic state of the shaper of an axis.
+static void shaper_reset(uint8_t axis)
+{
+  shaper_axis_t &a = shaper[axis];
+  const shaper_params_t params = a.params;
+  memset(&a, 0, sizeof(a));
+  a.params = params;
+}
+
+void st_set_shaper(uint8_t axis, const shaper_params_t *params)
+{
+  st_synchronize();
+  CRITICAL_SECTION_START;
+  const uint8_t bit = (axis == X_AXIS) ? STEP_BIT(X_AXIS) : STEP_BIT(Y_AXIS);
+  if (params) {
+    shaper[axis].params = *params;
+    shaper_step_mask |= bit;
+  } else
+    shaper_step_mask &= ~bit;
+  shaper_reset(axis);
+  CRITICAL_SECTION_END;
+}
+
+bool st_shaping_busy()
+{
+  return shaper_idle_slots < SHAPING_SLOTS;
+}
+#endif //INPUT_SHAPING
+
 void st_init()
 {
 #ifdef TMC2130
@@ -1238,8 +1616,7 @@ void st_init()
   // Set the timer pre-scaler
   // Generally we use a divider of 8, resulting in a 2MHz timer
   // frequency on a 16MHz MCU. If you are going to change this, be
-  // sure to regenerate speed_lookuptable.h with
-  // create_speed_lookuptable.py
+  // sure to update SPEED_TABLE_PRESCALER in speed_lookuptable.h
   TCCR1B = (TCCR1B & ~(0x07<<CS10)) | (2<<CS10);
 
   // Plan the first interrupt after 8ms from now.
@@ -1261,6 +1638,19 @@ void st_init()
   current_adv_steps = 0;
 #endif
 
+#ifdef INPUT_SHAPING
+  // The shaper settings are loaded before, keep them.
+  shaper_idle_slots = SHAPING_SLOTS;
+  shaper_reset(X_AXIS);
+  shaper_reset(Y_AXIS);
+#endif //INPUT_SHAPING
+
+#ifdef STEP_LOOPS_ADAPTIVE
+  step_isr_rate_max = STEP_ISR_RATE_DEFAULT;
+  busy_avg16 = 0;
+  memset(&isr_stats, 0, sizeof(isr_stats));
+#endif //STEP_LOOPS_ADAPTIVE
+
   enable_endstops(true); // Start with endstops active. After homing they can be disabled
 
   ENABLE_STEPPER_DRIVER_INTERRUPT();
@@ -1288,7 +1678,14 @@ void st_reset_timer()
 // Block until all buffered steps are executed
 void st_synchronize()
 {
+#ifdef PLANNER_STARVATION_COUNT
+	planner_starvation_disarm();
+#endif /* PLANNER_STARVATION_COUNT */
+#ifdef INPUT_SHAPING
+	while(blocks_queued() || st_shaping_busy())
+#else
 	while(blocks_queued())
+#endif //INPUT_SHAPING
 	{
 #ifdef TMC2130
 		manage_heater();
@@ -69,6 +69,30 @@ void invert_z_endstop(bool endstop_invert);
 
 void checkStepperErrors(); //Print errors detected by the stepper
 
+#ifdef STEP_LOOPS_ADAPTIVE
+// Multi-stepping state of the stepper interrupt (D30)
+struct st_isr_stats_t
+{
+  uint16_t isr_rate_max; // current limit of the ISR rate (steps/s) before multi-stepping
+  uint8_t step_loops;    // steps per ISR chosen by the last calc_timer()
+  uint16_t busy_max;     // longest ISR since the last reset, in timer ticks (0.5us)
+  uint16_t overruns;     // ISR invocations which missed their next compare match
+};
+
+void st_get_isr_stats(st_isr_stats_t &stats);
+void st_reset_isr_stats();
+#endif //STEP_LOOPS_ADAPTIVE
+
+#ifdef INPUT_SHAPING
+#include "input_shaper.h"
+
+// Set the input shaper of the X or Y axis, NULL disables it. Waits for the moves in progress to finish.
+void st_set_shaper(uint8_t axis, const shaper_params_t *params);
+
+// The shapers still emit delayed steps.
+bool st_shaping_busy();
+#endif //INPUT_SHAPING
+
 extern block_t *current_block;  // A pointer to the block currently being traced
 extern volatile long count_position[NUM_AXIS];
 
@@ -0,0 +1,63 @@
+#include "telemetry.h"
+
+#ifdef FEED_TELEMETRY
+
+#include "planner.h"
+#include "stepper.h"
+#include "cmdqueue.h"
+#include "system_timer.h"
+
+telemetry_t telemetry;
+
+static uint16_t stepper_overruns()
+{
+#ifdef STEP_LOOPS_ADAPTIVE
+    st_isr_stats_t stats;
+    st_get_isr_stats(stats);
+    return stats.overruns;
+#else
+    return 0;
+#endif //STEP_LOOPS_ADAPTIVE
+}
+
+void telemetry_update(bool printing)
+{
+    const uint32_t now = _millis();
+    const uint32_t elapsed = now - telemetry.last_ms;
+    telemetry.last_ms = now;
+    telemetry.planner_ms[telemetry_bin(moves_planned(), BLOCK_BUFFER_SIZE - 1)] += elapsed;
+    telemetry.cmdqueue_ms[telemetry_bin(buflen, CMDQUEUE_SIZE)] += elapsed;
+    if (printing && planner_starved())
+        telemetry.starved_ms += elapsed;
+}
+
+void telemetry_reset()
+{
+    memset(&telemetry, 0, sizeof(telemetry));
+    telemetry.overruns = stepper_overruns();
+    telemetry.last_ms = _millis();
+    MYSERIAL.rxMaxReset();
+    planner_starvation_reset();
+}
+
+static void print_histogram(const char *name_P, const uint32_t *ms)
+{
+    printf_P(name_P);
+    for (uint8_t i = 0; i < TELEMETRY_BINS; ++i)
+        printf_P(i ? PSTR(",%lu") : PSTR("%lu"), (unsigned long)ms[i]);
+}
+
+void telemetry_report()
+{
+    // The stepper statistics were reset by D30 R.
+    const uint16_t overruns = stepper_overruns();
+    if (overruns < telemetry.overruns)
+        telemetry.overruns = 0;
+    printf_P(PSTR("starved=%u starved_ms=%lu rx_max=%u rx_full=%u overruns=%u"), planner_starvation_count(),
+        (unsigned long)telemetry.starved_ms, (unsigned)MYSERIAL.rxMax(), telemetry.rx_full, overruns - telemetry.overruns);
+    print_histogram(PSTR(" planner_ms="), telemetry.planner_ms);
+    print_histogram(PSTR(" cmdqueue_ms="), telemetry.cmdqueue_ms);
+    printf_P(PSTR("\n"));
+}
+
+#endif // FEED_TELEMETRY
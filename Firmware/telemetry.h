@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Feed telemetry: how well the serial line or the SD card keep the planner fed.
+ *
+ * The time is split by the occupancy of the planner queue and of the command queue, sampled from
+ * manage_inactivity(). The time with the planner queue drained by the stepper during a print is
+ * counted apart, together with the moves which found it drained (planner_starvation_count()), the
+ * high water mark of the serial receive ring (MarlinSerial::rxMax()), its overflows and the stepper
+ * interrupt overruns. Printed by D31, periodically by M155 C8.
+ *
+ * Enabled by FEED_TELEMETRY in the variant, on top of PLANNER_STARVATION_COUNT. Takes 77 bytes of SRAM.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include "Marlin.h"
+
+#ifdef FEED_TELEMETRY
+#ifndef PLANNER_STARVATION_COUNT
+#error "FEED_TELEMETRY needs PLANNER_STARVATION_COUNT"
+#endif //PLANNER_STARVATION_COUNT
+
+// Bins of the occupancy histograms, each one covers an equal part of the queue.
+#define TELEMETRY_BINS 8
+
+struct telemetry_t
+{
+    uint32_t planner_ms[TELEMETRY_BINS];  // time by the moves in the planner queue
+    uint32_t cmdqueue_ms[TELEMETRY_BINS]; // time by the commands in the command queue
+    uint32_t starved_ms;                  // time with the planner queue drained during a print
+    uint16_t rx_full;                     // "Full RX Buffer" events, characters dropped
+    uint16_t overruns;                    // stepper interrupt overruns at the last reset
+    uint32_t last_ms;                     // time of the last sample
+};
+
+extern telemetry_t telemetry;
+
+// Account the time since the last call to the current occupancy of the queues. printing tells
+// whether a drained planner queue is starved.
+extern void telemetry_update(bool printing);
+
+// Start the telemetry over, the planner starvation count included.
+extern void telemetry_reset();
+
+// Print the telemetry in one line.
+extern void telemetry_report();
+
+// Bin of the histograms for the occupancy n of a queue, which holds up to max entries.
+static inline uint8_t telemetry_bin(uint8_t n, uint8_t max) { return uint16_t(n) * TELEMETRY_BINS / (max + 1); }
+
+#endif // FEED_TELEMETRY
+
+#endif // TELEMETRY_H
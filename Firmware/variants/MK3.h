@@ -202,6 +202,8 @@
 #define CMD_DIAGNOSTICS //Show cmd queue length on printer display
 #endif /* DEBUG_BUILD */
 
+//#define FEED_TELEMETRY // Feed telemetry in D31 and M155 C8, 77 bytes of SRAM. Needs PLANNER_STARVATION_COUNT.
+
 
 #define LINEARITY_CORRECTION
 #define TMC2130_LINEARITY_CORRECTION
@@ -23,6 +23,7 @@
 #define MOTHERBOARD BOARD_EINSY_1_0a
 #define STEEL_SHEET
 #define HAS_SECOND_SERIAL_PORT
+#define RX_BUFFER_SIZE 256 // serial receive ring in bytes, a power of two up to 512
 
 // PSU
 // #define PSU_Delta                                 // uncomment if DeltaElectronics PSU installed
@@ -204,6 +205,8 @@
 #define CMD_DIAGNOSTICS //Show cmd queue length on printer display
 #endif /* DEBUG_BUILD */
 
+//#define FEED_TELEMETRY // Feed telemetry in D31 and M155 C8, 77 bytes of SRAM. Needs PLANNER_STARVATION_COUNT.
+
 
 #define LINEARITY_CORRECTION
 #define TMC2130_LINEARITY_CORRECTION
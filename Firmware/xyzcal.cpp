@@ -950,6 +950,7 @@ BedSkewOffsetDetectionResultType xyzcal_scan_and_process(){
 	int16_t y = _Y;
 	const int16_t z = _Z;
 
+	static_assert(sizeof(block_t) * BLOCK_BUFFER_SIZE >= XYZCAL_SCRATCH_SIZE, "block_buffer is too small for the scan");
 	uint8_t *matrix32 = (uint8_t *)block_buffer;
 	uint16_t *pattern08 = (uint16_t *)(matrix32 + 32 * 32);
 	uint16_t *pattern10 = (uint16_t *)(pattern08 + 12);
@@ -17,3 +17,6 @@ extern bool xyzcal_spiral8(int16_t cx, int16_t cy, int16_t z0, int16_t dz, int16
 //extern int8_t xyzcal_measure_pinda_hysteresis(int16_t min_z, int16_t max_z, uint16_t delay_us, uint8_t samples);
 
 extern BedSkewOffsetDetectionResultType xyzcal_find_bed_induction_sensor_point_xy();
+
+// Bytes of block_buffer used by the scan: the 32x32 image and the two patterns of 12 words.
+#define XYZCAL_SCRATCH_SIZE (32 * 32 + 2 * 12 * sizeof(uint16_t))
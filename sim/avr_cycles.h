@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief AVR cycle cost model of the stepper interrupt.
+ *
+ * The host build does not execute AVR instructions, so the cost of an ISR invocation is
+ * estimated from the events the simulator observes: register accesses, program memory reads,
+ * Bresenham loops, emitted step pulses and block switches. The constants were fitted to the
+ * avr-gcc -Os listing of stepper.cpp and to the timing noted in stepper_tick_lowres()
+ * (13.38-14.63us steady state, 25.12us while accelerating at a single step per ISR).
+ */
+
+#ifndef AVR_CYCLES_H
+#define AVR_CYCLES_H
+
+#include <stdint.h>
+#include "sim_avr.h"
+
+namespace sim
+{
+namespace cycles
+{
+// ISR entry (vector jump, register push) and exit (pop, reti), including the
+// advance_isr_scheduler() bookkeeping and the timer overrun check.
+static const uint16_t ISR_OVERHEAD = 94;
+
+// Register accesses
+static const uint8_t IO_READ = 1;           // in, sbis/sbic
+static const uint8_t IO_WRITE = 2;          // out, sbi/cbi
+static const uint8_t MEM_READ = 2;          // lds
+static const uint8_t MEM_WRITE = 2;         // sts
+static const uint8_t PGM_READ = 5;          // lpm r, Z+ word with address setup
+static const uint8_t SERIAL_POLL = 4;       // lds + sbrc, no character waiting
+
+// Stepper loop
+static const uint8_t LOOP_OVERHEAD = 18;    // loop counter, step_events_completed increment, checkRx call
+static const uint8_t AXIS_LOWRES = 16;      // 16bit counter add + compare per axis
+static const uint8_t AXIS_HIGHRES = 28;     // 32bit counter add + compare per axis
+static const uint8_t STEP = 14;             // counter subtract and count_position update of a step
+static const uint8_t STEP_BATCH = 1;        // step_mask update, STEPPER_BATCH_STEPS (the PINC write is counted as I/O)
+static const uint8_t RAMP = 70;             // calc_timer() body and acceleration_time update
+static const uint8_t MUL24x24 = 45;         // acceleration_rate * acceleration_time
+static const uint8_t SCURVE = 130;          // scurve_gain(): six 16x16 and 32x16 bit multiplications
+static const uint16_t BLOCK_SETUP = 160;    // stepper_next_block() incl. LA and direction setup
+static const uint16_t BLOCK_END = 40;       // plan_discard_current_block()
+static const uint8_t STEP_LOOPS_ADAPT = 24; // step_loops_adapt(), STEP_LOOPS_ADAPTIVE (the TCNT1 read is counted as I/O)
+static const uint8_t SHAPER = 110;          // shaper_isr(): echo release (16x16 multiply), input and emission of X and Y
+static const uint16_t SHAPER_SLOT = 260;    // shaper_next_slot(): history update and 4 interpolated impulses
+
+static const uint8_t AXES = 4;
+} // namespace cycles
+
+/// Events recorded during a single invocation of the stepper ISR.
+struct isr_events_t
+{
+    io_stats_t io;
+    uint16_t loops;          ///< Bresenham iterations (step_events_completed increments)
+    uint16_t steps;          ///< step pulses emitted on all axes
+    uint8_t ramp_updates;    ///< calc_timer() evaluations while accelerating or decelerating
+    uint8_t scurve_updates;  ///< ramp updates evaluating the S-curve (S_CURVE_ACCELERATION)
+    uint8_t block_setups;    ///< blocks fetched from the planner
+    uint8_t block_ends;      ///< blocks discarded
+    bool lowres;             ///< the block uses the 16bit DDA
+    bool shaping;            ///< the input shaper was busy (INPUT_SHAPING)
+    uint8_t shaper_slots;    ///< slots of the step history closed by the shaper
+};
+
+/// Estimated AVR cycles of an ISR invocation, before the ISR epilogue.
+inline uint32_t estimate_cycles(const isr_events_t &ev)
+{
+    using namespace cycles;
+    uint32_t c = ISR_OVERHEAD;
+    c += ev.io.io_reads * IO_READ + ev.io.io_writes * IO_WRITE;
+    c += ev.io.mem_reads * MEM_READ + ev.io.mem_writes * MEM_WRITE;
+    c += ev.io.pgm_reads * PGM_READ + ev.io.serial_polls * SERIAL_POLL;
+    c += ev.loops * (LOOP_OVERHEAD + AXES * (ev.lowres ? AXIS_LOWRES : AXIS_HIGHRES));
+#if defined(STEPPER_BATCH_STEPS) && defined(TMC2130_DEDGE_STEPPING)
+    c += (ev.loops + ev.steps) * STEP_BATCH;
+#endif
+    c += ev.steps * STEP;
+    c += ev.ramp_updates * (RAMP + MUL24x24);
+    c += ev.scurve_updates * SCURVE;
+    c += ev.block_setups * BLOCK_SETUP + ev.block_ends * BLOCK_END;
+#ifdef STEP_LOOPS_ADAPTIVE
+    c += STEP_LOOPS_ADAPT;
+#endif
+    if (ev.shaping)
+        c += SHAPER + ev.shaper_slots * SHAPER_SLOT;
+    return c;
+}
+
+} // namespace sim
+
+#endif // AVR_CYCLES_H
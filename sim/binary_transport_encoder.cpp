@@ -0,0 +1,132 @@
+#include "binary_transport_encoder.h"
+#include <stdint.h>
+#include "binary_transport.h"
+#include "cmdqueue.h"
+
+namespace sim
+{
+
+uint16_t bt_crc16(const uint8_t *data, size_t size)
+{
+    uint16_t crc = 0xffff;
+    while (size--) {
+        crc ^= uint16_t(*data++) << 8;
+        for (int i = 0; i < 8; ++i)
+            crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x1021) : uint16_t(crc << 1);
+    }
+    return crc;
+}
+
+void bt_frame(uint8_t type, uint16_t n, const std::vector<uint8_t> &payload, std::vector<uint8_t> &out)
+{
+    out.push_back(BT_SYNC);
+    const size_t start = out.size();
+    out.push_back(type);
+    out.push_back(uint8_t(payload.size()));
+    out.push_back(uint8_t(n));
+    out.push_back(uint8_t(n >> 8));
+    out.insert(out.end(), payload.begin(), payload.end());
+    const uint16_t crc = bt_crc16(out.data() + start, out.size() - start);
+    out.push_back(uint8_t(crc));
+    out.push_back(uint8_t(crc >> 8));
+}
+
+// The decimal number at p in units of 10^-decimals, rounded half away from zero. Returns false if
+// it is not a number or out of the int32 range.
+static bool fixed_point(const char *&p, int decimals, int32_t &value)
+{
+    const bool negative = (*p == '-');
+    if (negative || *p == '+')
+        ++p;
+    int64_t mantissa = 0;
+    int frac = -1;
+    bool round_up = false;
+    bool digits = false;
+    for (;; ++p) {
+        if (*p >= '0' && *p <= '9') {
+            digits = true;
+            if (frac < decimals) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa > INT32_MAX)
+                    return false;
+                if (frac >= 0)
+                    ++frac;
+            } else if (frac == decimals) {
+                // The first dropped digit decides the rounding.
+                round_up = (*p >= '5');
+                ++frac;
+            }
+        } else if (*p == '.' && frac < 0)
+            frac = 0;
+        else
+            break;
+    }
+    if (!digits)
+        return false;
+    for (int i = (frac < 0) ? 0 : frac; i < decimals; ++i)
+        mantissa *= 10;
+    mantissa += round_up;
+    if (mantissa > INT32_MAX)
+        return false;
+    value = int32_t(negative ? -mantissa : mantissa);
+    return true;
+}
+
+// The payload of a move frame, false if the line is not a plain G0/G1 move in the range of the frame.
+static bool move_payload(const std::string &line, std::vector<uint8_t> &payload)
+{
+    const char *p = line.c_str();
+    if (p[0] != 'G' || (p[1] != '0' && p[1] != '1') || (p[2] != ' ' && p[2] != 0 && p[2] != '\n'))
+        return false;
+    int32_t values[MOVE_WORD_F + 1];
+    uint8_t seen = 0;
+    for (p += 2;;) {
+        uint8_t word;
+        switch (*p++) {
+        case ' ': continue;
+        case 0:
+        case '\n': {
+            payload.push_back(seen);
+            for (uint8_t w = 0; w <= MOVE_WORD_F; ++w)
+                if (seen & (1 << w))
+                    for (int i = 0; i < 4; ++i)
+                        payload.push_back(uint8_t(uint32_t(values[w]) >> (8 * i)));
+            return true;
+        }
+        case 'X': word = X_AXIS; break;
+        case 'Y': word = Y_AXIS; break;
+        case 'Z': word = Z_AXIS; break;
+        case 'E': word = E_AXIS; break;
+        case 'F': word = MOVE_WORD_F; break;
+        default: return false;
+        }
+        // A repeated word is left to the G-code parser.
+        if (seen & (1 << word))
+            return false;
+        seen |= 1 << word;
+        if (!fixed_point(p, word == MOVE_WORD_F ? 3 : 5, values[word]))
+            return false;
+        // Like code_move_words(), a following E is an exponent for the G-code parser.
+        if (*p == 'E')
+            return false;
+    }
+}
+
+bool bt_encode_line(const std::string &line, uint16_t n, std::vector<uint8_t> &out)
+{
+    std::vector<uint8_t> payload;
+    if (move_payload(line, payload)) {
+        bt_frame(BT_FRAME_MOVE, n, payload, out);
+        return true;
+    }
+    payload.assign(line.begin(), line.end());
+    if (!payload.empty() && payload.back() == '\n')
+        payload.pop_back();
+    // Cut like an overlong text line.
+    if (payload.size() > MAX_CMD_SIZE - 1)
+        payload.resize(MAX_CMD_SIZE - 1);
+    bt_frame(BT_FRAME_GCODE, n, payload, out);
+    return false;
+}
+
+} // namespace sim
@@ -0,0 +1,33 @@
+/**
+ * @file
+ * @brief Host side encoder of the binary G-code transport (binary_transport.h).
+ *
+ * Plain G0/G1 moves are sent in move frames, the values converted from their decimal text without
+ * rounding through a float. Every other command, and the moves with values the frame cannot carry,
+ * is sent as text in a G-code frame.
+ */
+
+#ifndef BINARY_TRANSPORT_ENCODER_H
+#define BINARY_TRANSPORT_ENCODER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+
+/// CRC of the frames, CRC-16/CCITT-FALSE.
+uint16_t bt_crc16(const uint8_t *data, size_t size);
+
+/// Appends the frame of the type (BT_FRAME_MOVE, BT_FRAME_GCODE) with the line number n to out.
+void bt_frame(uint8_t type, uint16_t n, const std::vector<uint8_t> &payload, std::vector<uint8_t> &out);
+
+/// Appends the frame of the command to out. The line is prepared like by meatpack_line(): without
+/// the comment and the surrounding white space, not empty, the terminating '\n' is optional. Returns
+/// true for a move frame.
+bool bt_encode_line(const std::string &line, uint16_t n, std::vector<uint8_t> &out);
+
+} // namespace sim
+
+#endif // BINARY_TRANSPORT_ENCODER_H
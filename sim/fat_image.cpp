@@ -0,0 +1,379 @@
+/**
+ * @file
+ * @brief Disk images of FAT formatted SD cards.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <set>
+#include <stdexcept>
+#include "fat_image.h"
+
+namespace sim
+{
+
+namespace
+{
+
+struct node_t
+{
+    std::string name;
+    bool dir;
+    const fat_file_t *file;
+    uint16_t time;
+    std::vector<node_t> children;
+    std::vector<uint32_t> chain;
+};
+
+void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+
+// The date of all the entries: 2024-01-01
+const uint16_t fat_date = (2024 - 1980) << 9 | 1 << 5 | 1;
+
+uint16_t fat_time(uint32_t n)
+{
+    return (n / 1800 % 24) << 11 | (n / 30 % 60) << 5 | n % 30;
+}
+
+std::string upper(const std::string &s)
+{
+    std::string u(s);
+    for (char &c : u)
+        if (c >= 'a' && c <= 'z')
+            c -= 'a' - 'A';
+    return u;
+}
+
+bool short_name_char(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || (c && strchr("$%'-_@~`!(){}^#&", c));
+}
+
+std::string short_name_chars(const std::string &s)
+{
+    std::string r;
+    for (char c : upper(s))
+        if (short_name_char(c))
+            r += c;
+    return r;
+}
+
+uint8_t lfn_checksum(const char *name)
+{
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < 11; ++i)
+        sum = ((sum & 1) << 7) + (sum >> 1) + uint8_t(name[i]);
+    return sum;
+}
+
+class builder_t
+{
+public:
+    builder_t(const fat_volume_t &volume)
+        : volume(volume)
+    {
+        const uint32_t spc = volume.blocks_per_cluster;
+        if (!spc || (spc & (spc - 1)) || volume.blocks <= FAT_VOLUME_START)
+            throw std::invalid_argument("fat_image: bad geometry");
+        const bool fat32 = volume.fat_type == 32;
+        entry_size = fat32 ? 4 : 2;
+        reserved = fat32 ? 32 : 1;
+        root_entries = fat32 ? 0 : 512;
+        const uint32_t root_blocks = root_entries * 32 / 512;
+        const uint32_t volume_blocks = volume.blocks - FAT_VOLUME_START;
+        const uint32_t estimate = (volume_blocks - reserved - root_blocks) / spc;
+        fat_blocks = ((estimate + 2) * entry_size + 511) / 512;
+        fat_start = FAT_VOLUME_START + reserved;
+        root_start = fat_start + 2 * fat_blocks;
+        data_start = root_start + root_blocks;
+        cluster_count = (volume.blocks - data_start) / spc;
+        if ((fat32 && cluster_count < 65525) || (!fat32 && (cluster_count < 4085 || cluster_count >= 65525)))
+            throw std::invalid_argument("fat_image: the cluster count does not match the FAT type");
+        fat.resize(2);
+        fat[0] = fat32 ? 0x0FFFFFF8 : 0xFFF8;
+        fat[1] = eoc();
+    }
+
+    std::vector<uint8_t> build(node_t &root)
+    {
+        write_boot_sectors();
+        if (volume.fat_type == 32) {
+            root.chain = allocate(dir_clusters(root), 0);
+        } else if (dir_entries(root) > root_entries) {
+            throw std::invalid_argument("fat_image: too many entries in the FAT16 root directory");
+        }
+        layout(root, 0, true);
+        for (uint8_t copy = 0; copy < 2; ++copy)
+            for (uint32_t i = 0; i < fat.size(); ++i) {
+                const uint32_t offset = i * entry_size;
+                uint8_t *p = at(fat_start + copy * fat_blocks + offset / 512) + offset % 512;
+                if (entry_size == 4)
+                    put32(p, fat[i]);
+                else
+                    put16(p, fat[i]);
+            }
+        return image;
+    }
+
+private:
+    const fat_volume_t volume;
+    uint8_t entry_size;
+    uint32_t reserved;
+    uint32_t root_entries;
+    uint32_t fat_blocks;
+    uint32_t fat_start;
+    uint32_t root_start;
+    uint32_t data_start;
+    uint32_t cluster_count;
+    std::vector<uint32_t> fat;
+    std::vector<uint8_t> image;
+
+    uint32_t eoc() const { return volume.fat_type == 32 ? 0x0FFFFFFF : 0xFFFF; }
+    uint32_t cluster_bytes() const { return volume.blocks_per_cluster * 512; }
+    uint32_t cluster_block(uint32_t cluster) const { return data_start + (cluster - 2) * volume.blocks_per_cluster; }
+
+    uint8_t *at(uint32_t block)
+    {
+        if (image.size() < (size_t(block) + 1) * 512)
+            image.resize((size_t(block) + 1) * 512);
+        return &image[size_t(block) * 512];
+    }
+
+    void write_boot_sectors()
+    {
+        const bool fat32 = volume.fat_type == 32;
+        const uint32_t volume_blocks = volume.blocks - FAT_VOLUME_START;
+
+        uint8_t *mbr = at(0);
+        uint8_t *part = mbr + 0x1BE;
+        part[4] = fat32 ? 0x0C : 0x0E;
+        put32(part + 8, FAT_VOLUME_START);
+        put32(part + 12, volume_blocks);
+        mbr[510] = 0x55;
+        mbr[511] = 0xAA;
+
+        uint8_t *bs = at(FAT_VOLUME_START);
+        memcpy(bs, fat32 ? "\xEB\x58\x90" "SIMFAT  " : "\xEB\x3C\x90" "SIMFAT  ", 11);
+        put16(bs + 0x0B, 512);
+        bs[0x0D] = volume.blocks_per_cluster;
+        put16(bs + 0x0E, reserved);
+        bs[0x10] = 2;
+        put16(bs + 0x11, root_entries);
+        if (!fat32 && volume_blocks < 0x10000)
+            put16(bs + 0x13, volume_blocks);
+        else
+            put32(bs + 0x20, volume_blocks);
+        bs[0x15] = 0xF8;
+        put32(bs + 0x1C, FAT_VOLUME_START);
+        uint8_t *ext = bs + 0x24;
+        if (fat32) {
+            put32(bs + 0x24, fat_blocks);
+            put32(bs + 0x2C, 2);  // root directory cluster
+            put16(bs + 0x30, 1);  // FSInfo sector
+            ext = bs + 0x40;
+        } else {
+            put16(bs + 0x16, fat_blocks);
+        }
+        ext[0] = 0x80;
+        ext[2] = 0x29;
+        put32(ext + 3, 0x20240101);
+        memcpy(ext + 7, fat32 ? "NO NAME    FAT32   " : "NO NAME    FAT16   ", 19);
+        bs[510] = 0x55;
+        bs[511] = 0xAA;
+
+        if (fat32) {
+            uint8_t *info = at(FAT_VOLUME_START + 1);
+            put32(info, 0x41615252);
+            put32(info + 484, 0x61417272);
+            put32(info + 488, 0xFFFFFFFF);  // free clusters unknown
+            put32(info + 492, 0xFFFFFFFF);
+            put32(info + 508, 0xAA550000);
+        }
+    }
+
+    std::vector<uint32_t> allocate(uint32_t clusters, uint16_t run)
+    {
+        std::vector<uint32_t> chain;
+        uint32_t next = fat.size();
+        for (uint32_t i = 0; i < clusters; ++i) {
+            // a free cluster between the runs
+            if (run && i && i % run == 0)
+                ++next;
+            chain.push_back(next++);
+        }
+        if (next - 2 > cluster_count)
+            throw std::invalid_argument("fat_image: the volume is full");
+        fat.resize(next, 0);
+        for (uint32_t i = 0; i < chain.size(); ++i)
+            fat[chain[i]] = i + 1 < chain.size() ? chain[i + 1] : eoc();
+        return chain;
+    }
+
+    void write_chain(const std::vector<uint32_t> &chain, const uint8_t *data, size_t size)
+    {
+        for (size_t offset = 0; offset < size; offset += 512) {
+            const uint32_t cluster = chain[offset / cluster_bytes()];
+            const uint32_t block = cluster_block(cluster) + offset % cluster_bytes() / 512;
+            memcpy(at(block), data + offset, size - offset < 512 ? size - offset : 512);
+        }
+    }
+
+    static uint32_t lfn_entries(const node_t &node, const std::string &short_name)
+    {
+        return node.name == short_name ? 0 : (node.name.size() + 12) / 13;
+    }
+
+    // The 8.3 name of the node, "" if the name is not an upper case 8.3 one.
+    static std::string plain_short_name(const std::string &name)
+    {
+        const size_t dot = name.rfind('.');
+        const std::string base = name.substr(0, dot);
+        const std::string ext = dot == std::string::npos ? "" : name.substr(dot + 1);
+        if (base.empty() || base.size() > 8 || ext.size() > 3 || upper(name) != name
+            || short_name_chars(base) != base || short_name_chars(ext) != ext)
+            return "";
+        return name;
+    }
+
+    uint32_t dir_entries(const node_t &dir) const
+    {
+        uint32_t entries = 2;  // . and .., or the end of the root directory
+        for (const node_t &child : dir.children)
+            entries += 1 + lfn_entries(child, plain_short_name(child.name));
+        return entries;
+    }
+
+    uint32_t dir_clusters(const node_t &dir) const
+    {
+        return (dir_entries(dir) * 32 + cluster_bytes() - 1) / cluster_bytes();
+    }
+
+    static void put_entry(std::vector<uint8_t> &entries, const char *name, uint8_t attributes, uint32_t cluster,
+        uint32_t size, uint16_t time)
+    {
+        uint8_t e[32] = {};
+        memcpy(e, name, 11);
+        e[11] = attributes;
+        put16(e + 14, time);
+        put16(e + 16, fat_date);
+        put16(e + 18, fat_date);
+        put16(e + 20, cluster >> 16);
+        put16(e + 22, time);
+        put16(e + 24, fat_date);
+        put16(e + 26, cluster);
+        put32(e + 28, size);
+        entries.insert(entries.end(), e, e + sizeof(e));
+    }
+
+    static void put_lfn(std::vector<uint8_t> &entries, const std::string &name, const char *short_name)
+    {
+        static const uint8_t offsets[13] = { 1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30 };
+        const uint32_t count = (name.size() + 12) / 13;
+        for (uint32_t seq = count; seq > 0; --seq) {
+            uint8_t e[32] = {};
+            e[0] = seq | (seq == count ? 0x40 : 0);
+            e[11] = 0x0F;
+            e[13] = lfn_checksum(short_name);
+            for (uint8_t i = 0; i < 13; ++i) {
+                const size_t n = (seq - 1) * 13 + i;
+                put16(e + offsets[i], n < name.size() ? uint8_t(name[n]) : n == name.size() ? 0 : 0xFFFF);
+            }
+            entries.insert(entries.end(), e, e + sizeof(e));
+        }
+    }
+
+    // Allocates and writes the children of the directory, then the directory itself.
+    void layout(node_t &dir, uint32_t parent_cluster, bool root)
+    {
+        for (node_t &child : dir.children) {
+            if (child.dir) {
+                child.chain = allocate(dir_clusters(child), 0);
+            } else if (!child.file->content.empty()) {
+                const std::string &content = child.file->content;
+                child.chain = allocate((content.size() + cluster_bytes() - 1) / cluster_bytes(), child.file->run);
+                write_chain(child.chain, (const uint8_t *)content.data(), content.size());
+            }
+        }
+        const uint32_t self_cluster = dir.chain.empty() ? 0 : dir.chain[0];
+        for (node_t &child : dir.children)
+            if (child.dir)
+                layout(child, root ? 0 : self_cluster, false);
+
+        std::vector<uint8_t> entries;
+        if (!root) {
+            put_entry(entries, ".          ", 0x10, self_cluster, 0, dir.time);
+            put_entry(entries, "..         ", 0x10, parent_cluster, 0, dir.time);
+        }
+        std::set<std::string> used;
+        for (const node_t &child : dir.children) {
+            std::string short_name = plain_short_name(child.name);
+            const bool lfn = short_name.empty();
+            if (lfn) {
+                // The upper case name if it is a valid 8.3 one, a numeric tail otherwise
+                short_name = plain_short_name(upper(child.name));
+                const size_t dot = child.name.rfind('.');
+                const std::string base = short_name_chars(child.name.substr(0, dot));
+                const std::string ext = dot == std::string::npos ? "" : short_name_chars(child.name.substr(dot + 1)).substr(0, 3);
+                for (uint32_t n = 1; short_name.empty() || used.count(short_name); ++n) {
+                    const std::string tail = "~" + std::to_string(n);
+                    short_name = base.substr(0, 8 - tail.size()) + tail + (ext.empty() ? "" : "." + ext);
+                }
+            }
+            used.insert(short_name);
+            char name83[12];
+            const size_t dot = short_name.rfind('.');
+            snprintf(name83, sizeof(name83), "%-8s%-3s", short_name.substr(0, dot).c_str(),
+                dot == std::string::npos ? "" : short_name.substr(dot + 1).c_str());
+            if (lfn)
+                put_lfn(entries, child.name, name83);
+            put_entry(entries, name83, child.dir ? 0x10 : 0x20, child.chain.empty() ? 0 : child.chain[0],
+                child.dir ? 0 : child.file->content.size(), child.time);
+        }
+        if (root && volume.fat_type == 16) {
+            for (size_t offset = 0; offset < entries.size(); offset += 512)
+                memcpy(at(root_start + offset / 512), &entries[offset], entries.size() - offset < 512 ? entries.size() - offset : 512);
+        } else {
+            write_chain(dir.chain, entries.data(), entries.size());
+        }
+    }
+};
+
+} // namespace
+
+std::vector<uint8_t> fat_image(const fat_volume_t &volume, const std::vector<fat_file_t> &files)
+{
+    node_t root = { "", true, nullptr, 0, {}, {} };
+    uint32_t time = 0;
+    for (const fat_file_t &file : files) {
+        node_t *dir = &root;
+        size_t start = 0;
+        for (size_t slash; (slash = file.path.find('/', start)) != std::string::npos; start = slash + 1) {
+            const std::string name = file.path.substr(start, slash - start);
+            node_t *sub = nullptr;
+            for (node_t &child : dir->children)
+                if (child.dir && child.name == name)
+                    sub = &child;
+            if (!sub) {
+                dir->children.push_back({ name, true, nullptr, fat_time(time++), {}, {} });
+                sub = &dir->children.back();
+            }
+            dir = sub;
+        }
+        if (start < file.path.size())
+            dir->children.push_back({ file.path.substr(start), false, &file, fat_time(time++), {}, {} });
+    }
+    builder_t builder(volume);
+    return builder.build(root);
+}
+
+} // namespace sim
@@ -0,0 +1,44 @@
+/**
+ * @file
+ * @brief Disk images of FAT16 and FAT32 formatted SD cards for the emulated card (sd_card.h).
+ *
+ * The volume fills the first partition of the card. The files and their directories are written
+ * in the order given, the clusters allocated one after another, so the image ends at the last
+ * cluster used and the rest of the card reads zeros. A file can be split in runs of clusters with
+ * a free cluster between them, like a file written to a card full of deleted files.
+ */
+
+#ifndef FAT_IMAGE_H
+#define FAT_IMAGE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+
+struct fat_volume_t
+{
+    uint8_t fat_type;            ///< 16 or 32, must match the number of the clusters
+    uint32_t blocks;             ///< size of the card
+    uint8_t blocks_per_cluster;  ///< power of two
+};
+
+struct fat_file_t
+{
+    std::string path;            ///< '/' separated, a trailing '/' for an empty directory
+    std::string content;
+    uint16_t run;                ///< clusters of the fragments, 0 for a contiguous file
+};
+
+/// Block of the card the volume starts at, after the partition table.
+static const uint32_t FAT_VOLUME_START = 2048;
+
+/// Builds the image of the card. The names which are not upper case 8.3 ones get long file name
+/// entries. The modification times increase by two seconds from file to file.
+std::vector<uint8_t> fat_image(const fat_volume_t &volume, const std::vector<fat_file_t> &files);
+
+} // namespace sim
+
+#endif // FAT_IMAGE_H
@@ -0,0 +1,15 @@
+; Small segment arcs as produced by the arc welders of the slicers and by G2/G3 with short
+; segments. Used to benchmark planner_recalculate() (planner sqrt/block).
+G28
+G90
+M83
+M204 P1250 T1250
+G1 Z0.2 F720
+G1 X100 Y80 F9000
+G2 X100 Y80 I0 J20 E30 F3600
+G3 X100 Y80 I0 J20 E30 F3600
+G2 X100 Y90 I0 J5 E8 F2400
+G3 X100 Y90 I0 J5 E8 F2400
+G1 X120 Y90 E1 F3600
+G2 X120 Y90 I-10 J0 E15 F6000
+M400
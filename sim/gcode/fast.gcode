@@ -0,0 +1,16 @@
+; High step rates: diagonal travels and fast extrusion, with several steps per ISR invocation.
+G28
+G90
+M83
+M204 P4000 T4000
+G1 Z0.2 F720
+G1 X20 Y20 F12000
+G1 X230 Y200 F12000
+G1 X20 Y20
+G1 X230 Y20
+G1 X230 Y200
+G1 X20 Y200 E14 F9000
+G1 X20 Y20 E12
+G1 X230 Y20 E14
+G1 X20 Y200 F12000
+M400
@@ -0,0 +1,23 @@
+; Input shaping: MZV on X and ZVD on Y, short zig-zag perimeters, fast diagonal travels and a retraction.
+; Run with -p position.csv to write the shaped X/Y position versus time.
+G28
+G90
+M83
+M593 X F40 D0.1 T2
+M593 Y F50 D0.1 T1
+M204 P2000 T4000
+M900 K0.05
+G1 Z0.2 F720
+G1 X20 Y20 F12000
+G1 X60 Y20 E1.6 F3600
+G1 X60 Y21 E0.04
+G1 X20 Y21 E1.6
+G1 X20 Y22 E0.04
+G1 X60 Y22 E1.6
+G1 X61 Y25 E-0.8 F2100
+G1 X230 Y200 F12000
+G1 X20 Y20
+G1 X230 Y20
+G1 X20 Y200
+G4
+M400
@@ -0,0 +1,1468 @@
+; generated by PrusaSlicer 2.6.1 on 2023-10-02 at 10:12:41 UTC
+
+; external perimeters extrusion width = 0.45mm
+; perimeters extrusion width = 0.45mm
+; infill extrusion width = 0.45mm
+
+M73 P0 R12
+M73 Q0 S12
+M201 X1000 Y1000 Z200 E5000 ; sets maximum accelerations, mm/sec^2
+M203 X200 Y200 Z12 E120 ; sets maximum feedrates, mm / sec
+M204 P1250 R1250 T1250 ; sets acceleration (P, T) and retract acceleration (R), mm/sec^2
+M205 X8.00 Y8.00 Z0.40 E4.50 ; sets the jerk limits, mm/sec
+M205 S0 T0 ; sets the minimum extruding and travel feed rate, mm/sec
+;TYPE:Custom
+M862.3 P "MK3S" ; printer model check
+M862.1 P0.4 ; nozzle diameter check
+M115 U3.13.0 ; tell printer latest fw version
+G90 ; use absolute coordinates
+M83 ; extruder relative mode
+M104 S215 ; set extruder temp
+M140 S60 ; set bed temp
+M190 S60 ; wait for bed temp
+M109 S215 ; wait for extruder temp
+G28 W ; home all without mesh bed level
+G80 ; mesh bed leveling
+G1 Z0.2 F720
+G1 Y-3 F1000 ; go outside print area
+G92 E0
+G1 X60 E9 F1000 ; intro line
+G1 X100 E12.5 F1000 ; intro line
+G92 E0
+M221 S95
+G21 ; set units to millimeters
+G90 ; use absolute coordinates
+M83 ; use relative distances for extrusion
+M900 K0.05 ; Filament gcode LA 1.5
+M107
+;LAYER_CHANGE
+;Z:.2
+;HEIGHT:.2
+;BEFORE_LAYER_CHANGE
+G92 E0.0
+;.2
+
+
+;AFTER_LAYER_CHANGE
+;.2
+G1 E-.8 F2100
+G1 Z.6 F720
+G1 X134.775 Y113.975 F10800
+G1 Z.2 F720
+G1 E.8 F2100
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.748 Y114.182 E.00781
+G1 X134.668 Y114.375 E.00781
+G1 X134.541 Y114.541 E.00781
+G1 X134.375 Y114.668 E.00781
+G1 X134.182 Y114.748 E.00781
+G1 X133.975 Y114.775 E.00781
+G1 X116.025 Y114.775 E.67165
+G1 X115.818 Y114.748 E.00781
+G1 X115.625 Y114.668 E.00781
+G1 X115.459 Y114.541 E.00781
+G1 X115.332 Y114.375 E.00781
+G1 X115.252 Y114.182 E.00781
+G1 X115.225 Y113.975 E.00781
+G1 X115.225 Y96.025 E.67165
+G1 X115.252 Y95.818 E.00781
+G1 X115.332 Y95.625 E.00781
+G1 X115.459 Y95.459 E.00781
+G1 X115.625 Y95.332 E.00781
+G1 X115.818 Y95.252 E.00781
+G1 X116.025 Y95.225 E.00781
+G1 X133.975 Y95.225 E.67165
+G1 X134.182 Y95.252 E.00781
+G1 X134.375 Y95.332 E.00781
+G1 X134.541 Y95.459 E.00781
+G1 X134.668 Y95.625 E.00781
+G1 X134.748 Y95.818 E.00781
+G1 X134.775 Y96.025 E.00781
+G1 X134.775 Y113.975 E.67165
+M204 P1000
+G1 X134.325 Y113.525 F10800
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.298 Y113.732 E.00781
+G1 X134.218 Y113.925 E.00781
+G1 X134.091 Y114.091 E.00781
+G1 X133.925 Y114.218 E.00781
+G1 X133.732 Y114.298 E.00781
+G1 X133.525 Y114.325 E.00781
+G1 X116.475 Y114.325 E.63797
+G1 X116.268 Y114.298 E.00781
+G1 X116.075 Y114.218 E.00781
+G1 X115.909 Y114.091 E.00781
+G1 X115.782 Y113.925 E.00781
+G1 X115.702 Y113.732 E.00781
+G1 X115.675 Y113.525 E.00781
+G1 X115.675 Y96.475 E.63797
+G1 X115.702 Y96.268 E.00781
+G1 X115.782 Y96.075 E.00781
+G1 X115.909 Y95.909 E.00781
+G1 X116.075 Y95.782 E.00781
+G1 X116.268 Y95.702 E.00781
+G1 X116.475 Y95.675 E.00781
+G1 X133.525 Y95.675 E.63797
+G1 X133.732 Y95.702 E.00781
+G1 X133.925 Y95.782 E.00781
+G1 X134.091 Y95.909 E.00781
+G1 X134.218 Y96.075 E.00781
+G1 X134.298 Y96.268 E.00781
+G1 X134.325 Y96.475 E.00781
+G1 X134.325 Y113.525 E.63797
+M204 P800
+G1 X133.875 Y113.075 F10800
+;TYPE:External perimeter
+;WIDTH:0.45
+G1 F1500
+G1 X133.848 Y113.282 E.00781
+G1 X133.768 Y113.475 E.00781
+G1 X133.641 Y113.641 E.00781
+G1 X133.475 Y113.768 E.00781
+G1 X133.282 Y113.848 E.00781
+G1 X133.075 Y113.875 E.00781
+G1 X116.925 Y113.875 E.6043
+G1 X116.718 Y113.848 E.00781
+G1 X116.525 Y113.768 E.00781
+G1 X116.359 Y113.641 E.00781
+G1 X116.232 Y113.475 E.00781
+G1 X116.152 Y113.282 E.00781
+G1 X116.125 Y113.075 E.00781
+G1 X116.125 Y96.925 E.6043
+G1 X116.152 Y96.718 E.00781
+G1 X116.232 Y96.525 E.00781
+G1 X116.359 Y96.359 E.00781
+G1 X116.525 Y96.232 E.00781
+G1 X116.718 Y96.152 E.00781
+G1 X116.925 Y96.125 E.00781
+G1 X133.075 Y96.125 E.6043
+G1 X133.282 Y96.152 E.00781
+G1 X133.475 Y96.232 E.00781
+G1 X133.641 Y96.359 E.00781
+G1 X133.768 Y96.525 E.00781
+G1 X133.848 Y96.718 E.00781
+G1 X133.875 Y96.925 E.00781
+G1 X133.875 Y113.075 E.6043
+M204 P1000
+;TYPE:Solid infill
+;WIDTH:0.45
+G1 F1200
+G1 X116.35 Y96.575 F10800
+G1 X125 Y96.575 E.32366
+G1 X133.65 Y96.575 E.32366
+G1 X133.65 Y97.025 E.00748
+G1 X125.013 Y97.025 E.32318
+G1 X116.35 Y97.025 E.32415
+G1 X116.35 Y97.475 E.00748
+G1 X125.026 Y97.475 E.32464
+G1 X133.65 Y97.475 E.32269
+G1 X133.65 Y97.925 E.00748
+G1 X125.039 Y97.925 E.3222
+G1 X116.35 Y97.925 E.32512
+G1 X116.35 Y98.375 E.00748
+G1 X125.052 Y98.375 E.32561
+G1 X133.65 Y98.375 E.32172
+G1 X133.65 Y98.825 E.00748
+G1 X125.065 Y98.825 E.32123
+G1 X116.35 Y98.825 E.32609
+G1 X116.35 Y99.275 E.00748
+G1 X125.078 Y99.275 E.32658
+G1 X133.65 Y99.275 E.32074
+G1 X133.65 Y99.725 E.00748
+G1 X125.091 Y99.725 E.32026
+G1 X116.35 Y99.725 E.32707
+G1 X116.35 Y100.175 E.00748
+G1 X125.104 Y100.175 E.32755
+G1 X133.65 Y100.175 E.31977
+G1 X133.65 Y100.625 E.00748
+G1 X125.117 Y100.625 E.31928
+G1 X116.35 Y100.625 E.32804
+G1 X116.35 Y101.075 E.00748
+G1 X125.13 Y101.075 E.32853
+G1 X133.65 Y101.075 E.3188
+G1 X133.65 Y101.525 E.00748
+G1 X125.143 Y101.525 E.31831
+G1 X116.35 Y101.525 E.32901
+G1 X116.35 Y101.975 E.00748
+G1 X125.156 Y101.975 E.3295
+G1 X133.65 Y101.975 E.31783
+G1 X133.65 Y102.425 E.00748
+G1 X125.169 Y102.425 E.31734
+G1 X116.35 Y102.425 E.32999
+G1 X116.35 Y102.875 E.00748
+G1 X125.182 Y102.875 E.33047
+G1 X133.65 Y102.875 E.31685
+G1 X133.65 Y103.325 E.00748
+G1 X125.195 Y103.325 E.31637
+G1 X116.35 Y103.325 E.33096
+G1 X116.35 Y103.775 E.00748
+G1 X125.208 Y103.775 E.33145
+G1 X133.65 Y103.775 E.31588
+G1 X133.65 Y104.225 E.00748
+G1 X125.221 Y104.225 E.31539
+G1 X116.35 Y104.225 E.33193
+G1 X116.35 Y104.675 E.00748
+G1 X125.234 Y104.675 E.33242
+G1 X133.65 Y104.675 E.31491
+G1 X133.65 Y105.125 E.00748
+G1 X125.247 Y105.125 E.31442
+G1 X116.35 Y105.125 E.3329
+G1 X116.35 Y105.575 E.00748
+G1 X125.26 Y105.575 E.33339
+G1 X133.65 Y105.575 E.31393
+G1 X133.65 Y106.025 E.00748
+G1 X125.273 Y106.025 E.31345
+G1 X116.35 Y106.025 E.33388
+G1 X116.35 Y106.475 E.00748
+G1 X125.286 Y106.475 E.33436
+G1 X133.65 Y106.475 E.31296
+G1 X133.65 Y106.925 E.00748
+G1 X125.299 Y106.925 E.31247
+G1 X116.35 Y106.925 E.33485
+G1 X116.35 Y107.375 E.00748
+G1 X125.312 Y107.375 E.33534
+G1 X133.65 Y107.375 E.31199
+G1 X133.65 Y107.825 E.00748
+G1 X125.325 Y107.825 E.3115
+G1 X116.35 Y107.825 E.33582
+G1 X116.35 Y108.275 E.00748
+G1 X125.338 Y108.275 E.33631
+G1 X133.65 Y108.275 E.31102
+G1 X133.65 Y108.725 E.00748
+G1 X125.351 Y108.725 E.31053
+G1 X116.35 Y108.725 E.3368
+G1 X116.35 Y109.175 E.00748
+G1 X125.364 Y109.175 E.33728
+G1 X133.65 Y109.175 E.31004
+G1 X133.65 Y109.625 E.00748
+G1 X125.377 Y109.625 E.30956
+G1 X116.35 Y109.625 E.33777
+G1 X116.35 Y110.075 E.00748
+G1 X125.39 Y110.075 E.33826
+G1 X133.65 Y110.075 E.30907
+G1 X133.65 Y110.525 E.00748
+G1 X125.403 Y110.525 E.30858
+G1 X116.35 Y110.525 E.33874
+G1 X116.35 Y110.975 E.00748
+G1 X125.416 Y110.975 E.33923
+G1 X133.65 Y110.975 E.3081
+G1 X133.65 Y111.425 E.00748
+G1 X125.429 Y111.425 E.30761
+G1 X116.35 Y111.425 E.33971
+G1 X116.35 Y111.875 E.00748
+G1 X125.442 Y111.875 E.3402
+G1 X133.65 Y111.875 E.30712
+G1 X133.65 Y112.325 E.00748
+G1 X125.455 Y112.325 E.30664
+G1 X116.35 Y112.325 E.34069
+G1 X116.35 Y112.775 E.00748
+G1 X125.468 Y112.775 E.34117
+G1 X133.65 Y112.775 E.30615
+G1 X133.65 Y113.225 E.00748
+G1 X125.481 Y113.225 E.30566
+G1 X116.35 Y113.225 E.34166
+;WIPE_START
+G1 F8640
+G1 X113.15 Y113.225 E-.76
+;WIPE_END
+G1 E-.04 F2100
+M73 P10 R11
+;LAYER_CHANGE
+;Z:.35
+;HEIGHT:.15
+;BEFORE_LAYER_CHANGE
+G92 E0.0
+;.35
+
+
+;AFTER_LAYER_CHANGE
+;.35
+G1 E-.8 F2100
+G1 Z.75 F720
+M106 S255
+G1 X134.775 Y113.975 F10800
+G1 Z.35 F720
+G1 E.8 F2100
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.748 Y114.182 E.00586
+G1 X134.668 Y114.375 E.00586
+G1 X134.541 Y114.541 E.00586
+G1 X134.375 Y114.668 E.00586
+G1 X134.182 Y114.748 E.00586
+G1 X133.975 Y114.775 E.00586
+G1 X116.025 Y114.775 E.50374
+G1 X115.818 Y114.748 E.00586
+G1 X115.625 Y114.668 E.00586
+G1 X115.459 Y114.541 E.00586
+G1 X115.332 Y114.375 E.00586
+G1 X115.252 Y114.182 E.00586
+G1 X115.225 Y113.975 E.00586
+G1 X115.225 Y96.025 E.50374
+G1 X115.252 Y95.818 E.00586
+G1 X115.332 Y95.625 E.00586
+G1 X115.459 Y95.459 E.00586
+G1 X115.625 Y95.332 E.00586
+G1 X115.818 Y95.252 E.00586
+G1 X116.025 Y95.225 E.00586
+G1 X133.975 Y95.225 E.50374
+G1 X134.182 Y95.252 E.00586
+G1 X134.375 Y95.332 E.00586
+G1 X134.541 Y95.459 E.00586
+G1 X134.668 Y95.625 E.00586
+G1 X134.748 Y95.818 E.00586
+G1 X134.775 Y96.025 E.00586
+G1 X134.775 Y113.975 E.50374
+M204 P1000
+G1 X134.325 Y113.525 F10800
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.298 Y113.732 E.00586
+G1 X134.218 Y113.925 E.00586
+G1 X134.091 Y114.091 E.00586
+G1 X133.925 Y114.218 E.00586
+G1 X133.732 Y114.298 E.00586
+G1 X133.525 Y114.325 E.00586
+G1 X116.475 Y114.325 E.47848
+G1 X116.268 Y114.298 E.00586
+G1 X116.075 Y114.218 E.00586
+G1 X115.909 Y114.091 E.00586
+G1 X115.782 Y113.925 E.00586
+G1 X115.702 Y113.732 E.00586
+G1 X115.675 Y113.525 E.00586
+G1 X115.675 Y96.475 E.47848
+G1 X115.702 Y96.268 E.00586
+G1 X115.782 Y96.075 E.00586
+G1 X115.909 Y95.909 E.00586
+G1 X116.075 Y95.782 E.00586
+G1 X116.268 Y95.702 E.00586
+G1 X116.475 Y95.675 E.00586
+G1 X133.525 Y95.675 E.47848
+G1 X133.732 Y95.702 E.00586
+G1 X133.925 Y95.782 E.00586
+G1 X134.091 Y95.909 E.00586
+G1 X134.218 Y96.075 E.00586
+G1 X134.298 Y96.268 E.00586
+G1 X134.325 Y96.475 E.00586
+G1 X134.325 Y113.525 E.47848
+M204 P800
+G1 X133.875 Y113.075 F10800
+;TYPE:External perimeter
+;WIDTH:0.45
+G1 F1500
+G1 X133.848 Y113.282 E.00586
+G1 X133.768 Y113.475 E.00586
+G1 X133.641 Y113.641 E.00586
+G1 X133.475 Y113.768 E.00586
+G1 X133.282 Y113.848 E.00586
+G1 X133.075 Y113.875 E.00586
+G1 X116.925 Y113.875 E.45322
+G1 X116.718 Y113.848 E.00586
+G1 X116.525 Y113.768 E.00586
+G1 X116.359 Y113.641 E.00586
+G1 X116.232 Y113.475 E.00586
+G1 X116.152 Y113.282 E.00586
+G1 X116.125 Y113.075 E.00586
+G1 X116.125 Y96.925 E.45322
+G1 X116.152 Y96.718 E.00586
+G1 X116.232 Y96.525 E.00586
+G1 X116.359 Y96.359 E.00586
+G1 X116.525 Y96.232 E.00586
+G1 X116.718 Y96.152 E.00586
+G1 X116.925 Y96.125 E.00586
+G1 X133.075 Y96.125 E.45322
+G1 X133.282 Y96.152 E.00586
+G1 X133.475 Y96.232 E.00586
+G1 X133.641 Y96.359 E.00586
+G1 X133.768 Y96.525 E.00586
+G1 X133.848 Y96.718 E.00586
+G1 X133.875 Y96.925 E.00586
+G1 X133.875 Y113.075 E.45322
+M204 P1000
+;TYPE:Solid infill
+;WIDTH:0.45
+G1 F4200
+G1 X116.575 Y96.35 F10800
+G1 X116.575 Y105 E.24275
+G1 X116.575 Y113.65 E.24275
+G1 X117.025 Y113.65 E.00561
+G1 X117.038 Y105 E.24275
+G1 X117.025 Y96.35 E.24275
+G1 X117.475 Y96.35 E.00561
+G1 X117.501 Y105 E.24275
+G1 X117.475 Y113.65 E.24275
+G1 X117.925 Y113.65 E.00561
+G1 X117.964 Y105 E.24275
+G1 X117.925 Y96.35 E.24275
+G1 X118.375 Y96.35 E.00561
+G1 X118.427 Y105 E.24275
+G1 X118.375 Y113.65 E.24275
+G1 X118.825 Y113.65 E.00561
+G1 X118.89 Y105 E.24275
+G1 X118.825 Y96.35 E.24275
+G1 X119.275 Y96.35 E.00561
+G1 X119.353 Y105 E.24276
+G1 X119.275 Y113.65 E.24276
+G1 X119.725 Y113.65 E.00561
+G1 X119.816 Y105 E.24276
+G1 X119.725 Y96.35 E.24276
+G1 X120.175 Y96.35 E.00561
+G1 X120.279 Y105 E.24276
+G1 X120.175 Y113.65 E.24276
+G1 X120.625 Y113.65 E.00561
+G1 X120.742 Y105 E.24277
+G1 X120.625 Y96.35 E.24277
+G1 X121.075 Y96.35 E.00561
+G1 X121.205 Y105 E.24277
+G1 X121.075 Y113.65 E.24277
+G1 X121.525 Y113.65 E.00561
+G1 X121.668 Y105 E.24278
+G1 X121.525 Y96.35 E.24278
+G1 X121.975 Y96.35 E.00561
+G1 X122.131 Y105 E.24279
+G1 X121.975 Y113.65 E.24279
+G1 X122.425 Y113.65 E.00561
+G1 X122.594 Y105 E.24279
+G1 X122.425 Y96.35 E.24279
+G1 X122.875 Y96.35 E.00561
+G1 X123.057 Y105 E.2428
+G1 X122.875 Y113.65 E.2428
+G1 X123.325 Y113.65 E.00561
+G1 X123.52 Y105 E.24281
+G1 X123.325 Y96.35 E.24281
+G1 X123.775 Y96.35 E.00561
+G1 X123.983 Y105 E.24282
+G1 X123.775 Y113.65 E.24282
+G1 X124.225 Y113.65 E.00561
+G1 X124.446 Y105 E.24283
+G1 X124.225 Y96.35 E.24283
+G1 X124.675 Y96.35 E.00561
+G1 X124.909 Y105 E.24284
+G1 X124.675 Y113.65 E.24284
+G1 X125.125 Y113.65 E.00561
+G1 X125.372 Y105 E.24285
+G1 X125.125 Y96.35 E.24285
+G1 X125.575 Y96.35 E.00561
+G1 X125.835 Y105 E.24286
+G1 X125.575 Y113.65 E.24286
+G1 X126.025 Y113.65 E.00561
+G1 X126.298 Y105 E.24287
+G1 X126.025 Y96.35 E.24287
+G1 X126.475 Y96.35 E.00561
+G1 X126.761 Y105 E.24288
+G1 X126.475 Y113.65 E.24288
+G1 X126.925 Y113.65 E.00561
+G1 X127.224 Y105 E.24289
+G1 X126.925 Y96.35 E.24289
+G1 X127.375 Y96.35 E.00561
+G1 X127.687 Y105 E.2429
+G1 X127.375 Y113.65 E.2429
+G1 X127.825 Y113.65 E.00561
+G1 X128.15 Y105 E.24292
+G1 X127.825 Y96.35 E.24292
+G1 X128.275 Y96.35 E.00561
+G1 X128.613 Y105 E.24293
+G1 X128.275 Y113.65 E.24293
+G1 X128.725 Y113.65 E.00561
+G1 X129.076 Y105 E.24295
+G1 X128.725 Y96.35 E.24295
+G1 X129.175 Y96.35 E.00561
+G1 X129.539 Y105 E.24296
+G1 X129.175 Y113.65 E.24296
+G1 X129.625 Y113.65 E.00561
+G1 X130.002 Y105 E.24298
+G1 X129.625 Y96.35 E.24298
+G1 X130.075 Y96.35 E.00561
+G1 X130.465 Y105 E.24299
+G1 X130.075 Y113.65 E.24299
+G1 X130.525 Y113.65 E.00561
+G1 X130.928 Y105 E.24301
+G1 X130.525 Y96.35 E.24301
+G1 X130.975 Y96.35 E.00561
+G1 X131.391 Y105 E.24303
+G1 X130.975 Y113.65 E.24303
+G1 X131.425 Y113.65 E.00561
+G1 X131.854 Y105 E.24305
+G1 X131.425 Y96.35 E.24305
+G1 X131.875 Y96.35 E.00561
+G1 X132.317 Y105 E.24306
+G1 X131.875 Y113.65 E.24306
+G1 X132.325 Y113.65 E.00561
+G1 X132.78 Y105 E.24308
+G1 X132.325 Y96.35 E.24308
+G1 X132.775 Y96.35 E.00561
+G1 X133.243 Y105 E.2431
+G1 X132.775 Y113.65 E.2431
+G1 X133.225 Y113.65 E.00561
+G1 X133.706 Y105 E.24312
+G1 X133.225 Y96.35 E.24312
+;WIPE_START
+G1 F8640
+G1 X130.025 Y96.35 E-.76
+;WIPE_END
+G1 E-.04 F2100
+M73 P24 R10
+;LAYER_CHANGE
+;Z:.5
+;HEIGHT:.15
+;BEFORE_LAYER_CHANGE
+G92 E0.0
+;.5
+
+
+;AFTER_LAYER_CHANGE
+;.5
+G1 E-.8 F2100
+G1 Z.9 F720
+M204 P1000
+G1 X134.775 Y113.975 F10800
+G1 Z.5 F720
+G1 E.8 F2100
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.748 Y114.182 E.00586
+G1 X134.668 Y114.375 E.00586
+G1 X134.541 Y114.541 E.00586
+G1 X134.375 Y114.668 E.00586
+G1 X134.182 Y114.748 E.00586
+G1 X133.975 Y114.775 E.00586
+G1 X116.025 Y114.775 E.50374
+G1 X115.818 Y114.748 E.00586
+G1 X115.625 Y114.668 E.00586
+G1 X115.459 Y114.541 E.00586
+G1 X115.332 Y114.375 E.00586
+G1 X115.252 Y114.182 E.00586
+G1 X115.225 Y113.975 E.00586
+G1 X115.225 Y96.025 E.50374
+G1 X115.252 Y95.818 E.00586
+G1 X115.332 Y95.625 E.00586
+G1 X115.459 Y95.459 E.00586
+G1 X115.625 Y95.332 E.00586
+G1 X115.818 Y95.252 E.00586
+G1 X116.025 Y95.225 E.00586
+G1 X133.975 Y95.225 E.50374
+G1 X134.182 Y95.252 E.00586
+G1 X134.375 Y95.332 E.00586
+G1 X134.541 Y95.459 E.00586
+G1 X134.668 Y95.625 E.00586
+G1 X134.748 Y95.818 E.00586
+G1 X134.775 Y96.025 E.00586
+G1 X134.775 Y113.975 E.50374
+M204 P1000
+G1 X134.325 Y113.525 F10800
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.298 Y113.732 E.00586
+G1 X134.218 Y113.925 E.00586
+G1 X134.091 Y114.091 E.00586
+G1 X133.925 Y114.218 E.00586
+G1 X133.732 Y114.298 E.00586
+G1 X133.525 Y114.325 E.00586
+G1 X116.475 Y114.325 E.47848
+G1 X116.268 Y114.298 E.00586
+G1 X116.075 Y114.218 E.00586
+G1 X115.909 Y114.091 E.00586
+G1 X115.782 Y113.925 E.00586
+G1 X115.702 Y113.732 E.00586
+G1 X115.675 Y113.525 E.00586
+G1 X115.675 Y96.475 E.47848
+G1 X115.702 Y96.268 E.00586
+G1 X115.782 Y96.075 E.00586
+G1 X115.909 Y95.909 E.00586
+G1 X116.075 Y95.782 E.00586
+G1 X116.268 Y95.702 E.00586
+G1 X116.475 Y95.675 E.00586
+G1 X133.525 Y95.675 E.47848
+G1 X133.732 Y95.702 E.00586
+G1 X133.925 Y95.782 E.00586
+G1 X134.091 Y95.909 E.00586
+G1 X134.218 Y96.075 E.00586
+G1 X134.298 Y96.268 E.00586
+G1 X134.325 Y96.475 E.00586
+G1 X134.325 Y113.525 E.47848
+M204 P800
+G1 X133.875 Y113.075 F10800
+;TYPE:External perimeter
+;WIDTH:0.45
+G1 F1500
+G1 X133.848 Y113.282 E.00586
+G1 X133.768 Y113.475 E.00586
+G1 X133.641 Y113.641 E.00586
+G1 X133.475 Y113.768 E.00586
+G1 X133.282 Y113.848 E.00586
+G1 X133.075 Y113.875 E.00586
+G1 X116.925 Y113.875 E.45322
+G1 X116.718 Y113.848 E.00586
+G1 X116.525 Y113.768 E.00586
+G1 X116.359 Y113.641 E.00586
+G1 X116.232 Y113.475 E.00586
+G1 X116.152 Y113.282 E.00586
+G1 X116.125 Y113.075 E.00586
+G1 X116.125 Y96.925 E.45322
+G1 X116.152 Y96.718 E.00586
+G1 X116.232 Y96.525 E.00586
+G1 X116.359 Y96.359 E.00586
+G1 X116.525 Y96.232 E.00586
+G1 X116.718 Y96.152 E.00586
+G1 X116.925 Y96.125 E.00586
+G1 X133.075 Y96.125 E.45322
+G1 X133.282 Y96.152 E.00586
+G1 X133.475 Y96.232 E.00586
+G1 X133.641 Y96.359 E.00586
+G1 X133.768 Y96.525 E.00586
+G1 X133.848 Y96.718 E.00586
+G1 X133.875 Y96.925 E.00586
+G1 X133.875 Y113.075 E.45322
+M204 P1000
+;TYPE:Solid infill
+;WIDTH:0.45
+G1 F4200
+G1 X116.35 Y96.575 F10800
+G1 X125 Y96.575 E.24275
+G1 X133.65 Y96.575 E.24275
+G1 X133.65 Y97.025 E.00561
+G1 X125.013 Y97.025 E.24238
+G1 X116.35 Y97.025 E.24311
+G1 X116.35 Y97.475 E.00561
+G1 X125.026 Y97.475 E.24348
+G1 X133.65 Y97.475 E.24202
+G1 X133.65 Y97.925 E.00561
+G1 X125.039 Y97.925 E.24165
+G1 X116.35 Y97.925 E.24384
+G1 X116.35 Y98.375 E.00561
+G1 X125.052 Y98.375 E.24421
+G1 X133.65 Y98.375 E.24129
+G1 X133.65 Y98.825 E.00561
+G1 X125.065 Y98.825 E.24092
+G1 X116.35 Y98.825 E.24457
+G1 X116.35 Y99.275 E.00561
+G1 X125.078 Y99.275 E.24494
+G1 X133.65 Y99.275 E.24056
+G1 X133.65 Y99.725 E.00561
+G1 X125.091 Y99.725 E.24019
+G1 X116.35 Y99.725 E.2453
+G1 X116.35 Y100.175 E.00561
+G1 X125.104 Y100.175 E.24567
+G1 X133.65 Y100.175 E.23983
+G1 X133.65 Y100.625 E.00561
+G1 X125.117 Y100.625 E.23946
+G1 X116.35 Y100.625 E.24603
+G1 X116.35 Y101.075 E.00561
+G1 X125.13 Y101.075 E.2464
+G1 X133.65 Y101.075 E.2391
+G1 X133.65 Y101.525 E.00561
+G1 X125.143 Y101.525 E.23873
+G1 X116.35 Y101.525 E.24676
+G1 X116.35 Y101.975 E.00561
+G1 X125.156 Y101.975 E.24712
+G1 X133.65 Y101.975 E.23837
+G1 X133.65 Y102.425 E.00561
+G1 X125.169 Y102.425 E.238
+G1 X116.35 Y102.425 E.24749
+G1 X116.35 Y102.875 E.00561
+G1 X125.182 Y102.875 E.24785
+G1 X133.65 Y102.875 E.23764
+G1 X133.65 Y103.325 E.00561
+G1 X125.195 Y103.325 E.23727
+G1 X116.35 Y103.325 E.24822
+G1 X116.35 Y103.775 E.00561
+G1 X125.208 Y103.775 E.24858
+G1 X133.65 Y103.775 E.23691
+G1 X133.65 Y104.225 E.00561
+G1 X125.221 Y104.225 E.23655
+G1 X116.35 Y104.225 E.24895
+G1 X116.35 Y104.675 E.00561
+G1 X125.234 Y104.675 E.24931
+G1 X133.65 Y104.675 E.23618
+G1 X133.65 Y105.125 E.00561
+G1 X125.247 Y105.125 E.23582
+G1 X116.35 Y105.125 E.24968
+G1 X116.35 Y105.575 E.00561
+G1 X125.26 Y105.575 E.25004
+G1 X133.65 Y105.575 E.23545
+G1 X133.65 Y106.025 E.00561
+G1 X125.273 Y106.025 E.23509
+G1 X116.35 Y106.025 E.25041
+G1 X116.35 Y106.475 E.00561
+G1 X125.286 Y106.475 E.25077
+G1 X133.65 Y106.475 E.23472
+G1 X133.65 Y106.925 E.00561
+G1 X125.299 Y106.925 E.23436
+G1 X116.35 Y106.925 E.25114
+G1 X116.35 Y107.375 E.00561
+G1 X125.312 Y107.375 E.2515
+G1 X133.65 Y107.375 E.23399
+G1 X133.65 Y107.825 E.00561
+G1 X125.325 Y107.825 E.23363
+G1 X116.35 Y107.825 E.25187
+G1 X116.35 Y108.275 E.00561
+G1 X125.338 Y108.275 E.25223
+G1 X133.65 Y108.275 E.23326
+G1 X133.65 Y108.725 E.00561
+G1 X125.351 Y108.725 E.2329
+G1 X116.35 Y108.725 E.2526
+G1 X116.35 Y109.175 E.00561
+G1 X125.364 Y109.175 E.25296
+G1 X133.65 Y109.175 E.23253
+G1 X133.65 Y109.625 E.00561
+G1 X125.377 Y109.625 E.23217
+G1 X116.35 Y109.625 E.25333
+G1 X116.35 Y110.075 E.00561
+G1 X125.39 Y110.075 E.25369
+G1 X133.65 Y110.075 E.2318
+G1 X133.65 Y110.525 E.00561
+G1 X125.403 Y110.525 E.23144
+G1 X116.35 Y110.525 E.25406
+G1 X116.35 Y110.975 E.00561
+G1 X125.416 Y110.975 E.25442
+G1 X133.65 Y110.975 E.23107
+G1 X133.65 Y111.425 E.00561
+G1 X125.429 Y111.425 E.23071
+G1 X116.35 Y111.425 E.25479
+G1 X116.35 Y111.875 E.00561
+G1 X125.442 Y111.875 E.25515
+G1 X133.65 Y111.875 E.23034
+G1 X133.65 Y112.325 E.00561
+G1 X125.455 Y112.325 E.22998
+G1 X116.35 Y112.325 E.25552
+G1 X116.35 Y112.775 E.00561
+G1 X125.468 Y112.775 E.25588
+G1 X133.65 Y112.775 E.22961
+G1 X133.65 Y113.225 E.00561
+G1 X125.481 Y113.225 E.22925
+G1 X116.35 Y113.225 E.25625
+;WIPE_START
+G1 F8640
+G1 X113.15 Y113.225 E-.76
+;WIPE_END
+G1 E-.04 F2100
+M73 P38 R9
+;LAYER_CHANGE
+;Z:.65
+;HEIGHT:.15
+;BEFORE_LAYER_CHANGE
+G92 E0.0
+;.65
+
+
+;AFTER_LAYER_CHANGE
+;.65
+G1 E-.8 F2100
+G1 Z1.05 F720
+G1 X134.775 Y113.975 F10800
+G1 Z.65 F720
+G1 E.8 F2100
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.748 Y114.182 E.00586
+G1 X134.668 Y114.375 E.00586
+G1 X134.541 Y114.541 E.00586
+G1 X134.375 Y114.668 E.00586
+G1 X134.182 Y114.748 E.00586
+G1 X133.975 Y114.775 E.00586
+G1 X116.025 Y114.775 E.50374
+G1 X115.818 Y114.748 E.00586
+G1 X115.625 Y114.668 E.00586
+G1 X115.459 Y114.541 E.00586
+G1 X115.332 Y114.375 E.00586
+G1 X115.252 Y114.182 E.00586
+G1 X115.225 Y113.975 E.00586
+G1 X115.225 Y96.025 E.50374
+G1 X115.252 Y95.818 E.00586
+G1 X115.332 Y95.625 E.00586
+G1 X115.459 Y95.459 E.00586
+G1 X115.625 Y95.332 E.00586
+G1 X115.818 Y95.252 E.00586
+G1 X116.025 Y95.225 E.00586
+G1 X133.975 Y95.225 E.50374
+G1 X134.182 Y95.252 E.00586
+G1 X134.375 Y95.332 E.00586
+G1 X134.541 Y95.459 E.00586
+G1 X134.668 Y95.625 E.00586
+G1 X134.748 Y95.818 E.00586
+G1 X134.775 Y96.025 E.00586
+G1 X134.775 Y113.975 E.50374
+M204 P1000
+G1 X134.325 Y113.525 F10800
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.298 Y113.732 E.00586
+G1 X134.218 Y113.925 E.00586
+G1 X134.091 Y114.091 E.00586
+G1 X133.925 Y114.218 E.00586
+G1 X133.732 Y114.298 E.00586
+G1 X133.525 Y114.325 E.00586
+G1 X116.475 Y114.325 E.47848
+G1 X116.268 Y114.298 E.00586
+G1 X116.075 Y114.218 E.00586
+G1 X115.909 Y114.091 E.00586
+G1 X115.782 Y113.925 E.00586
+G1 X115.702 Y113.732 E.00586
+G1 X115.675 Y113.525 E.00586
+G1 X115.675 Y96.475 E.47848
+G1 X115.702 Y96.268 E.00586
+G1 X115.782 Y96.075 E.00586
+G1 X115.909 Y95.909 E.00586
+G1 X116.075 Y95.782 E.00586
+G1 X116.268 Y95.702 E.00586
+G1 X116.475 Y95.675 E.00586
+G1 X133.525 Y95.675 E.47848
+G1 X133.732 Y95.702 E.00586
+G1 X133.925 Y95.782 E.00586
+G1 X134.091 Y95.909 E.00586
+G1 X134.218 Y96.075 E.00586
+G1 X134.298 Y96.268 E.00586
+G1 X134.325 Y96.475 E.00586
+G1 X134.325 Y113.525 E.47848
+M204 P800
+G1 X133.875 Y113.075 F10800
+;TYPE:External perimeter
+;WIDTH:0.45
+G1 F1500
+G1 X133.848 Y113.282 E.00586
+G1 X133.768 Y113.475 E.00586
+G1 X133.641 Y113.641 E.00586
+G1 X133.475 Y113.768 E.00586
+G1 X133.282 Y113.848 E.00586
+G1 X133.075 Y113.875 E.00586
+G1 X116.925 Y113.875 E.45322
+G1 X116.718 Y113.848 E.00586
+G1 X116.525 Y113.768 E.00586
+G1 X116.359 Y113.641 E.00586
+G1 X116.232 Y113.475 E.00586
+G1 X116.152 Y113.282 E.00586
+G1 X116.125 Y113.075 E.00586
+G1 X116.125 Y96.925 E.45322
+G1 X116.152 Y96.718 E.00586
+G1 X116.232 Y96.525 E.00586
+G1 X116.359 Y96.359 E.00586
+G1 X116.525 Y96.232 E.00586
+G1 X116.718 Y96.152 E.00586
+G1 X116.925 Y96.125 E.00586
+G1 X133.075 Y96.125 E.45322
+G1 X133.282 Y96.152 E.00586
+G1 X133.475 Y96.232 E.00586
+G1 X133.641 Y96.359 E.00586
+G1 X133.768 Y96.525 E.00586
+G1 X133.848 Y96.718 E.00586
+G1 X133.875 Y96.925 E.00586
+G1 X133.875 Y113.075 E.45322
+M204 P1000
+;TYPE:Internal infill
+;WIDTH:0.45
+G1 F4200
+G1 X116.575 Y96.35 F10800
+G1 X116.575 Y105 E.24275
+G1 X116.575 Y113.65 E.24275
+G1 X117.025 Y113.65 E.00561
+G1 X117.038 Y105 E.24275
+G1 X117.025 Y96.35 E.24275
+G1 X117.475 Y96.35 E.00561
+G1 X117.501 Y105 E.24275
+G1 X117.475 Y113.65 E.24275
+G1 X117.925 Y113.65 E.00561
+G1 X117.964 Y105 E.24275
+G1 X117.925 Y96.35 E.24275
+G1 X118.375 Y96.35 E.00561
+G1 X118.427 Y105 E.24275
+G1 X118.375 Y113.65 E.24275
+G1 X118.825 Y113.65 E.00561
+G1 X118.89 Y105 E.24275
+G1 X118.825 Y96.35 E.24275
+G1 X119.275 Y96.35 E.00561
+G1 X119.353 Y105 E.24276
+G1 X119.275 Y113.65 E.24276
+G1 X119.725 Y113.65 E.00561
+G1 X119.816 Y105 E.24276
+G1 X119.725 Y96.35 E.24276
+G1 X120.175 Y96.35 E.00561
+G1 X120.279 Y105 E.24276
+G1 X120.175 Y113.65 E.24276
+G1 X120.625 Y113.65 E.00561
+G1 X120.742 Y105 E.24277
+G1 X120.625 Y96.35 E.24277
+G1 X121.075 Y96.35 E.00561
+G1 X121.205 Y105 E.24277
+G1 X121.075 Y113.65 E.24277
+G1 X121.525 Y113.65 E.00561
+G1 X121.668 Y105 E.24278
+G1 X121.525 Y96.35 E.24278
+G1 X121.975 Y96.35 E.00561
+G1 X122.131 Y105 E.24279
+G1 X121.975 Y113.65 E.24279
+G1 X122.425 Y113.65 E.00561
+G1 X122.594 Y105 E.24279
+G1 X122.425 Y96.35 E.24279
+G1 X122.875 Y96.35 E.00561
+G1 X123.057 Y105 E.2428
+G1 X122.875 Y113.65 E.2428
+G1 X123.325 Y113.65 E.00561
+G1 X123.52 Y105 E.24281
+G1 X123.325 Y96.35 E.24281
+G1 X123.775 Y96.35 E.00561
+G1 X123.983 Y105 E.24282
+G1 X123.775 Y113.65 E.24282
+G1 X124.225 Y113.65 E.00561
+G1 X124.446 Y105 E.24283
+G1 X124.225 Y96.35 E.24283
+G1 X124.675 Y96.35 E.00561
+G1 X124.909 Y105 E.24284
+G1 X124.675 Y113.65 E.24284
+G1 X125.125 Y113.65 E.00561
+G1 X125.372 Y105 E.24285
+G1 X125.125 Y96.35 E.24285
+G1 X125.575 Y96.35 E.00561
+G1 X125.835 Y105 E.24286
+G1 X125.575 Y113.65 E.24286
+G1 X126.025 Y113.65 E.00561
+G1 X126.298 Y105 E.24287
+G1 X126.025 Y96.35 E.24287
+G1 X126.475 Y96.35 E.00561
+G1 X126.761 Y105 E.24288
+G1 X126.475 Y113.65 E.24288
+G1 X126.925 Y113.65 E.00561
+G1 X127.224 Y105 E.24289
+G1 X126.925 Y96.35 E.24289
+G1 X127.375 Y96.35 E.00561
+G1 X127.687 Y105 E.2429
+G1 X127.375 Y113.65 E.2429
+G1 X127.825 Y113.65 E.00561
+G1 X128.15 Y105 E.24292
+G1 X127.825 Y96.35 E.24292
+G1 X128.275 Y96.35 E.00561
+G1 X128.613 Y105 E.24293
+G1 X128.275 Y113.65 E.24293
+G1 X128.725 Y113.65 E.00561
+G1 X129.076 Y105 E.24295
+G1 X128.725 Y96.35 E.24295
+G1 X129.175 Y96.35 E.00561
+G1 X129.539 Y105 E.24296
+G1 X129.175 Y113.65 E.24296
+G1 X129.625 Y113.65 E.00561
+G1 X130.002 Y105 E.24298
+G1 X129.625 Y96.35 E.24298
+G1 X130.075 Y96.35 E.00561
+G1 X130.465 Y105 E.24299
+G1 X130.075 Y113.65 E.24299
+G1 X130.525 Y113.65 E.00561
+G1 X130.928 Y105 E.24301
+G1 X130.525 Y96.35 E.24301
+G1 X130.975 Y96.35 E.00561
+G1 X131.391 Y105 E.24303
+G1 X130.975 Y113.65 E.24303
+G1 X131.425 Y113.65 E.00561
+G1 X131.854 Y105 E.24305
+G1 X131.425 Y96.35 E.24305
+G1 X131.875 Y96.35 E.00561
+G1 X132.317 Y105 E.24306
+G1 X131.875 Y113.65 E.24306
+G1 X132.325 Y113.65 E.00561
+G1 X132.78 Y105 E.24308
+G1 X132.325 Y96.35 E.24308
+G1 X132.775 Y96.35 E.00561
+G1 X133.243 Y105 E.2431
+G1 X132.775 Y113.65 E.2431
+G1 X133.225 Y113.65 E.00561
+G1 X133.706 Y105 E.24312
+G1 X133.225 Y96.35 E.24312
+;WIPE_START
+G1 F8640
+G1 X130.025 Y96.35 E-.76
+;WIPE_END
+G1 E-.04 F2100
+M73 P52 R8
+;LAYER_CHANGE
+;Z:.8
+;HEIGHT:.15
+;BEFORE_LAYER_CHANGE
+G92 E0.0
+;.8
+
+
+;AFTER_LAYER_CHANGE
+;.8
+G1 E-.8 F2100
+G1 Z1.2 F720
+G1 X134.775 Y113.975 F10800
+G1 Z.8 F720
+G1 E.8 F2100
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.748 Y114.182 E.00586
+G1 X134.668 Y114.375 E.00586
+G1 X134.541 Y114.541 E.00586
+G1 X134.375 Y114.668 E.00586
+G1 X134.182 Y114.748 E.00586
+G1 X133.975 Y114.775 E.00586
+G1 X116.025 Y114.775 E.50374
+G1 X115.818 Y114.748 E.00586
+G1 X115.625 Y114.668 E.00586
+G1 X115.459 Y114.541 E.00586
+G1 X115.332 Y114.375 E.00586
+G1 X115.252 Y114.182 E.00586
+G1 X115.225 Y113.975 E.00586
+G1 X115.225 Y96.025 E.50374
+G1 X115.252 Y95.818 E.00586
+G1 X115.332 Y95.625 E.00586
+G1 X115.459 Y95.459 E.00586
+G1 X115.625 Y95.332 E.00586
+G1 X115.818 Y95.252 E.00586
+G1 X116.025 Y95.225 E.00586
+G1 X133.975 Y95.225 E.50374
+G1 X134.182 Y95.252 E.00586
+G1 X134.375 Y95.332 E.00586
+G1 X134.541 Y95.459 E.00586
+G1 X134.668 Y95.625 E.00586
+G1 X134.748 Y95.818 E.00586
+G1 X134.775 Y96.025 E.00586
+G1 X134.775 Y113.975 E.50374
+M204 P1000
+G1 X134.325 Y113.525 F10800
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.298 Y113.732 E.00586
+G1 X134.218 Y113.925 E.00586
+G1 X134.091 Y114.091 E.00586
+G1 X133.925 Y114.218 E.00586
+G1 X133.732 Y114.298 E.00586
+G1 X133.525 Y114.325 E.00586
+G1 X116.475 Y114.325 E.47848
+G1 X116.268 Y114.298 E.00586
+G1 X116.075 Y114.218 E.00586
+G1 X115.909 Y114.091 E.00586
+G1 X115.782 Y113.925 E.00586
+G1 X115.702 Y113.732 E.00586
+G1 X115.675 Y113.525 E.00586
+G1 X115.675 Y96.475 E.47848
+G1 X115.702 Y96.268 E.00586
+G1 X115.782 Y96.075 E.00586
+G1 X115.909 Y95.909 E.00586
+G1 X116.075 Y95.782 E.00586
+G1 X116.268 Y95.702 E.00586
+G1 X116.475 Y95.675 E.00586
+G1 X133.525 Y95.675 E.47848
+G1 X133.732 Y95.702 E.00586
+G1 X133.925 Y95.782 E.00586
+G1 X134.091 Y95.909 E.00586
+G1 X134.218 Y96.075 E.00586
+G1 X134.298 Y96.268 E.00586
+G1 X134.325 Y96.475 E.00586
+G1 X134.325 Y113.525 E.47848
+M204 P800
+G1 X133.875 Y113.075 F10800
+;TYPE:External perimeter
+;WIDTH:0.45
+G1 F1500
+G1 X133.848 Y113.282 E.00586
+G1 X133.768 Y113.475 E.00586
+G1 X133.641 Y113.641 E.00586
+G1 X133.475 Y113.768 E.00586
+G1 X133.282 Y113.848 E.00586
+G1 X133.075 Y113.875 E.00586
+G1 X116.925 Y113.875 E.45322
+G1 X116.718 Y113.848 E.00586
+G1 X116.525 Y113.768 E.00586
+G1 X116.359 Y113.641 E.00586
+G1 X116.232 Y113.475 E.00586
+G1 X116.152 Y113.282 E.00586
+G1 X116.125 Y113.075 E.00586
+G1 X116.125 Y96.925 E.45322
+G1 X116.152 Y96.718 E.00586
+G1 X116.232 Y96.525 E.00586
+G1 X116.359 Y96.359 E.00586
+G1 X116.525 Y96.232 E.00586
+G1 X116.718 Y96.152 E.00586
+G1 X116.925 Y96.125 E.00586
+G1 X133.075 Y96.125 E.45322
+G1 X133.282 Y96.152 E.00586
+G1 X133.475 Y96.232 E.00586
+G1 X133.641 Y96.359 E.00586
+G1 X133.768 Y96.525 E.00586
+G1 X133.848 Y96.718 E.00586
+G1 X133.875 Y96.925 E.00586
+G1 X133.875 Y113.075 E.45322
+M204 P1000
+;TYPE:Internal infill
+;WIDTH:0.45
+G1 F4200
+G1 X116.35 Y96.575 F10800
+G1 X125 Y96.575 E.24275
+G1 X133.65 Y96.575 E.24275
+G1 X133.65 Y97.025 E.00561
+G1 X125.013 Y97.025 E.24238
+G1 X116.35 Y97.025 E.24311
+G1 X116.35 Y97.475 E.00561
+G1 X125.026 Y97.475 E.24348
+G1 X133.65 Y97.475 E.24202
+G1 X133.65 Y97.925 E.00561
+G1 X125.039 Y97.925 E.24165
+G1 X116.35 Y97.925 E.24384
+G1 X116.35 Y98.375 E.00561
+G1 X125.052 Y98.375 E.24421
+G1 X133.65 Y98.375 E.24129
+G1 X133.65 Y98.825 E.00561
+G1 X125.065 Y98.825 E.24092
+G1 X116.35 Y98.825 E.24457
+G1 X116.35 Y99.275 E.00561
+G1 X125.078 Y99.275 E.24494
+G1 X133.65 Y99.275 E.24056
+G1 X133.65 Y99.725 E.00561
+G1 X125.091 Y99.725 E.24019
+G1 X116.35 Y99.725 E.2453
+G1 X116.35 Y100.175 E.00561
+G1 X125.104 Y100.175 E.24567
+G1 X133.65 Y100.175 E.23983
+G1 X133.65 Y100.625 E.00561
+G1 X125.117 Y100.625 E.23946
+G1 X116.35 Y100.625 E.24603
+G1 X116.35 Y101.075 E.00561
+G1 X125.13 Y101.075 E.2464
+G1 X133.65 Y101.075 E.2391
+G1 X133.65 Y101.525 E.00561
+G1 X125.143 Y101.525 E.23873
+G1 X116.35 Y101.525 E.24676
+G1 X116.35 Y101.975 E.00561
+G1 X125.156 Y101.975 E.24712
+G1 X133.65 Y101.975 E.23837
+G1 X133.65 Y102.425 E.00561
+G1 X125.169 Y102.425 E.238
+G1 X116.35 Y102.425 E.24749
+G1 X116.35 Y102.875 E.00561
+G1 X125.182 Y102.875 E.24785
+G1 X133.65 Y102.875 E.23764
+G1 X133.65 Y103.325 E.00561
+G1 X125.195 Y103.325 E.23727
+G1 X116.35 Y103.325 E.24822
+G1 X116.35 Y103.775 E.00561
+G1 X125.208 Y103.775 E.24858
+G1 X133.65 Y103.775 E.23691
+G1 X133.65 Y104.225 E.00561
+G1 X125.221 Y104.225 E.23655
+G1 X116.35 Y104.225 E.24895
+G1 X116.35 Y104.675 E.00561
+G1 X125.234 Y104.675 E.24931
+G1 X133.65 Y104.675 E.23618
+G1 X133.65 Y105.125 E.00561
+G1 X125.247 Y105.125 E.23582
+G1 X116.35 Y105.125 E.24968
+G1 X116.35 Y105.575 E.00561
+G1 X125.26 Y105.575 E.25004
+G1 X133.65 Y105.575 E.23545
+G1 X133.65 Y106.025 E.00561
+G1 X125.273 Y106.025 E.23509
+G1 X116.35 Y106.025 E.25041
+G1 X116.35 Y106.475 E.00561
+G1 X125.286 Y106.475 E.25077
+G1 X133.65 Y106.475 E.23472
+G1 X133.65 Y106.925 E.00561
+G1 X125.299 Y106.925 E.23436
+G1 X116.35 Y106.925 E.25114
+G1 X116.35 Y107.375 E.00561
+G1 X125.312 Y107.375 E.2515
+G1 X133.65 Y107.375 E.23399
+G1 X133.65 Y107.825 E.00561
+G1 X125.325 Y107.825 E.23363
+G1 X116.35 Y107.825 E.25187
+G1 X116.35 Y108.275 E.00561
+G1 X125.338 Y108.275 E.25223
+G1 X133.65 Y108.275 E.23326
+G1 X133.65 Y108.725 E.00561
+G1 X125.351 Y108.725 E.2329
+G1 X116.35 Y108.725 E.2526
+G1 X116.35 Y109.175 E.00561
+G1 X125.364 Y109.175 E.25296
+G1 X133.65 Y109.175 E.23253
+G1 X133.65 Y109.625 E.00561
+G1 X125.377 Y109.625 E.23217
+G1 X116.35 Y109.625 E.25333
+G1 X116.35 Y110.075 E.00561
+G1 X125.39 Y110.075 E.25369
+G1 X133.65 Y110.075 E.2318
+G1 X133.65 Y110.525 E.00561
+G1 X125.403 Y110.525 E.23144
+G1 X116.35 Y110.525 E.25406
+G1 X116.35 Y110.975 E.00561
+G1 X125.416 Y110.975 E.25442
+G1 X133.65 Y110.975 E.23107
+G1 X133.65 Y111.425 E.00561
+G1 X125.429 Y111.425 E.23071
+G1 X116.35 Y111.425 E.25479
+G1 X116.35 Y111.875 E.00561
+G1 X125.442 Y111.875 E.25515
+G1 X133.65 Y111.875 E.23034
+G1 X133.65 Y112.325 E.00561
+G1 X125.455 Y112.325 E.22998
+G1 X116.35 Y112.325 E.25552
+G1 X116.35 Y112.775 E.00561
+G1 X125.468 Y112.775 E.25588
+G1 X133.65 Y112.775 E.22961
+G1 X133.65 Y113.225 E.00561
+G1 X125.481 Y113.225 E.22925
+G1 X116.35 Y113.225 E.25625
+;WIPE_START
+G1 F8640
+G1 X113.15 Y113.225 E-.76
+;WIPE_END
+G1 E-.04 F2100
+M73 P66 R7
+;LAYER_CHANGE
+;Z:.95
+;HEIGHT:.15
+;BEFORE_LAYER_CHANGE
+G92 E0.0
+;.95
+
+
+;AFTER_LAYER_CHANGE
+;.95
+G1 E-.8 F2100
+G1 Z1.35 F720
+G1 X134.775 Y113.975 F10800
+G1 Z.95 F720
+G1 E.8 F2100
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.748 Y114.182 E.00586
+G1 X134.668 Y114.375 E.00586
+G1 X134.541 Y114.541 E.00586
+G1 X134.375 Y114.668 E.00586
+G1 X134.182 Y114.748 E.00586
+G1 X133.975 Y114.775 E.00586
+G1 X116.025 Y114.775 E.50374
+G1 X115.818 Y114.748 E.00586
+G1 X115.625 Y114.668 E.00586
+G1 X115.459 Y114.541 E.00586
+G1 X115.332 Y114.375 E.00586
+G1 X115.252 Y114.182 E.00586
+G1 X115.225 Y113.975 E.00586
+G1 X115.225 Y96.025 E.50374
+G1 X115.252 Y95.818 E.00586
+G1 X115.332 Y95.625 E.00586
+G1 X115.459 Y95.459 E.00586
+G1 X115.625 Y95.332 E.00586
+G1 X115.818 Y95.252 E.00586
+G1 X116.025 Y95.225 E.00586
+G1 X133.975 Y95.225 E.50374
+G1 X134.182 Y95.252 E.00586
+G1 X134.375 Y95.332 E.00586
+G1 X134.541 Y95.459 E.00586
+G1 X134.668 Y95.625 E.00586
+G1 X134.748 Y95.818 E.00586
+G1 X134.775 Y96.025 E.00586
+G1 X134.775 Y113.975 E.50374
+M204 P1000
+G1 X134.325 Y113.525 F10800
+;TYPE:Perimeter
+;WIDTH:0.45
+G1 F2400
+G1 X134.298 Y113.732 E.00586
+G1 X134.218 Y113.925 E.00586
+G1 X134.091 Y114.091 E.00586
+G1 X133.925 Y114.218 E.00586
+G1 X133.732 Y114.298 E.00586
+G1 X133.525 Y114.325 E.00586
+G1 X116.475 Y114.325 E.47848
+G1 X116.268 Y114.298 E.00586
+G1 X116.075 Y114.218 E.00586
+G1 X115.909 Y114.091 E.00586
+G1 X115.782 Y113.925 E.00586
+G1 X115.702 Y113.732 E.00586
+G1 X115.675 Y113.525 E.00586
+G1 X115.675 Y96.475 E.47848
+G1 X115.702 Y96.268 E.00586
+G1 X115.782 Y96.075 E.00586
+G1 X115.909 Y95.909 E.00586
+G1 X116.075 Y95.782 E.00586
+G1 X116.268 Y95.702 E.00586
+G1 X116.475 Y95.675 E.00586
+G1 X133.525 Y95.675 E.47848
+G1 X133.732 Y95.702 E.00586
+G1 X133.925 Y95.782 E.00586
+G1 X134.091 Y95.909 E.00586
+G1 X134.218 Y96.075 E.00586
+G1 X134.298 Y96.268 E.00586
+G1 X134.325 Y96.475 E.00586
+G1 X134.325 Y113.525 E.47848
+M204 P800
+G1 X133.875 Y113.075 F10800
+;TYPE:External perimeter
+;WIDTH:0.45
+G1 F1500
+G1 X133.848 Y113.282 E.00586
+G1 X133.768 Y113.475 E.00586
+G1 X133.641 Y113.641 E.00586
+G1 X133.475 Y113.768 E.00586
+G1 X133.282 Y113.848 E.00586
+G1 X133.075 Y113.875 E.00586
+G1 X116.925 Y113.875 E.45322
+G1 X116.718 Y113.848 E.00586
+G1 X116.525 Y113.768 E.00586
+G1 X116.359 Y113.641 E.00586
+G1 X116.232 Y113.475 E.00586
+G1 X116.152 Y113.282 E.00586
+G1 X116.125 Y113.075 E.00586
+G1 X116.125 Y96.925 E.45322
+G1 X116.152 Y96.718 E.00586
+G1 X116.232 Y96.525 E.00586
+G1 X116.359 Y96.359 E.00586
+G1 X116.525 Y96.232 E.00586
+G1 X116.718 Y96.152 E.00586
+G1 X116.925 Y96.125 E.00586
+G1 X133.075 Y96.125 E.45322
+G1 X133.282 Y96.152 E.00586
+G1 X133.475 Y96.232 E.00586
+G1 X133.641 Y96.359 E.00586
+G1 X133.768 Y96.525 E.00586
+G1 X133.848 Y96.718 E.00586
+G1 X133.875 Y96.925 E.00586
+G1 X133.875 Y113.075 E.45322
+M204 P1000
+;TYPE:Internal infill
+;WIDTH:0.45
+G1 F4200
+G1 X116.575 Y96.35 F10800
+G1 X116.575 Y105 E.24275
+G1 X116.575 Y113.65 E.24275
+G1 X117.025 Y113.65 E.00561
+G1 X117.038 Y105 E.24275
+G1 X117.025 Y96.35 E.24275
+G1 X117.475 Y96.35 E.00561
+G1 X117.501 Y105 E.24275
+G1 X117.475 Y113.65 E.24275
+G1 X117.925 Y113.65 E.00561
+G1 X117.964 Y105 E.24275
+G1 X117.925 Y96.35 E.24275
+G1 X118.375 Y96.35 E.00561
+G1 X118.427 Y105 E.24275
+G1 X118.375 Y113.65 E.24275
+G1 X118.825 Y113.65 E.00561
+G1 X118.89 Y105 E.24275
+G1 X118.825 Y96.35 E.24275
+G1 X119.275 Y96.35 E.00561
+G1 X119.353 Y105 E.24276
+G1 X119.275 Y113.65 E.24276
+G1 X119.725 Y113.65 E.00561
+G1 X119.816 Y105 E.24276
+G1 X119.725 Y96.35 E.24276
+G1 X120.175 Y96.35 E.00561
+G1 X120.279 Y105 E.24276
+G1 X120.175 Y113.65 E.24276
+G1 X120.625 Y113.65 E.00561
+G1 X120.742 Y105 E.24277
+G1 X120.625 Y96.35 E.24277
+G1 X121.075 Y96.35 E.00561
+G1 X121.205 Y105 E.24277
+G1 X121.075 Y113.65 E.24277
+G1 X121.525 Y113.65 E.00561
+G1 X121.668 Y105 E.24278
+G1 X121.525 Y96.35 E.24278
+G1 X121.975 Y96.35 E.00561
+G1 X122.131 Y105 E.24279
+G1 X121.975 Y113.65 E.24279
+G1 X122.425 Y113.65 E.00561
+G1 X122.594 Y105 E.24279
+G1 X122.425 Y96.35 E.24279
+G1 X122.875 Y96.35 E.00561
+G1 X123.057 Y105 E.2428
+G1 X122.875 Y113.65 E.2428
+G1 X123.325 Y113.65 E.00561
+G1 X123.52 Y105 E.24281
+G1 X123.325 Y96.35 E.24281
+G1 X123.775 Y96.35 E.00561
+G1 X123.983 Y105 E.24282
+G1 X123.775 Y113.65 E.24282
+G1 X124.225 Y113.65 E.00561
+G1 X124.446 Y105 E.24283
+G1 X124.225 Y96.35 E.24283
+G1 X124.675 Y96.35 E.00561
+G1 X124.909 Y105 E.24284
+G1 X124.675 Y113.65 E.24284
+G1 X125.125 Y113.65 E.00561
+G1 X125.372 Y105 E.24285
+G1 X125.125 Y96.35 E.24285
+G1 X125.575 Y96.35 E.00561
+G1 X125.835 Y105 E.24286
+G1 X125.575 Y113.65 E.24286
+G1 X126.025 Y113.65 E.00561
+G1 X126.298 Y105 E.24287
+G1 X126.025 Y96.35 E.24287
+G1 X126.475 Y96.35 E.00561
+G1 X126.761 Y105 E.24288
+G1 X126.475 Y113.65 E.24288
+G1 X126.925 Y113.65 E.00561
+G1 X127.224 Y105 E.24289
+G1 X126.925 Y96.35 E.24289
+G1 X127.375 Y96.35 E.00561
+G1 X127.687 Y105 E.2429
+G1 X127.375 Y113.65 E.2429
+G1 X127.825 Y113.65 E.00561
+G1 X128.15 Y105 E.24292
+G1 X127.825 Y96.35 E.24292
+G1 X128.275 Y96.35 E.00561
+G1 X128.613 Y105 E.24293
+G1 X128.275 Y113.65 E.24293
+G1 X128.725 Y113.65 E.00561
+G1 X129.076 Y105 E.24295
+G1 X128.725 Y96.35 E.24295
+G1 X129.175 Y96.35 E.00561
+G1 X129.539 Y105 E.24296
+G1 X129.175 Y113.65 E.24296
+G1 X129.625 Y113.65 E.00561
+G1 X130.002 Y105 E.24298
+G1 X129.625 Y96.35 E.24298
+G1 X130.075 Y96.35 E.00561
+G1 X130.465 Y105 E.24299
+G1 X130.075 Y113.65 E.24299
+G1 X130.525 Y113.65 E.00561
+G1 X130.928 Y105 E.24301
+G1 X130.525 Y96.35 E.24301
+G1 X130.975 Y96.35 E.00561
+G1 X131.391 Y105 E.24303
+G1 X130.975 Y113.65 E.24303
+G1 X131.425 Y113.65 E.00561
+G1 X131.854 Y105 E.24305
+G1 X131.425 Y96.35 E.24305
+G1 X131.875 Y96.35 E.00561
+G1 X132.317 Y105 E.24306
+G1 X131.875 Y113.65 E.24306
+G1 X132.325 Y113.65 E.00561
+G1 X132.78 Y105 E.24308
+G1 X132.325 Y96.35 E.24308
+G1 X132.775 Y96.35 E.00561
+G1 X133.243 Y105 E.2431
+G1 X132.775 Y113.65 E.2431
+G1 X133.225 Y113.65 E.00561
+G1 X133.706 Y105 E.24312
+G1 X133.225 Y96.35 E.24312
+;WIPE_START
+G1 F8640
+G1 X130.025 Y96.35 E-.76
+;WIPE_END
+G1 E-.04 F2100
+M73 P80 R6
+M107
+;TYPE:Custom
+; Filament-specific end gcode
+G1 Z10.95 F720 ; Move print head up
+G1 X0 Y200 F3600 ; park
+G4 ; wait
+M221 S100 ; reset flow
+M900 K0 ; reset LA
+M104 S0 ; turn off temperature
+M140 S0 ; turn off heatbed
+M107 ; turn off fan
+M84 ; disable motors
+M73 P100 R0
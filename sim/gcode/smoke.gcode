@@ -0,0 +1,26 @@
+; Short print-like sequence exercising travel, extrusion, arcs and a Z hop.
+G28
+G90
+M83
+M204 P1250 T1250
+G1 Z0.2 F720
+G1 X50 Y50 F9000
+G1 X100 Y50 E3.5 F2400
+G1 X100 Y100 E3.5
+G1 X50 Y100 E3.5
+G1 X50 Y50 E3.5
+G1 E-0.8 F2100
+G1 Z0.4 F720
+G1 X60 Y60 F9000
+G1 Z0.2 F720
+G1 E0.8 F2100
+G2 X80 Y60 I10 J0 E1.5 F1800
+G3 X60 Y60 I-10 J0 E1.5
+G1 X90 Y90 E2.0
+G1 X91 Y90.5 E0.05
+G1 X92 Y90 E0.05
+G1 X93 Y90.5 E0.05
+G1 X94 Y90 E0.05
+G1 X150 Y150 F12000
+G1 Z10 F720
+M400
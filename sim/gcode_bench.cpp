@@ -0,0 +1,224 @@
+/**
+ * @file
+ * @brief Host microbenchmark of the G-code parsing of process_commands().
+ *
+ * Usage: gcode_bench file.gcode
+ *
+ * Every command of the file is placed on the top of the command queue and parsed the way
+ * process_commands() does:
+ *
+ * - Parameter lookups (code_seen()) in the order of process_commands() (G0-G3: X Y Z E F of
+ *   get_coordinates() followed by the FWRETRACT check, G92: X Y Z E, other commands: S P). Once
+ *   with a strchr() scan per lookup (code_seen() before the word table) and once with
+ *   code_words_parse() and the table lookups.
+ * - G0/G1 moves through the generic dispatch (the special commands, the word table, the G-code
+ *   number and strtod() of every word) and through the fast path (code_move_words()).
+ *
+ * Printed are the host time per command, and for the lookups the number of command characters
+ * read per command and the AVR cycles estimated from them. The host strchr() is vectorized, so
+ * the host time of the lookups does not show the difference the AVR sees.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Marlin.h"
+#include "cmdqueue.h"
+
+// AVR cycles, avr-gcc -Os and avr-libc
+static const uint8_t STRCHR_CHAR = 7;  // strchr() loop: ld, cp, breq, tst, brne
+static const uint8_t PARSE_CHAR = 12;  // code_words_parse() loop, a letter costs the table read and write
+static const uint8_t LOOKUP = 18;      // call, CMDBUFFER_CURRENT_STRING, strchr_pointer store, return
+
+static const unsigned REPEAT = 200;
+
+static uint32_t chars_read;
+static uint32_t parsed_chars;
+static uint32_t lookups;
+
+// code_seen() before the word table.
+static bool code_seen_strchr(char code)
+{
+    char *cmd = CMDBUFFER_CURRENT_STRING;
+    strchr_pointer = strchr(cmd, code);
+    chars_read += (strchr_pointer ? strchr_pointer - cmd : strlen(cmd)) + 1;
+    ++lookups;
+    return strchr_pointer != NULL;
+}
+
+static bool code_seen_words(char code)
+{
+    ++lookups;
+    return code_seen(code);
+}
+
+static void parse_words()
+{
+    const uint32_t len = strlen(CMDBUFFER_CURRENT_STRING) + 1;
+    chars_read += len;
+    parsed_chars += len;
+    code_words_parse();
+}
+
+static void no_parse() {}
+
+static bool is_move(const char *cmd)
+{
+    return cmd[0] == 'G' && (cmd[1] == '0' || cmd[1] == '1') && (cmd[2] == ' ' || cmd[2] == 0);
+}
+
+// The lookups of process_commands() for the command on the top of the queue.
+template <void (*parse)(), bool (*seen)(char)>
+static float lookup(float sum)
+{
+    parse();
+    const char *cmd = CMDBUFFER_CURRENT_STRING;
+    if (cmd[0] == 'G' && cmd[1] >= '0' && cmd[1] <= '3' && (cmd[2] == ' ' || cmd[2] == 0)) {
+        for (char c : { 'X', 'Y', 'Z', 'E' })
+            if (seen(c))
+                sum += code_value();
+        if (seen('F'))
+            sum += code_value();
+        if (!(seen('X') || seen('Y') || seen('Z')) && seen('E'))
+            sum += 1;
+    } else if (strncmp(cmd, "G92", 3) == 0) {
+        for (char c : { 'X', 'Y', 'Z', 'E' })
+            if (seen(c))
+                sum += code_value();
+    } else {
+        if (seen('S'))
+            sum += code_value();
+        if (seen('P'))
+            sum += code_value();
+    }
+    return sum;
+}
+
+static float sum_move(float sum, uint8_t seen, const float *values)
+{
+    for (uint8_t i = 0; i <= MOVE_WORD_F; ++i)
+        if (seen & _BV(i))
+            sum += values[i];
+    return sum;
+}
+
+// A move through process_commands() without the fast path.
+static float move_dispatch(float sum)
+{
+    code_words_parse();
+    const char *cmd = CMDBUFFER_CURRENT_STRING;
+    if (strncmp_P(cmd, PSTR("CRASH_"), 6) == 0 || strncmp_P(cmd, PSTR("TMC_"), 4) == 0
+        || strncmp_P(cmd, PSTR("BACKLASH_X"), 10) == 0 || strncmp_P(cmd, PSTR("BACKLASH_Y"), 10) == 0
+        || strncmp_P(cmd, PSTR("PRUSA"), 5) == 0)
+        return sum;
+    strchr_pointer = CMDBUFFER_CURRENT_STRING;
+    if (code_value_short() > 1)
+        return sum;
+    float values[NUM_AXIS + 1];
+    uint8_t seen = 0;
+    for (uint8_t i = 0; i <= MOVE_WORD_F; ++i) {
+        if (code_seen("XYZEF"[i])) {
+            seen |= _BV(i);
+            values[i] = code_value();
+        }
+    }
+    return sum_move(sum, seen, values);
+}
+
+static float move_fast(float sum)
+{
+    float values[NUM_AXIS + 1];
+    const uint8_t seen = code_move_words(values);
+    return (seen == MOVE_WORDS_INVALID) ? sum : sum_move(sum, seen, values);
+}
+
+// The commands as get_command() stores them: comments and empty lines removed.
+static std::vector<std::string> load(const char *path)
+{
+    std::vector<std::string> cmds;
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return cmds;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char *end = strpbrk(line, ";\r\n");
+        if (end)
+            *end = 0;
+        while (end > line && end[-1] == ' ')
+            *--end = 0;
+        if (line[0] && strlen(line) < MAX_CMD_SIZE)
+            cmds.push_back(line);
+    }
+    fclose(f);
+    return cmds;
+}
+
+// Host time per command of process(), which parses the command on the top of the queue.
+static double run(const std::vector<std::string> &cmds, float (*process)(float), float &sum)
+{
+    sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < REPEAT; ++r) {
+        for (const std::string &cmd : cmds) {
+            strcpy(CMDBUFFER_CURRENT_STRING, cmd.c_str());
+            sum = process(sum);
+        }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (double(REPEAT) * cmds.size());
+}
+
+static void run_lookups(const char *name, const std::vector<std::string> &cmds, float (*process)(float))
+{
+    chars_read = 0;
+    parsed_chars = 0;
+    lookups = 0;
+    float sum;
+    const double ns = run(cmds, process, sum);
+    const double n = double(REPEAT) * cmds.size();
+    const double avr = (double(chars_read - parsed_chars) * STRCHR_CHAR + double(parsed_chars) * PARSE_CHAR + double(lookups) * LOOKUP) / n;
+    printf("%-12s %7.1f ns/cmd  %5.1f chars read/cmd  %6.1f AVR cycles/cmd  (checksum %g)\n", name, ns, chars_read / n, avr, sum);
+}
+
+static void run_moves(const char *name, const std::vector<std::string> &moves, float (*process)(float))
+{
+    float sum;
+    const double ns = run(moves, process, sum);
+    printf("%-12s %7.1f ns/move  (checksum %g)\n", name, ns, sum);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s file.gcode\n", argv[0]);
+        return 1;
+    }
+    const std::vector<std::string> cmds = load(argv[1]);
+    if (cmds.empty()) {
+        fprintf(stderr, "no commands in %s\n", argv[1]);
+        return 1;
+    }
+    size_t len = 0;
+    std::vector<std::string> moves;
+    for (const std::string &cmd : cmds) {
+        len += cmd.size();
+        if (is_move(cmd.c_str()))
+            moves.push_back(cmd);
+    }
+    printf("commands     %zu (avg %.1f chars, %zu G0/G1)\n", cmds.size(), double(len) / cmds.size(), moves.size());
+
+    bufindr = 0;
+    buflen = 1;
+    cmdqueue[bufindr].type = CMDBUFFER_CURRENT_TYPE_SDCARD;
+    cmdqueue[bufindr].cmd = 0;
+    cmdqueue[bufindr].sdlen = 0;
+    run_lookups("strchr", cmds, lookup<no_parse, code_seen_strchr>);
+    run_lookups("word table", cmds, lookup<parse_words, code_seen_words>);
+    if (!moves.empty()) {
+        run_moves("G1 dispatch", moves, move_dispatch);
+        run_moves("G1 fast path", moves, move_fast);
+    }
+    return 0;
+}
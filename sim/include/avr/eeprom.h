@@ -0,0 +1,37 @@
+/**
+ * @file
+ * @brief Host replacement of avr-libc's EEPROM access, backed by a RAM image of the 4KB EEPROM.
+ */
+
+#ifndef SIM_AVR_EEPROM_H
+#define SIM_AVR_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define EEMEM
+
+namespace sim
+{
+extern uint8_t eeprom[4096];
+}
+
+uint8_t eeprom_read_byte(const uint8_t *addr);
+uint16_t eeprom_read_word(const uint16_t *addr);
+uint32_t eeprom_read_dword(const uint32_t *addr);
+float eeprom_read_float(const float *addr);
+void eeprom_read_block(void *dst, const void *src, size_t n);
+void eeprom_write_byte(uint8_t *addr, uint8_t value);
+void eeprom_write_word(uint16_t *addr, uint16_t value);
+void eeprom_write_dword(uint32_t *addr, uint32_t value);
+void eeprom_write_float(float *addr, float value);
+void eeprom_write_block(const void *src, void *dst, size_t n);
+#define eeprom_update_byte eeprom_write_byte
+#define eeprom_update_word eeprom_write_word
+#define eeprom_update_dword eeprom_write_dword
+#define eeprom_update_float eeprom_write_float
+#define eeprom_update_block eeprom_write_block
+#define eeprom_is_ready() 1
+#define eeprom_busy_wait() do {} while (0)
+
+#endif // SIM_AVR_EEPROM_H
@@ -0,0 +1,18 @@
+/**
+ * @file
+ * @brief Host replacement of avr-libc's interrupt handling.
+ *
+ * Interrupt vectors become ordinary functions, which the simulator calls explicitly.
+ */
+
+#ifndef SIM_AVR_INTERRUPT_H
+#define SIM_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define sei() do { SREG.poke(SREG.peek() | 0x80); } while (0)
+#define cli() do { SREG.poke(SREG.peek() & ~0x80); } while (0)
+
+#define ISR(vector, ...) extern "C" void vector(void); extern "C" void vector(void)
+
+#endif // SIM_AVR_INTERRUPT_H
@@ -0,0 +1,805 @@
+/**
+ * @file
+ * @brief Register and bit definitions of the ATmega2560 for the host build of the motion core.
+ *
+ * Generated with the register map of the ATmega2560 datasheet. The registers are sim_reg8 /
+ * sim_reg16 objects defined in sim_avr.cpp.
+ */
+
+#ifndef SIM_AVR_IO_H
+#define SIM_AVR_IO_H
+
+#include <stdint.h>
+#include "sim_avr.h"
+
+#ifndef __AVR_ATmega2560__
+#define __AVR_ATmega2560__
+#endif
+
+#define _BV(bit) (1 << (bit))
+#define _SFR_BYTE(sfr) (sfr)
+
+// MarlinSerial.h detects the UARTs by the presence of these macros
+#define UBRR0H UBRR0H
+#define UBRR1H UBRR1H
+#define UBRR2H UBRR2H
+#define UBRR3H UBRR3H
+#define UDR0 UDR0
+
+#define RAMSTART 0x200
+#define RAMEND 0x21FF
+#define E2END 0xFFF
+#define FLASHEND 0x3FFFF
+
+extern sim_reg8 PINA;
+extern sim_reg8 DDRA;
+extern sim_reg8 PORTA;
+extern sim_reg8 PINB;
+extern sim_reg8 DDRB;
+extern sim_reg8 PORTB;
+extern sim_reg8 PINC;
+extern sim_reg8 DDRC;
+extern sim_reg8 PORTC;
+extern sim_reg8 PIND;
+extern sim_reg8 DDRD;
+extern sim_reg8 PORTD;
+extern sim_reg8 PINE;
+extern sim_reg8 DDRE;
+extern sim_reg8 PORTE;
+extern sim_reg8 PINF;
+extern sim_reg8 DDRF;
+extern sim_reg8 PORTF;
+extern sim_reg8 PING;
+extern sim_reg8 DDRG;
+extern sim_reg8 PORTG;
+extern sim_reg8 PINH;
+extern sim_reg8 DDRH;
+extern sim_reg8 PORTH;
+extern sim_reg8 PINJ;
+extern sim_reg8 DDRJ;
+extern sim_reg8 PORTJ;
+extern sim_reg8 PINK;
+extern sim_reg8 DDRK;
+extern sim_reg8 PORTK;
+extern sim_reg8 PINL;
+extern sim_reg8 DDRL;
+extern sim_reg8 PORTL;
+extern sim_reg8 TCCR0A;
+extern sim_reg8 TCCR0B;
+extern sim_reg8 TCNT0;
+extern sim_reg8 OCR0A;
+extern sim_reg8 OCR0B;
+extern sim_reg8 TIFR0;
+extern sim_reg8 TIFR1;
+extern sim_reg8 TIFR2;
+extern sim_reg8 TIFR3;
+extern sim_reg8 TIFR4;
+extern sim_reg8 TIFR5;
+extern sim_reg8 EIFR;
+extern sim_reg8 EIMSK;
+extern sim_reg8 GPIOR0;
+extern sim_reg8 SPCR;
+extern sim_reg8 SPSR;
+extern sim_reg8 SPDR;
+extern sim_reg8 MCUSR;
+extern sim_reg8 SPL;
+extern sim_reg8 SPH;
+extern sim_reg8 SREG;
+extern sim_reg8 WDTCSR;
+extern sim_reg8 PCICR;
+extern sim_reg8 EICRA;
+extern sim_reg8 EICRB;
+extern sim_reg8 PCMSK0;
+extern sim_reg8 PCMSK1;
+extern sim_reg8 PCMSK2;
+extern sim_reg8 TIMSK0;
+extern sim_reg8 TIMSK1;
+extern sim_reg8 TIMSK2;
+extern sim_reg8 TIMSK3;
+extern sim_reg8 TIMSK4;
+extern sim_reg8 TIMSK5;
+extern sim_reg8 ADCL;
+extern sim_reg8 ADCH;
+extern sim_reg8 ADCSRA;
+extern sim_reg8 ADCSRB;
+extern sim_reg8 ADMUX;
+extern sim_reg8 DIDR2;
+extern sim_reg8 DIDR0;
+extern sim_reg8 TCCR1A;
+extern sim_reg8 TCCR1B;
+extern sim_reg8 TCCR1C;
+extern sim_reg8 TCCR3A;
+extern sim_reg8 TCCR3B;
+extern sim_reg8 TCCR3C;
+extern sim_reg8 TCCR4A;
+extern sim_reg8 TCCR4B;
+extern sim_reg8 TCCR4C;
+extern sim_reg8 TCCR2A;
+extern sim_reg8 TCCR2B;
+extern sim_reg8 TCNT2;
+extern sim_reg8 OCR2A;
+extern sim_reg8 OCR2B;
+extern sim_reg8 ASSR;
+extern sim_reg8 TWBR;
+extern sim_reg8 TWSR;
+extern sim_reg8 TWAR;
+extern sim_reg8 TWDR;
+extern sim_reg8 TWCR;
+extern sim_reg8 TCCR5A;
+extern sim_reg8 TCCR5B;
+extern sim_reg8 TCCR5C;
+extern sim_reg8 OCR1AL;
+extern sim_reg8 OCR1BL;
+extern sim_reg8 OCR1CL;
+extern sim_reg8 OCR2AL;
+extern sim_reg8 OCR0AL;
+extern sim_reg8 OCR3AL;
+extern sim_reg8 OCR3BL;
+extern sim_reg8 OCR3CL;
+extern sim_reg8 OCR4AL;
+extern sim_reg8 OCR4BL;
+extern sim_reg8 OCR4CL;
+extern sim_reg8 OCR5AL;
+extern sim_reg8 OCR5BL;
+extern sim_reg8 OCR5CL;
+extern sim_reg8 UCSR0A;
+extern sim_reg8 UCSR0B;
+extern sim_reg8 UCSR0C;
+extern sim_reg8 UBRR0L;
+extern sim_reg8 UBRR0H;
+extern sim_reg8 UDR0;
+extern sim_reg8 UCSR1A;
+extern sim_reg8 UCSR1B;
+extern sim_reg8 UCSR1C;
+extern sim_reg8 UBRR1L;
+extern sim_reg8 UBRR1H;
+extern sim_reg8 UDR1;
+extern sim_reg8 UCSR2A;
+extern sim_reg8 UCSR2B;
+extern sim_reg8 UCSR2C;
+extern sim_reg8 UBRR2L;
+extern sim_reg8 UBRR2H;
+extern sim_reg8 UDR2;
+extern sim_reg8 UCSR3A;
+extern sim_reg8 UCSR3B;
+extern sim_reg8 UCSR3C;
+extern sim_reg8 UBRR3L;
+extern sim_reg8 UBRR3H;
+extern sim_reg8 UDR3;
+
+extern sim_reg16 TCNT1;
+extern sim_reg16 ICR1;
+extern sim_reg16 OCR1A;
+extern sim_reg16 OCR1B;
+extern sim_reg16 OCR1C;
+extern sim_reg16 TCNT3;
+extern sim_reg16 ICR3;
+extern sim_reg16 OCR3A;
+extern sim_reg16 OCR3B;
+extern sim_reg16 OCR3C;
+extern sim_reg16 TCNT4;
+extern sim_reg16 ICR4;
+extern sim_reg16 OCR4A;
+extern sim_reg16 OCR4B;
+extern sim_reg16 OCR4C;
+extern sim_reg16 TCNT5;
+extern sim_reg16 ICR5;
+extern sim_reg16 OCR5A;
+extern sim_reg16 OCR5B;
+extern sim_reg16 OCR5C;
+extern sim_reg16 ADC;
+
+#define ADATE 5
+#define ADEN 7
+#define ADIE 3
+#define ADIF 4
+#define ADLAR 5
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADSC 6
+#define BORF 2
+#define COM0A0 6
+#define COM0A1 7
+#define COM0B0 4
+#define COM0B1 5
+#define COM0C0 2
+#define COM0C1 3
+#define COM1A0 6
+#define COM1A1 7
+#define COM1B0 4
+#define COM1B1 5
+#define COM1C0 2
+#define COM1C1 3
+#define COM2A0 6
+#define COM2A1 7
+#define COM2B0 4
+#define COM2B1 5
+#define COM2C0 2
+#define COM2C1 3
+#define COM3A0 6
+#define COM3A1 7
+#define COM3B0 4
+#define COM3B1 5
+#define COM3C0 2
+#define COM3C1 3
+#define COM4A0 6
+#define COM4A1 7
+#define COM4B0 4
+#define COM4B1 5
+#define COM4C0 2
+#define COM4C1 3
+#define COM5A0 6
+#define COM5A1 7
+#define COM5B0 4
+#define COM5B1 5
+#define COM5C0 2
+#define COM5C1 3
+#define CPHA 2
+#define CPOL 3
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define CS30 0
+#define CS31 1
+#define CS32 2
+#define CS40 0
+#define CS41 1
+#define CS42 2
+#define CS50 0
+#define CS51 1
+#define CS52 2
+#define DDA0 0
+#define DDA1 1
+#define DDA2 2
+#define DDA3 3
+#define DDA4 4
+#define DDA5 5
+#define DDA6 6
+#define DDA7 7
+#define DDB0 0
+#define DDB1 1
+#define DDB2 2
+#define DDB3 3
+#define DDB4 4
+#define DDB5 5
+#define DDB6 6
+#define DDB7 7
+#define DDC0 0
+#define DDC1 1
+#define DDC2 2
+#define DDC3 3
+#define DDC4 4
+#define DDC5 5
+#define DDC6 6
+#define DDC7 7
+#define DDD0 0
+#define DDD1 1
+#define DDD2 2
+#define DDD3 3
+#define DDD4 4
+#define DDD5 5
+#define DDD6 6
+#define DDD7 7
+#define DDE0 0
+#define DDE1 1
+#define DDE2 2
+#define DDE3 3
+#define DDE4 4
+#define DDE5 5
+#define DDE6 6
+#define DDE7 7
+#define DDF0 0
+#define DDF1 1
+#define DDF2 2
+#define DDF3 3
+#define DDF4 4
+#define DDF5 5
+#define DDF6 6
+#define DDF7 7
+#define DDG0 0
+#define DDG1 1
+#define DDG2 2
+#define DDG3 3
+#define DDG4 4
+#define DDG5 5
+#define DDG6 6
+#define DDG7 7
+#define DDH0 0
+#define DDH1 1
+#define DDH2 2
+#define DDH3 3
+#define DDH4 4
+#define DDH5 5
+#define DDH6 6
+#define DDH7 7
+#define DDJ0 0
+#define DDJ1 1
+#define DDJ2 2
+#define DDJ3 3
+#define DDJ4 4
+#define DDJ5 5
+#define DDJ6 6
+#define DDJ7 7
+#define DDK0 0
+#define DDK1 1
+#define DDK2 2
+#define DDK3 3
+#define DDK4 4
+#define DDK5 5
+#define DDK6 6
+#define DDK7 7
+#define DDL0 0
+#define DDL1 1
+#define DDL2 2
+#define DDL3 3
+#define DDL4 4
+#define DDL5 5
+#define DDL6 6
+#define DDL7 7
+#define DOR0 3
+#define DOR1 3
+#define DOR2 3
+#define DOR3 3
+#define DORD 5
+#define EXTRF 1
+#define FE0 4
+#define FE1 4
+#define FE2 4
+#define FE3 4
+#define INT0 0
+#define INT1 1
+#define INT2 2
+#define INT3 3
+#define INT4 4
+#define INT5 5
+#define INT6 6
+#define INT7 7
+#define ISC00 0
+#define ISC01 1
+#define ISC10 2
+#define ISC11 3
+#define ISC20 4
+#define ISC21 5
+#define ISC30 6
+#define ISC31 7
+#define ISC40 0
+#define ISC41 1
+#define ISC50 2
+#define ISC51 3
+#define ISC60 4
+#define ISC61 5
+#define ISC70 6
+#define ISC71 7
+#define JTRF 4
+#define MPCM0 0
+#define MPCM1 0
+#define MPCM2 0
+#define MPCM3 0
+#define MSTR 4
+#define MUX5 3
+#define OCF0A 1
+#define OCF0B 2
+#define OCF0C 3
+#define OCF1A 1
+#define OCF1B 2
+#define OCF1C 3
+#define OCF2A 1
+#define OCF2B 2
+#define OCF2C 3
+#define OCF3A 1
+#define OCF3B 2
+#define OCF3C 3
+#define OCF4A 1
+#define OCF4B 2
+#define OCF4C 3
+#define OCF5A 1
+#define OCF5B 2
+#define OCF5C 3
+#define OCIE0A 1
+#define OCIE0B 2
+#define OCIE0C 3
+#define OCIE1A 1
+#define OCIE1B 2
+#define OCIE1C 3
+#define OCIE2A 1
+#define OCIE2B 2
+#define OCIE2C 3
+#define OCIE3A 1
+#define OCIE3B 2
+#define OCIE3C 3
+#define OCIE4A 1
+#define OCIE4B 2
+#define OCIE4C 3
+#define OCIE5A 1
+#define OCIE5B 2
+#define OCIE5C 3
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PC7 7
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+#define PE0 0
+#define PE1 1
+#define PE2 2
+#define PE3 3
+#define PE4 4
+#define PE5 5
+#define PE6 6
+#define PE7 7
+#define PF0 0
+#define PF1 1
+#define PF2 2
+#define PF3 3
+#define PF4 4
+#define PF5 5
+#define PF6 6
+#define PF7 7
+#define PG0 0
+#define PG1 1
+#define PG2 2
+#define PG3 3
+#define PG4 4
+#define PG5 5
+#define PG6 6
+#define PG7 7
+#define PH0 0
+#define PH1 1
+#define PH2 2
+#define PH3 3
+#define PH4 4
+#define PH5 5
+#define PH6 6
+#define PH7 7
+#define PINA0 0
+#define PINA1 1
+#define PINA2 2
+#define PINA3 3
+#define PINA4 4
+#define PINA5 5
+#define PINA6 6
+#define PINA7 7
+#define PINB0 0
+#define PINB1 1
+#define PINB2 2
+#define PINB3 3
+#define PINB4 4
+#define PINB5 5
+#define PINB6 6
+#define PINB7 7
+#define PINC0 0
+#define PINC1 1
+#define PINC2 2
+#define PINC3 3
+#define PINC4 4
+#define PINC5 5
+#define PINC6 6
+#define PINC7 7
+#define PIND0 0
+#define PIND1 1
+#define PIND2 2
+#define PIND3 3
+#define PIND4 4
+#define PIND5 5
+#define PIND6 6
+#define PIND7 7
+#define PINE0 0
+#define PINE1 1
+#define PINE2 2
+#define PINE3 3
+#define PINE4 4
+#define PINE5 5
+#define PINE6 6
+#define PINE7 7
+#define PINF0 0
+#define PINF1 1
+#define PINF2 2
+#define PINF3 3
+#define PINF4 4
+#define PINF5 5
+#define PINF6 6
+#define PINF7 7
+#define PING0 0
+#define PING1 1
+#define PING2 2
+#define PING3 3
+#define PING4 4
+#define PING5 5
+#define PING6 6
+#define PING7 7
+#define PINH0 0
+#define PINH1 1
+#define PINH2 2
+#define PINH3 3
+#define PINH4 4
+#define PINH5 5
+#define PINH6 6
+#define PINH7 7
+#define PINJ0 0
+#define PINJ1 1
+#define PINJ2 2
+#define PINJ3 3
+#define PINJ4 4
+#define PINJ5 5
+#define PINJ6 6
+#define PINJ7 7
+#define PINK0 0
+#define PINK1 1
+#define PINK2 2
+#define PINK3 3
+#define PINK4 4
+#define PINK5 5
+#define PINK6 6
+#define PINK7 7
+#define PINL0 0
+#define PINL1 1
+#define PINL2 2
+#define PINL3 3
+#define PINL4 4
+#define PINL5 5
+#define PINL6 6
+#define PINL7 7
+#define PJ0 0
+#define PJ1 1
+#define PJ2 2
+#define PJ3 3
+#define PJ4 4
+#define PJ5 5
+#define PJ6 6
+#define PJ7 7
+#define PK0 0
+#define PK1 1
+#define PK2 2
+#define PK3 3
+#define PK4 4
+#define PK5 5
+#define PK6 6
+#define PK7 7
+#define PL0 0
+#define PL1 1
+#define PL2 2
+#define PL3 3
+#define PL4 4
+#define PL5 5
+#define PL6 6
+#define PL7 7
+#define PORF 0
+#define PORTA0 0
+#define PORTA1 1
+#define PORTA2 2
+#define PORTA3 3
+#define PORTA4 4
+#define PORTA5 5
+#define PORTA6 6
+#define PORTA7 7
+#define PORTB0 0
+#define PORTB1 1
+#define PORTB2 2
+#define PORTB3 3
+#define PORTB4 4
+#define PORTB5 5
+#define PORTB6 6
+#define PORTB7 7
+#define PORTC0 0
+#define PORTC1 1
+#define PORTC2 2
+#define PORTC3 3
+#define PORTC4 4
+#define PORTC5 5
+#define PORTC6 6
+#define PORTC7 7
+#define PORTD0 0
+#define PORTD1 1
+#define PORTD2 2
+#define PORTD3 3
+#define PORTD4 4
+#define PORTD5 5
+#define PORTD6 6
+#define PORTD7 7
+#define PORTE0 0
+#define PORTE1 1
+#define PORTE2 2
+#define PORTE3 3
+#define PORTE4 4
+#define PORTE5 5
+#define PORTE6 6
+#define PORTE7 7
+#define PORTF0 0
+#define PORTF1 1
+#define PORTF2 2
+#define PORTF3 3
+#define PORTF4 4
+#define PORTF5 5
+#define PORTF6 6
+#define PORTF7 7
+#define PORTG0 0
+#define PORTG1 1
+#define PORTG2 2
+#define PORTG3 3
+#define PORTG4 4
+#define PORTG5 5
+#define PORTG6 6
+#define PORTG7 7
+#define PORTH0 0
+#define PORTH1 1
+#define PORTH2 2
+#define PORTH3 3
+#define PORTH4 4
+#define PORTH5 5
+#define PORTH6 6
+#define PORTH7 7
+#define PORTJ0 0
+#define PORTJ1 1
+#define PORTJ2 2
+#define PORTJ3 3
+#define PORTJ4 4
+#define PORTJ5 5
+#define PORTJ6 6
+#define PORTJ7 7
+#define PORTK0 0
+#define PORTK1 1
+#define PORTK2 2
+#define PORTK3 3
+#define PORTK4 4
+#define PORTK5 5
+#define PORTK6 6
+#define PORTK7 7
+#define PORTL0 0
+#define PORTL1 1
+#define PORTL2 2
+#define PORTL3 3
+#define PORTL4 4
+#define PORTL5 5
+#define PORTL6 6
+#define PORTL7 7
+#define REFS0 6
+#define REFS1 7
+#define RXC0 7
+#define RXC1 7
+#define RXC2 7
+#define RXC3 7
+#define RXCIE0 7
+#define RXCIE1 7
+#define RXCIE2 7
+#define RXCIE3 7
+#define RXEN0 4
+#define RXEN1 4
+#define RXEN2 4
+#define RXEN3 4
+#define SPE 6
+#define SPI2X 0
+#define SPIE 7
+#define SPIF 7
+#define SPR0 0
+#define SPR1 1
+#define TOIE0 0
+#define TOIE1 0
+#define TOIE2 0
+#define TOIE3 0
+#define TOIE4 0
+#define TOIE5 0
+#define TOV0 0
+#define TOV1 0
+#define TOV2 0
+#define TOV3 0
+#define TOV4 0
+#define TOV5 0
+#define TWEA 6
+#define TWEN 2
+#define TWIE 0
+#define TWINT 7
+#define TWSTA 5
+#define TWSTO 4
+#define TWWC 3
+#define TXC0 6
+#define TXC1 6
+#define TXC2 6
+#define TXC3 6
+#define TXCIE0 6
+#define TXCIE1 6
+#define TXCIE2 6
+#define TXCIE3 6
+#define TXEN0 3
+#define TXEN1 3
+#define TXEN2 3
+#define TXEN3 3
+#define U2X0 1
+#define U2X1 1
+#define U2X2 1
+#define U2X3 1
+#define UCSZ00 1
+#define UCSZ01 2
+#define UCSZ02 2
+#define UCSZ10 1
+#define UCSZ11 2
+#define UCSZ12 2
+#define UCSZ20 1
+#define UCSZ21 2
+#define UCSZ22 2
+#define UCSZ30 1
+#define UCSZ31 2
+#define UCSZ32 2
+#define UDRE0 5
+#define UDRE1 5
+#define UDRE2 5
+#define UDRE3 5
+#define UDRIE0 5
+#define UDRIE1 5
+#define UDRIE2 5
+#define UDRIE3 5
+#define UPE0 2
+#define UPE1 2
+#define UPE2 2
+#define UPE3 2
+#define WCOL 6
+#define WDCE 4
+#define WDE 3
+#define WDIE 6
+#define WDIF 7
+#define WDP0 0
+#define WDP1 1
+#define WDP2 2
+#define WDP3 5
+#define WDRF 3
+#define WGM00 0
+#define WGM01 1
+#define WGM02 3
+#define WGM03 3
+#define WGM10 0
+#define WGM11 1
+#define WGM12 3
+#define WGM13 4
+#define WGM20 0
+#define WGM21 1
+#define WGM22 3
+#define WGM23 3
+#define WGM30 0
+#define WGM31 1
+#define WGM32 3
+#define WGM33 4
+#define WGM40 0
+#define WGM41 1
+#define WGM42 3
+#define WGM43 4
+#define WGM50 0
+#define WGM51 1
+#define WGM52 3
+#define WGM53 4
+
+#endif // SIM_AVR_IO_H
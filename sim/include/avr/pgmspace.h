@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief Host replacement of avr-libc's program memory access.
+ *
+ * The host has a single address space, so PROGMEM data is plain const data. Word reads are
+ * counted, since each one corresponds to an lpm pair on the AVR.
+ */
+
+#ifndef SIM_AVR_PGMSPACE_H
+#define SIM_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#ifdef __cplusplus
+#include "sim_avr.h"
+#endif
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define strncasecmp_P strncasecmp
+#define strlen_P strlen
+#define strchr_P strchr
+#define strstr_P strstr
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+#define printf_P printf
+#define fputs_P fputs
+#define puts_P puts
+
+typedef uint32_t uint_farptr_t;
+
+static inline uint8_t pgm_read_byte(const void *p) { return *(const uint8_t *)p; }
+static inline uint16_t pgm_read_word(const void *p)
+{
+#ifdef __cplusplus
+    ++sim::io_stats.pgm_reads;
+#endif
+    uint16_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+static inline uint32_t pgm_read_dword(const void *p) { uint32_t d; memcpy(&d, p, sizeof(d)); return d; }
+static inline float pgm_read_float(const void *p) { float f; memcpy(&f, p, sizeof(f)); return f; }
+static inline const void *pgm_read_ptr(const void *p) { return *(const void *const *)p; }
+
+#define pgm_read_byte_near(p) pgm_read_byte((const void *)(uintptr_t)(p))
+#define pgm_read_word_near(p) pgm_read_word((const void *)(uintptr_t)(p))
+#define pgm_read_dword_near(p) pgm_read_dword((const void *)(uintptr_t)(p))
+#define pgm_read_byte_far(p) pgm_read_byte((const void *)(uintptr_t)(p))
+#define pgm_read_word_far(p) pgm_read_word((const void *)(uintptr_t)(p))
+
+#endif // SIM_AVR_PGMSPACE_H
@@ -0,0 +1,11 @@
+#ifndef SIM_AVR_WDT_H
+#define SIM_AVR_WDT_H
+
+#define WDTO_15MS 0
+#define WDTO_1S 6
+#define WDTO_4S 8
+#define wdt_reset() do {} while (0)
+#define wdt_enable(x) do {} while (0)
+#define wdt_disable() do {} while (0)
+
+#endif // SIM_AVR_WDT_H
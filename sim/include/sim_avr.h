@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @brief Host emulation of the ATmega2560 special function registers used by the motion core.
+ *
+ * Every register is an object which records its accesses, so the simulator can count the port
+ * writes of the stepper interrupt and estimate the AVR cycles spent in it (see avr_cycles.h).
+ */
+
+#ifndef SIM_AVR_H
+#define SIM_AVR_H
+
+#include <stdint.h>
+
+namespace sim
+{
+
+/// Access counters of the emulated I/O space, reset by the simulator before each ISR invocation.
+struct io_stats_t
+{
+    uint32_t io_reads;      ///< reads of registers in the I/O space (in/sbic/sbis)
+    uint32_t io_writes;     ///< read-modify-write or plain writes in the I/O space (out/sbi/cbi)
+    uint32_t mem_reads;     ///< reads of memory mapped registers (lds)
+    uint32_t mem_writes;    ///< writes of memory mapped registers (lds/ori/sts or sts)
+    uint32_t pgm_reads;     ///< lpm word reads from the program memory
+    uint32_t serial_polls;  ///< polls of the USART status register (MSerial.checkRx())
+};
+
+extern io_stats_t io_stats;
+
+/// Estimate of the AVR cycles elapsed since the start of the current ISR, zero outside of it.
+/// Used to emulate TCNT1 while the stepper interrupt is executing.
+uint32_t isr_cycles_so_far();
+
+/// Simulated time since the start of the simulation.
+uint32_t now_us();
+
+/// Called whenever a port output register changes. Used by the simulator to detect step pulses.
+typedef void (*port_hook_t)(uint16_t addr, uint8_t old_value, uint8_t new_value);
+extern port_hook_t port_hook;
+
+/// Called for every character written to a USART data register.
+typedef void (*serial_hook_t)(uint8_t c);
+extern serial_hook_t serial_hook;
+
+/// Called for every byte written to the SPI data register, returns the byte shifted in from the
+/// slave. The transfer completes immediately. Without a hook the bus reads 0xFF (no SD card).
+typedef uint8_t (*spi_hook_t)(uint8_t c);
+extern spi_hook_t spi_hook;
+
+/// Address limit of the I/O space. Registers above are accessed through lds/sts only.
+static const uint16_t IO_SPACE_END = 0x60;
+
+void reset_registers();
+
+} // namespace sim
+
+/// 8bit special function register
+class sim_reg8
+{
+public:
+    explicit sim_reg8(uint16_t addr, uint16_t toggle_addr = 0)
+        : value(0), addr(addr), toggle_addr(toggle_addr) {}
+
+    operator uint8_t() const { count_read(); return value; }
+    sim_reg8 &operator=(uint8_t v) { store(v); return *this; }
+    sim_reg8 &operator=(const sim_reg8 &r) { store(uint8_t(r)); return *this; }
+    sim_reg8 &operator|=(int v) { store(value | v); return *this; }
+    sim_reg8 &operator&=(int v) { store(value & v); return *this; }
+    sim_reg8 &operator^=(int v) { store(value ^ v); return *this; }
+
+    /// The firmware compares register addresses (see _WRITE in fastio.h), return the AVR one.
+    uint8_t *operator&() const { return (uint8_t *)(uintptr_t)addr; }
+    explicit operator char *() const { return (char *)(uintptr_t)addr; }
+
+    /// Set the register content without accounting (external pin levels, peripherals).
+    void poke(uint8_t v) { value = v; }
+    uint8_t peek() const { return value; }
+
+    uint8_t value;
+    const uint16_t addr;
+
+private:
+    void count_read() const;
+    void store(uint8_t v);
+    const uint16_t toggle_addr; ///< PINx registers toggle PORTx on write
+};
+
+/// 16bit special function register
+class sim_reg16
+{
+public:
+    typedef uint16_t (*read_hook_t)();
+
+    explicit sim_reg16(uint16_t addr, read_hook_t hook = nullptr)
+        : value(0), addr(addr), hook(hook) {}
+
+    operator uint16_t() const { count(false); return hook ? hook() : value; }
+    sim_reg16 &operator=(uint16_t v) { count(true); value = v; return *this; }
+    sim_reg16 &operator=(const sim_reg16 &r) { return *this = uint16_t(r); }
+    sim_reg16 &operator|=(int v) { return *this = uint16_t(value | v); }
+    sim_reg16 &operator&=(int v) { return *this = uint16_t(value & v); }
+    sim_reg16 &operator+=(int v) { return *this = uint16_t(value + v); }
+    uint16_t *operator&() const { return (uint16_t *)(uintptr_t)addr; }
+
+    void poke(uint16_t v) { value = v; }
+    uint16_t peek() const { return value; }
+
+    uint16_t value;
+    const uint16_t addr;
+
+private:
+    void count(bool write) const;
+    read_hook_t hook;
+};
+
+#endif // SIM_AVR_H
@@ -0,0 +1,11 @@
+#ifndef SIM_UTIL_ATOMIC_H
+#define SIM_UTIL_ATOMIC_H
+
+#include <avr/interrupt.h>
+
+// The simulator runs the interrupts synchronously, the atomic blocks are single pass loops.
+#define ATOMIC_BLOCK(type) for (uint8_t _sim_atomic_once = 1; _sim_atomic_once; _sim_atomic_once = 0)
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+
+#endif // SIM_UTIL_ATOMIC_H
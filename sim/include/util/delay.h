@@ -0,0 +1,8 @@
+#ifndef SIM_UTIL_DELAY_H
+#define SIM_UTIL_DELAY_H
+
+/// Busy waits do not advance the simulated time. They are not used in the stepping path.
+#define _delay_us(us) do { (void)(us); } while (0)
+#define _delay_ms(ms) do { (void)(ms); } while (0)
+
+#endif // SIM_UTIL_DELAY_H
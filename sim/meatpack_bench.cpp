@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @brief Serial bandwidth of MeatPack over a G-code file.
+ *
+ * Usage: meatpack_bench file.gcode
+ *
+ * The lines of the file are packed by the host encoder (meatpack_encoder.h), with and without the
+ * spaces, and fed byte by byte through the firmware decoder (mp_handle_rx_char()). The decoded text
+ * has to be identical to the packed one. Printed are the bytes on the serial line, the characters
+ * of the plain G-code per second they carry at 115200 baud and the host time of the decoder per
+ * byte, once a byte at a time (mp_handle_rx_char()) and once a line at a time (mp_decode_line()).
+ * The last row sends the lines in the frames of the binary transport (binary_transport_encoder.h),
+ * with their line numbers and CRC, through the firmware frame parser (bt_receive()).
+ * The exit code is non zero if a round trip failed.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Marlin.h"
+#include "cmdqueue.h"
+#include "meatpack.h"
+#include "meatpack_encoder.h"
+#include "binary_transport.h"
+#include "binary_transport_encoder.h"
+#include "sim_avr.h"
+
+// 115200 baud, 8N1: 10 bits per byte.
+static const double SERIAL_BYTES_PER_S = 115200 / 10.;
+
+static const unsigned REPEAT = 20;
+
+// The text of the file as the host sends it, one packed line after another.
+static std::string load(const char *path, bool no_spaces)
+{
+    std::string text;
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return text;
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+        text += sim::meatpack_line(line, no_spaces);
+    fclose(f);
+    return text;
+}
+
+// Decodes the stream byte by byte, returns the decoded text.
+static std::string decode(const std::vector<uint8_t> &stream)
+{
+    std::string text;
+    for (uint8_t c : stream) {
+        mp_handle_rx_char(c);
+        char out[2];
+        const uint8_t n = mp_get_result_char(out);
+        text.append(out, n);
+    }
+    return text;
+}
+
+// Decodes the stream line by line (mp_decode_line()), as get_command() does.
+static std::string decode_lines(const std::vector<uint8_t> &stream)
+{
+    std::string text;
+    size_t pos = 0;
+    for (;;) {
+        char line[MAX_CMD_SIZE];
+        uint16_t consumed;
+        const uint16_t n = uint16_t(min(stream.size() - pos, size_t(RX_BUFFER_SIZE)));
+        const uint8_t count = mp_decode_line(stream.data() + pos, n, consumed, line, sizeof(line));
+        if (count == 0 && consumed == 0)
+            return text;
+        text.append(line, count);
+        pos += consumed;
+    }
+}
+
+template <std::string (*decoder)(const std::vector<uint8_t> &)>
+static double decode_ns(const std::vector<uint8_t> &stream, size_t &check)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < REPEAT; ++r)
+        check += decoder(stream).size();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (double(REPEAT) * stream.size());
+}
+
+// The bytes and the rates relate to the characters of the plain text (chars), the text without the
+// spaces carries the same commands.
+static bool run(const char *name, const std::string &text, size_t chars, bool packed, bool no_spaces)
+{
+    std::vector<uint8_t> stream;
+    sim::meatpack_command(MPCommand_ResetAll, stream);
+    if (packed) {
+        sim::meatpack_command(MPCommand_EnablePacking, stream);
+        if (no_spaces)
+            sim::meatpack_command(MPCommand_EnableNoSpaces, stream);
+    }
+    const size_t header = stream.size();
+    if (packed)
+        sim::meatpack_encode(text, no_spaces, stream);
+    else
+        stream.insert(stream.end(), text.begin(), text.end());
+
+    const bool ok = (decode(stream) == text) && (decode_lines(stream) == text);
+    size_t check = 0;
+    const double ns_bytes = decode_ns<decode>(stream, check);
+    const double ns_lines = decode_ns<decode_lines>(stream, check);
+
+    const size_t bytes = stream.size() - header;
+    printf("%-14s %7zu bytes  %5.1f %%  %6.0f chars/s  %5.1f ns/byte, %5.1f ns/byte by lines  (checksum %zu) round trip %s\n",
+        name, bytes, 100. * bytes / chars, SERIAL_BYTES_PER_S * chars / bytes, ns_bytes, ns_lines, check, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+#ifdef ENABLE_BINARY_TRANSPORT
+// Receives the frames, returns the G-code of the G-code frames, one line per move frame.
+static std::string receive_frames(const std::vector<uint8_t> &stream)
+{
+    std::string text;
+    bt_enable(true);
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        char line[MAX_CMD_SIZE];
+        int line_len = 0;
+        uint16_t consumed;
+        const uint16_t n = uint16_t(min(stream.size() - pos, size_t(RX_BUFFER_SIZE)));
+        const uint8_t status = bt_receive(stream.data() + pos, n, consumed, line, line_len);
+        pos += consumed;
+        if (status == BT_RX_ERROR)
+            break;
+        if (status == BT_RX_FRAME)
+            text += (line[0] == MOVE_RECORD_MARKER) ? std::string("move") : std::string(line, line_len);
+    }
+    bt_enable(false);
+    return text;
+}
+
+static bool run_binary(const std::string &text, size_t chars)
+{
+    std::vector<uint8_t> stream;
+    std::string expected;
+    uint16_t n = 0;
+    for (size_t start = 0; start < text.size();) {
+        const size_t end = text.find('\n', start);
+        const std::string line = text.substr(start, end - start);
+        expected += sim::bt_encode_line(line, ++n, stream) ? std::string("move") : line;
+        start = end + 1;
+    }
+    const bool ok = (receive_frames(stream) == expected);
+    size_t check = 0;
+    const double ns = decode_ns<receive_frames>(stream, check);
+    printf("%-14s %7zu bytes  %5.1f %%  %6.0f chars/s  %5.1f ns/byte by frames  (checksum %zu) round trip %s\n",
+        "binary", stream.size(), 100. * stream.size() / chars, SERIAL_BYTES_PER_S * chars / stream.size(), ns, check,
+        ok ? "ok" : "FAILED");
+    return ok;
+}
+#endif // ENABLE_BINARY_TRANSPORT
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s file.gcode\n", argv[0]);
+        return 1;
+    }
+    const std::string text = load(argv[1], false);
+    const std::string text_no_spaces = load(argv[1], true);
+    if (text.empty()) {
+        fprintf(stderr, "no commands in %s\n", argv[1]);
+        return 1;
+    }
+    // The decoder echoes its configuration to the serial line.
+    sim::reset_registers();
+    printf("text           %7zu chars\n", text.size());
+    bool ok = run("plain", text, text.size(), false, false);
+    ok &= run("packed", text, text.size(), true, false);
+    ok &= run("packed no sp", text_no_spaces, text.size(), true, true);
+#ifdef ENABLE_BINARY_TRANSPORT
+    ok &= run_binary(text, text.size());
+#endif
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#include "meatpack_encoder.h"
+#include <string.h>
+
+namespace sim
+{
+
+static const uint8_t COMMAND_BYTE = 0xff;
+static const uint8_t NOT_PACKED = 0x0f;
+static const uint8_t SPACE_INDEX = 11;
+
+// The alphabet of the decoder (MeatPackLookupTbl), the space is 'E' with the spaces omitted.
+static const char alphabet[] = "0123456789. \nGX";
+
+static int8_t pack_index(char c, bool no_spaces)
+{
+    if (c == ' ')
+        return no_spaces ? -1 : SPACE_INDEX;
+    if (c == 'E')
+        return no_spaces ? SPACE_INDEX : -1;
+    const char *p = (c != 0) ? strchr(alphabet, c) : nullptr;
+    return p ? int8_t(p - alphabet) : -1;
+}
+
+void meatpack_command(uint8_t cmd, std::vector<uint8_t> &out)
+{
+    out.push_back(COMMAND_BYTE);
+    out.push_back(COMMAND_BYTE);
+    out.push_back(cmd);
+}
+
+std::string meatpack_line(const char *line, bool no_spaces)
+{
+    std::string text(line, strcspn(line, ";\r\n"));
+    const size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos)
+        return std::string();
+    text.erase(0, first);
+    text.erase(text.find_last_not_of(" \t") + 1);
+    if (no_spaces && text[0] == 'G') {
+        std::string packed;
+        for (char c : text)
+            if (c != ' ')
+                packed += c;
+        text.swap(packed);
+    }
+    return text + '\n';
+}
+
+void meatpack_encode(const std::string &text, bool no_spaces, std::vector<uint8_t> &out)
+{
+    for (size_t i = 0; i < text.size();) {
+        const char c1 = text[i++];
+        if (c1 == '\n') {
+            // The decoder drops the second character of a pair starting with the end of line.
+            out.push_back(uint8_t(SPACE_INDEX << 4) | uint8_t(pack_index('\n', no_spaces)));
+            continue;
+        }
+        // Every line ends with '\n', so the pair is complete.
+        const char c2 = text[i++];
+        const int8_t i1 = pack_index(c1, no_spaces);
+        const int8_t i2 = pack_index(c2, no_spaces);
+        if (i1 >= 0 && i2 >= 0)
+            out.push_back(uint8_t(i2 << 4) | uint8_t(i1));
+        else if (i1 >= 0) {
+            out.push_back(uint8_t(NOT_PACKED << 4) | uint8_t(i1));
+            out.push_back(uint8_t(c2));
+        } else if (i2 >= 0) {
+            out.push_back(uint8_t(i2 << 4) | NOT_PACKED);
+            out.push_back(uint8_t(c1));
+        } else {
+            out.push_back(COMMAND_BYTE);
+            out.push_back(uint8_t(c1));
+            out.push_back(uint8_t(c2));
+        }
+    }
+}
+
+} // namespace sim
@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @brief Host side MeatPack encoder, the counterpart of the firmware decoder (meatpack.cpp).
+ *
+ * Follows the packing of the host plugins: comments are stripped, every line is terminated by a
+ * single '\n'. Two characters of the 15 character alphabet share one byte, the other characters are
+ * sent in full after the byte which announces them.
+ */
+
+#ifndef MEATPACK_ENCODER_H
+#define MEATPACK_ENCODER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace sim
+{
+
+/// Appends the sequence of the MeatPack command cmd (MPCommand_EnablePacking, ...) to out.
+void meatpack_command(uint8_t cmd, std::vector<uint8_t> &out);
+
+/// The line as it is packed: without the comment and the surrounding white space, terminated by
+/// '\n'. Empty for an empty line. With no_spaces the spaces of the G-codes are removed, the other
+/// commands keep them (M117 texts and the like).
+std::string meatpack_line(const char *line, bool no_spaces);
+
+/// Appends the packed text (prepared by meatpack_line()) to out. With no_spaces the decoder has to
+/// be switched to MPCommand_EnableNoSpaces, 'E' is packed instead of the space.
+void meatpack_encode(const std::string &text, bool no_spaces, std::vector<uint8_t> &out);
+
+} // namespace sim
+
+#endif // MEATPACK_ENCODER_H
@@ -0,0 +1,225 @@
+/**
+ * @file
+ * @brief Host side driver of the planner and the stepper interrupt.
+ */
+
+#include <string.h>
+#include <memory>
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "ConfigurationStore.h"
+#include "fastio.h"
+#include "motion_core.h"
+
+extern "C" void TIMER1_COMPA_vect(void);
+extern volatile dda_usteps_t step_events_completed;
+extern bool stepper_timer_overflow_state;
+
+namespace sim
+{
+
+#define SIM_DIO_WPORT(IO) _SIM_DIO_WPORT(IO)
+#define _SIM_DIO_WPORT(IO) DIO ## IO ## _WPORT
+#define SIM_DIO_PIN(IO) _SIM_DIO_PIN(IO)
+#define _SIM_DIO_PIN(IO) DIO ## IO ## _PIN
+
+struct step_pin_t
+{
+    const sim_reg8 *port;
+    uint8_t mask;
+    uint8_t active;     ///< output level of a step, unused with TMC2130_DEDGE_STEPPING
+    const sim_reg8 *dir_port;
+    uint8_t dir_mask;
+    uint8_t dir_invert; ///< output level of the direction pin moving towards the negative end
+};
+
+static step_pin_t step_pins[4];
+static motion_stats_t stats;
+static isr_trace_t isr_trace;
+static step_trace_t step_trace;
+static int32_t positions[4];
+
+static bool in_isr;
+static isr_events_t events;
+static block_t *isr_block;
+static uint32_t isr_block_step;
+
+static void init_step_pins()
+{
+    step_pins[X_AXIS] = { std::addressof(SIM_DIO_WPORT(X_STEP_PIN)), _BV(SIM_DIO_PIN(X_STEP_PIN)), !INVERT_X_STEP_PIN,
+        std::addressof(SIM_DIO_WPORT(X_DIR_PIN)), _BV(SIM_DIO_PIN(X_DIR_PIN)), INVERT_X_DIR };
+    step_pins[Y_AXIS] = { std::addressof(SIM_DIO_WPORT(Y_STEP_PIN)), _BV(SIM_DIO_PIN(Y_STEP_PIN)), !INVERT_Y_STEP_PIN,
+        std::addressof(SIM_DIO_WPORT(Y_DIR_PIN)), _BV(SIM_DIO_PIN(Y_DIR_PIN)), INVERT_Y_DIR };
+    step_pins[Z_AXIS] = { std::addressof(SIM_DIO_WPORT(Z_STEP_PIN)), _BV(SIM_DIO_PIN(Z_STEP_PIN)), !INVERT_Z_STEP_PIN,
+        std::addressof(SIM_DIO_WPORT(Z_DIR_PIN)), _BV(SIM_DIO_PIN(Z_DIR_PIN)), INVERT_Z_DIR };
+    step_pins[E_AXIS] = { std::addressof(SIM_DIO_WPORT(E0_STEP_PIN)), _BV(SIM_DIO_PIN(E0_STEP_PIN)), !INVERT_E_STEP_PIN,
+        std::addressof(SIM_DIO_WPORT(E0_DIR_PIN)), _BV(SIM_DIO_PIN(E0_DIR_PIN)), INVERT_E0_DIR };
+}
+
+static void on_port_write(uint16_t addr, uint8_t old_value, uint8_t new_value)
+{
+    const uint8_t changed = old_value ^ new_value;
+    for (uint8_t axis = 0; axis < 4; ++axis) {
+        const step_pin_t &pin = step_pins[axis];
+        if (pin.port->addr != addr || !(changed & pin.mask))
+            continue;
+#ifndef TMC2130_DEDGE_STEPPING
+        if (bool(new_value & pin.mask) != bool(pin.active))
+            continue;
+#endif
+        ++stats.steps[axis];
+        ++events.steps;
+        const bool negative = bool(pin.dir_port->peek() & pin.dir_mask) == bool(pin.dir_invert);
+        positions[axis] += negative ? -1 : 1;
+        if (step_trace)
+            step_trace(axis, positions[axis]);
+    }
+}
+
+/// Bresenham loops executed since the start of the ISR.
+static uint16_t loops_so_far()
+{
+    if (current_block == isr_block)
+        return current_block ? step_events_completed.wide - isr_block_step : 0;
+    uint32_t loops = 0;
+    if (isr_block)
+        loops += isr_block->step_event_count.wide - isr_block_step;
+    if (current_block)
+        loops += step_events_completed.wide;
+    return loops;
+}
+
+static void collect_events()
+{
+    events.io = io_stats;
+    events.loops = loops_so_far();
+    if (current_block != isr_block) {
+        events.block_ends = isr_block != NULL;
+        events.block_setups = current_block != NULL;
+    }
+    const block_t *block = current_block ? current_block : isr_block;
+    if (block) {
+        events.lowres = block->flag & BLOCK_FLAG_DDA_LOWRES;
+        const uint32_t step = isr_block == block ? isr_block_step : 0;
+        if (events.loops && (step < block->accelerate_until || step > block->decelerate_after)) {
+            events.ramp_updates = 1;
+#ifdef S_CURVE_ACCELERATION
+            events.scurve_updates = (step < block->accelerate_until) ? (block->accel_dv_inv != 0) : (block->decel_dv_inv != 0);
+#endif
+        }
+    }
+}
+
+uint32_t isr_cycles_so_far()
+{
+    if (!in_isr)
+        return 0;
+    collect_events();
+    return estimate_cycles(events);
+}
+
+uint32_t now_us()
+{
+    return stats.ticks / (F_CPU / CYCLES_PER_TICK / 1000000);
+}
+
+void motion_init()
+{
+    reset_registers();
+    init_step_pins();
+    port_hook = on_port_write;
+
+    // Drop the moves an earlier run left queued, Config_ResetDefault() waits for them to finish
+    // when it updates the input shapers. The delayed steps of the shapers are counted before the
+    // statistics are cleared.
+    quickStop();
+    Config_ResetDefault();
+    memset(&stats, 0, sizeof(stats));
+    memset(positions, 0, sizeof(positions));
+    plan_init();
+    st_init();
+    enable_endstops(false);
+    sei();
+}
+
+void isr()
+{
+    memset(&io_stats, 0, sizeof(io_stats));
+    memset(&events, 0, sizeof(events));
+    isr_block = current_block;
+    isr_block_step = current_block ? step_events_completed.wide : 0;
+    stepper_timer_overflow_state = false;
+#ifdef INPUT_SHAPING
+    const bool shaping = st_shaping_busy();
+#endif
+
+    in_isr = true;
+    TIMER1_COMPA_vect();
+    collect_events();
+    in_isr = false;
+
+#ifdef INPUT_SHAPING
+    // The shaper closes a slot every 2^SHAPING_SLOT_SHIFT ticks while it is busy.
+    if (shaping || st_shaping_busy()) {
+        events.shaping = true;
+        events.shaper_slots = ((stats.ticks + OCR1A.peek()) >> SHAPING_SLOT_SHIFT) - (stats.ticks >> SHAPING_SLOT_SHIFT);
+    }
+#endif
+    const uint32_t cycles = estimate_cycles(events);
+    const uint16_t period = OCR1A.peek();
+    ++stats.isr_invocations;
+    stats.isr_stepping += events.loops != 0;
+    stats.isr_ramp += events.ramp_updates;
+    stats.loops += events.loops;
+    stats.blocks += events.block_setups;
+    stats.cycles += cycles;
+    if (cycles > stats.cycles_max)
+        stats.cycles_max = cycles;
+    if (cycles > uint32_t(period) * CYCLES_PER_TICK)
+        ++stats.overruns;
+    stats.fw_overruns += stepper_timer_overflow_state;
+    stats.ticks += period;
+
+    if (isr_trace)
+        isr_trace(events, cycles, period);
+}
+
+void idle()
+{
+    // Nested calls may come from the firmware code executed by the ISR itself.
+    if (!in_isr)
+        isr();
+}
+
+void run_until_idle()
+{
+#ifdef INPUT_SHAPING
+    while (blocks_queued() || current_block || st_shaping_busy())
+#else
+    while (blocks_queued() || current_block)
+#endif
+        isr();
+}
+
+int32_t step_position(uint8_t axis)
+{
+    return positions[axis];
+}
+
+motion_stats_t &motion_stats()
+{
+    return stats;
+}
+
+void set_isr_trace(isr_trace_t trace)
+{
+    isr_trace = trace;
+}
+
+void set_step_trace(step_trace_t trace)
+{
+    step_trace = trace;
+}
+
+} // namespace sim
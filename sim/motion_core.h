@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief Host side driver of the planner and the stepper interrupt.
+ *
+ * The firmware motion core (planner.cpp, stepper.cpp, motion_control.cpp) is compiled unchanged
+ * against the emulated registers of sim_avr.h. The driver executes TIMER1_COMPA_vect at the
+ * times programmed into OCR1A, counts the emitted step pulses and estimates the AVR cycles of
+ * every invocation with the cost model of avr_cycles.h.
+ */
+
+#ifndef MOTION_CORE_H
+#define MOTION_CORE_H
+
+#include <stdint.h>
+#include "avr_cycles.h"
+
+namespace sim
+{
+
+/// Timer1 runs at F_CPU / 8.
+static const uint8_t CYCLES_PER_TICK = 8;
+
+/// Accumulated statistics of the stepper interrupt.
+struct motion_stats_t
+{
+    uint32_t isr_invocations;
+    uint32_t isr_stepping;          ///< invocations executing at least one Bresenham loop
+    uint32_t isr_ramp;              ///< invocations recalculating the step rate
+    uint32_t overruns;              ///< invocations exceeding the period they programmed into OCR1A
+    uint32_t fw_overruns;           ///< invocations flagged by the firmware (DEBUG_STEPPER_TIMER_MISSED)
+    uint32_t loops;
+    uint32_t blocks;
+    uint32_t steps[4];              ///< step pulses emitted per axis (X, Y, Z, E)
+    uint32_t cycles_max;            ///< the longest invocation
+    uint64_t cycles;                ///< estimated cycles spent in the interrupt
+    uint64_t ticks;                 ///< simulated time in timer1 ticks (0.5us)
+};
+
+/// Called after every ISR invocation with its recorded events and cycle estimate.
+typedef void (*isr_trace_t)(const isr_events_t &ev, uint32_t cycles, uint16_t period);
+
+/// Called on every step pulse with the axis and its new position.
+typedef void (*step_trace_t)(uint8_t axis, int32_t position);
+
+/// Reset the emulated hardware, load the default settings and initialize the planner and the stepper.
+void motion_init();
+
+/// Execute the stepper interrupt once and advance the simulated time by the programmed period.
+void isr();
+
+/// Called by the firmware from its busy loops (see manage_heater() in sim_stubs.cpp).
+void idle();
+
+/// Execute the stepper interrupt until all queued blocks are finished (and the input shapers emitted their delayed steps).
+void run_until_idle();
+
+/// Position of an axis in steps, counted from the step pulses and the direction pins since motion_init().
+int32_t step_position(uint8_t axis);
+
+/// Called by the process_commands() stub of sim_stubs.cpp for the command on the top of the queue.
+typedef void (*process_commands_hook_t)();
+extern process_commands_hook_t process_commands_hook;
+
+motion_stats_t &motion_stats();
+void set_isr_trace(isr_trace_t trace);
+void set_step_trace(step_trace_t trace);
+
+} // namespace sim
+
+#endif // MOTION_CORE_H
@@ -0,0 +1,291 @@
+/**
+ * @file
+ * @brief Replays a G-code file through the planner and the stepper interrupt on the host.
+ *
+ * Usage: motion_sim [-v] [-t trace.csv] [-p position.csv] file.gcode
+ *
+ * Supported commands: G0/G1, G2/G3 (I J offsets), G4, G28 (resets the position to zero),
+ * G90/G91, G92, M82/M83, M204 P/S/T, M205 X/Y/Z/E/J, M400, M593 X/Y/F/D/T, M900 K.
+ * Everything else is ignored.
+ * At the end, the emitted steps, the stepper interrupt statistics and the estimated AVR cycles
+ * spent in it are printed to stdout.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "motion_control.h"
+#include "ConfigurationStore.h"
+#include "motion_core.h"
+
+static bool relative_xyz;
+static bool relative_e = true;
+static FILE *trace;
+static FILE *position_trace;
+
+struct gcode_line_t
+{
+    char letter[16];
+    float value[16];
+    uint8_t count;
+
+    bool seen(char c, float *v = NULL) const
+    {
+        for (uint8_t i = 0; i < count; ++i)
+            if (letter[i] == c) {
+                if (v)
+                    *v = value[i];
+                return true;
+            }
+        return false;
+    }
+};
+
+static void parse(const char *s, gcode_line_t &line)
+{
+    line.count = 0;
+    while (*s && *s != ';' && line.count < sizeof(line.letter)) {
+        if (isalpha(*s)) {
+            char *end;
+            line.letter[line.count] = toupper(*s);
+            line.value[line.count] = strtof(s + 1, &end);
+            ++line.count;
+            s = (end == s + 1) ? s + 1 : end;
+        } else
+            ++s;
+    }
+}
+
+static void set_destination(const gcode_line_t &line)
+{
+    static const char axis_codes[NUM_AXIS] = { 'X', 'Y', 'Z', 'E' };
+    for (uint8_t i = 0; i < NUM_AXIS; ++i) {
+        float v;
+        if (line.seen(axis_codes[i], &v))
+            destination[i] = v + (((i == E_AXIS) ? relative_e : relative_xyz) ? current_position[i] : 0);
+        else
+            destination[i] = current_position[i];
+    }
+    float f;
+    if (line.seen('F', &f) && f > 0)
+        feedrate = f;
+}
+
+static void process(const gcode_line_t &line)
+{
+    float code, v;
+    if (line.seen('G', &code)) {
+        switch ((int)code) {
+        case 0:
+        case 1:
+            set_destination(line);
+            plan_buffer_line_destinationXYZE(feedrate / 60);
+            memcpy(current_position, destination, sizeof(current_position));
+            break;
+        case 2:
+        case 3: {
+            set_destination(line);
+            float offset[2] = { 0, 0 };
+            line.seen('I', &offset[0]);
+            line.seen('J', &offset[1]);
+            mc_arc(current_position, destination, offset, feedrate / 60, hypot(offset[0], offset[1]), code == 2, 1);
+            memcpy(current_position, destination, sizeof(current_position));
+            break;
+        }
+        case 4:
+            st_synchronize();
+            break;
+        case 28:
+            st_synchronize();
+            memset(current_position, 0, sizeof(current_position));
+            plan_set_position_curposXYZE();
+            break;
+        case 90:
+            relative_xyz = false;
+            relative_e = false;
+            break;
+        case 91:
+            relative_xyz = true;
+            relative_e = true;
+            break;
+        case 92:
+            for (uint8_t i = 0; i < NUM_AXIS; ++i)
+                if (line.seen("XYZE"[i], &v))
+                    current_position[i] = v;
+            plan_set_position_curposXYZE();
+            break;
+        }
+    } else if (line.seen('M', &code)) {
+        switch ((int)code) {
+        case 82:
+            relative_e = false;
+            break;
+        case 83:
+            relative_e = true;
+            break;
+        case 204:
+            if (line.seen('S', &v))
+                cs.acceleration = cs.travel_acceleration = v;
+            if (line.seen('P', &v))
+                cs.acceleration = v;
+            if (line.seen('T', &v))
+                cs.travel_acceleration = v;
+            break;
+        case 205:
+            if (line.seen('X', &v))
+                cs.max_jerk[X_AXIS] = cs.max_jerk[Y_AXIS] = v;
+            if (line.seen('Y', &v))
+                cs.max_jerk[Y_AXIS] = v;
+            if (line.seen('Z', &v))
+                cs.max_jerk[Z_AXIS] = v;
+            if (line.seen('E', &v))
+                cs.max_jerk[E_AXIS] = v;
+            if (line.seen('J', &v))
+                cs.junction_deviation = v;
+            break;
+        case 214:
+            if (line.seen('P', &v))
+                cs.mm_per_arc_segment = v;
+            if (line.seen('S', &v))
+                cs.min_mm_per_arc_segment = v;
+            if (line.seen('T', &v))
+                cs.arc_tolerance = v;
+            break;
+        case 400:
+            st_synchronize();
+            break;
+#ifdef INPUT_SHAPING
+        case 593: {
+            const bool x = line.seen('X') || !line.seen('Y');
+            const bool y = line.seen('Y') || !line.seen('X');
+            for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis) {
+                if (!(axis == X_AXIS ? x : y))
+                    continue;
+                if (line.seen('F', &v))
+                    cs.shaping_freq[axis] = v;
+                if (line.seen('D', &v))
+                    cs.shaping_zeta[axis] = v;
+                if (line.seen('T', &v))
+                    cs.shaping_type[axis] = v;
+            }
+            shaper_update();
+            break;
+        }
+#endif
+#ifdef LIN_ADVANCE
+        case 900:
+            if (line.seen('K', &v))
+                extruder_advance_K = v;
+            break;
+#endif
+        }
+    }
+}
+
+static void echo_serial(uint8_t c)
+{
+    fputc(c, stderr);
+}
+
+static void trace_isr(const sim::isr_events_t &ev, uint32_t cycles, uint16_t period)
+{
+    fprintf(trace, "%llu,%u,%u,%u,%u,%u\n", (unsigned long long)sim::motion_stats().ticks,
+        period, (unsigned)cycles, ev.loops, ev.steps, ev.block_setups);
+}
+
+static void trace_position(uint8_t axis, int32_t)
+{
+    if (axis > Y_AXIS)
+        return;
+    const double us = double(sim::motion_stats().ticks) * sim::CYCLES_PER_TICK / (F_CPU / 1000000);
+    fprintf(position_trace, "%.1f,%d,%d\n", us, sim::step_position(X_AXIS), sim::step_position(Y_AXIS));
+}
+
+static void report(const sim::motion_stats_t &s)
+{
+    const double seconds = double(s.ticks) * sim::CYCLES_PER_TICK / F_CPU;
+    printf("simulated time      %.3f s\n", seconds);
+    printf("blocks              %u\n", s.blocks);
+#ifdef PLANNER_DIAGNOSTICS
+    printf("planner sqrt/block  %.2f\n", s.blocks ? double(planner_sqrt_count()) / s.blocks : 0.);
+#endif
+    printf("steps X/Y/Z/E       %u / %u / %u / %u\n", s.steps[X_AXIS], s.steps[Y_AXIS], s.steps[Z_AXIS], s.steps[E_AXIS]);
+    printf("position X/Y/Z/E    %ld / %ld / %ld / %ld\n", st_get_position(X_AXIS), st_get_position(Y_AXIS),
+        st_get_position(Z_AXIS), st_get_position(E_AXIS));
+    printf("isr invocations     %u (stepping %u, ramp %u)\n", s.isr_invocations, s.isr_stepping, s.isr_ramp);
+    printf("bresenham loops     %u\n", s.loops);
+    printf("isr cycles avg/max  %.1f / %u\n", s.isr_invocations ? double(s.cycles) / s.isr_invocations : 0., s.cycles_max);
+    printf("isr cpu load        %.2f %%\n", s.ticks ? 100. * s.cycles / (double(s.ticks) * sim::CYCLES_PER_TICK) : 0.);
+    printf("timer overruns      %u (firmware detected %u)\n", s.overruns, s.fw_overruns);
+#ifdef STEP_LOOPS_ADAPTIVE
+    st_isr_stats_t isr;
+    st_get_isr_stats(isr);
+    printf("multi-step limit    %u steps/s (busy max %u ticks)\n", isr.isr_rate_max, isr.busy_max);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-v"))
+            verbose = true;
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            trace = fopen(argv[++i], "w");
+            if (!trace) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            position_trace = fopen(argv[++i], "w");
+            if (!position_trace) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else
+            path = argv[i];
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [-v] [-t trace.csv] [-p position.csv] file.gcode\n", argv[0]);
+        return 1;
+    }
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+
+    if (verbose)
+        sim::serial_hook = echo_serial;
+    sim::motion_init();
+    if (trace) {
+        fprintf(trace, "ticks,period,cycles,loops,steps,block\n");
+        sim::set_isr_trace(trace_isr);
+    }
+    if (position_trace) {
+        fprintf(position_trace, "time_us,x,y\n");
+        sim::set_step_trace(trace_position);
+    }
+
+    char buf[256];
+    gcode_line_t line;
+    while (fgets(buf, sizeof(buf), f)) {
+        parse(buf, line);
+        process(line);
+    }
+    fclose(f);
+    sim::run_until_idle();
+
+    report(sim::motion_stats());
+    if (trace)
+        fclose(trace);
+    if (position_trace)
+        fclose(position_trace);
+    return 0;
+}
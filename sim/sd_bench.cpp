@@ -0,0 +1,177 @@
+/**
+ * @file
+ * @brief SD card traffic of printing, listing and sorting, on the emulated card (sd_card.h).
+ *
+ * Usage: sd_bench file.gcode
+ *        sd_bench -i card.img FILE.GCO
+ *
+ * The first form builds the images of FAT16 and FAT32 cards of several cluster sizes
+ * (fat_image.h), each one with a print of about 4 MB made of the repeated G-code file, 60 more
+ * G-code files with long names in the root directory and two subdirectories of 20 files. The
+ * second form loads the image of a real card and prints the named file of its root directory.
+ *
+ * Printed are the blocks read from the card and the read commands (CMD17 and CMD18) per MB of the
+ * printed G-code (CardReader::getFilteredGcodeChar()), the blocks read by a recursive listing
+ * (M20, CardReader::ls()), by CardReader::presort() of the root directory, by a seek to 90 % of
+ * the print after it was read (CardReader::setIndex() and the next line) and by the same seek of
+ * the resume of a power panic, right after the file is opened. The firmware built with the FAT
+ * cache (SD_FAT_CACHE) adds the FAT lookups of the print served by it and the FAT blocks read.
+ * The exit code is non zero if the card reported a protocol error.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "fat_image.h"
+#include "sd_card.h"
+#include "Marlin.h"
+#include "cardreader.h"
+#include "eeprom.h"
+#include "sim_avr.h"
+
+static const size_t PRINT_SIZE = 4 * 1024 * 1024;
+static const char PRINT_NAME[] = "PRINT.GCO";
+
+static std::string load(const char *path)
+{
+    std::string text;
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return text;
+    char buffer[4096];
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), f)) > 0;)
+        text.append(buffer, n);
+    fclose(f);
+    return text;
+}
+
+static std::vector<sim::fat_file_t> card_files(const std::string &gcode, uint16_t run)
+{
+    std::vector<sim::fat_file_t> files;
+    char name[64];
+    for (unsigned i = 0; i < 60; ++i) {
+        snprintf(name, sizeof(name), "model %02u %s 0.2mm PLA MK3S.gcode", (i * 37) % 60, i % 2 ? "left" : "right");
+        files.push_back({ name, gcode.substr(0, 20000), 0 });
+    }
+    for (unsigned i = 0; i < 40; ++i) {
+        snprintf(name, sizeof(name), "%s/part %02u.gcode", i < 20 ? "calibration" : "archive", i);
+        files.push_back({ name, gcode.substr(0, 5000), 0 });
+    }
+    std::string print;
+    while (print.size() < PRINT_SIZE)
+        print += gcode;
+    files.push_back({ PRINT_NAME, print, run });
+    return files;
+}
+
+static uint32_t read_commands()
+{
+    return sim::sd_card_stats.single_reads + sim::sd_card_stats.multiple_reads;
+}
+
+static bool run(const char *name, const char *print_name)
+{
+    sim::reset_registers();
+    card.mount(false);
+    if (!card.mounted) {
+        printf("%-18s mount failed\n", name);
+        return false;
+    }
+    uint32_t errors = sim::sd_card_stats.errors;
+
+    sim::sd_card_stats = sim::sd_card_stats_t();
+    card.ls(CardReader::ls_param());
+    const uint32_t list_blocks = sim::sd_card_stats.blocks_read;
+    errors += sim::sd_card_stats.errors;
+
+    sim::sd_card_stats = sim::sd_card_stats_t();
+    eeprom_update_byte((uint8_t *)EEPROM_SD_SORT, SD_SORT_ALPHA);
+    card.presort();
+    const uint32_t presort_blocks = sim::sd_card_stats.blocks_read;
+    errors += sim::sd_card_stats.errors;
+
+    card.openFileReadFilteredGcode(print_name);
+    if (!card.isFileOpen()) {
+        printf("%-18s %s not found\n", name, print_name);
+        return false;
+    }
+    const uint32_t size = card.getFileSize();
+    sim::sd_card_stats = sim::sd_card_stats_t();
+#if SD_FAT_CACHE
+    const uint32_t fat_hits = SdVolume::fatCacheHits();
+    const uint32_t fat_misses = SdVolume::fatCacheMisses();
+#endif
+    while (card.getFilteredGcodeChar() >= 0) {}
+    const double mb = size / double(1024 * 1024);
+    const double print_blocks = sim::sd_card_stats.blocks_read / mb;
+    const double print_commands = read_commands() / mb;
+#if SD_FAT_CACHE
+    const uint32_t print_fat_hits = SdVolume::fatCacheHits() - fat_hits;
+    const uint32_t print_fat_misses = SdVolume::fatCacheMisses() - fat_misses;
+#endif
+    errors += sim::sd_card_stats.errors;
+
+    sim::sd_card_stats = sim::sd_card_stats_t();
+    card.setIndex(size / 10 * 9);
+    while (card.getFilteredGcodeChar() > '\n') {}
+    const uint32_t seek_blocks = sim::sd_card_stats.blocks_read;
+    errors += sim::sd_card_stats.errors;
+    card.closefile();
+
+    card.openFileReadFilteredGcode(print_name);
+    sim::sd_card_stats = sim::sd_card_stats_t();
+    card.setIndex(size / 10 * 9);
+    while (card.getFilteredGcodeChar() > '\n') {}
+    const uint32_t resume_blocks = sim::sd_card_stats.blocks_read;
+    errors += sim::sd_card_stats.errors;
+    card.closefile();
+
+    printf("%-18s print %7.1f blocks/MB %6.1f reads/MB  list %5u blocks  presort %6u blocks  seek %4u blocks  resume %4u blocks",
+        name, print_blocks, print_commands, list_blocks, presort_blocks, seek_blocks, resume_blocks);
+#if SD_FAT_CACHE
+    printf("  FAT cache %5u hits %4u misses", print_fat_hits, print_fat_misses);
+#endif
+    printf("%s\n", errors ? "  ERRORS" : "");
+    return !errors;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 4 && strcmp(argv[1], "-i") == 0) {
+        if (!sim::sd_card_load(argv[2])) {
+            fprintf(stderr, "can't read %s\n", argv[2]);
+            return 1;
+        }
+        return run(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s file.gcode\n       %s -i card.img FILE.GCO\n", argv[0], argv[0]);
+        return 1;
+    }
+    const std::string gcode = load(argv[1]);
+    if (gcode.empty()) {
+        fprintf(stderr, "no G-code in %s\n", argv[1]);
+        return 1;
+    }
+
+    struct config_t
+    {
+        const char *name;
+        sim::fat_volume_t volume;
+        uint16_t run;
+    };
+    static const config_t configs[] = {
+        { "FAT16 16k", { 16, 1024 * 1024, 32 }, 0 },
+        { "FAT32 4k", { 32, 2 * 1024 * 1024, 8 }, 0 },
+        { "FAT32 32k", { 32, 16 * 1024 * 1024, 64 }, 0 },
+        { "FAT32 4k 8k runs", { 32, 2 * 1024 * 1024, 8 }, 2 },
+        { "FAT32 32k 64k runs", { 32, 16 * 1024 * 1024, 64 }, 2 },
+    };
+    bool ok = true;
+    for (const config_t &config : configs) {
+        sim::sd_card_insert(sim::fat_image(config.volume, card_files(gcode, config.run)), config.volume.blocks);
+        ok &= run(config.name, PRINT_NAME);
+    }
+    return ok ? 0 : 1;
+}
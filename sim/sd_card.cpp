@@ -0,0 +1,302 @@
+/**
+ * @file
+ * @brief SD card on the emulated SPI bus.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include "sd_card.h"
+#include "Marlin.h"
+
+// Chip select of the card, active low
+#define SD_SELECTED_(IO) (!(DIO##IO##_WPORT.peek() & _BV(DIO##IO##_PIN)))
+#define SD_SELECTED(IO) SD_SELECTED_(IO)
+
+// Level of the card detect switch
+#ifdef SDCARDDETECTINVERTED
+#define SD_DETECT_LEVEL(inserted) (inserted)
+#else
+#define SD_DETECT_LEVEL(inserted) (!(inserted))
+#endif
+#define SD_DETECT_(IO, inserted) DIO##IO##_RPORT.poke(SD_DETECT_LEVEL(inserted) ? \
+    DIO##IO##_RPORT.peek() | _BV(DIO##IO##_PIN) : DIO##IO##_RPORT.peek() & ~_BV(DIO##IO##_PIN))
+#define SD_DETECT(IO, inserted) SD_DETECT_(IO, inserted)
+
+namespace sim
+{
+
+sd_card_stats_t sd_card_stats;
+
+namespace
+{
+
+enum sd_state_t : uint8_t
+{
+    SD_WAIT_COMMAND,  // 0xFF from the host until the start of a command
+    SD_COMMAND,       // receiving the 6 bytes of a command
+    SD_WRITE_TOKEN,   // CMD24 accepted, waiting for the data token
+    SD_WRITE_DATA,    // receiving the block and its CRC
+};
+
+struct sd_card_t
+{
+    std::vector<uint8_t> image;
+    uint32_t blocks;          // size of the card, the blocks past the image read zeros
+    std::deque<uint8_t> out;  // bytes shifted out by the next transfers
+    sd_state_t state;
+    uint8_t command[6];
+    uint16_t received;        // bytes of the command or of the written block
+    uint8_t data[512 + 2];
+    uint32_t block;           // written block, next block of the multiple block read
+    bool idle;                // idle state until ACMD41
+    bool app_command;         // CMD55 received, the next command is an ACMD
+    bool streaming;           // CMD18 sends the blocks until CMD12
+    bool access_time;         // one byte of the access time sent before the next block
+};
+
+sd_card_t sd;
+
+// CRC16 of the data blocks, CRC-16/XMODEM.
+uint16_t sd_crc16(const uint8_t *data, size_t size)
+{
+    uint16_t crc = 0;
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= uint16_t(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+void sd_send_data(const uint8_t *data, size_t size)
+{
+    const uint16_t crc = sd_crc16(data, size);
+    sd.out.push_back(0xFF); // access time
+    sd.out.push_back(0xFE); // start block token
+    sd.out.insert(sd.out.end(), data, data + size);
+    sd.out.push_back(crc >> 8);
+    sd.out.push_back(crc & 0xFF);
+}
+
+void sd_send_block(uint32_t block)
+{
+    static const uint8_t zeros[512] = {};
+    if (block >= sd.blocks) {
+        sd.out.push_back(0x08); // data error token, out of range
+        return;
+    }
+    sd_send_data(block < sd.image.size() / 512 ? &sd.image[size_t(block) * 512] : zeros, 512);
+    ++sd_card_stats.blocks_read;
+}
+
+void sd_send_register(bool csd)
+{
+    uint8_t reg[16] = {};
+    if (csd) {
+        // CSD version 2.0, the capacity in units of 512 KiB
+        const uint32_t c_size = sd.blocks >= 1024 ? sd.blocks / 1024 - 1 : 0;
+        reg[0] = 0x40;
+        reg[7] = (c_size >> 16) & 0x3F;
+        reg[8] = c_size >> 8;
+        reg[9] = c_size;
+    }
+    sd_send_data(reg, sizeof(reg));
+}
+
+void sd_respond(uint8_t r1)
+{
+    sd.out.push_back(0xFF); // command response time
+    sd.out.push_back(r1 | (sd.idle ? 0x01 : 0));
+}
+
+void sd_execute()
+{
+    const uint8_t cmd = sd.command[0] & 0x3F;
+    const uint32_t arg = uint32_t(sd.command[1]) << 24 | uint32_t(sd.command[2]) << 16
+        | uint32_t(sd.command[3]) << 8 | sd.command[4];
+    const bool app_command = sd.app_command;
+    sd.app_command = false;
+    ++sd_card_stats.commands;
+    sd.out.clear();
+
+    if (cmd == 12) {
+        ++sd_card_stats.stops;
+        sd.streaming = false;
+        sd.out.push_back(0xFF); // stuff byte
+        sd_respond(0);
+        return;
+    }
+    if (sd.streaming) {
+        // The host has to stop the transfer first.
+        ++sd_card_stats.errors;
+        sd.streaming = false;
+    }
+    switch (cmd) {
+    case 0:
+        sd.idle = true;
+        sd_respond(0);
+        break;
+    case 8:
+        sd_respond(0);
+        sd.out.insert(sd.out.end(), { 0x00, 0x00, uint8_t(arg >> 8), uint8_t(arg) });
+        break;
+    case 9:
+    case 10:
+        sd_respond(0);
+        sd_send_register(cmd == 9);
+        break;
+    case 13:
+        sd_respond(0);
+        sd.out.push_back(0x00);
+        break;
+    case 17:
+        ++sd_card_stats.single_reads;
+        sd_respond(0);
+        sd_send_block(arg);
+        break;
+    case 18:
+        ++sd_card_stats.multiple_reads;
+        sd_respond(0);
+        sd.streaming = true;
+        sd.access_time = false;
+        sd.block = arg;
+        break;
+    case 24:
+        ++sd_card_stats.writes;
+        sd_respond(0);
+        sd.block = arg;
+        sd.state = SD_WRITE_TOKEN;
+        break;
+    case 41:
+        if (app_command) {
+            sd.idle = false;
+            sd_respond(0);
+            break;
+        }
+        goto illegal;
+    case 55:
+        sd_respond(0);
+        sd.app_command = true;
+        break;
+    case 58:
+        sd_respond(0);
+        sd.out.insert(sd.out.end(), { 0xC0, 0xFF, 0x80, 0x00 }); // powered up, SDHC
+        break;
+    default:
+    illegal:
+        ++sd_card_stats.errors;
+        sd_respond(0x04);
+        break;
+    }
+}
+
+void sd_receive(uint8_t c)
+{
+    switch (sd.state) {
+    case SD_WAIT_COMMAND:
+        if ((c & 0xC0) == 0x40) {
+            sd.command[0] = c;
+            sd.received = 1;
+            sd.state = SD_COMMAND;
+        }
+        break;
+    case SD_COMMAND:
+        sd.command[sd.received++] = c;
+        if (sd.received == sizeof(sd.command)) {
+            sd.state = SD_WAIT_COMMAND;
+            sd_execute();
+        }
+        break;
+    case SD_WRITE_TOKEN:
+        if (c == 0xFE) {
+            sd.received = 0;
+            sd.state = SD_WRITE_DATA;
+        }
+        break;
+    case SD_WRITE_DATA:
+        sd.data[sd.received++] = c;
+        if (sd.received == sizeof(sd.data)) {
+            sd.state = SD_WAIT_COMMAND;
+            if (sd.block < sd.blocks) {
+                if (sd.block >= sd.image.size() / 512)
+                    sd.image.resize((size_t(sd.block) + 1) * 512);
+                memcpy(&sd.image[size_t(sd.block) * 512], sd.data, 512);
+                ++sd_card_stats.blocks_written;
+                sd.out.push_back(0x05); // data accepted
+            } else {
+                sd.out.push_back(0x0D); // write error
+            }
+            sd.out.push_back(0x00);     // busy programming
+        }
+        break;
+    }
+}
+
+uint8_t sd_transfer(uint8_t c)
+{
+    if (!SD_SELECTED(SDSS))
+        return 0xFF;
+    uint8_t reply = 0xFF;
+    if (!sd.out.empty()) {
+        reply = sd.out.front();
+        sd.out.pop_front();
+    } else if (sd.streaming && sd.state == SD_WAIT_COMMAND && c == 0xFF) {
+        // Not busy while the card fetches the next block: the host may stop the transfer here.
+        if (sd.access_time) {
+            sd_send_block(sd.block++);
+            reply = sd.out.front();
+            sd.out.pop_front();
+        }
+        sd.access_time = !sd.access_time;
+    }
+    sd_receive(c);
+    return reply;
+}
+
+} // namespace
+
+void sd_card_insert(const std::vector<uint8_t> &image, uint32_t blocks)
+{
+    sd = sd_card_t();
+    sd.image = image;
+    sd.image.resize((image.size() + 511) / 512 * 512);
+    sd.blocks = blocks > sd.image.size() / 512 ? blocks : sd.image.size() / 512;
+    sd.idle = true;
+    sd_card_stats = sd_card_stats_t();
+    spi_hook = sd_transfer;
+#if SDCARDDETECT > -1
+    SD_DETECT(SDCARDDETECT, true);
+#endif
+}
+
+bool sd_card_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+    std::vector<uint8_t> image;
+    uint8_t buffer[4096];
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), f)) > 0;)
+        image.insert(image.end(), buffer, buffer + n);
+    const bool ok = !ferror(f);
+    fclose(f);
+    if (ok)
+        sd_card_insert(image);
+    return ok;
+}
+
+void sd_card_remove()
+{
+    spi_hook = nullptr;
+#if SDCARDDETECT > -1
+    SD_DETECT(SDCARDDETECT, false);
+#endif
+}
+
+std::vector<uint8_t> &sd_card_image()
+{
+    return sd.image;
+}
+
+} // namespace sim
@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @brief SD card on the emulated SPI bus, serving the blocks of a disk image.
+ *
+ * Answers the SPI mode commands sent by Sd2Card.cpp like an SDHC card: the initialization, the CSD
+ * and CID registers, the single and multiple block reads (CMD17, CMD18 ended by CMD12) and the
+ * single block writes (CMD24). The commands and the transferred blocks are counted, to measure the
+ * card traffic of the FAT code.
+ */
+
+#ifndef SD_CARD_H
+#define SD_CARD_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace sim
+{
+
+struct sd_card_stats_t
+{
+    uint32_t commands;        ///< commands received, the application commands included
+    uint32_t single_reads;    ///< CMD17
+    uint32_t multiple_reads;  ///< CMD18
+    uint32_t stops;           ///< CMD12
+    uint32_t writes;          ///< CMD24
+    uint32_t blocks_read;     ///< data blocks sent to the host
+    uint32_t blocks_written;  ///< data blocks written to the image
+    uint32_t errors;          ///< commands not supported, or sent before the end of a multiple block read
+};
+
+extern sd_card_stats_t sd_card_stats;
+
+/// Inserts the card holding the image, padded to whole blocks. A card of more blocks than the image
+/// reads zeros past its end. Resets the statistics.
+void sd_card_insert(const std::vector<uint8_t> &image, uint32_t blocks = 0);
+
+/// Inserts the card holding the content of the disk image file. Returns false if it can't be read.
+bool sd_card_load(const char *path);
+
+/// Removes the card, the SPI bus reads 0xFF.
+void sd_card_remove();
+
+/// Content of the card, the written blocks included.
+std::vector<uint8_t> &sd_card_image();
+
+} // namespace sim
+
+#endif // SD_CARD_H
@@ -0,0 +1,296 @@
+/**
+ * @file
+ * @brief Emulated ATmega2560 registers, EEPROM and Arduino core functions of the motion simulator.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include "Arduino.h"
+#include <avr/eeprom.h>
+
+namespace sim
+{
+io_stats_t io_stats;
+port_hook_t port_hook;
+serial_hook_t serial_hook;
+spi_hook_t spi_hook;
+uint8_t eeprom[4096];
+} // namespace sim
+
+// TCNT1 counts at F_CPU/8 from the compare match which started the current ISR.
+static uint16_t sim_tcnt1()
+{
+    return uint16_t(sim::isr_cycles_so_far() / 8);
+}
+
+// Register storage, generated together with include/avr/io.h
+sim_reg8 PINA(0x020, 0x022);
+sim_reg8 DDRA(0x021);
+sim_reg8 PORTA(0x022);
+sim_reg8 PINB(0x023, 0x025);
+sim_reg8 DDRB(0x024);
+sim_reg8 PORTB(0x025);
+sim_reg8 PINC(0x026, 0x028);
+sim_reg8 DDRC(0x027);
+sim_reg8 PORTC(0x028);
+sim_reg8 PIND(0x029, 0x02B);
+sim_reg8 DDRD(0x02A);
+sim_reg8 PORTD(0x02B);
+sim_reg8 PINE(0x02C, 0x02E);
+sim_reg8 DDRE(0x02D);
+sim_reg8 PORTE(0x02E);
+sim_reg8 PINF(0x02F, 0x031);
+sim_reg8 DDRF(0x030);
+sim_reg8 PORTF(0x031);
+sim_reg8 PING(0x032, 0x034);
+sim_reg8 DDRG(0x033);
+sim_reg8 PORTG(0x034);
+sim_reg8 PINH(0x100, 0x102);
+sim_reg8 DDRH(0x101);
+sim_reg8 PORTH(0x102);
+sim_reg8 PINJ(0x103, 0x105);
+sim_reg8 DDRJ(0x104);
+sim_reg8 PORTJ(0x105);
+sim_reg8 PINK(0x106, 0x108);
+sim_reg8 DDRK(0x107);
+sim_reg8 PORTK(0x108);
+sim_reg8 PINL(0x109, 0x10B);
+sim_reg8 DDRL(0x10A);
+sim_reg8 PORTL(0x10B);
+sim_reg8 TCCR0A(0x044);
+sim_reg8 TCCR0B(0x045);
+sim_reg8 TCNT0(0x046);
+sim_reg8 OCR0A(0x047);
+sim_reg8 OCR0B(0x048);
+sim_reg8 TIFR0(0x035);
+sim_reg8 TIFR1(0x036);
+sim_reg8 TIFR2(0x037);
+sim_reg8 TIFR3(0x038);
+sim_reg8 TIFR4(0x039);
+sim_reg8 TIFR5(0x03A);
+sim_reg8 EIFR(0x03C);
+sim_reg8 EIMSK(0x03D);
+sim_reg8 GPIOR0(0x03E);
+sim_reg8 SPCR(0x04C);
+sim_reg8 SPSR(0x04D);
+sim_reg8 SPDR(0x04E);
+sim_reg8 MCUSR(0x054);
+sim_reg8 SPL(0x05D);
+sim_reg8 SPH(0x05E);
+sim_reg8 SREG(0x05F);
+sim_reg8 WDTCSR(0x060);
+sim_reg8 PCICR(0x068);
+sim_reg8 EICRA(0x069);
+sim_reg8 EICRB(0x06A);
+sim_reg8 PCMSK0(0x06B);
+sim_reg8 PCMSK1(0x06C);
+sim_reg8 PCMSK2(0x06D);
+sim_reg8 TIMSK0(0x06E);
+sim_reg8 TIMSK1(0x06F);
+sim_reg8 TIMSK2(0x070);
+sim_reg8 TIMSK3(0x071);
+sim_reg8 TIMSK4(0x072);
+sim_reg8 TIMSK5(0x073);
+sim_reg8 ADCL(0x078);
+sim_reg8 ADCH(0x079);
+sim_reg8 ADCSRA(0x07A);
+sim_reg8 ADCSRB(0x07B);
+sim_reg8 ADMUX(0x07C);
+sim_reg8 DIDR2(0x07D);
+sim_reg8 DIDR0(0x07E);
+sim_reg8 TCCR1A(0x080);
+sim_reg8 TCCR1B(0x081);
+sim_reg8 TCCR1C(0x082);
+sim_reg8 TCCR3A(0x090);
+sim_reg8 TCCR3B(0x091);
+sim_reg8 TCCR3C(0x092);
+sim_reg8 TCCR4A(0x0A0);
+sim_reg8 TCCR4B(0x0A1);
+sim_reg8 TCCR4C(0x0A2);
+sim_reg8 TCCR2A(0x0B0);
+sim_reg8 TCCR2B(0x0B1);
+sim_reg8 TCNT2(0x0B2);
+sim_reg8 OCR2A(0x0B3);
+sim_reg8 OCR2B(0x0B4);
+sim_reg8 ASSR(0x0B6);
+sim_reg8 TWBR(0x0B8);
+sim_reg8 TWSR(0x0B9);
+sim_reg8 TWAR(0x0BA);
+sim_reg8 TWDR(0x0BB);
+sim_reg8 TWCR(0x0BC);
+sim_reg8 TCCR5A(0x120);
+sim_reg8 TCCR5B(0x121);
+sim_reg8 TCCR5C(0x122);
+sim_reg8 OCR1AL(0x088);
+sim_reg8 OCR1BL(0x08A);
+sim_reg8 OCR1CL(0x08C);
+sim_reg8 OCR2AL(0x0B3);
+sim_reg8 OCR0AL(0x047);
+sim_reg8 OCR3AL(0x098);
+sim_reg8 OCR3BL(0x09A);
+sim_reg8 OCR3CL(0x09C);
+sim_reg8 OCR4AL(0x0A8);
+sim_reg8 OCR4BL(0x0AA);
+sim_reg8 OCR4CL(0x0AC);
+sim_reg8 OCR5AL(0x128);
+sim_reg8 OCR5BL(0x12A);
+sim_reg8 OCR5CL(0x12C);
+sim_reg8 UCSR0A(0x0C0);
+sim_reg8 UCSR0B(0x0C1);
+sim_reg8 UCSR0C(0x0C2);
+sim_reg8 UBRR0L(0x0C4);
+sim_reg8 UBRR0H(0x0C5);
+sim_reg8 UDR0(0x0C6);
+sim_reg8 UCSR1A(0x0C8);
+sim_reg8 UCSR1B(0x0C9);
+sim_reg8 UCSR1C(0x0CA);
+sim_reg8 UBRR1L(0x0CC);
+sim_reg8 UBRR1H(0x0CD);
+sim_reg8 UDR1(0x0CE);
+sim_reg8 UCSR2A(0x0D0);
+sim_reg8 UCSR2B(0x0D1);
+sim_reg8 UCSR2C(0x0D2);
+sim_reg8 UBRR2L(0x0D4);
+sim_reg8 UBRR2H(0x0D5);
+sim_reg8 UDR2(0x0D6);
+sim_reg8 UCSR3A(0x130);
+sim_reg8 UCSR3B(0x131);
+sim_reg8 UCSR3C(0x132);
+sim_reg8 UBRR3L(0x134);
+sim_reg8 UBRR3H(0x135);
+sim_reg8 UDR3(0x136);
+sim_reg16 TCNT1(0x084, sim_tcnt1);
+sim_reg16 ICR1(0x086);
+sim_reg16 OCR1A(0x088);
+sim_reg16 OCR1B(0x08A);
+sim_reg16 OCR1C(0x08C);
+sim_reg16 TCNT3(0x094);
+sim_reg16 ICR3(0x096);
+sim_reg16 OCR3A(0x098);
+sim_reg16 OCR3B(0x09A);
+sim_reg16 OCR3C(0x09C);
+sim_reg16 TCNT4(0x0A4);
+sim_reg16 ICR4(0x0A6);
+sim_reg16 OCR4A(0x0A8);
+sim_reg16 OCR4B(0x0AA);
+sim_reg16 OCR4C(0x0AC);
+sim_reg16 TCNT5(0x124);
+sim_reg16 ICR5(0x126);
+sim_reg16 OCR5A(0x128);
+sim_reg16 OCR5B(0x12A);
+sim_reg16 OCR5C(0x12C);
+sim_reg16 ADC(0x078);
+
+static sim_reg8 *const port_regs[] = {
+    std::addressof(PORTA), std::addressof(PORTB), std::addressof(PORTC), std::addressof(PORTD),
+    std::addressof(PORTE), std::addressof(PORTF), std::addressof(PORTG), std::addressof(PORTH),
+    std::addressof(PORTJ), std::addressof(PORTK), std::addressof(PORTL),
+};
+
+static sim_reg8 *port_by_addr(uint16_t addr)
+{
+    for (sim_reg8 *r : port_regs)
+        if (r->addr == addr)
+            return r;
+    return nullptr;
+}
+
+void sim_reg8::count_read() const
+{
+    if (addr < sim::IO_SPACE_END)
+        ++sim::io_stats.io_reads;
+    else
+        ++sim::io_stats.mem_reads;
+    if (addr == UCSR0A.addr || addr == UCSR1A.addr)
+        ++sim::io_stats.serial_polls;
+}
+
+void sim_reg8::store(uint8_t v)
+{
+    if (addr < sim::IO_SPACE_END)
+        ++sim::io_stats.io_writes;
+    else
+        ++sim::io_stats.mem_writes;
+    if ((addr == UDR0.addr || addr == UDR1.addr) && sim::serial_hook)
+        sim::serial_hook(v);
+    if (addr == SPDR.addr) {
+        value = sim::spi_hook ? sim::spi_hook(v) : 0xFF;
+        SPSR.value |= _BV(SPIF);
+        return;
+    }
+    if (toggle_addr) {
+        // Writing a one to PINxn toggles PORTxn.
+        sim_reg8 *port = port_by_addr(toggle_addr);
+        uint8_t old = port->value;
+        port->value ^= v;
+        if (sim::port_hook)
+            sim::port_hook(port->addr, old, port->value);
+        return;
+    }
+    uint8_t old = value;
+    value = v;
+    if (sim::port_hook && old != v && port_by_addr(addr) == this)
+        sim::port_hook(addr, old, v);
+}
+
+void sim_reg16::count(bool write) const
+{
+    // 16bit timer registers live above the I/O space, accessed by two lds/sts.
+    if (write)
+        sim::io_stats.mem_writes += 2;
+    else
+        sim::io_stats.mem_reads += 2;
+}
+
+void sim::reset_registers()
+{
+    for (sim_reg8 *r : port_regs)
+        r->poke(0);
+    TCNT1.poke(0);
+    OCR1A.poke(0);
+    TIMSK1.poke(0);
+    SREG.poke(0);
+    // The transmitter is always ready, writes to UDRn complete immediately.
+    UCSR0A.poke(_BV(UDRE0));
+    UCSR1A.poke(_BV(UDRE1));
+    memset(&io_stats, 0, sizeof(io_stats));
+}
+
+//
+// EEPROM
+//
+uint8_t eeprom_read_byte(const uint8_t *addr) { return sim::eeprom[uintptr_t(addr) % sizeof(sim::eeprom)]; }
+void eeprom_write_byte(uint8_t *addr, uint8_t value) { sim::eeprom[uintptr_t(addr) % sizeof(sim::eeprom)] = value; }
+
+void eeprom_read_block(void *dst, const void *src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        ((uint8_t *)dst)[i] = eeprom_read_byte((const uint8_t *)src + i);
+}
+
+void eeprom_write_block(const void *src, void *dst, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        eeprom_write_byte((uint8_t *)dst + i, ((const uint8_t *)src)[i]);
+}
+
+uint16_t eeprom_read_word(const uint16_t *addr) { uint16_t v; eeprom_read_block(&v, addr, sizeof(v)); return v; }
+uint32_t eeprom_read_dword(const uint32_t *addr) { uint32_t v; eeprom_read_block(&v, addr, sizeof(v)); return v; }
+float eeprom_read_float(const float *addr) { float v; eeprom_read_block(&v, addr, sizeof(v)); return v; }
+void eeprom_write_word(uint16_t *addr, uint16_t value) { eeprom_write_block(&value, addr, sizeof(value)); }
+void eeprom_write_dword(uint32_t *addr, uint32_t value) { eeprom_write_block(&value, addr, sizeof(value)); }
+void eeprom_write_float(float *addr, float value) { eeprom_write_block(&value, addr, sizeof(value)); }
+
+//
+// Arduino core
+//
+unsigned long millis() { return sim::now_us() / 1000; }
+unsigned long micros() { return sim::now_us(); }
+void delay(unsigned long) {}
+void delayMicroseconds(unsigned int) {}
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return 0; }
+int analogRead(uint8_t) { return 0; }
+void analogWrite(uint8_t, int) {}
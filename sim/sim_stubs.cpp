@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief Firmware symbols referenced by the motion core, but living outside of it.
+ *
+ * The simulator links planner.cpp, stepper.cpp, motion_control.cpp and the command queue with
+ * the SD card reader without Marlin_main.cpp, the temperature control, the LCD and the TMC2130
+ * drivers. Their state is provided here with the defaults of a homed printer at room temperature
+ * and no mesh bed leveling.
+ */
+
+#include <stdio.h>
+#include "Marlin.h"
+#include "temperature.h"
+#include "tmc2130.h"
+#include "lcd.h"
+#include "timer02.h"
+#include "fancheck.h"
+#include "mesh_bed_leveling.h"
+#include "mesh_bed_calibration.h"
+#include "cmdqueue.h"
+#include "cardreader.h"
+#include "power_panic.h"
+#include "Prusa_farm.h"
+#include "ultralcd.h"
+#include "menu.h"
+#include "motion_core.h"
+
+//
+// Marlin_main.cpp
+//
+float current_position[NUM_AXIS] = { 0.0, 0.0, 0.0, 0.0 };
+float destination[NUM_AXIS] = { 0.0, 0.0, 0.0, 0.0 };
+bool axis_known_position[3] = { true, true, true };
+float feedrate = 1500.0;
+uint8_t fanSpeed = 0;
+const char echomagic[] PROGMEM = "echo:";
+const char errormagic[] PROGMEM = "Error:";
+int8_t busy_state = NOT_BUSY;
+ShortTimer usb_timer;
+bool Stopped = false;
+bool saved_printing = false;
+uint8_t saved_printing_type = PowerPanic::PRINT_TYPE_NONE;
+CardReader card;
+
+void serialprintPGM(const char *str)
+{
+    while (uint8_t ch = pgm_read_byte(str)) {
+        MYSERIAL.write((char)ch);
+        ++str;
+    }
+}
+
+void serialprintlnPGM(const char *str)
+{
+    serialprintPGM(str);
+    MYSERIAL.println();
+}
+
+sim::process_commands_hook_t sim::process_commands_hook;
+
+void process_commands()
+{
+    if (sim::process_commands_hook)
+        sim::process_commands_hook();
+}
+
+void clamp_to_software_endstops(float[3]) {}
+void calculate_extruder_multipliers() {}
+void check_babystep() {}
+
+// The planner and st_synchronize() spin in these while waiting for the stepper interrupt.
+// Let the simulated time advance by executing the interrupt instead.
+void manage_inactivity(bool) {}
+void manage_heater() { sim::idle(); }
+void lcd_update(uint8_t) {}
+bool FarmOrUserECool() { return false; }
+
+unsigned long millis2() { return millis(); }
+
+bool printingIsPaused() { return false; }
+void finishAndDisableSteppers() {}
+void save_statistics() {}
+void kill(const char *) { abort(); }
+
+void FlushSerialRequestResend()
+{
+    // Through the serial port, printf() of the host does not reach it.
+    MYSERIAL.flush();
+    SERIAL_PROTOCOLPGM("Resend: ");
+    SERIAL_PROTOCOLLN(gcode_LastN + 1);
+    SERIAL_PROTOCOLLNPGM("ok");
+}
+
+void ClearToSend()
+{
+    if (buflen && ((CMDBUFFER_CURRENT_TYPE == CMDBUFFER_CURRENT_TYPE_USB) || (CMDBUFFER_CURRENT_TYPE == CMDBUFFER_CURRENT_TYPE_USB_WITH_LINENR)))
+        SERIAL_PROTOCOLLNPGM("ok");
+}
+
+//
+// Prusa_farm.cpp
+//
+uint8_t farm_mode = 0;
+void prusa_statistics(uint8_t) {}
+
+//
+// strtod.c is built from avr-libc's internals
+//
+extern "C" double __floatunsisf(unsigned long x) { return x; }
+
+//
+// ultralcd.cpp
+//
+bool stepper_timer_overflow_state;
+uint16_t stepper_timer_overflow_last;
+uint8_t scrollstuff = 0;
+
+void lcd_setstatus(const char *) {}
+void lcd_setstatuspgm(const char *) {}
+void lcd_show_fullscreen_message_and_wait_P(const char *) {}
+void menu_progressbar_init(uint16_t, const char *) {}
+void menu_progressbar_update(uint16_t) {}
+void menu_progressbar_finish() {}
+
+//
+// temperature.cpp
+//
+float current_temperature[EXTRUDERS] = { 215 };
+unsigned char fanSpeedSoftPwm;
+uint8_t fanSpeedBckp = 255;
+bool fan_measuring;
+
+void updatePID() {}
+float unscalePID_i(float i) { return i; }
+float unscalePID_d(float d) { return d; }
+#ifdef THERMAL_MODEL
+void thermal_model_report_settings() {}
+void thermal_model_reset_settings() {}
+void thermal_model_load_settings() {}
+void thermal_model_save_settings() {}
+#endif //THERMAL_MODEL
+
+//
+// tmc2130.cpp
+//
+uint8_t tmc2130_mode = TMC2130_MODE_NORMAL;
+uint8_t tmc2130_sg_homing_axes_mask;
+
+void tmc2130_init(TMCInitParams) {}
+void tmc2130_st_isr() {}
+bool tmc2130_update_sg() { return false; }
+void tmc2130_set_res(uint8_t, uint16_t) {}
+
+//
+// mesh_bed_calibration.cpp, mesh_bed_leveling.cpp
+//
+uint8_t world2machine_correction_mode = WORLD2MACHINE_CORRECTION_NONE;
+float world2machine_rotation_and_skew[2][2] = { { 1, 0 }, { 0, 1 } };
+float world2machine_rotation_and_skew_inv[2][2] = { { 1, 0 }, { 0, 1 } };
+float world2machine_shift[2];
+
+mesh_bed_leveling mbl;
+
+void mesh_bed_leveling::reset()
+{
+    active = 0;
+    memset(z_values, 0, sizeof(z_values));
+}
+
+float mesh_bed_leveling::get_z(float, float) { return 0; }
@@ -0,0 +1,189 @@
+/**
+ * @file
+ * @brief G2/G3 arc interpolation against the exact arcs
+ */
+
+#include <math.h>
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "motion_control.h"
+#include "ConfigurationStore.h"
+#include "motion_core.h"
+
+// Steps per mm of X and Y in the tests, fine enough to resolve the chord deviation.
+static const float arc_steps_per_mm = 1000;
+
+struct ArcTrace
+{
+    double center[2];
+    double radius;
+    double max_deviation;               // farthest step position from the arc
+    std::vector<double> ends[2];        // end positions of the planned segments (mm)
+    int32_t end_steps[2];
+    int32_t step_base[2];               // planner position minus the step position of the simulator
+    const block_t *block;
+};
+
+static ArcTrace trace;
+
+static void trace_block(const sim::isr_events_t &, uint32_t, uint16_t)
+{
+    if (!current_block || current_block == trace.block)
+        return;
+    trace.block = current_block;
+    for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis) {
+        const int32_t steps = current_block->steps[axis].wide;
+        trace.end_steps[axis] += (current_block->direction_bits & _BV(axis)) ? -steps : steps;
+        trace.ends[axis].push_back(trace.end_steps[axis] / double(arc_steps_per_mm));
+    }
+}
+
+static void trace_step(uint8_t axis, int32_t)
+{
+    if (axis > Y_AXIS)
+        return;
+    const double dx = (sim::step_position(X_AXIS) + trace.step_base[0]) / double(arc_steps_per_mm) - trace.center[0];
+    const double dy = (sim::step_position(Y_AXIS) + trace.step_base[1]) / double(arc_steps_per_mm) - trace.center[1];
+    const double deviation = fabs(hypot(dx, dy) - trace.radius);
+    if (deviation > trace.max_deviation)
+        trace.max_deviation = deviation;
+}
+
+// The default settings with the finer X and Y steps.
+static void arc_init()
+{
+    sim::motion_init();
+    cs.axis_steps_per_mm[X_AXIS] = cs.axis_steps_per_mm[Y_AXIS] = arc_steps_per_mm;
+    reset_acceleration_rates();
+}
+
+// Plans the arc from the start around the center by the angle (CCW positive) and executes it.
+// Returns the number of the segments.
+static size_t run_arc(const float start[2], const float center[2], double angle)
+{
+    plan_set_position(start[X_AXIS], start[Y_AXIS], 0, 0);
+
+    trace = ArcTrace();
+    trace.center[0] = center[X_AXIS];
+    trace.center[1] = center[Y_AXIS];
+    trace.radius = hypot(start[X_AXIS] - center[X_AXIS], start[Y_AXIS] - center[Y_AXIS]);
+    const double start_angle = atan2(start[Y_AXIS] - center[Y_AXIS], start[X_AXIS] - center[X_AXIS]);
+    for (uint8_t axis = X_AXIS; axis <= Y_AXIS; ++axis) {
+        trace.end_steps[axis] = lround(start[axis] * arc_steps_per_mm);
+        trace.step_base[axis] = trace.end_steps[axis] - sim::step_position(axis);
+    }
+    sim::set_isr_trace(trace_block);
+    sim::set_step_trace(trace_step);
+
+    float position[NUM_AXIS] = { start[X_AXIS], start[Y_AXIS], 0, 0 };
+    float target[NUM_AXIS] = {
+        float(center[X_AXIS] + trace.radius * cos(start_angle + angle)),
+        float(center[Y_AXIS] + trace.radius * sin(start_angle + angle)),
+        0, float(fabs(angle) * trace.radius * 0.05) };
+    // A full circle ends exactly at the start, like in the G-code.
+    if (fabs(angle) == 2 * M_PI) {
+        target[X_AXIS] = start[X_AXIS];
+        target[Y_AXIS] = start[Y_AXIS];
+    }
+    const float offset[2] = { center[X_AXIS] - start[X_AXIS], center[Y_AXIS] - start[Y_AXIS] };
+    mc_arc(position, target, offset, 40, float(trace.radius), angle < 0, 1);
+    sim::run_until_idle();
+
+    sim::set_isr_trace(NULL);
+    sim::set_step_trace(NULL);
+    return trace.ends[0].size();
+}
+
+// Largest distance of the segment ends from the points of the exact arc, spread evenly by angle.
+static double max_end_error(const float start[2], const float center[2], double angle)
+{
+    const double start_angle = atan2(start[Y_AXIS] - center[Y_AXIS], start[X_AXIS] - center[X_AXIS]);
+    const size_t segments = trace.ends[0].size();
+    double error = 0;
+    for (size_t i = 0; i < segments; ++i) {
+        const double a = start_angle + angle * (i + 1) / segments;
+        const double e = hypot(trace.ends[0][i] - (center[X_AXIS] + trace.radius * cos(a)),
+            trace.ends[1][i] - (center[Y_AXIS] + trace.radius * sin(a)));
+        if (e > error)
+            error = e;
+    }
+    return error;
+}
+
+// Rounding to the planner steps by up to half a step in X and Y, some float rounding of the positions
+// around 100 mm.
+static const double end_resolution = M_SQRT1_2 / arc_steps_per_mm + 1e-4;
+static const double step_resolution = 2 / arc_steps_per_mm;
+
+TEST_CASE("Arc segments within the chord tolerance", "[arc]")
+{
+    const float start[2] = { 120, 5 };
+    for (const float tolerance : { 0.002f, 0.01f, 0.05f }) {
+        for (const float radius : { 1.f, 5.f, 20.f, 100.f }) {
+            for (const double angle : { 0.3, -2.0, 2 * M_PI, -2 * M_PI }) {
+                INFO("tolerance " << tolerance << " radius " << radius << " angle " << angle);
+                const float center[2] = { start[X_AXIS], start[Y_AXIS] + radius };
+                arc_init();
+                cs.arc_tolerance = tolerance;
+                cs.min_mm_per_arc_segment = 0;
+                cs.arc_segments_per_sec = 0;
+                const size_t segments = run_arc(start, center, angle);
+
+                // The chords stay within the tolerance, apart of the step resolution: the Bresenham
+                // lines trail by up to a step, their ends are rounded to the steps.
+                CHECK(trace.max_deviation <= tolerance + step_resolution);
+                CHECK(max_end_error(start, center, angle) <= end_resolution);
+
+                // As long as the tolerance allows: rounding up the number of the segments at most
+                // halves their angle. Unless the angle limit of the segments applies.
+                const double theta = fabs(angle) / segments;
+                const double sagitta = radius * (1 - cos(theta / 2));
+                if (segments > 1 && theta < 0.25)
+                    CHECK(sagitta >= tolerance * 0.25);
+                CHECK(sagitta <= tolerance * 1.001);
+            }
+        }
+    }
+}
+
+TEST_CASE("Arc segments of the fixed length", "[arc]")
+{
+    // The chord tolerance off: the segments follow the length limits as before.
+    const float start[2] = { 120, 5 };
+    const float center[2] = { 120, 55 };
+    arc_init();
+    cs.arc_tolerance = 0;
+    CHECK(run_arc(start, center, 2 * M_PI) == size_t(ceil(2 * M_PI * 50 / cs.mm_per_arc_segment)));
+    CHECK(max_end_error(start, center, 2 * M_PI) <= end_resolution);
+
+    // The small circles keep the segments of the minimum length, longer than the angle limit of the
+    // chord tolerance mode.
+    const float small_center[2] = { 120, 5.5f };
+    CHECK(run_arc(start, small_center, 2 * M_PI) == size_t(ceil(2 * M_PI * 0.5 / cs.min_mm_per_arc_segment)));
+
+    // The tolerance of 0.01 mm needs fewer segments of the radius of 50 mm.
+    cs.arc_tolerance = 0.01f;
+    const size_t segments = run_arc(start, center, 2 * M_PI);
+    CHECK(segments <= size_t(ceil(2 * M_PI * 50 / cs.mm_per_arc_segment)) / 2 + 1);
+    CHECK(trace.max_deviation <= 0.01 + step_resolution);
+}
+
+TEST_CASE("Arc rotation without corrections", "[arc]")
+{
+    // Up to 255 rotations between the exact positions: the rounding does not accumulate.
+    const float start[2] = { 130, 5 };
+    for (const float radius : { 0.5f, 10.f, 100.f }) {
+        INFO("radius " << radius);
+        const float center[2] = { start[X_AXIS], start[Y_AXIS] + radius };
+        arc_init();
+        cs.n_arc_correction = 255;
+        cs.arc_tolerance = radius * 1e-4f;
+        cs.min_mm_per_arc_segment = 0;
+        const size_t segments = run_arc(start, center, 2 * M_PI);
+        CHECK(segments >= 200);
+        CHECK(max_end_error(start, center, 2 * M_PI) <= end_resolution);
+    }
+}
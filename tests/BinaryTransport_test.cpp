@@ -0,0 +1,315 @@
+/**
+ * @file
+ * @brief Binary G-code transport: host encoder, frame parser and the loopback through get_command()
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "cmdqueue.h"
+#include "binary_transport.h"
+#include "binary_transport_encoder.h"
+#include "sim_avr.h"
+
+#ifdef ENABLE_BINARY_TRANSPORT
+
+extern "C" void USART0_RX_vect(void);
+
+static void receive(const std::string &s)
+{
+    for (char c : s) {
+        UDR0.poke(c);
+        USART0_RX_vect();
+    }
+}
+
+static std::string serial_out;
+
+static void record_serial(uint8_t c)
+{
+    serial_out += char(c);
+}
+
+// Moves and other commands as a slicer writes them.
+static std::vector<std::string> print_lines(int count)
+{
+    std::vector<std::string> lines;
+    for (int n = 0; n < count; ++n) {
+        char line[64];
+        switch (n % 10) {
+        case 3: snprintf(line, sizeof(line), "G1 E-.8 F2100"); break;
+        case 6: snprintf(line, sizeof(line), "M204 P800"); break;
+        case 8: snprintf(line, sizeof(line), "G1 Z%d.2 F720", n % 5); break;
+        case 9: snprintf(line, sizeof(line), "G0 X%d Y-%d.5", 10 + n % 90, n % 3); break;
+        default:
+            snprintf(line, sizeof(line), "G1 X%d.%03d Y%d.%03d E.%05d", 100 + n % 50, n * 37 % 1000, 80 + n % 30,
+                n * 91 % 1000, 1000 + n * 13 % 9000);
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// The words of the move as parsed from its text by code_move_words().
+static uint8_t text_move_words(const std::string &line, float values[NUM_AXIS + 1])
+{
+    enquecommand(line.c_str());
+    const uint8_t seen = code_move_words(values);
+    cmdqueue_pop_front();
+    return seen;
+}
+
+TEST_CASE("Binary frames", "[binary]")
+{
+    std::vector<uint8_t> frame;
+    CHECK(sim::bt_encode_line("G1 X134.748 Y114.182 E.00781\n", 0x1234, frame));
+    REQUIRE(frame.size() == BT_FRAME_OVERHEAD + 1 + 3 * 4);
+    CHECK(frame[0] == BT_SYNC);
+    CHECK(frame[1] == BT_FRAME_MOVE);
+    CHECK(frame[2] == 1 + 3 * 4);
+    CHECK(frame[3] == 0x34);
+    CHECK(frame[4] == 0x12);
+    CHECK(frame[5] == (_BV(X_AXIS) | _BV(Y_AXIS) | _BV(E_AXIS)));
+    // X 13474800 in 10^-5 mm units
+    CHECK(frame[6] == 0xf0);
+    CHECK(frame[7] == 0x9b);
+    CHECK(frame[8] == 0xcd);
+    CHECK(frame[9] == 0x00);
+    const uint16_t crc = sim::bt_crc16(frame.data() + 1, frame.size() - 3);
+    CHECK(frame[frame.size() - 2] == uint8_t(crc));
+    CHECK(frame[frame.size() - 1] == uint8_t(crc >> 8));
+
+    // CRC-16/CCITT-FALSE check value
+    CHECK(sim::bt_crc16((const uint8_t *)"123456789", 9) == 0x29b1);
+    uint16_t fw_crc = 0xffff;
+    for (const char *p = "123456789"; *p; ++p)
+        fw_crc = bt_crc16_update(fw_crc, *p);
+    CHECK(fw_crc == 0x29b1);
+
+    // Commands other than plain moves are sent as text.
+    for (const char *line : { "G28 W", "G1 X1 A2", "G1 X1 X2", "G1 X1E5", "G1 X", "G1 X3000000", "G10", "G1X1Y2", "M117 G1 X1" }) {
+        INFO(line);
+        frame.clear();
+        CHECK_FALSE(sim::bt_encode_line(line, 1, frame));
+        REQUIRE(frame.size() == BT_FRAME_OVERHEAD + strlen(line));
+        CHECK(frame[1] == BT_FRAME_GCODE);
+        CHECK(std::string(frame.begin() + 5, frame.end() - 2) == line);
+    }
+    for (const char *line : { "G1", "G0 F7200", "G1 X-0.000004 E+1.000005 F1234.5675" }) {
+        INFO(line);
+        frame.clear();
+        CHECK(sim::bt_encode_line(line, 1, frame));
+    }
+}
+
+TEST_CASE("Binary frame parser", "[binary]")
+{
+    std::vector<uint8_t> stream;
+    sim::bt_encode_line("G1 X-1.5 Y.00001 Z20 E-.8 F2100.5", 7, stream);
+    const size_t move_size = stream.size();
+    sim::bt_encode_line("M117 Binary", 8, stream);
+
+    bt_enable(true);
+    for (uint16_t in_size : { 1, 2, 5, 1000 }) {
+        INFO("in " << in_size);
+        std::vector<std::string> lines;
+        std::vector<uint16_t> numbers;
+        char line[MAX_CMD_SIZE];
+        int line_len = 0;
+        size_t pos = 0;
+        while (pos < stream.size()) {
+            const uint16_t n = uint16_t(std::min<size_t>(in_size, stream.size() - pos));
+            uint16_t consumed;
+            const uint8_t status = bt_receive(stream.data() + pos, n, consumed, line, line_len);
+            REQUIRE(status != BT_RX_ERROR);
+            REQUIRE(consumed <= n);
+            pos += consumed;
+            if (status == BT_RX_FRAME) {
+                lines.push_back(std::string(line, line_len));
+                numbers.push_back(bt_frame_n());
+            } else
+                REQUIRE(consumed == n);
+        }
+        REQUIRE(lines.size() == 2);
+        CHECK(numbers == std::vector<uint16_t>{ 7, 8 });
+        CHECK(lines[1] == "M117 Binary");
+        // The move record is NUL free and decodes to the values of the text.
+        REQUIRE(lines[0][0] == MOVE_RECORD_MARKER);
+        CHECK(lines[0].find('\0') == std::string::npos);
+        float values[NUM_AXIS + 1];
+        CHECK(move_record_words(lines[0].c_str(), values) == 0x1f);
+        CHECK(values[X_AXIS] == -1.5f);
+        CHECK(values[Y_AXIS] == 1e-5f);
+        CHECK(values[Z_AXIS] == 20.f);
+        CHECK(values[E_AXIS] == -.8f);
+        CHECK(values[MOVE_WORD_F] == 2100.5f);
+    }
+
+    // A corrupted frame is reported once, the bytes up to the next valid frame are dropped silently.
+    for (size_t corrupt = 1; corrupt < move_size; ++corrupt) {
+        INFO("corrupted byte " << corrupt);
+        std::vector<uint8_t> bad(stream.begin(), stream.begin() + move_size);
+        bad[corrupt] ^= 0x10;
+        bad.insert(bad.end(), { BT_SYNC, 0x77, 0x00, 0x12 });
+        bad.insert(bad.end(), stream.begin() + move_size, stream.end());
+        bt_enable(true);
+        char line[MAX_CMD_SIZE];
+        int line_len = 0;
+        int errors = 0, frames = 0;
+        size_t pos = 0;
+        while (pos < bad.size()) {
+            uint16_t consumed;
+            const uint8_t status = bt_receive(bad.data() + pos, uint16_t(bad.size() - pos), consumed, line, line_len);
+            pos += consumed;
+            errors += (status == BT_RX_ERROR);
+            if (status == BT_RX_FRAME) {
+                ++frames;
+                CHECK(std::string(line, line_len) == "M117 Binary");
+            }
+        }
+        CHECK(errors == 1);
+        CHECK(frames == 1);
+    }
+    bt_enable(false);
+}
+
+TEST_CASE("Binary transport loopback", "[binary]")
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    MSerial.overflowed();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+    gcode_LastN = 0;
+    bt_enable(false);
+    serial_out.clear();
+    sim::serial_hook = record_serial;
+
+    // Switched on by a text line, the frames follow its "ok".
+    receive("M930 S1\n");
+    get_command();
+    REQUIRE(buflen == 1);
+    CHECK(strcmp(CMDBUFFER_CURRENT_STRING, "M930 S1") == 0);
+    CHECK(bt_enabled);
+    cmdqueue_pop_front();
+
+    const std::vector<std::string> lines = print_lines(300);
+    std::vector<std::vector<uint8_t>> frames;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        frames.emplace_back();
+        sim::bt_encode_line(lines[i], uint16_t(i + 1), frames.back());
+    }
+
+    // The host keeps the receive ring full, one frame is corrupted once. The frames are resent
+    // from the one requested.
+    const size_t corrupted = 123;
+    bool corrupt = true;
+    std::vector<std::string> received;
+    std::vector<uint8_t> types;
+    size_t next = 0;
+    for (int i = 0; i < 100000 && (next < frames.size() || buflen || MSerial.available()); ++i) {
+        while (next < frames.size() && MSerial.available() + frames[next].size() <= RX_BUFFER_SIZE - 1) {
+            std::vector<uint8_t> frame = frames[next++];
+            if (next - 1 == corrupted && corrupt) {
+                frame[8] ^= 0x04;
+                corrupt = false;
+            }
+            receive(std::string(frame.begin(), frame.end()));
+        }
+        serial_out.clear();
+        get_command();
+        const size_t resend = serial_out.find("Resend: ");
+        if (resend != std::string::npos) {
+            next = size_t(atol(serial_out.c_str() + resend + 8)) - 1;
+            CHECK(next == corrupted);
+        }
+        if (buflen) {
+            float values[NUM_AXIS + 1];
+            const uint8_t seen = code_move_words(values);
+            std::string words;
+            // Compared as the words of the text, the ASCII G0/G1 also end up in code_move_words().
+            if (CMDBUFFER_CURRENT_STRING[0] == MOVE_RECORD_MARKER) {
+                for (uint8_t w = 0; w <= MOVE_WORD_F; ++w) {
+                    char value[32];
+                    snprintf(value, sizeof(value), (seen & _BV(w)) ? " %a" : " -", double(values[w]));
+                    words += value;
+                }
+            } else
+                words = CMDBUFFER_CURRENT_STRING;
+            received.push_back(words);
+            types.push_back(CMDBUFFER_CURRENT_TYPE);
+            cmdqueue_pop_front();
+        }
+    }
+    CHECK_FALSE(corrupt);
+    CHECK(gcode_LastN == long(lines.size()));
+    REQUIRE(received.size() == lines.size());
+    for (size_t i = 0; i < lines.size(); ++i) {
+        INFO(lines[i]);
+        CHECK(types[i] == CMDBUFFER_CURRENT_TYPE_USB_WITH_LINENR);
+        float values[NUM_AXIS + 1];
+        const uint8_t seen = text_move_words(lines[i], values);
+        std::string words;
+        if (seen != MOVE_WORDS_INVALID) {
+            for (uint8_t w = 0; w <= MOVE_WORD_F; ++w) {
+                char value[32];
+                snprintf(value, sizeof(value), (seen & _BV(w)) ? " %a" : " -", double(values[w]));
+                words += value;
+            }
+        } else
+            words = lines[i];
+        CHECK(received[i] == words);
+    }
+
+    // Switched off by a frame, the text lines follow.
+    std::vector<uint8_t> off;
+    sim::bt_encode_line("M930 S0", uint16_t(lines.size() + 1), off);
+    receive(std::string(off.begin(), off.end()) + "G1 X5\n");
+    get_command();
+    REQUIRE(buflen == 2);
+    CHECK(strcmp(CMDBUFFER_CURRENT_STRING, "M930 S0") == 0);
+    cmdqueue_pop_front();
+    CHECK(strcmp(CMDBUFFER_CURRENT_STRING, "G1 X5") == 0);
+    CHECK(CMDBUFFER_CURRENT_TYPE == CMDBUFFER_CURRENT_TYPE_USB);
+    CHECK_FALSE(bt_enabled);
+
+    sim::serial_hook = NULL;
+    cmdqueue_reset();
+}
+
+TEST_CASE("Binary transport bandwidth", "[binary]")
+{
+    // Extrusion moves as PrusaSlicer writes them: the frames, with their line numbers and CRC, carry
+    // more than 1.35 times the G-code of the plain text, more than 1.85 times the one of the text with
+    // the line numbers and checksums the hosts send.
+    std::string plain, numbered;
+    std::vector<uint8_t> stream;
+    for (int n = 1000; n < 1500; ++n) {
+        char line[64];
+        snprintf(line, sizeof(line), "G1 X%d.%03d Y%d.%03d E.%05d", 100 + n % 50, n * 37 % 1000, 80 + n % 30,
+            n * 91 % 1000, 1000 + n * 13 % 9000);
+        plain += line;
+        plain += '\n';
+        char numbered_line[80];
+        snprintf(numbered_line, sizeof(numbered_line), "N%d %s", n, line);
+        uint8_t checksum = 0;
+        for (const char *p = numbered_line; *p; ++p)
+            checksum ^= *p;
+        numbered += numbered_line;
+        numbered += '*' + std::to_string(checksum) + '\n';
+        REQUIRE(sim::bt_encode_line(line, uint16_t(n), stream));
+    }
+    const double gain = double(plain.size()) / stream.size();
+    const double gain_numbered = double(numbered.size()) / stream.size();
+    INFO("gain " << gain << " numbered " << gain_numbered);
+    CHECK(gain > 1.35);
+    CHECK(gain_numbered > 1.85);
+}
+
+#endif // ENABLE_BINARY_TRANSPORT
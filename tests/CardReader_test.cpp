@@ -0,0 +1,339 @@
+/**
+ * @file
+ * @brief SdVolume, SdFile and CardReader on the FAT images of the emulated SD card
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "fat_image.h"
+#include "sd_card.h"
+#include "Marlin.h"
+#include "cardreader.h"
+#include "spi.h"
+#include "eeprom.h"
+#include "sim_avr.h"
+
+static const sim::fat_volume_t fat16 = { 16, 2048 + 262144, 8 };       // 128 MiB, 4 KiB clusters
+static const sim::fat_volume_t fat32 = { 32, 16u * 1024 * 1024, 64 };  // 8 GiB, 32 KiB clusters
+
+// Moves with a comment line from time to time, numbered from first.
+static std::string gcode(uint32_t first, uint32_t lines)
+{
+    std::string text;
+    char line[64];
+    for (uint32_t i = first; i < first + lines; ++i) {
+        if (i % 50 == 0)
+            text += "; layer change\n";
+        snprintf(line, sizeof(line), "G1 X%u.%03u Y%u E0.0%u\n", i % 250, i % 1000, (i * 7) % 210, i % 10);
+        text += line;
+    }
+    return text;
+}
+
+// The G-code as readFilteredGcode() returns it: a run of comment lines leaves its line end,
+// the last line end of the file is not returned.
+static std::string filtered(const std::string &text)
+{
+    std::string out;
+    bool comment = false;
+    for (size_t start = 0; start < text.size();) {
+        const size_t end = text.find('\n', start);
+        const std::string line = text.substr(start, end + 1 - start);
+        if (line[0] == ';') {
+            comment = true;
+        } else {
+            if (comment)
+                out += '\n';
+            comment = false;
+            out += line;
+        }
+        start = end + 1;
+    }
+    out.pop_back();
+    return out;
+}
+
+// Level of the output pin, READ() samples the input register.
+#define PIN_HIGH_(IO) (DIO##IO##_WPORT.peek() & _BV(DIO##IO##_PIN))
+#define PIN_HIGH(IO) PIN_HIGH_(IO)
+
+static void insert(const sim::fat_volume_t &volume, const std::vector<sim::fat_file_t> &files)
+{
+    sim::reset_registers();
+    sim::sd_card_insert(sim::fat_image(volume, files), volume.blocks);
+    card.mount(false);
+    REQUIRE(card.mounted);
+    sim::sd_card_stats = sim::sd_card_stats_t();
+}
+
+static std::string print_file(const char *name)
+{
+    card.openFileReadFilteredGcode(name);
+    REQUIRE(card.isFileOpen());
+    std::string text;
+    for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0;)
+        text += char(c);
+    card.closefile();
+    return text;
+}
+
+TEST_CASE("SD card volumes", "[sdcard]")
+{
+    const std::string content = gcode(0, 30000);
+    for (const sim::fat_volume_t &volume : { fat16, fat32 }) {
+        INFO("FAT" << int(volume.fat_type));
+        insert(volume, { { "PRINT.GCO", content, 0 } });
+        card.openFileReadFilteredGcode("PRINT.GCO");
+        CHECK(card.getFileSize() == content.size());
+        card.closefile();
+
+        // The FAT of the contiguous file is read at the open, then every data block once,
+        // streamed by a single multiple block read.
+        card.openFileReadFilteredGcode("PRINT.GCO");
+        sim::sd_card_stats = sim::sd_card_stats_t();
+        std::string text;
+        for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0;)
+            text += char(c);
+        card.closefile();
+        CHECK(text == filtered(content));
+        CHECK(sim::sd_card_stats.blocks_read == (content.size() + 511) / 512);
+        CHECK(sim::sd_card_stats.multiple_reads == 1);
+        CHECK(sim::sd_card_stats.single_reads == 0);
+        CHECK(sim::sd_card_stats.errors == 0);
+
+        // The resume of a power panic reads just the data block.
+        card.openFileReadFilteredGcode("PRINT.GCO");
+        sim::sd_card_stats = sim::sd_card_stats_t();
+        const uint32_t pos = content.find("\nG1", content.size() / 10 * 9) + 1;
+        card.setIndex(pos);
+        CHECK(card.getFilteredGcodeChar() == content[pos]);
+        CHECK(sim::sd_card_stats.blocks_read == 1);
+        card.closefile();
+    }
+}
+
+TEST_CASE("SD card multiple block read ends when the SPI bus is shared", "[sdcard]")
+{
+    const std::string content = gcode(0, 30000);
+    insert(fat16, { { "PRINT.GCO", content, 0 } });
+    card.openFileReadFilteredGcode("PRINT.GCO");
+    sim::sd_card_stats = sim::sd_card_stats_t();
+    std::string text;
+    for (int16_t c; text.size() < content.size() / 2 && (c = card.getFilteredGcodeChar()) >= 0;)
+        text += char(c);
+    REQUIRE(sim::sd_card_stats.multiple_reads == 1);
+    CHECK(sim::sd_card_stats.stops == 0);
+
+    // The TMC2130 drivers take the bus, then the card continues from the next block.
+    spi_setup(SPI_SPCR(0, 1, 1, 1, 0), SPI_SPSR(0));
+    CHECK(sim::sd_card_stats.stops == 1);
+    spi_setup(SPI_SPCR(0, 1, 1, 1, 0), SPI_SPSR(0));
+    CHECK(sim::sd_card_stats.stops == 1);
+    for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0;)
+        text += char(c);
+    card.closefile();
+    CHECK(text == filtered(content));
+    CHECK(sim::sd_card_stats.blocks_read == (content.size() + 511) / 512);
+    CHECK(sim::sd_card_stats.multiple_reads == 2);
+    CHECK(sim::sd_card_stats.errors == 0);
+}
+
+TEST_CASE("SD card multiple block read abandoned by the power panic", "[sdcard]")
+{
+    const std::string content = gcode(0, 30000);
+    insert(fat16, { { "PRINT.GCO", content, 0 } });
+    card.openFileReadFilteredGcode("PRINT.GCO");
+    for (size_t n = 0; n < content.size() / 2 && card.getFilteredGcodeChar() >= 0; ++n)
+        ;
+    REQUIRE(sim::sd_card_stats.multiple_reads == 1);
+
+    // The TMC2130 drivers take the bus without a CMD12 to the card.
+    card.readStreamAbandon();
+    CHECK(PIN_HIGH(SDSS));
+    spi_setup(SPI_SPCR(0, 1, 1, 1, 0), SPI_SPSR(0));
+    CHECK(sim::sd_card_stats.stops == 0);
+    CHECK(sim::sd_card_stats.errors == 0);
+    card.closefile();
+}
+
+TEST_CASE("SD card fragmented file", "[sdcard]")
+{
+    const std::string content = gcode(1000, 20000);
+    insert(fat16, { { "FIRST.GCO", gcode(0, 100), 0 }, { "FRAG.GCO", content, 3 }, { "LAST.GCO", gcode(0, 200), 0 } });
+    CHECK(print_file("FRAG.GCO") == filtered(content));
+#if !SD_FAT_CACHE
+    // The next cluster is looked up in the FAT at every cluster boundary, the FAT block evicts
+    // the data block.
+    const uint32_t blocks = (content.size() + 511) / 512;
+    const uint32_t clusters = (content.size() + 4095) / 4096;
+    CHECK(sim::sd_card_stats.blocks_read > blocks + clusters / 3);
+#endif
+    CHECK(print_file("LAST.GCO") == filtered(gcode(0, 200)));
+
+    // The position of a power panic, in the middle of a run of clusters, at its start and past
+    // the runs the seeks remember.
+    for (const uint32_t pos : { 100000u, 3u * 4096 * 5, uint32_t(content.size() - 5000) }) {
+        card.openFileReadFilteredGcode("FRAG.GCO");
+        card.setIndex(pos);
+        std::string text;
+        for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0 && text.size() < 40;)
+            text += char(c);
+        CHECK(text == content.substr(pos, 40));
+        card.closefile();
+    }
+
+    // More runs than the seeks remember, after the whole file was read.
+    card.openFileReadFilteredGcode("FRAG.GCO");
+    while (card.getFilteredGcodeChar() >= 0) {}
+    for (uint32_t pos = content.size() - 1000; pos > 40000; pos -= 4999) {
+        card.setIndex(pos);
+        std::string text;
+        for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0 && text.size() < 40;)
+            text += char(c);
+        const size_t end = content.find('\n', pos + 100) + 1;
+        CHECK(text == filtered(content.substr(pos, end - pos)).substr(0, 40));
+    }
+    card.closefile();
+    CHECK(sim::sd_card_stats.errors == 0);
+}
+
+TEST_CASE("SD card seeks in a fragmented file", "[sdcard]")
+{
+    // 44 clusters in runs of 4.
+    const std::string content = gcode(0, 8000);
+    REQUIRE(content.size() / 4096 == 43);
+    insert(fat16, { { "FRAG.GCO", content, 4 } });
+    const auto read_at = [&](uint32_t pos) {
+        pos = content.find("\nG1", pos) + 1;
+        sim::sd_card_stats = sim::sd_card_stats_t();
+        card.setIndex(pos);
+        const uint32_t seek_blocks = sim::sd_card_stats.blocks_read;
+        std::string text;
+        for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0 && text.size() < 20;)
+            text += char(c);
+        CHECK(text == content.substr(pos, 20));
+        return seek_blocks;
+    };
+
+    // The resume of a power panic follows the FAT once, the runs found serve the next seeks.
+    card.openFileReadFilteredGcode("FRAG.GCO");
+#if SD_FAT_CACHE
+    // The FAT block may be cached already.
+    CHECK(read_at(150000) <= 1);
+#else
+    CHECK(read_at(150000) == 1);
+#endif
+    for (const uint32_t pos : { 1000u, 70000u, 149000u, 120000u })
+        CHECK(read_at(pos) == 0);
+
+    // The runs read are known as well.
+    card.openFileReadFilteredGcode("FRAG.GCO");
+    while (card.getFilteredGcodeChar() >= 0) {}
+    for (const uint32_t pos : { 170000u, 17000u, 4096u * 8 })
+        CHECK(read_at(pos) == 0);
+    card.closefile();
+    CHECK(sim::sd_card_stats.errors == 0);
+}
+
+#if SD_FAT_CACHE
+TEST_CASE("SD card FAT cache", "[sdcard]")
+{
+    // Every data block once and the FAT blocks, the lookups at the cluster boundaries of the
+    // fragmented file don't evict the data block.
+    const std::string content = gcode(0, 20000);
+    insert(fat16, { { "FRAG.GCO", content, 2 } });
+    card.openFileReadFilteredGcode("FRAG.GCO");
+    sim::sd_card_stats = sim::sd_card_stats_t();
+    const uint32_t hits = SdVolume::fatCacheHits();
+    const uint32_t misses = SdVolume::fatCacheMisses();
+    std::string text;
+    for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0;)
+        text += char(c);
+    card.closefile();
+    CHECK(text == filtered(content));
+    CHECK(SdVolume::fatCacheHits() - hits >= content.size() / 4096 - 1);
+    CHECK(sim::sd_card_stats.blocks_read == (content.size() + 511) / 512 + SdVolume::fatCacheMisses() - misses);
+
+    // The clusters allocated by a write are read back without a new mount.
+    card.openFileWrite("LOG.GCO");
+    REQUIRE(card.saving);
+    std::string expected;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        char line[32];
+        snprintf(line, sizeof(line), "G1 X%u", i);
+        card.write_command(line);
+        expected += std::string(line) + "\r\n";
+    }
+    card.closefile();
+    expected.pop_back();
+    CHECK(print_file("LOG.GCO") == expected);
+    CHECK(print_file("FRAG.GCO") == filtered(content));
+    CHECK(sim::sd_card_stats.errors == 0);
+}
+#endif
+
+TEST_CASE("SD card directory listing", "[sdcard]")
+{
+    std::vector<sim::fat_file_t> files;
+    const char *const names[] = { "benchy 0.2mm PLA.gcode", "ZZ.GCO", "calibration cube.gcode", "Aa first layer.gcode",
+        "models/part one.gcode", "models/part two.gcode", "notes.txt", "models/deep/inner.gcode" };
+    for (const char *name : names)
+        files.push_back({ name, gcode(0, 10), 0 });
+    for (const sim::fat_volume_t &volume : { fat16, fat32 }) {
+        INFO("FAT" << int(volume.fat_type));
+        insert(volume, files);
+
+        // The G-code files and the directory, with their long names.
+        CHECK(card.getnrfilenames() == 5);
+        card.getfilename(0);
+        CHECK(strcmp(card.longFilename, "benchy 0.2mm PLA.gcode") == 0);
+        CHECK(strcmp(card.filename, "BENCHY~1.GCO") == 0);
+        card.getfilename(1);
+        CHECK(card.longFilename[0] == 0);
+        CHECK(strcmp(card.filename, "ZZ.GCO") == 0);
+        card.getfilename(4);
+        CHECK(card.filenameIsDir);
+        CHECK(strcmp(card.longFilename, "models") == 0);
+
+        // Sorted by the name, the directories first.
+        eeprom_update_byte((uint8_t *)EEPROM_SD_SORT, SD_SORT_ALPHA);
+        card.presort();
+        const char *const sorted[] = { "models", "Aa first layer.gcode", "benchy 0.2mm PLA.gcode", "calibration cube.gcode", "ZZ.GCO" };
+        for (uint16_t i = 0; i < 5; ++i) {
+            // The menu shows the last sorted entry at the top.
+            card.getfilename_sorted(4 - i, SD_SORT_ALPHA);
+            CHECK(strcmp(card.longFilename[0] ? card.longFilename : card.filename, sorted[i]) == 0);
+        }
+
+        REQUIRE(card.chdir("MODELS", false));
+        CHECK(card.getnrfilenames() == 3);
+        card.updir();
+        CHECK(sim::sd_card_stats.errors == 0);
+    }
+}
+
+TEST_CASE("SD card file writes", "[sdcard]")
+{
+    insert(fat32, { { "PRINT.GCO", gcode(0, 1000), 0 } });
+    card.openFileWrite("LOG.GCO");
+    REQUIRE(card.saving);
+    std::string expected;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        char line[32];
+        snprintf(line, sizeof(line), "G1 X%u", i);
+        card.write_command(line);
+        expected += std::string(line) + "\r\n";
+    }
+    card.closefile();
+    CHECK(sim::sd_card_stats.blocks_written >= expected.size() / 512);
+    CHECK(sim::sd_card_stats.errors == 0);
+
+    // Read back from a fresh mount.
+    card.mount(false);
+    expected.pop_back();
+    CHECK(print_file("LOG.GCO") == expected);
+    CHECK(print_file("PRINT.GCO") == filtered(gcode(0, 1000)));
+}
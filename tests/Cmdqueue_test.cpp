@@ -0,0 +1,583 @@
+/**
+ * @file
+ * @brief Command queue and the G-code parameter lookups
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include "catch2/catch_test_macros.hpp"
+#include "fat_image.h"
+#include "sd_card.h"
+#include "Marlin.h"
+#include "cmdqueue.h"
+#include "cardreader.h"
+#include "planner.h"
+#include "stepper.h"
+#include "motion_core.h"
+#include "sim_avr.h"
+
+extern "C" void USART0_RX_vect(void);
+
+// Place cmd on the top of an otherwise empty queue, as loop() processes it.
+static void cmdqueue_set_top(const char *cmd)
+{
+    sim::reset_registers();
+    cmdqueue_reset();
+    enquecommand(cmd);
+    cmdbuffer_front_already_processed = false;
+}
+
+TEST_CASE("code_seen matches strchr", "[cmdqueue]")
+{
+    static const char *const cmds[] = {
+        "G1 X134.748 Y114.182 E.00781",
+        "G1 E-.8 F2100",
+        "G1 Z.6 F720",
+        "G28 W",
+        "M862.3 P \"MK3S\"",
+        "M117 Printing XYZ calibration",
+        "M552 P192.168.1.14",
+        "PRUSA MBL V1",
+        "G1 X1 X2 Y3",
+        "T?",
+        "",
+    };
+    for (const char *cmd : cmds) {
+        cmdqueue_set_top(cmd);
+        code_words_parse();
+        for (int c = 1; c < 128; ++c) {
+            INFO("cmd \"" << cmd << "\" code '" << char(c) << "'");
+            const char *expected = strchr(cmd, c);
+            REQUIRE(code_seen(c) == (expected != NULL));
+            if (expected) {
+                CHECK(strchr_pointer == CMDBUFFER_CURRENT_STRING + (expected - cmd));
+            } else {
+                CHECK(strchr_pointer == NULL);
+            }
+        }
+    }
+}
+
+TEST_CASE("code_seen values", "[cmdqueue]")
+{
+    cmdqueue_set_top("G1 X134.748 Y-114.182 E.00781 F7200");
+    code_words_parse();
+    REQUIRE(code_seen('X'));
+    CHECK(code_value() == 134.748f);
+    REQUIRE(code_seen('Y'));
+    CHECK(code_value() == -114.182f);
+    REQUIRE(code_seen('E'));
+    CHECK(code_value() == .00781f);
+    REQUIRE(code_seen('F'));
+    CHECK(code_value_long() == 7200);
+    CHECK_FALSE(code_seen('Z'));
+
+    // The IP address of M552 is read by overwriting the parameter letter and looking for the dots.
+    cmdqueue_set_top("M552 P192.168.1.14");
+    code_words_parse();
+    REQUIRE(code_seen('P'));
+    *strchr_pointer = '*';
+    CHECK(code_value_short() == 192);
+    REQUIRE(code_seen('.'));
+    *strchr_pointer = '*';
+    CHECK(code_value_short() == 168);
+}
+
+TEST_CASE("code_seen after a command was pushed to the front", "[cmdqueue]")
+{
+    cmdqueue_set_top("G1 X10 Y20");
+    code_words_parse();
+    REQUIRE(code_seen('X'));
+
+    // The current command is replaced by the one pushed to the front without being dequeued.
+    enquecommand_front("M220 S95");
+    REQUIRE(strcmp(CMDBUFFER_CURRENT_STRING, "M220 S95") == 0);
+    CHECK_FALSE(code_seen('X'));
+    REQUIRE(code_seen('S'));
+    CHECK(code_value_short() == 95);
+    cmdqueue_reset();
+}
+
+// Pops the front of the queue, which has to be cmd.
+static void check_pop_front(const std::string &cmd)
+{
+    REQUIRE(buflen > 0);
+    CHECK(CMDBUFFER_CURRENT_STRING == cmd);
+    cmdqueue_pop_front();
+}
+
+TEST_CASE("Command queue wrap", "[cmdqueue]")
+{
+    sim::reset_registers();
+    cmdqueue_reset();
+    serial_count = 0;
+    std::deque<std::string> queued;
+    uint32_t seed = 7;
+    bool wrapped = false;
+    int rejected = 0;
+    for (int n = 0; n < 2000; ++n) {
+        seed = seed * 1103515245 + 12345;
+        // Short commands use up the descriptors, long ones the characters.
+        std::string cmd = "M117 " + std::to_string(n);
+        cmd.resize(cmd.size() + (seed >> 16) % 60, 'x');
+        const int len = buflen;
+        enquecommand(cmd.c_str());
+        if (buflen == len) {
+            // The queue is full, but the commands pushed to the front still fit.
+            ++rejected;
+            REQUIRE(len > 0);
+            enquecommand_front("M400");
+            REQUIRE(buflen == len + 1);
+            check_pop_front("M400");
+            check_pop_front(queued.front());
+            queued.pop_front();
+            continue;
+        }
+        REQUIRE(buflen == len + 1);
+        queued.push_back(cmd);
+        // The strings wrap around the end of cmdbuffer.
+        if (cmdqueue[(bufindr + buflen - 1) % CMDQUEUE_SIZE].cmd < CMDBUFFER_CURRENT_ENTRY.cmd)
+            wrapped = true;
+        if ((seed >> 8) % 3 == 0) {
+            check_pop_front(queued.front());
+            queued.pop_front();
+        }
+    }
+    CHECK(wrapped);
+    CHECK(rejected > 0);
+    while (!queued.empty()) {
+        check_pop_front(queued.front());
+        queued.pop_front();
+    }
+    CHECK(buflen == 0);
+    CHECK(cmdqueue_calc_sd_length() == 0);
+}
+
+TEST_CASE("Command queue serial line in place", "[cmdqueue]")
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+    gcode_LastN = 4;
+
+    std::string line = "N5 G1 X1.5 E.2";
+    uint8_t checksum = 0;
+    for (char c : line)
+        checksum ^= c;
+    line += "*" + std::to_string(checksum) + "\n";
+    for (char c : line) {
+        UDR0.poke(c);
+        USART0_RX_vect();
+    }
+    get_command();
+
+    // The command is left where it was received, past the line number, without the checksum.
+    REQUIRE(buflen == 1);
+    CHECK(CMDBUFFER_CURRENT_TYPE == CMDBUFFER_CURRENT_TYPE_USB_WITH_LINENR);
+    CHECK(CMDBUFFER_CURRENT_STRING == cmdbuffer + 3);
+    CHECK(strcmp(CMDBUFFER_CURRENT_STRING, "G1 X1.5 E.2") == 0);
+    CHECK(gcode_LastN == 5);
+    CHECK(cmdqueue_calc_sd_length() == 0);
+    cmdqueue_reset();
+}
+
+static std::string serial_out;
+
+static void record_serial(uint8_t c)
+{
+    serial_out += char(c);
+}
+
+TEST_CASE("Command queue serial line errors", "[cmdqueue]")
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+    gcode_LastN = 4;
+    serial_out.clear();
+    sim::serial_hook = record_serial;
+
+    // A skipped line number is reported before the checksum of the line is checked.
+    for (char c : std::string("N7 G1 X1*0\n")) {
+        UDR0.poke(c);
+        USART0_RX_vect();
+    }
+    get_command();
+    CHECK(buflen == 0);
+    CHECK(serial_out.find("Line Number is not Last Line Number+1, Last Line: 4") != std::string::npos);
+    CHECK(serial_out.find("checksum") == std::string::npos);
+
+    // The expected line number with a wrong checksum.
+    serial_out.clear();
+    for (char c : std::string("N5 G1 X1*0\n")) {
+        UDR0.poke(c);
+        USART0_RX_vect();
+    }
+    get_command();
+    CHECK(buflen == 0);
+    CHECK(serial_out.find("checksum mismatch, Last Line: 4") != std::string::npos);
+    CHECK(gcode_LastN == 4);
+
+    sim::serial_hook = NULL;
+    cmdqueue_reset();
+}
+
+TEST_CASE("Command queue front", "[cmdqueue]")
+{
+    SECTION("enquecommand_front") {
+        cmdqueue_set_top("G28");
+        enquecommand("M1");
+        // The command being processed is dropped, the new one is processed next.
+        enquecommand_front("M2");
+        CHECK(cmdbuffer_front_already_processed);
+        enquecommand_front("M3");
+        REQUIRE(buflen == 3);
+        check_pop_front("M3");
+        check_pop_front("M2");
+        check_pop_front("M1");
+    }
+    SECTION("repeatcommand_front") {
+        cmdqueue_set_top("G28");
+        enquecommand("M1");
+        // The command being processed is kept, to be processed again after the one pushed.
+        repeatcommand_front();
+        enquecommand_front("M2");
+        REQUIRE(buflen == 3);
+        check_pop_front("M2");
+        check_pop_front("G28");
+        check_pop_front("M1");
+    }
+    SECTION("wrapped") {
+        cmdqueue_set_top("G28");
+        cmdqueue_pop_front();
+        // Move the tail past the middle of cmdbuffer, then wrap it with commands popped behind it.
+        std::deque<std::string> queued;
+        for (int n = 0; n < 6; ++n) {
+            std::string cmd = "M117 " + std::to_string(n);
+            cmd.resize(MAX_CMD_SIZE - 10, 'x');
+            enquecommand(cmd.c_str());
+            queued.push_back(cmd);
+            if (queued.size() > 2) {
+                check_pop_front(queued.front());
+                queued.pop_front();
+            }
+        }
+        CHECK(cmdqueue[(bufindr + buflen - 1) % CMDQUEUE_SIZE].cmd < CMDBUFFER_CURRENT_ENTRY.cmd);
+        cmdbuffer_front_already_processed = false;
+        queued.pop_front();
+        enquecommand_front("M2");
+        enquecommand_front("M3");
+        REQUIRE(buflen == int(queued.size()) + 2);
+        check_pop_front("M3");
+        check_pop_front("M2");
+        for (const std::string &cmd : queued)
+            check_pop_front(cmd);
+    }
+    CHECK(buflen == 0);
+    cmdqueue_reset();
+}
+
+TEST_CASE("Move records", "[cmdqueue]")
+{
+    static const char *const moves[] = {
+        "G1 X134.748 Y114.182 E.00781",
+        "G1 E-.8 F2100",
+        "G1 Z0.6 F720.5",
+        "G0 X-12.5 Y+7 Z0.2 E-0.04 F9000.5",
+        "G1 F1800",
+        "G1",
+    };
+    for (const char *cmd : moves) {
+        INFO("cmd \"" << cmd << "\"");
+        cmdqueue_set_top(cmd);
+        float values[NUM_AXIS + 1];
+        const uint8_t seen = code_move_words(values);
+        REQUIRE(seen != MOVE_WORDS_INVALID);
+
+        // Shorter than the text, NUL free and decoded to the very same values.
+        std::string record(cmd);
+        record.resize(move_record_from_text(&record[0], record.size()));
+        CHECK(record.size() <= strlen(cmd));
+        CHECK(record[0] == MOVE_RECORD_MARKER);
+        CHECK(record.find('\0') == std::string::npos);
+        float record_values[NUM_AXIS + 1];
+        REQUIRE(move_record_words(record.c_str(), record_values) == seen);
+        for (uint8_t w = 0; w <= MOVE_WORD_F; ++w)
+            if (seen & _BV(w))
+                CHECK(memcmp(&record_values[w], &values[w], sizeof(float)) == 0);
+
+        // The record at the front of the queue is planned like the text.
+        cmdqueue_set_top(record.c_str());
+        float queued_values[NUM_AXIS + 1];
+        CHECK(code_move_words(queued_values) == seen);
+
+        // Written back as text to a file being saved, the same move.
+        char text[MOVE_RECORD_TEXT_SIZE];
+        const size_t text_len = move_record_to_text(record.c_str(), text);
+        CHECK(text_len == strlen(text));
+        INFO("text \"" << text << "\"");
+        cmdqueue_set_top(text);
+        float text_values[NUM_AXIS + 1];
+        REQUIRE(code_move_words(text_values) == seen);
+        for (uint8_t w = 0; w <= MOVE_WORD_F; ++w)
+            if (seen & _BV(w))
+                CHECK(memcmp(&text_values[w], &values[w], sizeof(float)) == 0);
+    }
+    cmdqueue_reset();
+
+    std::string record("G0 X-12.5 Y+7 Z0.2 E-.00781 F9000.5");
+    record.resize(move_record_from_text(&record[0], record.size()));
+    char text[MOVE_RECORD_TEXT_SIZE];
+    move_record_to_text(record.c_str(), text);
+    CHECK(std::string(text) == "G1 X-12.5 Y7 Z0.2 E-0.00781 F9000.5");
+
+    // Short moves, whose record would be longer, and the other commands stay text.
+    for (const char *cmd : { "G1 X1", "G1 Z.6 F720", "M117 G1 X134.748 Y114.182", "G1 X1e3" }) {
+        INFO("cmd \"" << cmd << "\"");
+        std::string text(cmd);
+        CHECK(move_record_from_text(&text[0], text.size()) == strlen(cmd));
+        CHECK(text == cmd);
+    }
+}
+
+#ifdef CMDQUEUE_PREFETCH_MOVES
+// Number of the lines of fmt (with an %d for a digit) queued from the serial line, until the queue
+// stops taking them.
+static int queued_serial_lines(const char *fmt)
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+    for (int n = 0; n < 10; ++n) {
+        // The host keeps the receive ring full.
+        for (;;) {
+            char line[64];
+            snprintf(line, sizeof(line), fmt, n % 10);
+            if (MSerial.available() + strlen(line) + 1 > RX_BUFFER_SIZE - 1)
+                break;
+            for (const char *p = line; *p; ++p) {
+                UDR0.poke(*p);
+                USART0_RX_vect();
+            }
+            UDR0.poke('\n');
+            USART0_RX_vect();
+        }
+        get_command();
+    }
+    const int queued = buflen;
+    cmdqueue_reset();
+    MSerial.flush();
+    serial_count = 0;
+    return queued;
+}
+
+TEST_CASE("Moves prefetched into the queue", "[cmdqueue]")
+{
+    // Commands of the same length, the moves are stored as records.
+    const char *const move = "G1 X134.748 Y114.182 E.0078%d";
+    const char *const other = "M73 X134.748 Y114.182 E.078%d";
+    REQUIRE(strlen(move) == strlen(other));
+    const int moves = queued_serial_lines(move);
+    const int others = queued_serial_lines(other);
+    INFO("moves " << moves << ", other commands " << others);
+    CHECK(moves >= others * 3 / 2);
+    CHECK(moves < CMDQUEUE_SIZE - CMDQUEUE_RESERVE_FRONT);
+}
+
+static std::deque<std::string> processed;
+
+// M28 opens its file, the moves are planned.
+static void process_saved_commands()
+{
+    const char *cmd = CMDBUFFER_CURRENT_STRING;
+    if (cmd[0] == MOVE_RECORD_MARKER) {
+        char text[MOVE_RECORD_TEXT_SIZE];
+        move_record_to_text(cmd, text);
+        processed.push_back(text);
+        plan_buffer_line(10, 0, 0, 0, 50);
+    } else {
+        processed.push_back(cmd);
+        if (strncmp(cmd, "M28 ", 4) == 0)
+            card.openFileWrite(cmd + 4);
+    }
+}
+
+TEST_CASE("Moves queued behind M28 are saved", "[cmdqueue]")
+{
+    sim::motion_init();
+    const sim::fat_volume_t fat16 = { 16, 2048 + 262144, 8 };
+    sim::sd_card_insert(sim::fat_image(fat16, {}), fat16.blocks);
+    card.mount(false);
+    REQUIRE(card.mounted);
+
+    // The moves come in one pass of get_command() with the M28, before it opens the file.
+    selectedSerialPort = 0;
+    MSerial.flush();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+    std::string expected;
+    std::string input = "M28 SAVED.GCO\n";
+    for (int n = 1; n <= 5; ++n) {
+        char line[64];
+        snprintf(line, sizeof(line), "G1 X134.748 Y114.182 E0.0078%d", n);
+        input += std::string(line) + "\n";
+        expected += std::string(line) + "\r\n";
+    }
+    input += "M29\n";
+    for (const char c : input) {
+        UDR0.poke(c);
+        USART0_RX_vect();
+    }
+    get_command();
+    REQUIRE(buflen == 7);
+    REQUIRE(cmdqueue_front_prefetched() == false);
+
+    sim::process_commands_hook = process_saved_commands;
+    while (buflen)
+        cmdqueue_process_front();
+    sim::process_commands_hook = nullptr;
+
+    // Only the M28 was processed, the rest went to the file.
+    REQUIRE(processed.size() == 1);
+    CHECK(processed.front() == "M28 SAVED.GCO");
+    processed.clear();
+    CHECK_FALSE(card.saving);
+    CHECK(blocks_queued() == false);
+
+    card.openFileReadFilteredGcode("SAVED.GCO");
+    REQUIRE(card.isFileOpen());
+    std::string text;
+    for (int16_t c; (c = card.getFilteredGcodeChar()) >= 0;)
+        text += char(c);
+    card.closefile();
+    expected.pop_back();
+    CHECK(text == expected);
+    sim::sd_card_remove();
+    MSerial.flush();
+}
+#endif // CMDQUEUE_PREFETCH_MOVES
+
+#ifdef PLANNER_STARVATION_COUNT
+TEST_CASE("Planner starvation count", "[cmdqueue]")
+{
+    sim::motion_init();
+    CHECK(planner_starvation_count() == 0);
+    plan_buffer_line(10, 0, 0, 0, 50);
+    plan_buffer_line(20, 0, 0, 0, 50);
+    CHECK(planner_starvation_count() == 0);
+
+    // The stepper drained the queue before the next move came.
+    sim::run_until_idle();
+    plan_buffer_line(30, 0, 0, 0, 50);
+    CHECK(planner_starvation_count() == 1);
+
+    // A command waiting for the moves to finish drains the queue on purpose.
+    st_synchronize();
+    plan_buffer_line(40, 0, 0, 0, 50);
+    CHECK(planner_starvation_count() == 1);
+    sim::run_until_idle();
+    planner_starvation_reset();
+    CHECK(planner_starvation_count() == 0);
+}
+#endif // PLANNER_STARVATION_COUNT
+
+// The words of a move as get_coordinates() finds them.
+static uint8_t generic_move_words(float values[NUM_AXIS + 1])
+{
+    uint8_t seen = 0;
+    for (uint8_t i = 0; i <= MOVE_WORD_F; ++i) {
+        if (code_seen("XYZEF"[i])) {
+            seen |= _BV(i);
+            values[i] = strtod(strchr_pointer + 1, NULL);
+        }
+    }
+    return seen;
+}
+
+static bool within_ulp(float a, float b)
+{
+    return a == b || fabsf(a - b) <= fabsf(b) * 1.2e-7f;
+}
+
+TEST_CASE("G0/G1 fast path", "[cmdqueue]")
+{
+    static const char *const moves[] = {
+        "G1 X134.748 Y-114.182 E.00781 F7200",
+        "G1 X134.748 Y114.182 E.00781",
+        "G1 E-.8 F2100",
+        "G1 Z.6 F720",
+        "G0 X10 Y20",
+        "G1",
+        "G1 X1Y2Z3F5",
+        "G1 X1 X2 F3 ",
+        "G1 X+5 Y-0 Z0000.500",
+        "G1 X0.12345678912345 Y123456789",
+        "G1 E0.000000001",
+        "G1 X-",
+    };
+    for (const char *cmd : moves) {
+        INFO("cmd \"" << cmd << "\"");
+        cmdqueue_set_top(cmd);
+        code_words_parse();
+        float expected[NUM_AXIS + 1], values[NUM_AXIS + 1];
+        const uint8_t seen = generic_move_words(expected);
+        REQUIRE(code_move_words(values) == seen);
+        for (uint8_t i = 0; i <= MOVE_WORD_F; ++i) {
+            if (seen & _BV(i)) {
+                INFO("word " << "XYZEF"[i] << " " << values[i] << " expected " << expected[i]);
+                CHECK(within_ulp(values[i], expected[i]));
+            }
+        }
+    }
+
+    static const char *const others[] = {
+        "G2 X10 Y10 I5 J0",
+        "G10",
+        "G01 X1",
+        "G1 X10 R5",
+        "G1 x10",
+        "G1 X1e3",
+        "G1 X1Y2Z3E4",
+        "G1 X1.2.3",
+        "G1 X1234567890",
+        "M1",
+        "",
+    };
+    for (const char *cmd : others) {
+        INFO("cmd \"" << cmd << "\"");
+        cmdqueue_set_top(cmd);
+        float values[NUM_AXIS + 1];
+        CHECK(code_move_words(values) == MOVE_WORDS_INVALID);
+    }
+}
+
+TEST_CASE("G0/G1 fast path numbers", "[cmdqueue]")
+{
+    // Slicer formatted coordinates, extrusions and feed rates.
+    uint32_t seed = 1;
+    for (int n = 0; n < 20000; ++n) {
+        seed = seed * 1103515245 + 12345;
+        const uint8_t decimals = (seed >> 8) % 6;
+        const long mantissa = long(seed >> 12) % 2500000 - 1250000;
+        char cmd[32];
+        snprintf(cmd, sizeof(cmd), "G1 X%.*f", decimals, mantissa / 1e5);
+        INFO("cmd \"" << cmd << "\"");
+        cmdqueue_set_top(cmd);
+        float values[NUM_AXIS + 1];
+        REQUIRE(code_move_words(values) == X_AXIS_MASK);
+        CHECK(values[X_AXIS] == strtof(cmd + 4, NULL));
+    }
+}
@@ -0,0 +1,264 @@
+/**
+ * @file
+ * @brief Input shaping of the X and Y step streams
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "ConfigurationStore.h"
+#include "motion_core.h"
+
+#ifdef INPUT_SHAPING
+
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+static const double slot_time = double(1UL << SHAPING_SLOT_SHIFT) * sim::CYCLES_PER_TICK / F_CPU;
+
+// The impulses of the shapers in double precision.
+static uint8_t reference_impulses(uint8_t type, double f, double zeta, double amp[3], double time[3])
+{
+    const double df = sqrt(1 - zeta * zeta);
+    const double td = 1 / (f * df);
+    uint8_t count;
+    if (type == SHAPER_MZV) {
+        const double k = exp(-0.75 * zeta * M_PI / df);
+        const double a1 = 1 - 1 / sqrt(2.);
+        count = 3;
+        amp[0] = a1;
+        amp[1] = (sqrt(2.) - 1) * k;
+        amp[2] = a1 * k * k;
+        time[1] = 0.375 * td;
+        time[2] = 0.75 * td;
+    } else {
+        const double k = exp(-zeta * M_PI / df);
+        amp[0] = 1;
+        amp[1] = (type == SHAPER_ZV) ? k : 2 * k;
+        amp[2] = k * k;
+        time[1] = td / 2;
+        time[2] = td;
+        count = (type == SHAPER_ZV) ? 2 : 3;
+    }
+    time[0] = 0;
+    double sum = 0;
+    for (uint8_t i = 0; i < count; ++i)
+        sum += amp[i];
+    for (uint8_t i = 0; i < count; ++i)
+        amp[i] /= sum;
+    return count;
+}
+
+TEST_CASE("Shaper impulses", "[shaping]")
+{
+    for (uint8_t type = SHAPER_ZV; type <= SHAPER_MZV; ++type) {
+        for (double zeta : { 0., 0.05, 0.1, 0.3 }) {
+            for (double f : { 20., 40., 80. }) {
+                INFO("type " << int(type) << " zeta " << zeta << " f " << f);
+                double amp[3], time[3];
+                const uint8_t count = reference_impulses(type, f, zeta, amp, time);
+                shaper_impulses_t imp;
+                REQUIRE(shaper_impulses(type, f, zeta, imp));
+                REQUIRE(imp.count == count);
+                for (uint8_t i = 0; i < count; ++i) {
+                    CHECK_THAT(imp.amp[i], WithinRel(amp[i], 1e-5));
+                    CHECK_THAT(imp.time[i], WithinAbs(time[i], 1e-7));
+                }
+            }
+        }
+    }
+
+    shaper_impulses_t imp;
+    CHECK_FALSE(shaper_impulses(SHAPER_ZV, 0, 0.1f, imp));
+    CHECK_FALSE(shaper_impulses(SHAPER_ZV, 40, 1, imp));
+    CHECK_FALSE(shaper_impulses(SHAPER_ZV, 40, -0.1f, imp));
+    CHECK_FALSE(shaper_impulses(SHAPER_MZV + 1, 40, 0.1f, imp));
+}
+
+TEST_CASE("Shaper fixed point parameters", "[shaping]")
+{
+    for (uint8_t type = SHAPER_ZV; type <= SHAPER_MZV; ++type) {
+        for (uint16_t f = 10; f <= 300; ++f) {
+            INFO("type " << int(type) << " f " << f);
+            double amp[3], time[3];
+            const uint8_t count = reference_impulses(type, f, 0.1, amp, time);
+            shaper_params_t params;
+            const bool fits = time[count - 1] / slot_time < SHAPING_SLOTS - 2;
+            REQUIRE(shaper_params(type, f, 0.1f, params) == fits);
+            if (!fits)
+                continue;
+            uint16_t sum = params.amp0;
+            CHECK(fabs(params.amp0 - amp[0] * 256) <= 1);
+            for (uint8_t i = 1; i < SHAPER_IMPULSES_MAX; ++i) {
+                sum += params.amp[i - 1];
+                if (i >= count) {
+                    CHECK(params.amp[i - 1] == 0);
+                    continue;
+                }
+                CHECK(fabs(params.amp[i - 1] - amp[i] * 256) <= 0.5);
+                CHECK(params.slots[i - 1] >= 1);
+                CHECK(params.slots[i - 1] <= SHAPING_SLOTS - 2);
+                CHECK_THAT(params.slots[i - 1] + params.frac[i - 1] / 256., WithinAbs(time[i] / slot_time, 1 / 512. + 1e-6));
+            }
+            CHECK(sum == 256);
+        }
+    }
+
+    // The longest delay has to fit into the step history.
+    shaper_params_t params;
+    CHECK(shaper_params(SHAPER_ZV, 20, 0.1f, params));
+    CHECK_FALSE(shaper_params(SHAPER_ZVD, 20, 0.1f, params));
+    CHECK(shaper_params(SHAPER_ZVD, 40, 0.1f, params));
+    CHECK_FALSE(shaper_params(SHAPER_ZV, 2000, 0.1f, params));
+}
+
+// X position over time, one sample per X step.
+struct x_sample_t
+{
+    double t;
+    int32_t x;
+};
+
+static std::vector<x_sample_t> x_trace;
+
+static void record_x(uint8_t axis, int32_t position)
+{
+    if (axis == X_AXIS)
+        x_trace.push_back({ double(sim::motion_stats().ticks) * sim::CYCLES_PER_TICK / F_CPU, position });
+}
+
+static int32_t x_at(const std::vector<x_sample_t> &trace, double t)
+{
+    const auto it = std::upper_bound(trace.begin(), trace.end(), t, [](double t, const x_sample_t &s) { return t < s.t; });
+    return (it == trace.begin()) ? 0 : std::prev(it)->x;
+}
+
+#define TEST_DIO_RPORT(IO) _TEST_DIO_RPORT(IO)
+#define _TEST_DIO_RPORT(IO) DIO ## IO ## _RPORT
+
+// A back and forth X move, with the shaper of X switched off for freq 0. With homing, the endstops
+// are checked (and not hit).
+static std::vector<x_sample_t> run_x_moves(uint8_t type, float freq, bool homing = false)
+{
+    sim::motion_init();
+#ifdef TMC2130_SG_HOMING
+    TEST_DIO_RPORT(X_TMC2130_DIAG).poke(0xff);
+#endif
+    cs.shaping_freq[X_AXIS] = freq;
+    cs.shaping_zeta[X_AXIS] = 0.1f;
+    cs.shaping_type[X_AXIS] = type;
+    shaper_update();
+    cs.acceleration = 3000;
+    enable_endstops(homing);
+    x_trace.clear();
+    sim::set_step_trace(record_x);
+    plan_buffer_line(30, 0, 0, 0, 80);
+    plan_buffer_line(35, 0, 0, 0, 40);
+    plan_buffer_line(5, 0, 0, 0, 100);
+    sim::run_until_idle();
+    sim::set_step_trace(NULL);
+    enable_endstops(false);
+    cs.shaping_freq[X_AXIS] = 0;
+    shaper_update();
+    return x_trace;
+}
+
+// Largest deviation of the shaped trajectory from the unshaped one convolved with the impulses.
+static double shaped_error(const std::vector<x_sample_t> &unshaped, const std::vector<x_sample_t> &shaped, uint8_t type, double f)
+{
+    shaper_impulses_t imp;
+    REQUIRE(shaper_impulses(type, f, 0.1f, imp));
+    double error = 0;
+    const double end = shaped.back().t + 0.01;
+    for (double t = 0; t < end; t += 50e-6) {
+        double ref = 0;
+        for (uint8_t i = 0; i < imp.count; ++i)
+            ref += imp.amp[i] * x_at(unshaped, t - imp.time[i]);
+        error = max(error, fabs(x_at(shaped, t) - ref));
+    }
+    return error;
+}
+
+// Largest amplitude of a resonance (2nd order oscillator at freq, damping ratio 0.1) driven by the
+// trajectory after it reached its end.
+static double residual_vibration(const std::vector<x_sample_t> &trace, double freq)
+{
+    const double w = 2 * M_PI * freq;
+    const double zeta = 0.1;
+    const double dt = 5e-6;
+    const double end = trace.back().t;
+    double x = 0, v = 0, residual = 0;
+    for (double t = 0; t < end + 0.2; t += dt) {
+        const double u = x_at(trace, t);
+        v += (-w * w * (x - u) - 2 * zeta * w * v) * dt;
+        x += v * dt;
+        if (t > end)
+            residual = max(residual, fabs(x - u));
+    }
+    return residual;
+}
+
+TEST_CASE("Shaped X trajectory", "[shaping]")
+{
+    const std::vector<x_sample_t> unshaped = run_x_moves(SHAPER_ZV, 0);
+    REQUIRE(unshaped.back().x == 500);
+
+    for (uint8_t type = SHAPER_ZV; type <= SHAPER_MZV; ++type) {
+        INFO("type " << int(type));
+        const std::vector<x_sample_t> shaped = run_x_moves(type, 40);
+        CHECK(shaped.back().x == 500);
+        CHECK(sim::motion_stats().overruns == 0);
+
+        // The shaped position follows the sum of the delayed unshaped ones. Both are step functions,
+        // the delayed steps are released over a slot and emitted at half a step.
+        CHECK(shaped_error(unshaped, shaped, type, 40) <= 2.5);
+
+        // And cancels the residual vibration of the resonance.
+        const double residual = residual_vibration(shaped, 40);
+        const double residual_unshaped = residual_vibration(unshaped, 40);
+        INFO("residual " << residual << " unshaped " << residual_unshaped);
+        CHECK(residual < 0.1 * residual_unshaped);
+    }
+}
+
+TEST_CASE("Shaper bypass while checking the endstops", "[shaping]")
+{
+    const std::vector<x_sample_t> unshaped = run_x_moves(SHAPER_ZV, 0, true);
+    REQUIRE(unshaped.back().x == 500);
+    const std::vector<x_sample_t> bypass = run_x_moves(SHAPER_MZV, 40, true);
+    REQUIRE(bypass.size() == unshaped.size());
+    for (size_t i = 0; i < bypass.size(); ++i)
+        if (bypass[i].x != unshaped[i].x || fabs(bypass[i].t - unshaped[i].t) > 1e-6)
+            FAIL("step " << i);
+}
+
+TEST_CASE("Shaped moves after the direction pin was driven directly", "[shaping]")
+{
+    sim::motion_init();
+    cs.shaping_freq[X_AXIS] = 40;
+    cs.shaping_zeta[X_AXIS] = 0.1f;
+    cs.shaping_type[X_AXIS] = SHAPER_MZV;
+    shaper_update();
+    // motion_init() does not reset the step counters of the firmware.
+    const long counted = st_get_position(X_AXIS);
+    plan_buffer_line(30, 0, 0, 0, 80);
+    sim::run_until_idle();
+    REQUIRE(sim::step_position(X_AXIS) == st_get_position(X_AXIS) - counted);
+
+    // xyzcal (sm4_set_dir_bits()), the TMC2130 homing and D2130 leave the pin in the other direction.
+    WRITE(X_DIR_PIN, INVERT_X_DIR);
+    plan_buffer_line(40, 0, 0, 0, 80);
+    sim::run_until_idle();
+    CHECK(sim::step_position(X_AXIS) == st_get_position(X_AXIS) - counted);
+    CHECK(sim::step_position(X_AXIS) == lround(40 * cs.axis_steps_per_mm[X_AXIS]));
+
+    cs.shaping_freq[X_AXIS] = 0;
+    shaper_update();
+}
+
+#endif // INPUT_SHAPING
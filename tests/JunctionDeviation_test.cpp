@@ -0,0 +1,80 @@
+/**
+ * @file
+ * @brief Junction deviation cornering of the planner against a reference implementation
+ */
+
+#include <math.h>
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_approx.hpp"
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "ConfigurationStore.h"
+#include "motion_core.h"
+
+// Reference: the largest circle touching both segments, which passes the corner at the deviation
+// distance, in double precision and with the junction angle evaluated by the trigonometric functions.
+// turn is the change of the direction in radians, 0 for a straight line.
+static double reference_speed(double turn, double acceleration, double deviation)
+{
+    const double half_junction_angle = (M_PI - turn) / 2;
+    const double radius = deviation * sin(half_junction_angle) / (1 - sin(half_junction_angle));
+    return sqrt(acceleration * radius);
+}
+
+TEST_CASE("Junction deviation speed", "[planner]")
+{
+    for (int turn = 5; turn <= 175; turn += 5) {
+        for (float deviation : { 0.013f, 0.05f, 0.2f }) {
+            INFO("turn " << turn << " deg, deviation " << deviation << " mm");
+            const float cos_theta = -cos(radians(turn));
+            CHECK(junction_deviation_speed(cos_theta, 1000.f, deviation) ==
+                  Catch::Approx(reference_speed(radians(turn), 1000., deviation)).epsilon(0.001));
+        }
+    }
+    // A full reversal stops, a straight line is not limited by the junction.
+    CHECK(junction_deviation_speed(1.f, 1000.f, 0.05f) == 0.f);
+    CHECK(junction_deviation_speed(-1.f, 1000.f, 0.05f) > 1000.f);
+}
+
+// Queue a segment along X followed by a segment turned by the angle, return the max entry speed of the second one
+// and abort the moves.
+static float planned_junction_speed(double turn)
+{
+    const float feedrate = 100; // mm/s
+    plan_buffer_line(10, 10, 0, 0, feedrate);
+    plan_buffer_line(20, 10, 0, 0, feedrate);
+    plan_buffer_line(20 + 10 * cos(radians(turn)), 10 + 10 * sin(radians(turn)), 0, 0, feedrate);
+    REQUIRE(moves_planned() == 3);
+    const float speed = fx_to_speed(block_buffer[2].max_entry_speed);
+    quickStop();
+    return speed;
+}
+
+TEST_CASE("Junction deviation in plan_buffer_line", "[planner]")
+{
+    // Below the X and Y acceleration limits, so that the acceleration does not depend on the direction.
+    const float acceleration = 500;
+    const float deviation = 0.05f;
+
+    for (double turn : { 10., 30., 45., 60., 90., 135. }) {
+        INFO("turn " << turn << " deg");
+        sim::motion_init();
+        cs.acceleration = cs.travel_acceleration = acceleration;
+        cs.junction_deviation = deviation;
+        const float v_junction = planned_junction_speed(turn);
+        // The junction speed is stored with 1/SPEED_FX_ONE mm/s resolution, the acceleration is rounded to steps/s^2.
+        CHECK(v_junction == Catch::Approx(reference_speed(radians(turn), acceleration, deviation)).epsilon(0.005).margin(1. / SPEED_FX_ONE));
+    }
+
+    SECTION("Higher corner speed than the jerk on shallow corners") {
+        sim::motion_init();
+        cs.acceleration = cs.travel_acceleration = acceleration;
+        const float v_jerk = planned_junction_speed(10);
+        sim::motion_init();
+        cs.acceleration = cs.travel_acceleration = acceleration;
+        cs.junction_deviation = deviation;
+        const float v_deviation = planned_junction_speed(10);
+        CHECK(v_deviation > v_jerk);
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * @file
+ * @brief Linear advance scheduling of the stepper interrupt
+ */
+
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "fastdiv.h"
+#include "fastio.h"
+#include "motion_core.h"
+
+TEST_CASE("fastdiv is exact", "[linadvance]")
+{
+    for (uint16_t d = 1; d <= 2 * FASTDIV_TABLE_MAX; ++d) {
+        INFO("d " << d);
+        for (uint32_t q = 0; q <= UINT16_MAX; ++q)
+            if (fastdiv(q, d) != q / d)
+                FAIL("q " << q);
+    }
+}
+
+TEST_CASE("fastdiv_rate is exact", "[linadvance]")
+{
+    for (uint32_t rate = 200; rate <= UINT16_MAX; rate += (rate < 2000) ? 1 : 97) {
+        INFO("rate " << rate);
+        const uint16_t rate_inv = fastdiv_rate_inv(rate);
+        // Around every multiple of the rate up to three timer periods.
+        for (uint32_t ticks = 0; ticks * rate < 3 * 0x10000UL; ++ticks) {
+            for (int8_t offset = -1; offset <= 1; ++offset) {
+                const uint32_t err0 = ticks * rate + offset;
+                if (int32_t(err0) < 0)
+                    continue;
+                uint32_t err = err0;
+                if (fastdiv_rate(err, rate, rate_inv) != err0 / rate || err != err0 % rate)
+                    FAIL("err " << err0);
+            }
+        }
+    }
+}
+
+#ifdef LIN_ADVANCE
+
+#define TEST_DIO_WPORT(IO) _TEST_DIO_WPORT(IO)
+#define _TEST_DIO_WPORT(IO) DIO ## IO ## _WPORT
+#define TEST_DIO_PIN(IO) _TEST_DIO_PIN(IO)
+#define _TEST_DIO_PIN(IO) DIO ## IO ## _PIN
+
+// E steps emitted while a block was the current one (or the last one, if none is current).
+struct block_e_steps_t
+{
+    int32_t planned;
+    int32_t emitted;
+    uint16_t max_adv_steps;
+};
+
+static std::vector<block_e_steps_t> replay;
+static const block_t *replay_block;
+static sim::port_hook_t replay_next_hook;
+
+static void replay_port_write(uint16_t addr, uint8_t old_value, uint8_t new_value)
+{
+    if (current_block && current_block != replay_block) {
+        replay_block = current_block;
+        const int32_t steps = current_block->steps[E_AXIS].wide;
+        replay.push_back({ (current_block->direction_bits & _BV(E_AXIS)) ? -steps : steps, 0, current_block->max_adv_steps });
+    }
+    if (addr == TEST_DIO_WPORT(E0_STEP_PIN).addr && ((old_value ^ new_value) & _BV(TEST_DIO_PIN(E0_STEP_PIN)))) {
+        REQUIRE(! replay.empty());
+        const bool forward = bool(TEST_DIO_WPORT(E0_DIR_PIN).peek() & _BV(TEST_DIO_PIN(E0_DIR_PIN))) != bool(INVERT_E0_DIR);
+#ifndef TMC2130_DEDGE_STEPPING
+        if (bool(new_value & _BV(TEST_DIO_PIN(E0_STEP_PIN))) == bool(INVERT_E_STEP_PIN))
+            return;
+#endif
+        replay.back().emitted += forward ? 1 : -1;
+    }
+    replay_next_hook(addr, old_value, new_value);
+}
+
+// Perimeters with short infill like segments, a retraction and a slow Z dominated extrusion,
+// which spreads up to 8 advance ticks over a single main ISR period.
+static void replay_moves(float k)
+{
+    sim::motion_init();
+    replay.clear();
+    replay_block = NULL;
+    replay_next_hook = sim::port_hook;
+    sim::port_hook = replay_port_write;
+    extruder_advance_K = k;
+
+    float e = 0;
+    for (uint8_t i = 0; i < 3; ++i) {
+        plan_buffer_line(20, 20, 0.2f, e += 0.5f, 40);
+        plan_buffer_line(60, 20, 0.2f, e += 1.6f, 60);
+        plan_buffer_line(60, 60, 0.2f, e += 1.6f, 120);
+        plan_buffer_line(62, 61, 0.2f, e += 0.09f, 120);
+        plan_buffer_line(64, 60, 0.2f, e += 0.09f, 120);
+        plan_buffer_line(20, 60, 0.2f, e += 1.8f, 80);
+        plan_buffer_line(20, 20, 0.2f, e += 1.6f, 80);
+        plan_buffer_line(20, 20, 0.2f, e -= 0.8f, 35);
+        plan_buffer_line(20, 21, 0.2f, e += 0.8f + 0.05f, 40);
+        // A slow Z dominated move, the advance ticks several times per main ISR.
+        plan_buffer_line(20.1f, 21, 0.6f, e += 0.4f, 5);
+        plan_buffer_line(20.2f, 21, 0.2f, e += 0.4f, 5);
+    }
+    sim::run_until_idle();
+    sim::port_hook = replay_next_hook;
+    extruder_advance_K = LA_K_DEF;
+}
+
+TEST_CASE("Linear advance E steps per block", "[linadvance]")
+{
+    SECTION("Without advance every block emits its own E steps") {
+        replay_moves(0);
+        REQUIRE(replay.size() == 33);
+        for (const block_e_steps_t &b : replay)
+            CHECK(b.emitted == b.planned);
+    }
+
+    SECTION("The advance shifts E steps between the blocks") {
+        replay_moves(0.2f);
+        REQUIRE(replay.size() == 33);
+        int32_t pressure = 0;
+        uint16_t max_adv_steps = 0;
+        bool advanced = false;
+        for (const block_e_steps_t &b : replay) {
+            INFO("block " << (&b - replay.data()));
+            // The pressure built up by the advance steps stays within the planned advance. The blocks
+            // without advance (the retraction) keep it, it is released by the following ones.
+            max_adv_steps = max(max_adv_steps, b.max_adv_steps);
+            pressure += b.emitted - b.planned;
+            CHECK(pressure >= 0);
+            CHECK(pressure <= max_adv_steps);
+            advanced |= b.emitted != b.planned;
+        }
+        CHECK(advanced);
+        CHECK(sim::motion_stats().overruns == 0);
+    }
+}
+
+#endif // LIN_ADVANCE
@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief Serial receive ring and the reading of the serial lines by get_command()
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "cmdqueue.h"
+#include "sim_avr.h"
+
+extern "C" void USART0_RX_vect(void);
+
+// A character received by the USART.
+static void receive(char c)
+{
+    UDR0.poke(c);
+    USART0_RX_vect();
+}
+
+static void receive(const char *s)
+{
+    while (*s)
+        receive(*s++);
+}
+
+static std::string serial_out;
+
+static void record_serial(uint8_t c)
+{
+    serial_out += char(c);
+}
+
+// The line as stored in the command queue, the plain moves as their records.
+static std::string queued(std::string line)
+{
+#ifdef CMDQUEUE_PREFETCH_MOVES
+    line.resize(move_record_from_text(&line[0], line.size()));
+#endif
+    return line;
+}
+
+TEST_CASE("Receive ring", "[serial]")
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    MSerial.overflowed();
+
+    // Fill the ring in several rounds, so that the blocks wrap around its end.
+    uint8_t next_in = 0, next_out = 0;
+    for (int round = 0; round < 8; ++round) {
+        const rx_index_t count = RX_BUFFER_SIZE / 3 + round;
+        for (rx_index_t i = 0; i < count; ++i)
+            receive(char(next_in++));
+        REQUIRE(MSerial.available() == count);
+
+        const unsigned char *data;
+        const rx_index_t block = MSerial.peekBlock(data);
+        REQUIRE(block > 0);
+        REQUIRE(block <= count);
+        CHECK(*data == next_out);
+        CHECK(MSerial.peek() == next_out);
+
+        unsigned char dst[RX_BUFFER_SIZE];
+        REQUIRE(MSerial.readBlock(dst, count - 1) == count - 1);
+        for (rx_index_t i = 0; i < count - 1; ++i)
+            REQUIRE(dst[i] == next_out++);
+        REQUIRE(MSerial.read() == next_out++);
+        CHECK(MSerial.read() == -1);
+        CHECK(MSerial.readBlock(dst, RX_BUFFER_SIZE - 1) == 0);
+    }
+    CHECK_FALSE(MSerial.overflowed());
+
+    // One location stays free, the characters received into a full ring are dropped.
+    for (rx_index_t i = 0; i < RX_BUFFER_SIZE - 1; ++i)
+        receive('a');
+    CHECK_FALSE(MSerial.overflowed());
+    receive('b');
+    CHECK(MSerial.available() == RX_BUFFER_SIZE - 1);
+    CHECK(MSerial.overflowed());
+    CHECK_FALSE(MSerial.overflowed());
+    MSerial.flush();
+    CHECK(MSerial.available() == 0);
+}
+
+TEST_CASE("Serial lines drained from the receive ring", "[serial]")
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    MSerial.overflowed();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+    serial_out.clear();
+    sim::serial_hook = record_serial;
+
+    // The host keeps the receive ring full, while the commands are processed one at a time. The
+    // lines which do not fit into the command queue wait in the ring, none of them is lost.
+    std::vector<std::string> sent, received;
+    bool waited = false;
+    for (int n = 0; n < 200;) {
+        char line[48];
+        snprintf(line, sizeof(line), "G1 X%d.%03d Y%d.5 E.0%d\n", 100 + n, n * 7 % 1000, 50 + n, n % 10);
+        if (MSerial.available() + strlen(line) <= RX_BUFFER_SIZE - 1) {
+            receive(line);
+            sent.push_back(queued(std::string(line, strlen(line) - 1)));
+            ++n;
+            continue;
+        }
+        get_command();
+        waited |= (MSerial.available() > 0);
+        REQUIRE(buflen > 0);
+        received.push_back(CMDBUFFER_CURRENT_STRING);
+        cmdqueue_pop_front();
+    }
+    while (buflen || MSerial.available()) {
+        get_command();
+        received.push_back(CMDBUFFER_CURRENT_STRING);
+        cmdqueue_pop_front();
+    }
+    sim::serial_hook = NULL;
+    CHECK(waited);
+    CHECK(received == sent);
+    CHECK(serial_out.find("Full RX Buffer") == std::string::npos);
+    cmdqueue_reset();
+}
@@ -0,0 +1,245 @@
+/**
+ * @file
+ * @brief MeatPack round trip through the host encoder and the firmware decoder
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "cmdqueue.h"
+#include "meatpack.h"
+#include "meatpack_encoder.h"
+#include "sim_avr.h"
+
+#ifdef ENABLE_MEATPACK
+
+extern "C" void USART0_RX_vect(void);
+
+// The line as stored in the command queue, the plain moves as their records.
+static std::string queued(std::string line)
+{
+#ifdef CMDQUEUE_PREFETCH_MOVES
+    line.resize(move_record_from_text(&line[0], line.size()));
+#endif
+    return line;
+}
+
+// The stream switching the decoder to the packing mode.
+static std::vector<uint8_t> packed_stream(bool no_spaces)
+{
+    std::vector<uint8_t> stream;
+    sim::meatpack_command(MPCommand_ResetAll, stream);
+    sim::meatpack_command(MPCommand_EnablePacking, stream);
+    if (no_spaces)
+        sim::meatpack_command(MPCommand_EnableNoSpaces, stream);
+    return stream;
+}
+
+static std::string decode(const std::vector<uint8_t> &stream)
+{
+    // The decoder echoes its configuration to the serial line.
+    sim::reset_registers();
+    std::string text;
+    for (uint8_t c : stream) {
+        mp_handle_rx_char(c);
+        char out[2];
+        const uint8_t n = mp_get_result_char(out);
+        REQUIRE(n <= 2);
+        text.append(out, n);
+    }
+    return text;
+}
+
+TEST_CASE("MeatPack lines", "[meatpack]")
+{
+    CHECK(sim::meatpack_line("G1 X10.5 Y20 E.0312 ; perimeter\r\n", false) == "G1 X10.5 Y20 E.0312\n");
+    CHECK(sim::meatpack_line("  G28 W  \n", false) == "G28 W\n");
+    CHECK(sim::meatpack_line("; comment only\n", false) == "");
+    CHECK(sim::meatpack_line("\r\n", false) == "");
+    CHECK(sim::meatpack_line("G1 X10.5 Y20 E.0312\n", true) == "G1X10.5Y20E.0312\n");
+    CHECK(sim::meatpack_line("M117 Printing a cube\n", true) == "M117 Printing a cube\n");
+}
+
+TEST_CASE("MeatPack round trip", "[meatpack]")
+{
+    static const char *const lines[] = {
+        "G1 X134.748 Y114.182 E.00781",
+        "G1 E-.8 F2100",
+        "G1 Z.6 F720",
+        "G92 E0",
+        "M862.3 P \"MK3S\"",
+        "M117 Printing XYZ calibration",
+        "N123 G1 X1*45",
+        "T0",
+        "G",
+        "X",
+        "M",
+        "MM",
+        "G1",
+        "ab",
+        "G1 x0",
+    };
+    for (bool no_spaces : { false, true }) {
+        std::string text;
+        for (const char *line : lines)
+            text += sim::meatpack_line(line, no_spaces);
+        INFO("no spaces " << no_spaces << " text \"" << text << "\"");
+        std::vector<uint8_t> stream = packed_stream(no_spaces);
+        const size_t header = stream.size();
+        sim::meatpack_encode(text, no_spaces, stream);
+        CHECK(decode(stream) == text);
+        CHECK(stream.size() - header < text.size());
+    }
+
+    // Random printable lines, packed and full width characters in any order.
+    static const char charset[] = "0123456789. GXEYZFM-SPTN*;\"abcdefghijklmnopqrstuvwxyz";
+    uint32_t seed = 1;
+    for (int n = 0; n < 200; ++n) {
+        const bool no_spaces = n & 1;
+        std::string text;
+        for (int l = 0; l < 20; ++l) {
+            std::string line;
+            seed = seed * 1103515245 + 12345;
+            const int len = 1 + (seed >> 16) % 40;
+            for (int i = 0; i < len; ++i) {
+                seed = seed * 1103515245 + 12345;
+                line += charset[(seed >> 16) % (sizeof(charset) - 1)];
+            }
+            text += sim::meatpack_line(line.c_str(), no_spaces);
+        }
+        INFO("no spaces " << no_spaces << " text \"" << text << "\"");
+        std::vector<uint8_t> stream = packed_stream(no_spaces);
+        sim::meatpack_encode(text, no_spaces, stream);
+        REQUIRE(decode(stream) == text);
+    }
+
+    // Switched off again, the characters pass unchanged.
+    std::vector<uint8_t> stream;
+    sim::meatpack_command(MPCommand_ResetAll, stream);
+    const std::string text = "G1 X1 Y2\n";
+    stream.insert(stream.end(), text.begin(), text.end());
+    CHECK(decode(stream) == text);
+}
+
+TEST_CASE("MeatPack bandwidth", "[meatpack]")
+{
+    // Extrusion moves as PrusaSlicer writes them: the packed stream carries more than 1.65 times the
+    // G-code of the plain one over the same serial line, more than 1.85 times with the spaces omitted.
+    for (bool no_spaces : { false, true }) {
+        std::string plain, text;
+        for (int n = 0; n < 500; ++n) {
+            char line[64];
+            snprintf(line, sizeof(line), "G1 X%d.%03d Y%d.%03d E.%05d\n", 100 + n % 50, n * 37 % 1000, 80 + n % 30,
+                n * 91 % 1000, 1000 + n * 13 % 9000);
+            plain += line;
+            text += sim::meatpack_line(line, no_spaces);
+        }
+        std::vector<uint8_t> stream = packed_stream(no_spaces);
+        const size_t header = stream.size();
+        sim::meatpack_encode(text, no_spaces, stream);
+        REQUIRE(decode(stream) == text);
+        const double gain = double(plain.size()) / (stream.size() - header);
+        INFO("no spaces " << no_spaces << " gain " << gain);
+        CHECK(gain > (no_spaces ? 1.85 : 1.65));
+    }
+}
+
+TEST_CASE("MeatPack line decode", "[meatpack]")
+{
+    std::string text;
+    for (const char *line : { "G1 X134.748 Y114.182 E.00781", "M117 Printing; a cube", "G1 Z.6 F720", "T0", "G28 W" })
+        text += sim::meatpack_line(line, false);
+    text += "G1 X1\rM2\r\nM3 abc\n";
+
+    // Any split of the stream and of the output decodes the same text, line by line.
+    for (bool no_spaces : { false, true }) {
+        std::vector<uint8_t> stream = packed_stream(no_spaces);
+        sim::meatpack_encode(text, no_spaces, stream);
+        for (uint16_t in_size : { 1, 2, 3, 7, 64, 1000 }) {
+            for (uint8_t out_size : { 1, 2, 5, 96 }) {
+                INFO("no spaces " << no_spaces << " in " << in_size << " out " << int(out_size));
+                sim::reset_registers();
+                std::string decoded;
+                size_t pos = 0;
+                while (pos < stream.size()) {
+                    const uint16_t n = uint16_t(std::min<size_t>(in_size, stream.size() - pos));
+                    uint16_t consumed;
+                    char out[96];
+                    const uint8_t count = mp_decode_line(stream.data() + pos, n, consumed, out, out_size);
+                    REQUIRE(consumed <= n);
+                    REQUIRE(count <= out_size);
+                    REQUIRE((consumed > 0 || count > 0));
+                    // Nothing follows the end of a line.
+                    for (uint8_t i = 0; i + 1 < count; ++i)
+                        REQUIRE((out[i] != '\n' && out[i] != '\r'));
+                    if (count < out_size && consumed < n)
+                        REQUIRE((out[count - 1] == '\n' || out[count - 1] == '\r'));
+                    decoded.append(out, count);
+                    pos += consumed;
+                }
+                // The characters decoded from the last byte.
+                uint16_t consumed;
+                char out[2];
+                const uint8_t count = mp_decode_line(NULL, 0, consumed, out, 2);
+                decoded.append(out, count);
+                CHECK(decoded == text);
+            }
+        }
+    }
+}
+
+TEST_CASE("MeatPack stream into the command queue", "[meatpack]")
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+
+    std::vector<std::string> sent;
+    std::string text;
+    for (int n = 0; n < 100; ++n) {
+        char line[64];
+        snprintf(line, sizeof(line), "G1 X%d.%03d Y%d.5 E.0%d%s", 100 + n, n * 7 % 1000, 50 + n, n % 10, (n % 7) ? "" : " ; wall");
+        sent.push_back(sim::meatpack_line(line, false));
+        sent.back().pop_back();
+        sent.back() = queued(sent.back());
+        text += sim::meatpack_line(line, false);
+    }
+    // A line longer than a command, cut at MAX_CMD_SIZE - 1 characters.
+    const std::string overlong(MAX_CMD_SIZE + 10, '7');
+    text += "G1 X" + overlong + "\nM400\n";
+    sent.push_back(("G1 X" + overlong).substr(0, MAX_CMD_SIZE - 1));
+    sent.push_back("M400");
+    std::vector<uint8_t> stream = packed_stream(false);
+    sim::meatpack_encode(text, false, stream);
+
+    std::vector<std::string> received;
+    size_t pos = 0;
+    for (int i = 0; i < 10000 && (pos < stream.size() || buflen || MSerial.available()); ++i) {
+        while (pos < stream.size() && MSerial.available() < RX_BUFFER_SIZE - 1) {
+            UDR0.poke(stream[pos++]);
+            USART0_RX_vect();
+        }
+        get_command();
+        if (buflen) {
+            received.push_back(CMDBUFFER_CURRENT_STRING);
+            cmdqueue_pop_front();
+        }
+    }
+    // The rest of the overlong line is a command of its own.
+    REQUIRE(received.size() == sent.size() + 1);
+    received.erase(received.end() - 2);
+    CHECK(received == sent);
+
+    std::vector<uint8_t> reset;
+    sim::meatpack_command(MPCommand_ResetAll, reset);
+    decode(reset);
+    cmdqueue_reset();
+}
+
+#endif // ENABLE_MEATPACK
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @brief Trapezoids of a long run of short segments, replanned while the stepper consumes the queue
+ */
+
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "motion_core.h"
+
+struct block_rates_t
+{
+    uint32_t initial_rate;
+    uint32_t final_rate;
+};
+
+static std::vector<block_rates_t> executed;
+
+// The rates of every block, as the stepper interrupt starts it.
+static void record_block(const sim::isr_events_t &ev, uint32_t, uint16_t)
+{
+    if (ev.block_setups && current_block)
+        executed.push_back({ current_block->initial_rate, current_block->final_rate });
+}
+
+// Seconds to print the collinear segments along X, the queue wrapping many times.
+static double print_segments(float segment, uint16_t count, float feedrate)
+{
+    sim::motion_init();
+    executed.clear();
+    sim::set_isr_trace(record_block);
+    for (uint16_t i = 1; i <= count; ++i)
+        plan_buffer_line(10 + segment * i, 10, 0, 0, feedrate);
+    sim::run_until_idle();
+    sim::set_isr_trace(NULL);
+    return sim::motion_stats().ticks * double(sim::CYCLES_PER_TICK) / F_CPU;
+}
+
+TEST_CASE("Junction rates of a long run of short segments", "[planner]")
+{
+    // The seconds measured with planner_recalculate() replanning every queued block. At these
+    // feedrates the lookahead of the queue limits the speed, not the junctions.
+    const struct
+    {
+        float segment;
+        double seconds;
+    } runs[] = { { 0.2f, 4.985 }, { 0.5f, 7.781 } };
+    for (const auto &run : runs) {
+        INFO("segment " << run.segment << " mm");
+        const uint16_t count = 2000;
+        const double seconds = print_segments(run.segment, count, 200);
+        REQUIRE(executed.size() == count);
+
+        // The stepper leaves every block at the rate it enters the next one, but for the rounding.
+        // The first blocks start before the queue has filled and can't be replanned anymore.
+        uint16_t jumps = 0;
+        for (uint16_t i = BLOCK_BUFFER_SIZE; i + 1 < count; ++i)
+            jumps += abs(int32_t(executed[i].final_rate) - int32_t(executed[i + 1].initial_rate)) > 1;
+        CHECK(jumps == 0);
+
+        CHECK(seconds > run.seconds * 0.99);
+        CHECK(seconds < run.seconds * 1.01);
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief Layout of the planner queue
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "xyzcal.h"
+
+// The AVR does not align the structure members. Pack the planner structures to get their size
+// on the target. The namespace keeps them apart from the regular host layout.
+namespace avr {
+#pragma pack(push, 1)
+#include "planner.h"
+#pragma pack(pop)
+} // namespace avr
+
+TEST_CASE("Planner queue fits into the RAM budget", "[planner]")
+{
+    const size_t slot_size = sizeof(avr::block_t) + sizeof(avr::block_recovery_t);
+    const size_t blocks_fitting = BLOCK_BUFFER_RAM / slot_size;
+    INFO("block_t " << sizeof(avr::block_t) << " B, block_recovery_t " << sizeof(avr::block_recovery_t) << " B");
+
+    CHECK(blocks_fitting >= BLOCK_BUFFER_SIZE);
+    // The compact layout has to make the queue longer than the former 16 blocks.
+    CHECK(BLOCK_BUFFER_SIZE > 16);
+    // xyzcal uses block_buffer as the scratch buffer of the scan (1072 B), the thermal model
+    // calibration 1kB of it.
+    CHECK(sizeof(avr::block_t) * BLOCK_BUFFER_SIZE >= XYZCAL_SCRATCH_SIZE);
+    CHECK(XYZCAL_SCRATCH_SIZE == 1072);
+}
+
+TEST_CASE("Junction speeds in fixed point", "[planner]")
+{
+    CHECK(avr::speed_to_fx(0.f) == 0);
+    CHECK(avr::speed_to_fx(1.f) == SPEED_FX_ONE);
+    CHECK(avr::speed_to_fx(200.f) == 200 * SPEED_FX_ONE);
+    // Rounding down keeps the junction speed within the limits.
+    CHECK(avr::speed_to_fx(0.999f) == SPEED_FX_ONE - 1);
+    CHECK(avr::fx_to_speed(avr::speed_to_fx(123.456f)) <= 123.456f);
+    CHECK(avr::fx_to_speed(avr::speed_to_fx(123.456f)) > 123.456f - 1.f / SPEED_FX_ONE);
+    // Saturation instead of an overflow
+    CHECK(avr::speed_to_fx(1024.f) == SPEED_FX_MAX);
+    CHECK(avr::speed_to_fx(1e6f) == SPEED_FX_MAX);
+}
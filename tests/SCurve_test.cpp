@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief Fixed point S-curve ramp of the stepper interrupt
+ */
+
+#include <math.h>
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/catch_approx.hpp"
+#include "../Firmware/scurve.h"
+
+static double smoothstep(double u)
+{
+    return u * u * u * (10 - 15 * u + 6 * u * u);
+}
+
+TEST_CASE("S-curve smoothstep in fixed point", "[scurve]")
+{
+    CHECK(scurve_smoothstep(0) == 0);
+    CHECK(scurve_smoothstep(UINT16_MAX) >= UINT16_MAX - 4);
+    CHECK(scurve_smoothstep(0x8000) == 0x8000);
+
+    uint16_t last = 0;
+    for (uint32_t u = 0; u <= UINT16_MAX; u += 97) {
+        const uint16_t s = scurve_smoothstep(u);
+        INFO("u " << u);
+        // Within a few LSB of the exact polynomial, monotonic and point symmetric around the middle.
+        CHECK(fabs(s - smoothstep(u / 65536.) * 65536.) <= 4);
+        CHECK(s >= last);
+        CHECK(abs(int(s) + int(scurve_smoothstep(UINT16_MAX - u)) - UINT16_MAX) <= 6);
+        last = s;
+    }
+}
+
+TEST_CASE("S-curve ramp time", "[scurve]")
+{
+    CHECK(scurve_dv_inv(SCURVE_DV_MIN) == 0);
+    CHECK(scurve_dv_inv(SCURVE_DV_MIN + 1) != 0);
+
+    for (uint16_t dv : { 300, 1000, 4567, 20000, 40000 }) {
+        INFO("dv " << dv);
+        const uint16_t dv_inv = scurve_dv_inv(dv);
+        CHECK(scurve_time(0, dv_inv) == 0);
+        CHECK(scurve_time(dv / 2, dv_inv) == Catch::Approx(0x8000).epsilon(0.01));
+        // Saturated at the end of the ramp.
+        CHECK(scurve_time(dv, dv_inv) >= UINT16_MAX - 0x100);
+        CHECK(scurve_time(UINT16_MAX, dv_inv) == UINT16_MAX);
+    }
+}
+
+// Step the ramp in the same way as the stepper interrupt: the linear gain grows with the time,
+// the S-curve gain replaces it. Integrate the rates over the time of the linear ramp.
+TEST_CASE("S-curve ramp matches the trapezoid time and distance", "[scurve]")
+{
+    for (uint16_t dv : { 500, 3000, 12000 }) {
+        INFO("dv " << dv);
+        const uint16_t v0 = 200;
+        const uint16_t dv_inv = scurve_dv_inv(dv);
+        const int n = 10000;
+        // The acceleration is averaged over 1/50 of the ramp.
+        const int window = n / 50;
+        uint16_t gains[n];
+        double distance_linear = 0, distance_scurve = 0, max_slope = 0;
+        for (int i = 0; i < n; ++i) {
+            const uint16_t linear_gain = uint32_t(dv) * i / n;
+            gains[i] = scurve_gain(linear_gain, dv, dv_inv);
+            distance_linear += v0 + linear_gain;
+            distance_scurve += v0 + gains[i];
+            if (i >= window)
+                max_slope = fmax(max_slope, double(gains[i] - gains[i - window]) * n / (double(dv) * window));
+        }
+        CHECK(distance_scurve == Catch::Approx(distance_linear).epsilon(0.001));
+        // Peak acceleration 15/8 of the linear ramp.
+        CHECK(max_slope == Catch::Approx(15. / 8.).epsilon(0.05));
+        // The ramp ends at the target rate.
+        CHECK(scurve_gain(dv, dv, dv_inv) >= dv - 2);
+    }
+    // Small rate changes are ramped linearly.
+    CHECK(scurve_gain(100, 200, scurve_dv_inv(200)) == 100);
+}
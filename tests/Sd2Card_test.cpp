@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @brief Sd2Card against the emulated SD card: single and streamed block reads
+ */
+
+#include <string.h>
+#include <vector>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "Sd2Card.h"
+#include "sd_card.h"
+#include "sim_avr.h"
+
+static const uint32_t image_blocks = 2048;
+
+// Every byte tells its block and its offset.
+static uint8_t pattern(uint32_t block, uint16_t i)
+{
+    return uint8_t(block * 7 + i);
+}
+
+static void insert_card(Sd2Card &sd)
+{
+    std::vector<uint8_t> image(image_blocks * 512);
+    for (uint32_t block = 0; block < image_blocks; ++block)
+        for (uint16_t i = 0; i < 512; ++i)
+            image[block * 512 + i] = pattern(block, i);
+    sim::reset_registers();
+    sim::sd_card_insert(image);
+    REQUIRE(sd.init(SPI_FULL_SPEED));
+    sim::sd_card_stats = sim::sd_card_stats_t();
+}
+
+static bool block_matches(uint32_t block, const uint8_t *data)
+{
+    for (uint16_t i = 0; i < 512; ++i)
+        if (data[i] != pattern(block, i))
+            return false;
+    return true;
+}
+
+TEST_CASE("Sd2Card initialization", "[sd]")
+{
+    Sd2Card sd;
+    insert_card(sd);
+    CHECK(sd.type() == SD_CARD_TYPE_SDHC);
+    CHECK(sd.cardSize() == image_blocks);
+    CHECK(sim::sd_card_stats.errors == 0);
+}
+
+TEST_CASE("Sd2Card single block reads and writes", "[sd]")
+{
+    Sd2Card sd;
+    insert_card(sd);
+    uint8_t data[512];
+    REQUIRE(sd.readBlock(100, data));
+    CHECK(block_matches(100, data));
+    CHECK(sim::sd_card_stats.single_reads == 1);
+    CHECK(sim::sd_card_stats.blocks_read == 1);
+
+    memset(data, 0x5A, sizeof(data));
+    REQUIRE(sd.writeBlock(101, data));
+    CHECK(sim::sd_card_stats.blocks_written == 1);
+    CHECK(sim::sd_card_image()[101 * 512 + 17] == 0x5A);
+    CHECK(sim::sd_card_stats.errors == 0);
+}
+
+TEST_CASE("Sd2Card streamed block reads", "[sd]")
+{
+    Sd2Card sd;
+    insert_card(sd);
+    uint8_t data[512];
+
+    // A sequential read: one command for all the blocks.
+    for (uint32_t block = 300; block < 364; ++block) {
+        REQUIRE(sd.readBlockStream(block, data));
+        CHECK(block_matches(block, data));
+    }
+    CHECK(sim::sd_card_stats.multiple_reads == 1);
+    CHECK(sim::sd_card_stats.blocks_read == 64);
+    CHECK(sim::sd_card_stats.commands == 1);
+
+    // Another command ends the sequence first.
+    REQUIRE(sd.readBlock(10, data));
+    CHECK(block_matches(10, data));
+    CHECK(sim::sd_card_stats.stops == 1);
+    CHECK(sim::sd_card_stats.single_reads == 1);
+
+    // The next block is read by a new sequence, so is a block out of the sequence.
+    REQUIRE(sd.readBlockStream(364, data));
+    CHECK(block_matches(364, data));
+    REQUIRE(sd.readBlockStream(365, data));
+    REQUIRE(sd.readBlockStream(500, data));
+    CHECK(block_matches(500, data));
+    CHECK(sim::sd_card_stats.multiple_reads == 3);
+    CHECK(sim::sd_card_stats.stops == 2);
+
+    // A write in the middle of the sequence.
+    memset(data, 0xA5, sizeof(data));
+    REQUIRE(sd.writeBlock(501, data));
+    CHECK(sim::sd_card_stats.stops == 3);
+    REQUIRE(sd.readBlockStream(501, data));
+    CHECK(data[0] == 0xA5);
+    CHECK(sim::sd_card_stats.blocks_read == 64 + 1 + 4);
+    CHECK(sim::sd_card_stats.errors == 0);
+
+    // A read past the end of the card fails, the card is left out of the sequence.
+    CHECK_FALSE(sd.readBlockStream(image_blocks, data));
+    REQUIRE(sd.readBlock(1, data));
+    CHECK(block_matches(1, data));
+    CHECK(sim::sd_card_stats.errors == 0);
+}
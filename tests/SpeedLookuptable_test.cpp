@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief Compile time generated speed lookup tables of the stepper interrupt
+ */
+
+#include <math.h>
+#include "catch2/catch_test_macros.hpp"
+#include "speed_lookuptable.h"
+#include "speed_lookuptable_ref.h"
+
+template <uint16_t N>
+static bool table_equals(const speed_table_t<N> &table, const uint16_t (&reference)[N][2])
+{
+    for (uint16_t i = 0; i < N; ++i) {
+        INFO("entry " << i);
+        CHECK(table.entry[i][0] == reference[i][0]);
+        CHECK(table.entry[i][1] == reference[i][1]);
+        if (table.entry[i][0] != reference[i][0] || table.entry[i][1] != reference[i][1])
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE("Generated speed tables reproduce the former tables", "[speed_lookuptable]")
+{
+    // The former tables: truncated periods, 256 entries spaced by 256 (fast) and 8 (slow) steps/s.
+    SECTION("16 MHz") {
+        constexpr auto fast = speed_table_generate<256>(16000000 / 8, 16000000 / 500000, 8, false);
+        constexpr auto slow = speed_table_generate<256>(16000000 / 8, 16000000 / 500000, 3, false);
+        CHECK(table_equals(fast, f16mhz::reference_fast));
+        CHECK(table_equals(slow, f16mhz::reference_slow));
+    }
+    SECTION("20 MHz") {
+        constexpr auto fast = speed_table_generate<256>(20000000 / 8, 20000000 / 500000, 8, false);
+        constexpr auto slow = speed_table_generate<256>(20000000 / 8, 20000000 / 500000, 3, false);
+        CHECK(table_equals(fast, f20mhz::reference_fast));
+        CHECK(table_equals(slow, f20mhz::reference_slow));
+    }
+}
+
+TEST_CASE("Speed table layout", "[speed_lookuptable]")
+{
+    // The fast table reaches the highest step rate of a single ISR invocation.
+    CHECK(((SPEED_TABLE_MAX_RATE - SPEED_TABLE_RATE_MIN) >> SPEED_TABLE_FAST_SHIFT) + 1 < SPEED_TABLE_FAST_SIZE);
+    CHECK(SPEED_TABLE_FAST_SHIFT <= 8);
+    // The legacy spacing when the table has to cover the whole 16 bit range.
+    CHECK(speed_table_fast_shift(65535 - 32) == 8);
+    CHECK(speed_table_fast_shift(20000 - 32) == 7);
+    CHECK(speed_table_fast_shift(2000) == 3);
+}
+
+// Maximum relative error of calc_timer() against the exact period over a range of step rates.
+static double max_relative_error(uint16_t rate_from, uint16_t rate_to)
+{
+    double error = 0;
+    for (uint32_t rate = rate_from; rate <= rate_to; ++rate) {
+        uint8_t step_loops;
+        const uint16_t timer = calc_timer(rate, step_loops, UINT16_MAX / 2);
+        REQUIRE(step_loops == 1);
+        const double exact = double(SPEED_TABLE_TIMER_FREQ) / rate;
+        if (exact < 100)
+            break; // calc_timer() limits the period to 100 ticks
+        error = fmax(error, fabs(timer - exact) / exact);
+    }
+    return error;
+}
+
+TEST_CASE("calc_timer interpolation error", "[speed_lookuptable]")
+{
+    // The slow table is spaced by 8 steps/s, the interpolation is coarse close to the minimum rate.
+    CHECK(max_relative_error(SPEED_TABLE_RATE_MIN, 200) < 0.015);
+    CHECK(max_relative_error(200, SPEED_TABLE_SLOW_SIZE << SPEED_TABLE_SLOW_SHIFT) < 0.002);
+    // The fast table, up to the highest ISR step rate.
+    CHECK(max_relative_error(SPEED_TABLE_SLOW_SIZE << SPEED_TABLE_SLOW_SHIFT, SPEED_TABLE_MAX_RATE) < 0.008);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief Multi-stepping decision of the stepper interrupt
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "planner.h"
+#include "stepper.h"
+#include "speed_lookuptable.h"
+#include "motion_core.h"
+
+TEST_CASE("calc_timer multi-stepping limit", "[stepper]")
+{
+    uint8_t step_loops;
+    calc_timer(9000, step_loops);
+    CHECK(step_loops == 1);
+    calc_timer(15000, step_loops);
+    CHECK(step_loops == 2);
+    calc_timer(25000, step_loops);
+    CHECK(step_loops == 4);
+
+    // A higher limit keeps the same rates single or double stepped.
+    calc_timer(15000, step_loops, 16000);
+    CHECK(step_loops == 1);
+    calc_timer(25000, step_loops, 16000);
+    CHECK(step_loops == 2);
+
+    // Multi-stepping keeps the step rate: twice the steps per ISR at twice the ISR period.
+    const uint16_t single = calc_timer(12000, step_loops, 16000);
+    REQUIRE(step_loops == 1);
+    const uint16_t dual = calc_timer(12000, step_loops, 10000);
+    REQUIRE(step_loops == 2);
+    CHECK(abs(int(dual) - 2 * int(single)) <= 2);
+}
+
+#ifdef STEP_LOOPS_ADAPTIVE
+TEST_CASE("Adaptive multi-stepping limit", "[stepper]")
+{
+    sim::motion_init();
+    st_isr_stats_t stats;
+    st_get_isr_stats(stats);
+    CHECK(stats.isr_rate_max == STEP_ISR_RATE_DEFAULT);
+
+    // Fast travels: the ISR stays well below the load target, so the limit rises
+    // and the moves are single stepped beyond the default limit.
+    for (uint8_t i = 0; i < 4; ++i) {
+        plan_buffer_line(200, 200, 0, 0, 200);
+        plan_buffer_line(0, 0, 0, 0, 200);
+    }
+    sim::run_until_idle();
+
+    st_get_isr_stats(stats);
+    CHECK(stats.isr_rate_max > STEP_ISR_RATE_DEFAULT);
+    CHECK(stats.isr_rate_max <= STEP_ISR_RATE_MAX);
+    CHECK(stats.overruns == 0);
+    CHECK(stats.busy_max > 0);
+    CHECK(sim::motion_stats().overruns == 0);
+    // Fewer loops per ISR than with the fixed 10 kHz limit.
+    const sim::motion_stats_t &s = sim::motion_stats();
+    CHECK(double(s.loops) / s.isr_stepping < 1.5);
+
+    st_reset_isr_stats();
+    st_get_isr_stats(stats);
+    CHECK(stats.busy_max == 0);
+}
+#endif //STEP_LOOPS_ADAPTIVE
@@ -0,0 +1,143 @@
+/**
+ * @file
+ * @brief Feed telemetry of the planner, the command queue and the serial line
+ */
+
+#include <string.h>
+#include "catch2/catch_test_macros.hpp"
+#include "Marlin.h"
+#include "cmdqueue.h"
+#include "planner.h"
+#include "stepper.h"
+#include "telemetry.h"
+#include "motion_core.h"
+#include "sim_avr.h"
+
+extern "C" void USART0_RX_vect(void);
+
+// Execute the stepper interrupt for at least ms of the simulated time.
+static void run_for(uint32_t ms)
+{
+    const uint32_t start = sim::now_us();
+    while (sim::now_us() - start < ms * 1000)
+        sim::isr();
+}
+
+static uint32_t total(const uint32_t *ms)
+{
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < TELEMETRY_BINS; ++i)
+        sum += ms[i];
+    return sum;
+}
+
+TEST_CASE("Telemetry bins", "[telemetry]")
+{
+    CHECK(telemetry_bin(0, BLOCK_BUFFER_SIZE - 1) == 0);
+    CHECK(telemetry_bin(BLOCK_BUFFER_SIZE - 1, BLOCK_BUFFER_SIZE - 1) == TELEMETRY_BINS - 1);
+    CHECK(telemetry_bin(0, CMDQUEUE_SIZE) == 0);
+    CHECK(telemetry_bin(CMDQUEUE_SIZE, CMDQUEUE_SIZE) == TELEMETRY_BINS - 1);
+    for (uint8_t n = 1; n <= CMDQUEUE_SIZE; ++n)
+        CHECK(telemetry_bin(n, CMDQUEUE_SIZE) >= telemetry_bin(n - 1, CMDQUEUE_SIZE));
+}
+
+TEST_CASE("Telemetry of the planner queue", "[telemetry]")
+{
+    sim::motion_init();
+    cmdqueue_reset();
+    telemetry_reset();
+
+    // A full planner queue.
+    for (int i = 1; i < BLOCK_BUFFER_SIZE; ++i)
+        plan_buffer_line(i * 10, 0, 0, 0, 50);
+    REQUIRE(moves_planned() == BLOCK_BUFFER_SIZE - 1);
+    run_for(50);
+    telemetry_update(true);
+    const uint32_t full_ms = telemetry.planner_ms[TELEMETRY_BINS - 1];
+    CHECK(full_ms >= 50);
+    CHECK(total(telemetry.planner_ms) == full_ms);
+    CHECK(telemetry.cmdqueue_ms[0] == full_ms);
+    CHECK(telemetry.starved_ms == 0);
+
+    // The stepper drained the queue during a print, the next move is late.
+    sim::run_until_idle();
+    telemetry_update(true);
+    run_for(100);
+    telemetry_update(true);
+    CHECK(telemetry.starved_ms >= 100);
+    CHECK(telemetry.planner_ms[0] >= 100);
+
+    // Not while idle.
+    const uint32_t starved_ms = telemetry.starved_ms;
+    run_for(100);
+    telemetry_update(false);
+    CHECK(telemetry.starved_ms == starved_ms);
+
+    // The move which found it drained.
+    plan_buffer_line(0, 0, 0, 0, 50);
+    CHECK(planner_starvation_count() == 1);
+
+    // Nor after a command waited for the moves to finish.
+    st_synchronize();
+    telemetry_update(true);
+    run_for(100);
+    telemetry_update(true);
+    CHECK(telemetry.starved_ms == starved_ms);
+    plan_buffer_line(10, 0, 0, 0, 50);
+    CHECK(planner_starvation_count() == 1);
+    sim::run_until_idle();
+
+    telemetry_reset();
+    CHECK(planner_starvation_count() == 0);
+    CHECK(telemetry.starved_ms == 0);
+    CHECK(total(telemetry.planner_ms) == 0);
+}
+
+TEST_CASE("Telemetry of the serial line", "[telemetry]")
+{
+    sim::reset_registers();
+    selectedSerialPort = 0;
+    MSerial.flush();
+    MSerial.overflowed();
+    cmdqueue_reset();
+    serial_count = 0;
+    comment_mode = false;
+    telemetry_reset();
+
+    // The high water mark of the receive ring, as the receive interrupt stores the characters.
+    static const char lines[] = "M117 A\nM117 B\nM117 C\n";
+    for (const char *p = lines; *p; ++p) {
+        UDR0.poke(*p);
+        USART0_RX_vect();
+    }
+    CHECK(MSerial.rxMax() == strlen(lines));
+    get_command();
+    CHECK(buflen == 3);
+    cmdqueue_reset();
+    get_command();
+    CHECK(MSerial.rxMax() == strlen(lines));
+    CHECK(telemetry.rx_full == 0);
+
+    // Characters received and read between two samples of get_command() count as well.
+    telemetry_reset();
+    CHECK(MSerial.rxMax() == 0);
+    for (const char *p = lines; *p; ++p) {
+        UDR0.poke(*p);
+        USART0_RX_vect();
+    }
+    MSerial.flush();
+    get_command();
+    CHECK(MSerial.rxMax() == strlen(lines));
+
+    // A character dropped by the receive interrupt.
+    for (uint16_t i = 0; i < RX_BUFFER_SIZE; ++i) {
+        UDR0.poke(i % 32 ? 'a' : '\n');
+        USART0_RX_vect();
+    }
+    get_command();
+    CHECK(MSerial.rxMax() == RX_BUFFER_SIZE - 1);
+    CHECK(telemetry.rx_full == 1);
+    MSerial.flush();
+    cmdqueue_reset();
+    serial_count = 0;
+}